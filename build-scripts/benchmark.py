@@ -0,0 +1,539 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# This script benchmarks kernelconfig's Kconfig import and resolve pipeline
+# against one or more kernel source trees,
+# and writes the results to a JSON file.
+#
+# Usage: benchmark [-o <outfile>] [-n <repeat>] [--pym <dir>] ...
+#                  <srctree>[:<arch>[,<arch>...]]...
+#
+# Each (srctree, arch) case runs in a separate process,
+# so that lkc's global state and the peak RSS are not shared between cases.
+#
+# Measured steps:
+#  * symbolgen        -- KconfigSymbolGenerator.get_symbols()
+#                        (read_symbols(), symbol table, Expr creation)
+#  * lkc_symbols      -- lkconfig.get_symbols()
+#  * exprview         -- recursive ExprView expansion to Expr objects
+#                        of all symbols' dir_dep/rev_dep/prompts/defaults
+#  * oldconfig        -- lkconfig.oldconfig() of an empty input config
+#  * depgraph_resolve -- ConfigGraph.resolve() for a random set of
+#                        "builtin" decisions (--decisions, --seed)
+#
+# With --check-split, the depgraph_resolve decisions are also resolved
+# with and without splitting levels into independent decision groups
+# (ConfigGraph.SPLIT_DECISION_LEVELS), and the case fails if the
+# results differ.
+#
+# Results (per step): wall/cpu time of each run, best/median wall time,
+# number of items processed and throughput (items per second, best run),
+# peak RSS after the step and the number of allocated Python memory blocks
+# (sys.getallocatedblocks()) the step left behind.
+# With --tracemalloc, also the peak traced memory of the step
+# (slow, timings are not comparable to runs without --tracemalloc).
+# lkconfig's own profile (see lkconfig.get_profile()) is included, too.
+#
+import argparse
+import json
+import os
+import platform
+import random
+import resource
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+
+RESULTS_FORMAT_VERSION = 1
+
+
+def get_peak_rss_kib():
+    # ru_maxrss is in KiB on Linux
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+# --- end of get_peak_rss_kib (...) ---
+
+
+class StepTimer(object):
+    """Runs a benchmark step one or more times and collects its results.
+
+    @ivar name:     step name
+    @type name:     C{str}
+    @ivar runs:     list of (wall time, cpu time) per run
+    @type runs:     C{list} of 2-tuple (C{float}, C{float})
+    @ivar items:    number of items processed per run
+    @type items:    C{int} or C{None}
+    @ivar tracemalloc_peak:  peak traced memory of the first run, or None
+    @type tracemalloc_peak:  C{int} or C{None}
+    """
+
+    def __init__(self, name):
+        super().__init__()
+        self.name = name
+        self.runs = []
+        self.items = None
+        self.alloc_blocks = None
+        self.peak_rss_kib = None
+        self.tracemalloc_peak = None
+        self.failed = None
+
+    def run(self, func, repeat, use_tracemalloc=False):
+        """Calls func() repeat times.
+
+        @param func:             no-arg function that returns the number
+                                 of items processed (or None)
+        @type  func:             callable
+        @param repeat:           number of runs
+        @type  repeat:           C{int}
+        @keyword use_tracemalloc:  whether to trace Python memory allocations
+        @type    use_tracemalloc:  C{bool}
+
+        @return:  return value of the last func() call
+        """
+        if use_tracemalloc:
+            import tracemalloc
+            tracemalloc.start()
+
+        blocks_before = sys.getallocatedblocks()
+        ret = None
+        try:
+            for k in range(repeat):
+                wall_start = time.perf_counter()
+                cpu_start = time.process_time()
+                ret = func()
+                cpu_end = time.process_time()
+                wall_end = time.perf_counter()
+
+                self.runs.append((wall_end - wall_start, cpu_end - cpu_start))
+                self.items = ret
+
+                if use_tracemalloc and k == 0:
+                    self.tracemalloc_peak = tracemalloc.get_traced_memory()[1]
+            # --
+        except Exception as err:
+            self.failed = "{}: {}".format(err.__class__.__name__, err)
+            ret = None
+        finally:
+            if use_tracemalloc:
+                tracemalloc.stop()
+        # --
+
+        self.alloc_blocks = sys.getallocatedblocks() - blocks_before
+        self.peak_rss_kib = get_peak_rss_kib()
+        return ret
+    # --- end of run (...) ---
+
+    def get_result(self):
+        walls = [w for w, _ in self.runs]
+
+        result = {
+            "runs": [{"wall": w, "cpu": c} for w, c in self.runs],
+            "items": self.items,
+            "alloc_blocks": self.alloc_blocks,
+            "peak_rss_kib": self.peak_rss_kib,
+        }
+
+        if walls:
+            best = min(walls)
+            result["wall_best"] = best
+            result["wall_median"] = statistics.median(walls)
+            if self.items and best > 0:
+                result["throughput"] = self.items / best
+
+        if self.tracemalloc_peak is not None:
+            result["tracemalloc_peak"] = self.tracemalloc_peak
+
+        if self.failed:
+            result["failed"] = self.failed
+
+        return result
+    # --- end of get_result (...) ---
+
+# --- end of StepTimer ---
+
+
+def get_git_rev(srctree):
+    try:
+        proc = subprocess.run(
+            ["git", "-C", srctree, "rev-parse", "HEAD"],
+            stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+            universal_newlines=True
+        )
+    except OSError:
+        return None
+
+    return (proc.stdout.strip() or None) if proc.returncode == 0 else None
+# --- end of get_git_rev (...) ---
+
+
+def run_case(args):
+    """Benchmarks one (srctree, arch) case in the current process
+    and returns the results as dict.
+    """
+    # imports are deferred until --pym has been added to sys.path
+    from kernelconfig.kernel import info as kernel_info
+    from kernelconfig.kconfig import lkconfig
+    from kernelconfig.kconfig import symbol
+    from kernelconfig.kconfig import symbolexpr
+    from kernelconfig.kconfig import symbolgen
+    from kernelconfig.kconfig import depgraph
+    from kernelconfig.kconfig.config import data
+
+    repeat = args.repeat
+    use_tracemalloc = args.tracemalloc
+    steps = []
+
+    def run_step(name, func, step_repeat=repeat):
+        step = StepTimer(name)
+        steps.append(step)
+        return step.run(func, step_repeat, use_tracemalloc=use_tracemalloc)
+    # ---
+
+    kinfo = kernel_info.KernelInfo(args.srctree, arch=args.arch)
+    kinfo.prepare()
+
+    lkconfig.set_profiling(True)
+    lkc_profile = {}
+    split_check = None
+
+    # symbolgen, each run parses the Kconfig files in a new lkc context
+    kconfig_symbols = None
+
+    def step_symbolgen():
+        nonlocal kconfig_symbols
+        symgen = symbolgen.KconfigSymbolGenerator(kinfo)
+        kconfig_symbols = symgen.get_symbols()
+        return len(kconfig_symbols)
+    # ---
+
+    run_step("symbolgen", step_symbolgen)
+    if kconfig_symbols is None:
+        return {"steps": {s.name: s.get_result() for s in steps}}
+
+    lkc_profile["symbolgen"] = lkconfig.get_profile(True)
+
+    # lkc_symbols, the last symbolgen context is still active
+    lkc_symbol_views = None
+
+    def step_lkc_symbols():
+        nonlocal lkc_symbol_views
+        lkc_symbol_views = lkconfig.get_symbols()
+        return len(lkc_symbol_views)
+    # ---
+
+    run_step("lkc_symbols", step_lkc_symbols)
+
+    # exprview
+    def step_exprview():
+        expr_builder = symbolgen.KconfigSymbolExpressionBuilder()
+        create_expr = expr_builder.create
+        nexpr = 0
+
+        symbolexpr.clear_cache()
+        try:
+            for sym_view in lkc_symbol_views:
+                for eview in (sym_view.get_dir_dep(), sym_view.get_rev_dep()):
+                    if eview is not None:
+                        create_expr(eview)
+                        nexpr += 1
+
+                for _, eview in sym_view.get_prompts():
+                    if eview is not None:
+                        create_expr(eview)
+                        nexpr += 1
+
+                for def_views in sym_view.get_defaults():
+                    for eview in def_views:
+                        if eview is not None:
+                            create_expr(eview)
+                            nexpr += 1
+        finally:
+            symbolexpr.clear_cache()
+
+        return nexpr
+    # ---
+
+    if lkc_symbol_views is not None:
+        run_step("exprview", step_exprview)
+
+    # oldconfig
+    with tempfile.TemporaryDirectory(prefix="kernelconfig-bench-") as tmpdir:
+        infile = os.path.join(tmpdir, "config.in")
+        outfile = os.path.join(tmpdir, "config.out")
+
+        with open(infile, "wt"):
+            pass
+
+        def step_oldconfig():
+            lkconfig.oldconfig(infile, outfile, {})
+            return len(lkc_symbol_views or ())
+        # ---
+
+        lkconfig.get_profile(True)
+        run_step("oldconfig", step_oldconfig)
+        lkc_profile["oldconfig"] = lkconfig.get_profile(True)
+
+        default_config = None
+        if os.path.isfile(outfile):
+            default_config = data.KernelConfig(kconfig_symbols)
+            default_config.read_config_file(outfile)
+    # --
+
+    # depgraph_resolve
+    if default_config is not None:
+        rand = random.Random(args.seed)
+        candidates = sorted(
+            (
+                sym for sym in kconfig_symbols
+                if isinstance(sym, symbol.TristateKconfigSymbol)
+            ),
+            key=lambda s: s.name
+        )
+        decision_syms = rand.sample(
+            candidates, min(args.decisions, len(candidates))
+        )
+        decisions = {
+            sym: {symbol.TristateKconfigSymbolValue.y}
+            for sym in decision_syms
+        }
+
+        def step_depgraph_resolve():
+            dgraph = depgraph.ConfigGraph(default_config, decisions)
+            dgraph.resolve()
+            return len(dgraph.value_nodes)
+        # ---
+
+        run_step("depgraph_resolve", step_depgraph_resolve)
+
+        if args.check_split:
+            split_check = check_depgraph_split(
+                depgraph, default_config, decisions
+            )
+    # --
+
+    lkconfig.set_profiling(False)
+
+    results = {
+        "kernelversion": str(kinfo.kernelversion),
+        "karch": kinfo.karch,
+        "num_symbols": len(kconfig_symbols),
+        "steps": {s.name: s.get_result() for s in steps},
+        "peak_rss_kib": get_peak_rss_kib(),
+        "lkconfig_profile": lkc_profile,
+    }
+    if split_check is not None:
+        results["depgraph_split_check"] = split_check
+
+    return results
+# --- end of run_case (...) ---
+
+
+def check_depgraph_split(depgraph, default_config, decisions):
+    """Resolves the decisions with and without splitting decision levels
+    into independent groups, and compares the results.
+
+    @return:  dict with "ok" (results are equal) and both outcomes
+    @rtype:   C{dict}
+    """
+    def resolve_outcome(split):
+        dgraph = depgraph.ConfigGraph(
+            default_config,
+            {sym: set(values) for sym, values in decisions.items()}
+        )
+        dgraph.SPLIT_DECISION_LEVELS = split
+        try:
+            dgraph.resolve()
+        except (depgraph.ConfigResolveError, AssertionError) as err:
+            # the failing symbol depends on the order of the groups,
+            # compare the kind of error only
+            return {"error": type(err).__name__}
+
+        return {
+            "config": sorted(
+                (sym.name, str(value))
+                for sym, value in dgraph.iter_update_config()
+            ),
+            "decisions": sorted(
+                (sym.name, sorted(str(v) for v in values))
+                for sym, values in dgraph.decisions.items()
+            ),
+        }
+    # ---
+
+    split_outcome = resolve_outcome(True)
+    unsplit_outcome = resolve_outcome(False)
+    return {
+        "ok": split_outcome == unsplit_outcome,
+        "split": split_outcome,
+        "unsplit": unsplit_outcome,
+    }
+# --- end of check_depgraph_split (...) ---
+
+
+def parse_case_arg(arg):
+    """Splits a <srctree>[:<arch>[,<arch>...]] arg.
+
+    @return:  list of 2-tuples (srctree, arch or None)
+    @rtype:   C{list} of 2-tuple (C{str}, C{str}|C{None})
+    """
+    srctree, sep, archs = arg.partition(":")
+    srctree = os.path.abspath(srctree)
+    if not archs:
+        return [(srctree, None)]
+    return [(srctree, arch) for arch in archs.split(",") if arch]
+# --- end of parse_case_arg (...) ---
+
+
+def get_arg_parser():
+    parser = argparse.ArgumentParser(
+        description="benchmark the Kconfig import and resolve pipeline"
+    )
+
+    parser.add_argument(
+        "cases", metavar="<srctree>[:<arch>[,<arch>...]]", nargs="*",
+        help="kernel source tree(s) and target architecture(s)"
+    )
+    parser.add_argument(
+        "-o", "--outfile", default=None,
+        help="write JSON results to <outfile> instead of stdout"
+    )
+    parser.add_argument(
+        "-n", "--repeat", type=int, default=3,
+        help="number of runs per step (default: %(default)s)"
+    )
+    parser.add_argument(
+        "--decisions", type=int, default=50,
+        help=(
+            "number of random decisions for depgraph_resolve"
+            " (default: %(default)s)"
+        )
+    )
+    parser.add_argument(
+        "--seed", type=int, default=0,
+        help="seed for picking the decisions (default: %(default)s)"
+    )
+    parser.add_argument(
+        "--check-split", default=False, action="store_true",
+        help=(
+            "compare depgraph_resolve results with and without"
+            " splitting decision levels into independent groups"
+        )
+    )
+    parser.add_argument(
+        "--tracemalloc", default=False, action="store_true",
+        help="trace Python memory allocations (slow)"
+    )
+    parser.add_argument(
+        "--pym", default=None,
+        help=(
+            "directory containing the kernelconfig package,"
+            " defaults to the project root"
+        )
+    )
+
+    # internal: run a single case in this process
+    parser.add_argument("--run-case", nargs=2, help=argparse.SUPPRESS)
+
+    return parser
+# --- end of get_arg_parser (...) ---
+
+
+if __name__ == "__main__":
+    def main():
+        parser = get_arg_parser()
+        args = parser.parse_args()
+
+        pym_dir = args.pym or os.path.dirname(
+            os.path.dirname(os.path.abspath(__file__))
+        )
+
+        if args.run_case:
+            # add <pym> to sys.path, giving it the highest priority
+            sys.path[:0] = [pym_dir]
+            args.srctree, args.arch = args.run_case
+            args.arch = args.arch or None
+            json.dump(run_case(args), sys.stdout)
+            return
+        # --
+
+        if not args.cases:
+            parser.error("no kernel source trees specified")
+
+        cases = []
+        for case_arg in args.cases:
+            cases.extend(parse_case_arg(case_arg))
+
+        results = {
+            "format": RESULTS_FORMAT_VERSION,
+            "timestamp": time.time(),
+            "host": {
+                "machine": platform.machine(),
+                "python": platform.python_version(),
+                "cpu_count": os.cpu_count(),
+            },
+            "options": {
+                "repeat": args.repeat,
+                "decisions": args.decisions,
+                "seed": args.seed,
+                "tracemalloc": args.tracemalloc,
+                "check_split": args.check_split,
+            },
+            "cases": [],
+        }
+
+        for srctree, arch in cases:
+            sys.stderr.write(
+                "Benchmarking {} ({})\n".format(srctree, arch or "host arch")
+            )
+
+            cmdv = [
+                sys.executable, os.path.abspath(__file__),
+                "--pym", pym_dir,
+                "-n", str(args.repeat),
+                "--decisions", str(args.decisions),
+                "--seed", str(args.seed),
+                "--run-case", srctree, (arch or "")
+            ]
+            if args.tracemalloc:
+                cmdv.append("--tracemalloc")
+            if args.check_split:
+                cmdv.append("--check-split")
+
+            proc = subprocess.run(
+                cmdv, stdout=subprocess.PIPE, universal_newlines=True
+            )
+
+            case_result = {
+                "srctree": srctree,
+                "arch": arch,
+                "git_rev": get_git_rev(srctree),
+            }
+            if proc.returncode == 0:
+                case_result.update(json.loads(proc.stdout))
+                split_check = case_result.get("depgraph_split_check")
+                if split_check is not None and not split_check["ok"]:
+                    case_result["failed"] = "depgraph split check"
+            else:
+                case_result["failed"] = "exit code {}".format(proc.returncode)
+
+            results["cases"].append(case_result)
+        # --
+
+        if args.outfile:
+            outfile_dir = os.path.dirname(os.path.abspath(args.outfile))
+            os.makedirs(outfile_dir, exist_ok=True)
+            with open(args.outfile, "wt") as fh:
+                json.dump(results, fh, indent=2, sort_keys=True)
+                fh.write("\n")
+        else:
+            json.dump(results, sys.stdout, indent=2, sort_keys=True)
+            sys.stdout.write("\n")
+
+        if any(c.get("failed") for c in results["cases"]):
+            sys.exit(1)
+    # --- end of __main__ (...) ---
+
+    main()
+# -- end if __main__
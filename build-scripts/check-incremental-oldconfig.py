@@ -0,0 +1,283 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# This script compares lkconfig's incremental oldconfig mode
+# with the full mode on randomly generated Kconfig trees.
+#
+# Usage: check-incremental-oldconfig [-n <num trees>] [--seed <seed>]
+#                                    [--symbols <num>] [--pym <dir>]
+#
+# Each tree gets a random input config and a few random decisions dicts.
+# oldconfig() runs once per decisions dict, in both modes,
+# and each mode runs in a separate process,
+# so that lkc's global state is not shared between the modes.
+# The resulting .config files (or errors) must be identical.
+#
+# Exits with non-zero status if any tree gives different results,
+# the seeds of the failing trees are written to stdout.
+#
+import argparse
+import json
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+
+def gen_expr(rand, names, limit, depth=0):
+    """Creates a random dependency expression
+    that references the symbols names[0] .. names[limit - 1].
+    """
+    if limit == 0:
+        return "y"
+
+    if depth > 1 or rand.random() < 0.5:
+        name = names[rand.randrange(limit)]
+        return name if rand.random() < 0.8 else ("!" + name)
+
+    return "({} {} {})".format(
+        gen_expr(rand, names, limit, depth + 1),
+        rand.choice(("&&", "||")),
+        gen_expr(rand, names, limit, depth + 1)
+    )
+# --- end of gen_expr (...) ---
+
+
+def gen_kconfig(rand, num_symbols):
+    """Creates a random Kconfig file with bool and tristate symbols,
+    choices, defaults, selects and conditional prompts.
+
+    @return:  2-tuple (Kconfig text, symbol names)
+    @rtype:   2-tuple (C{str}, C{list} of C{str})
+    """
+    names = ["S{:d}".format(k) for k in range(num_symbols)]
+    lines = [
+        "config MODULES", "\tbool \"modules\"",
+        "\toption modules", "\tdefault y"
+    ]
+
+    choice_remaining = 0
+    for k, name in enumerate(names):
+        if choice_remaining:
+            lines.extend(["config " + name, "\tbool \"{}\"".format(name)])
+            choice_remaining -= 1
+            if not choice_remaining:
+                lines.append("endchoice")
+            continue
+
+        if k > 3 and rand.random() < 0.08:
+            lines.extend(["choice", "\tprompt \"choice {}\"".format(name)])
+            if rand.random() < 0.5:
+                lines.append("\tdepends on " + gen_expr(rand, names, k))
+            lines.extend(["config " + name, "\tbool \"{}\"".format(name)])
+            choice_remaining = 3
+            continue
+
+        stype = rand.choice(("bool", "tristate"))
+        lines.append("config " + name)
+        if rand.random() < 0.8:
+            cond = ""
+            if rand.random() < 0.2:
+                cond = " if " + gen_expr(rand, names, k)
+            lines.append("\t{} \"{}\"{}".format(stype, name, cond))
+        else:
+            lines.append("\t" + stype)
+
+        if rand.random() < 0.5:
+            lines.append("\tdepends on " + gen_expr(rand, names, k))
+
+        for _ in range(rand.randrange(3)):
+            value = rand.choice(
+                ("y", "m", "n", (names[rand.randrange(k)] if k else "y"))
+            )
+            cond = ""
+            if rand.random() < 0.5:
+                cond = " if " + gen_expr(rand, names, k)
+            lines.append("\tdefault {}{}".format(value, cond))
+
+        if rand.random() < 0.5 and k + 1 < num_symbols:
+            cond = ""
+            if rand.random() < 0.3:
+                cond = " if " + gen_expr(rand, names, k)
+            lines.append(
+                "\tselect {}{}".format(
+                    names[rand.randrange(k + 1, num_symbols)], cond
+                )
+            )
+    # --
+
+    if choice_remaining:
+        lines.append("endchoice")
+
+    return ("\n".join(lines) + "\n", names)
+# --- end of gen_kconfig (...) ---
+
+
+def gen_case(rand, num_symbols, num_decisions):
+    """Creates a random Kconfig file, input config and decisions dicts.
+
+    @return:  3-tuple (Kconfig text, .config text, list of decisions dicts)
+    @rtype:   3-tuple (C{str}, C{str}, C{list} of C{dict})
+    """
+    kconfig_text, names = gen_kconfig(rand, num_symbols)
+
+    config_lines = []
+    for name in names:
+        value = rand.choice(("y", "m", "n", None))
+        if value == "n":
+            config_lines.append("# CONFIG_{} is not set".format(name))
+        elif value is not None:
+            config_lines.append("CONFIG_{}={}".format(name, value))
+
+    decisions_list = [
+        {
+            name: rand.choice((0, 1, 2))
+            for name in rand.sample(names, rand.randrange(1, 6))
+        }
+        for _ in range(num_decisions)
+    ]
+
+    return (kconfig_text, "\n".join(config_lines) + "\n", decisions_list)
+# --- end of gen_case (...) ---
+
+
+def run_tree(tree_dir, incremental):
+    """Runs oldconfig for all decisions dicts of a tree in this process.
+
+    @return:  list of .config texts or error strings, one per decisions dict
+    @rtype:   C{list} of C{str}
+    """
+    # imports are deferred until --pym has been added to sys.path
+    from kernelconfig.kconfig import lkconfig
+
+    os.environ["srctree"] = tree_dir
+
+    with open(os.path.join(tree_dir, "decisions.json"), "rt") as fh:
+        decisions_list = json.load(fh)
+
+    lkconfig.read_symbols(os.path.join(tree_dir, "Kconfig"))
+
+    infile = os.path.join(tree_dir, "config.in")
+    outfile = os.path.join(tree_dir, "config.out")
+
+    outcomes = []
+    for decisions in decisions_list:
+        try:
+            lkconfig.oldconfig(
+                infile, outfile, decisions, incremental=incremental
+            )
+        except (ValueError, RuntimeError) as err:
+            outcomes.append("error: {}: {}".format(type(err).__name__, err))
+        else:
+            with open(outfile, "rt") as fh:
+                outcomes.append(fh.read())
+    # --
+
+    return outcomes
+# --- end of run_tree (...) ---
+
+
+def get_arg_parser():
+    parser = argparse.ArgumentParser(
+        description="compare incremental oldconfig with the full mode"
+    )
+
+    parser.add_argument(
+        "-n", "--trees", type=int, default=1000,
+        help="number of random trees (default: %(default)s)"
+    )
+    parser.add_argument(
+        "--seed", type=int, default=0,
+        help="seed of the first tree (default: %(default)s)"
+    )
+    parser.add_argument(
+        "--symbols", type=int, default=40,
+        help="number of symbols per tree (default: %(default)s)"
+    )
+    parser.add_argument(
+        "--decisions", type=int, default=8,
+        help="number of decisions dicts per tree (default: %(default)s)"
+    )
+    parser.add_argument(
+        "--pym", default=None,
+        help=(
+            "directory containing the kernelconfig package,"
+            " defaults to the project root"
+        )
+    )
+
+    # internal: run a single tree in this process
+    parser.add_argument("--run-tree", nargs=2, help=argparse.SUPPRESS)
+
+    return parser
+# --- end of get_arg_parser (...) ---
+
+
+if __name__ == "__main__":
+    def main():
+        parser = get_arg_parser()
+        args = parser.parse_args()
+
+        pym_dir = args.pym or os.path.dirname(
+            os.path.dirname(os.path.abspath(__file__))
+        )
+
+        if args.run_tree:
+            # add <pym> to sys.path, giving it the highest priority
+            sys.path[:0] = [pym_dir]
+            tree_dir, mode = args.run_tree
+            json.dump(run_tree(tree_dir, mode == "incremental"), sys.stdout)
+            return
+        # --
+
+        def run_mode(tree_dir, mode):
+            proc = subprocess.run(
+                [
+                    sys.executable, os.path.abspath(__file__),
+                    "--pym", pym_dir, "--run-tree", tree_dir, mode
+                ],
+                stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                universal_newlines=True
+            )
+            if proc.returncode != 0:
+                return "exit code {}".format(proc.returncode)
+            return json.loads(proc.stdout)
+        # ---
+
+        failed = []
+        for seed in range(args.seed, args.seed + args.trees):
+            rand = random.Random(seed)
+            kconfig_text, config_text, decisions_list = gen_case(
+                rand, args.symbols, args.decisions
+            )
+
+            with tempfile.TemporaryDirectory(
+                prefix="kernelconfig-incr-"
+            ) as tree_dir:
+                for name, text in (
+                    ("Kconfig", kconfig_text),
+                    ("config.in", config_text),
+                    ("decisions.json", json.dumps(decisions_list)),
+                ):
+                    with open(os.path.join(tree_dir, name), "wt") as fh:
+                        fh.write(text)
+
+                full_outcome = run_mode(tree_dir, "full")
+                incr_outcome = run_mode(tree_dir, "incremental")
+            # --
+
+            if full_outcome != incr_outcome:
+                failed.append(seed)
+                sys.stdout.write("{:d}\n".format(seed))
+        # --
+
+        sys.stderr.write(
+            "{:d} of {:d} trees differ\n".format(len(failed), args.trees)
+        )
+        if failed:
+            sys.exit(1)
+    # --- end of __main__ (...) ---
+
+    main()
+# -- end if __main__
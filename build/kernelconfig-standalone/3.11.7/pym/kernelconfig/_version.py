@@ -0,0 +1,4 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+version = "1.0_alpha1"
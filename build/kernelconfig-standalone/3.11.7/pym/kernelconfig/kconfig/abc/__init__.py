@@ -0,0 +1,4 @@
+# kernelconfig -- abstract description of Kconfig-related classes
+# -*- coding: utf-8 -*-
+
+__all__ = []
@@ -0,0 +1,215 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import abc
+
+from ...abc import informed
+from ...lang import cmdcache
+from ...lang import interpreter
+
+from .. import symbolgen
+from .. import symtabcache
+
+from . import data
+from . import choices
+from . import choicemodules
+
+
+__all__ = ["KernelConfigGenerator"]
+
+
+def _lazy_constructor(attr_name, attr_constructor_name=None):
+    if attr_constructor_name is None:
+        attr_constructor_name = "_create_" + attr_name.lstrip("_")
+
+    def wrapper(self):
+        attr = getattr(self, attr_name)
+        if attr is None:
+            attr = getattr(self, attr_constructor_name)()
+            setattr(self, attr_name, attr)
+        return attr
+    # ---
+
+    return wrapper
+# ---
+
+
+class AbstractConfigGenerator(informed.AbstractInformed):
+
+    @abc.abstractmethod
+    def get_kconfig_symbols(self):
+        raise NotImplementedError()
+
+    @abc.abstractmethod
+    def get_config(self):
+        raise NotImplementedError()
+
+    @abc.abstractmethod
+    def get_config_choices(self):
+        raise NotImplementedError()
+
+    @abc.abstractmethod
+    def get_config_choices_interpreter(self):
+        raise NotImplementedError()
+
+    @abc.abstractmethod
+    def commit(self):
+        raise NotImplementedError()
+
+# --- end of AbstractConfigGenerator ---
+
+
+class _ConfigGenerator(AbstractConfigGenerator):
+
+    def __init__(
+        self, install_info, source_info, kconfig_symbols=None, **kwargs
+    ):
+        """Constructor.
+
+        @param   install_info:
+        @param   source_info:
+        @keyword kconfig_symbols:  already loaded Kconfig symbols of
+                                   source_info, which may be shared with
+                                   other generators, or None.
+                                   Defaults to None.
+        @type    kconfig_symbols:  L{KconfigSymbols} or C{None}
+        """
+        # super().__init__() is kw-only
+        super().__init__(
+            install_info=install_info, source_info=source_info, **kwargs
+        )
+
+        # take over ownership of source_info
+        self.source_info.set_logger(parent_logger=self.logger)
+
+        self._kconfig_symbols = kconfig_symbols
+        self._config = None
+        self._config_choices = None
+        self._config_choices_interpreter = None
+    # --- end of __init__ (...) ---
+
+    def _create_symtab_cache(self):
+        try:
+            cache_dir = self.install_info.get_cache_dirs("kconfig").get_path()
+        except StopIteration:
+            # no cache dir configured
+            return None
+
+        return self.create_source_informed(
+            symtabcache.SymbolTableCache, cache_dir
+        )
+    # --- end of _create_symtab_cache (...) ---
+
+    def _create_cmd_cache(self):
+        try:
+            cache_dir = self.install_info.get_cache_dirs("lang").get_path()
+        except StopIteration:
+            # no cache dir configured, cache command lists in memory
+            cache_dir = None
+
+        return self.create_loggable(cmdcache.KernelConfigLangCache, cache_dir)
+    # --- end of _create_cmd_cache (...) ---
+
+    def _create_symbol_binder(self):
+        return cmdcache.KconfigSymbolBinder(
+            self.get_kconfig_symbols(), self.get_config_choices().get_symbol
+        )
+    # --- end of _create_symbol_binder (...) ---
+
+    def _create_kconfig_symbols(self):
+        self.source_info.prepare()
+        symgen = self.create_source_informed(
+            symbolgen.KconfigSymbolGenerator,
+            symtab_cache=self._create_symtab_cache()
+        )
+        return symgen.get_symbols()
+
+    def _create_config(self):
+        return self.create_loggable(
+            data.KernelConfig, self.get_kconfig_symbols()
+        )
+
+    def _create_config_choices(self):
+        return self.create_loggable(
+            choices.ConfigChoices, self.get_config()
+        )
+
+    @abc.abstractmethod
+    def _create_config_choices_interpreter(self):
+        raise NotImplementedError()
+
+    get_kconfig_symbols = _lazy_constructor("_kconfig_symbols")
+    get_config = _lazy_constructor("_config")
+    get_config_choices = _lazy_constructor("_config_choices")
+    get_config_choices_interpreter = \
+        _lazy_constructor("_config_choices_interpreter")
+
+    def get_config_choice_modules(self):
+        return None
+
+    def commit(self):
+        if self._config_choices is None:
+            return True
+
+        elif self._config_choices.commit():
+            self._config_choices = None
+            return True
+
+        else:
+            return False
+    # --- end of commit (...) ---
+
+# --- end of _ConfigGenerator ---
+
+
+class KernelConfigGenerator(_ConfigGenerator):
+
+    def __init__(
+        self, install_info, source_info, modules_dir=True, hwdetector=None,
+        **kwargs
+    ):
+        super().__init__(
+            install_info=install_info, source_info=source_info, **kwargs
+        )
+
+        self._config_choice_modules = self.create_informed(
+            choicemodules.KernelConfigChoiceModules,
+            modules_dir=modules_dir, hwdetector=hwdetector
+        )
+    # --- end of __init__ (...) ---
+
+    def get_config_choice_modules(self):
+        return self._config_choice_modules
+
+    def get_modules_map(self):
+        # FIXME: remove
+        return self.get_hwdetector().get_modules_map()
+    # --- end of get_modules_map (...) ---
+
+    def get_modalias_map(self):
+        # FIXME: remove
+        return self.get_hwdetector().get_modalias_map()
+    # --- end of get_modalias_map (...) ---
+
+    def get_hwdetector(self):
+        return self.get_config_choice_modules()["hwdetector"]
+    # --- end of get_hwdetector (...) ---
+
+    def get_pm_suggestions(self):
+        # FIXME: method name implies to return suggestions,
+        #        but the returned object is a choice module
+        return self.get_config_choice_modules()["pm"]
+    # --- end of get_pm_suggestions (...) ---
+
+    def _create_config_choices_interpreter(self):
+        return self.create_loggable(
+            interpreter.KernelConfigLangInterpreter,
+            self.install_info,
+            self.source_info,
+            self.get_config_choices(),
+            self.get_config_choice_modules(),
+            cmd_cache=self._create_cmd_cache(),
+            symbol_binder=self._create_symbol_binder()
+        )
+
+# --- end of KernelConfigGenerator ---
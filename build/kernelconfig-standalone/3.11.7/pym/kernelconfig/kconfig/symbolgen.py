@@ -0,0 +1,779 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import logging
+
+from ..abc import loggable
+from ..abc import informed
+from . import symbol
+from . import symbols
+from . import symbolexpr
+from . import lkconfig  # pylint: disable=E0611
+
+__all__ = ["KconfigSymbolGenerator"]
+
+
+class KconfigSymbolExpressionBuilder(loggable.AbstractLoggable):
+    """Converts 'C' struct expr/ExprView objects to 'Python' Expr objects."""
+
+    SYM_CMP_CLS_MAP = {
+        lkconfig.ExprView.E_EQUAL: symbolexpr.Expr_SymbolEQ,
+        lkconfig.ExprView.E_UNEQUAL: symbolexpr.Expr_SymbolNEQ,
+        lkconfig.ExprView.E_LTH: symbolexpr.Expr_SymbolLTH,
+        lkconfig.ExprView.E_LEQ: symbolexpr.Expr_SymbolLEQ,
+        lkconfig.ExprView.E_GTH: symbolexpr.Expr_SymbolGTH,
+        lkconfig.ExprView.E_GEQ: symbolexpr.Expr_SymbolGEQ,
+    }
+
+    def _gen_createv(self, top_expr_views):
+        _create = self.create
+
+        for top_expr_view in top_expr_views:
+            expr = _create(top_expr_view)
+            if expr is not None:
+                yield expr
+        # --
+    # ---
+
+    def createv(self, top_expr_views):
+        return list(self._gen_createv(top_expr_views))
+
+    def _createv_junction(self, junction_cls, one_expr_cls, component_views):
+        return self._join_junction(
+            junction_cls, one_expr_cls, self._gen_createv(component_views)
+        )
+    # --- end of _createv_junction (...) ---
+
+    def _join_junction(self, junction_cls, one_expr_cls, expr_iter):
+        try:
+            first_expr = next(expr_iter)
+        except StopIteration:
+            # no expr
+            return None
+
+        try:
+            next_expr = next(expr_iter)
+        except StopIteration:
+            # one expr
+            if one_expr_cls is None:
+                return first_expr
+            else:
+                return one_expr_cls(first_expr)
+
+        junction_expr = junction_cls(first_expr, next_expr)
+        # add remaining exprs
+        junction_expr.extend_expr(expr_iter)
+        return junction_expr
+    # --- end of _join_junction (...) ---
+
+    def createv_and(self, component_views):
+        return self._createv_junction(
+            symbolexpr.Expr_And, None, component_views
+        )
+    # ---
+
+    def createv_or(self, component_views):
+        return self._createv_junction(
+            symbolexpr.Expr_Or, None, component_views
+        )
+    # ---
+
+    def create_symbol_exprs(
+        self, expr_pool, symbol_names, symbol_name_map, constants
+    ):
+        """Converts the symbol names referenced by expressions
+        to symbol or constant expressions.
+
+        A name is first looked up in constants (resulting in a
+        Expr_Constant object), and then in symbol_name_map (Expr_Symbol).
+        Meta symbols (no name) are converted to constant "n".
+
+        @param expr_pool:        expression pool
+        @type  expr_pool:        L{ExprPool}
+        @param symbol_names:     symbol names
+        @type  symbol_names:     iterable of C{str} or C{None}
+        @param symbol_name_map:  symbol name to symbol map
+        @type  symbol_name_map:  C{dict}-like :: C{str} => _
+        @param constants:        symbol name to constant,hashable value map
+        @type  constants:        C{dict} :: C{str} => a, a.__hash__ != None
+
+        @return: 2-tuple (list of expressions, set of missing symbol names),
+                 names that could not be resolved are kept as
+                 Expr_SymbolName objects
+        @rtype:  2-tuple (C{list} of subclass of L{Expr}, C{set} of C{str})
+        """
+        const_false = expr_pool.get_constant(
+            symbol.TristateKconfigSymbolValue.n
+        )
+
+        symbol_names_missing = set()
+        sym_exprs = []
+
+        for name in symbol_names:
+            if not name:
+                sym_expr = const_false
+
+            elif name in constants:
+                sym_expr = expr_pool.get_constant(constants[name])
+
+            else:
+                sym = symbol_name_map.get(name)
+                if sym is None:
+                    symbol_names_missing.add(name)
+                    sym_expr = expr_pool.get_symbol_name(name)
+                else:
+                    sym_expr = expr_pool.get_symbol(sym)
+            # --
+
+            sym_exprs.append(sym_expr)
+        # --
+
+        return (sym_exprs, symbol_names_missing)
+    # --- end of create_symbol_exprs (...) ---
+
+    def create_nodes(self, expr_pool, symtab, sym_exprs):
+        """Converts the flat expression node table of a symbol table
+        to pooled Expr objects, in one linear pass.
+
+        The node table is in topological order,
+        so the operands of a node have already been converted
+        when reaching the node.
+        Shared subexpressions get converted only once
+        and are referenced by all parent expressions.
+
+        Note: the created expressions are not normalized,
+              see create_from_node().
+
+        @param expr_pool:  expression pool
+        @type  expr_pool:  L{ExprPool}
+        @param symtab:     symbol table
+        @type  symtab:     L{SymbolTable}
+        @param sym_exprs:  expressions for symtab.expr_symbol_names,
+                           see create_symbol_exprs()
+        @type  sym_exprs:  C{list} of subclass of L{Expr}
+
+        @return: list of expressions, indexed by node
+        @rtype:  C{list} of subclass of L{Expr}
+        """
+        E_OR = lkconfig.ExprView.E_OR
+        E_AND = lkconfig.ExprView.E_AND
+        E_NOT = lkconfig.ExprView.E_NOT
+        E_SYMBOL = lkconfig.ExprView.E_SYMBOL
+        sym_cmp_cls_map = self.SYM_CMP_CLS_MAP
+
+        const_false = expr_pool.get_constant(
+            symbol.TristateKconfigSymbolValue.n
+        )
+
+        nodes = []
+        for etype, lidx, ridx, sidx in zip(
+            memoryview(symtab.expr_types).cast("i"),
+            memoryview(symtab.expr_lefts).cast("i"),
+            memoryview(symtab.expr_rights).cast("i"),
+            memoryview(symtab.expr_syms).cast("i")
+        ):
+            if etype == E_SYMBOL:
+                expr = sym_exprs[sidx] if sidx >= 0 else const_false
+
+            elif etype == E_OR:
+                expr = expr_pool.get_or((nodes[lidx], nodes[ridx]))
+
+            elif etype == E_AND:
+                expr = expr_pool.get_and((nodes[lidx], nodes[ridx]))
+
+            elif etype == E_NOT:
+                expr = expr_pool.get_not(nodes[lidx])
+
+            else:
+                try:
+                    sym_cmp_cls = sym_cmp_cls_map[etype]
+                except KeyError:
+                    raise NotImplementedError(etype) from None
+
+                expr = expr_pool.get_cmp(
+                    sym_cmp_cls, nodes[lidx], nodes[ridx]
+                )
+            # --
+
+            nodes.append(expr)
+        # --
+
+        return nodes
+    # --- end of create_nodes (...) ---
+
+    def create_from_node(self, expr_pool, nodes, node_idx):
+        """Returns the normalized top-level expression for a node index.
+
+        @param expr_pool: expression pool
+        @type  expr_pool: L{ExprPool}
+        @param nodes:     expressions, see create_nodes()
+        @type  nodes:     C{list} of subclass of L{Expr}
+        @param node_idx:  node index, negative values mean "no expression"
+        @type  node_idx:  C{int}
+
+        @return: expr or None
+        @rtype:  subclass of L{Expr} or C{None}
+        """
+        if node_idx < 0:
+            return None
+        else:
+            return expr_pool.normalize(nodes[node_idx])
+    # --- end of create_from_node (...) ---
+
+    def create(self, top_expr_view):
+        """Recursively converts an ExprView to an Expr.
+
+        @param top_expr_view:  struct expr view object
+        @type  top_expr_view:  L{ExprView}
+
+        @return: expr
+        @rtype:  subclass of L{Expr}
+        """
+        sym_cmp_cls_map = self.SYM_CMP_CLS_MAP
+
+        const_false = symbolexpr.Expr_Constant.get_instance(
+            symbol.TristateKconfigSymbolValue.n
+        )
+
+        def expand_expr(eview):
+            """Recursively expands/converts an ExprView.
+
+            Recursive: expand_expr -> _
+            """
+            nonlocal sym_cmp_cls_map
+            nonlocal const_false
+
+            def expand_sym(sym):
+                """Expands a E_SYMBOL-type ExprView.
+
+                Non-recursive.
+
+                @param sym:  symbol view object
+                @type  sym:  L{SymbolView}
+
+                @rtype: L{Expr_Symbol}
+                """
+                nonlocal const_false
+
+                if not sym.name:
+                    # meta symbols
+                    return const_false
+                else:
+                    return symbolexpr.Expr_SymbolName(sym.name)
+            # ---
+
+            def expand_sym_cmp(sym_cmp_cls, lsym, rsym):
+                """Expands a E_EQUAL/E_UNEQUAL-type ExprView.
+
+                Non-recursive.
+
+                @param sym_cmp_cls:  Expr class
+                @type  sym_cmp_cls:  subclass of L{_Expr_SymbolValueComparison}
+                @param lsym:         symbol view object (left operand)
+                @type  lsym:         L{SymbolView}
+                @param rsym:         symbol view object (right operand)
+                @type  rsym:         L{SymbolView}
+
+                @return:  Expr
+                @rtype:   sym_cmp_cls
+                """
+                return sym_cmp_cls(expand_sym(lsym), expand_sym(rsym))
+            # ---
+
+            def expand_expr_or_sym(subeview, sym):
+                """Recursively expands a symbol or ExprView,
+                depending on which param is not None.
+
+                Recursive: expand_expr_or_sym -> expand_expr -> _
+
+                Note: exactly one out of the two parameters {subeview,sym}
+                      must be None.
+                      This is guaranteed by how SymbolView.get_expr() works.
+
+                @param subeview:  expr view object, may be None
+                @type  subeview:  L{ExprView} or C{None}
+                @param sym:       symbol view object, may be None
+                @type  sym:       L{SymbolView} or C{None}
+
+                @return: expanded expression
+                @rtype:  subclass of L{Expr}
+                """
+                if sym is not None:
+                    assert subeview is None
+                    return expand_sym(sym)
+                elif subeview is not None:
+                    return expand_expr(subeview)
+                else:
+                    raise AssertionError()
+            # ---
+
+            if eview is None:
+                raise AssertionError()
+            # --
+
+            etype, lexpr, lsym, rexpr, rsym = eview.get_expr()
+
+            if etype == eview.E_OR:
+                expr = symbolexpr.Expr_Or()
+                expr.add_expr(expand_expr_or_sym(lexpr, lsym))
+                expr.add_expr(expand_expr_or_sym(rexpr, rsym))
+
+            elif etype == eview.E_AND:
+                expr = symbolexpr.Expr_And()
+                expr.add_expr(expand_expr_or_sym(lexpr, lsym))
+                expr.add_expr(expand_expr_or_sym(rexpr, rsym))
+
+            elif etype == eview.E_NOT:
+                expr = symbolexpr.Expr_Not(expand_expr_or_sym(lexpr, lsym))
+
+            elif etype == eview.E_SYMBOL:
+                expr = expand_sym(lsym)
+
+            else:
+                try:
+                    sym_cmp_cls = sym_cmp_cls_map[etype]
+                except KeyError:
+                    raise NotImplementedError(etype) from None
+
+                expr = expand_sym_cmp(sym_cmp_cls, lsym, rsym)
+            # --
+
+            # Note: "return expr.simplify()" would hide missing symbols
+            return expr
+        # ---
+
+        if top_expr_view is None:
+            return None
+        elif top_expr_view.e_type == top_expr_view.E_NONE:
+            return None
+        else:
+            return expand_expr(top_expr_view).move_negation_inwards()
+    # ---
+# ---
+
+
+class KconfigSymbolGenerator(informed.AbstractSourceInformed):
+    """Creates kconfig symbols using the kconfig parser
+    from the linux kernel sources.
+
+    Use KconfigSymbolGenerator(source_info).get_symbols()
+    to read kconfig symbols from a Kconfig file
+    and create a KconfigSymbols instance.
+
+    Note: due to how the lkc parser processes Kconfig files,
+          some environment variables need to be modified,
+          namely srctree, ARCH, SRCARCH and KERNELVERSION.
+
+
+    @cvar SYMBOL_TYPE_TO_CLS_MAP:  mapping from lkc symbol type to symbol class
+    @type SYMBOL_TYPE_TO_CLS_MAP:  C{dict} :: C{int} => C{type}|C{None}
+
+    @ivar source_info:  object that provides some information about the
+                        kconfig structure being parsed
+    @type source_info:  subclass of L{SourceInfo}
+
+    @ivar symtab_cache: symbol table cache, may be None
+    @type symtab_cache: L{SymbolTableCache} or C{None}
+
+    @ivar lkc_context:  lkc parser state of the kconfig structure,
+                        created on demand
+    @type lkc_context:  L{lkconfig.Context} or C{None}
+
+    @ivar _symbols:     kconfig symbols data structure
+    @type _symbols:     L{KconfigSymbols}
+    @ivar _dir_deps:    a symbol -> dir_dep expression node index mapping,
+                        used for linking symbols to Expr objects
+    @type _dir_deps:    C{dict} :: L{AbstractKconfigSymbol} => C{int}
+    @ivar _vis_deps:    a symbol -> prompt vis_dep node indices mapping
+    @type _vis_deps:    C{dict} :: L{AbstractKconfigSymbol}
+                                => C{list} of C{int}
+    @ivar _def_deps:    a symbol -> intermediate symbol defaults mapping
+                        "intermediate symbol defaults" are
+                        2-tuples (dir_dep, vis_dep) of node indices.
+                        They are converted to L{KconfigSymbolDefault} objects
+                        during the "link deps" phase.
+    @type _def_deps:    C{dict} :: L{AbstractKconfigSymbol}
+                                => C{list} of 2-tuple <C{int}>
+    """
+
+    SYMBOL_TYPE_TO_CLS_MAP = {
+        lkconfig.S_TRISTATE:    symbol.TristateKconfigSymbol,
+        lkconfig.S_BOOLEAN:     symbol.BooleanKconfigSymbol,
+        lkconfig.S_STRING:      symbol.StringKconfigSymbol,
+        lkconfig.S_INT:         symbol.IntKconfigSymbol,
+        lkconfig.S_HEX:         symbol.HexKconfigSymbol,
+        lkconfig.S_OTHER:       None
+    }
+
+    @classmethod
+    def get_default_symbol_constants(cls):
+        return {
+            "n": symbol.TristateKconfigSymbolValue.n,
+            "m": symbol.TristateKconfigSymbolValue.m,
+            "y": symbol.TristateKconfigSymbolValue.y,
+            "0": 0,
+            "1": 1
+        }
+    # --- end of get_default_symbol_constants (...) ---
+
+    def __init__(self, source_info, symtab_cache=None, **kwargs):
+        super().__init__(source_info=source_info, **kwargs)
+        self.symtab_cache = symtab_cache
+        self.lkc_context = None
+        self._symbols = symbols.KconfigSymbols()
+        self._dir_deps = {}
+        self._vis_deps = {}
+        self._def_deps = {}
+    # --- end of __init__ (...) ---
+
+    def read_lkc_symbols(self):
+        """Makes the lkc context of this generator the active one,
+        and instructs the lkc parser to read kconfig symbols
+        if that has not been done yet for this context.
+
+        The context stays active only as long as the caller
+        holds symbols.lkc_session_lock, see KconfigSymbols.lkc_session().
+
+        @return: None (implicit)
+        """
+        with symbols.lkc_session_lock:
+            lkc_context = self.lkc_context
+            if lkc_context is None:
+                lkc_context = lkconfig.Context()
+                self.lkc_context = lkc_context
+
+            lkconfig.switch_context(lkc_context)
+
+            if not lkc_context.have_symbols:
+                # the environment may have been set up
+                # for another source tree in the meantime
+                self.source_info.setenv()
+                self._read_lkc_symbols()
+    # --- end of read_lkc_symbols (...) ---
+
+    def get_lkc_symbols(self):
+        """Gets SymbolView objects from the lkc parser.
+
+        @return: list of symbol view objects
+        @rtype:  list of L{SymbolView}
+        """
+        with symbols.lkc_session_lock:
+            self.read_lkc_symbols()
+            return self._get_lkc_symbols()
+    # --- end of get_lkc_symbols (...) ---
+
+    def get_lkc_symbol_table(self):
+        """Gets the packed symbol table from the lkc parser.
+
+        @return: symbol table
+        @rtype:  L{SymbolTable}
+        """
+        with symbols.lkc_session_lock:
+            self.read_lkc_symbols()
+            return self._get_lkc_symbol_table()
+    # --- end of get_lkc_symbol_table (...) ---
+
+    def get_symbol_table(self):
+        """Gets the packed symbol table,
+        either from the symbol table cache or from the lkc parser.
+
+        Writes the symbol table to the cache after parsing Kconfig files.
+        Note that lkc does not know about the symbols
+        if they have been read from the cache.
+
+        @return: symbol table
+        @rtype:  L{SymbolTable} or L{CachedSymbolTable}
+        """
+        symtab_cache = self.symtab_cache
+
+        if symtab_cache is not None:
+            symtab = symtab_cache.load()
+            if symtab is not None:
+                return symtab
+        # --
+
+        with symbols.lkc_session_lock:
+            symtab = self.get_lkc_symbol_table()
+
+            if symtab_cache is not None:
+                symtab_cache.store(symtab, lkconfig.get_kconfig_deps())
+
+        return symtab
+    # --- end of get_symbol_table (...) ---
+
+    def constify_missing_symbol(self, name):
+        """Converts the name of a missing symbol into a constant value.
+
+        First, checks if the name is already a value and, if so,
+        returns that value.
+
+        Otherwise, defaults to symbol to tristate "n".
+
+        @param name:  name of the missing symbol
+        @type  name:  C{str}
+        @return:      hashable value
+        @rtype:       L{symbol.TristateKconfigSymbolValue} | C{int}
+        """
+        try:
+            value_type, value = symbol.unpack_value_str(name)
+        except ValueError:
+            return symbol.TristateKconfigSymbolValue.n
+
+        if value_type == symbol.KconfigSymbolValueType.v_unknown:
+            # this cannot happen,
+            # unpack_value_str() should have raised a ValueError
+            raise AssertionError()
+
+        elif value_type == symbol.KconfigSymbolValueType.v_string:
+            # unpack_value_str() is strict when determing a string value type,
+            # but don't allow string comparisons for now
+            self.logger.warning(
+                "string comparisons are not allowed: %r", value
+            )
+            return symbol.TristateKconfigSymbolValue.n
+        else:
+            return value
+    # --- end of constify_missing_symbol (...) ---
+
+    def _prepare_symbols(self):
+        """
+        Imports kconfig symbols from the lkc parser
+        and adds them to self._symbols.
+
+        Also collects the node indices of dependencies,
+        but does not "link" them to symbols,
+        which needs to be done after reading all symbols.
+
+        @return: symbol table
+        @rtype:  L{SymbolTable} or L{CachedSymbolTable}
+        """
+        get_symbol_cls = self.SYMBOL_TYPE_TO_CLS_MAP.__getitem__
+
+        kconfig_symbols = self._symbols
+        dir_deps = self._dir_deps
+        vis_deps = self._vis_deps
+        def_deps = self._def_deps
+
+        symtab = self.get_symbol_table()
+        s_types = memoryview(symtab.s_types).cast("i")
+        sym_dir_deps = memoryview(symtab.dir_deps).cast("i")
+        prompt_offsets = memoryview(symtab.prompt_offsets).cast("i")
+        prompt_counts = memoryview(symtab.prompt_counts).cast("i")
+        prompt_vis_deps = memoryview(symtab.prompt_vis_deps).cast("i")
+        default_offsets = memoryview(symtab.default_offsets).cast("i")
+        default_counts = memoryview(symtab.default_counts).cast("i")
+        default_dir_deps = memoryview(symtab.default_dir_deps).cast("i")
+        default_vis_deps = memoryview(symtab.default_vis_deps).cast("i")
+
+        # the symbol table row is also the lkc symbol index
+        for sym_idx, sym_name in enumerate(symtab.names):
+            if sym_name:
+                # do not create nameless symbols
+                sym = get_symbol_cls(s_types[sym_idx])(sym_name, index=sym_idx)
+
+                kconfig_symbols.add_symbol(sym)
+                dir_deps[sym] = sym_dir_deps[sym_idx]
+
+                prompt_offset = prompt_offsets[sym_idx]
+                vis_deps[sym] = prompt_vis_deps[
+                    prompt_offset:prompt_offset + prompt_counts[sym_idx]
+                ].tolist()
+
+                # get symbol defaults
+                #  keep dependency and visibility depepencies separate,
+                #  visibility does not contribute to the default value
+                #  except that it can limit a tristate "y" to "m" (and similar)
+                #
+                # spare the overhead if defaults
+                # are not supported for the symbol (type)
+                if sym.supports_defaults():
+                    default_offset = default_offsets[sym_idx]
+                    default_end = default_offset + default_counts[sym_idx]
+                    def_deps[sym] = list(zip(
+                        default_dir_deps[default_offset:default_end],
+                        default_vis_deps[default_offset:default_end]
+                    ))
+                # --
+            # --
+        # --
+
+        return symtab
+    # --- end of _prepare_symbols (...) ---
+
+    def _link_deps(self, symtab):
+        """
+        Links the dependencies of all symbols to symbols,
+        so that they can be evaluated.
+
+        The expressions are created in an expression pool,
+        so that each distinct (sub)expression gets created, normalized
+        and simplified only once and is shared by all symbols using it.
+
+        Reports missing symbol names via self.logger.
+
+        @param symtab:  symbol table, see _prepare_symbols()
+        @type  symtab:  L{SymbolTable} or L{CachedSymbolTable}
+        """
+        expr_builder = self.create_loggable(
+            KconfigSymbolExpressionBuilder, logger_name="ExpressionBuilder"
+        )
+        expr_pool = symbolexpr.ExprPool()
+
+        sym_constants = self.get_default_symbol_constants()
+
+        # resolve symbol names once, collect missing names
+        self.logger.debug("Expanding dependency expressions")
+        sym_exprs, symbol_names_missing = expr_builder.create_symbol_exprs(
+            expr_pool, symtab.expr_symbol_names, self._symbols, sym_constants
+        )
+
+        if symbol_names_missing:
+            self.logger.info(
+                "missing %d symbols, defaulting them.",
+                len(symbol_names_missing)
+            )
+
+            if self.logger.isEnabledFor(logging.DEBUG):
+                for name in sorted(symbol_names_missing):
+                    value = self.constify_missing_symbol(name)
+                    self.logger.debug(
+                        "Defaulting symbol %s to %s", name, value
+                    )
+                    sym_constants[name] = value
+                # --
+            else:
+                sym_constants.update((
+                    (name, self.constify_missing_symbol(name))
+                    for name in symbol_names_missing
+                ))
+            # -- end debug | nodebug
+
+            self.logger.debug("Expanding dependency expressions again")
+            sym_exprs, symbol_names_missing = (
+                expr_builder.create_symbol_exprs(
+                    expr_pool, symtab.expr_symbol_names,
+                    self._symbols, sym_constants
+                )
+            )
+            if symbol_names_missing:
+                raise AssertionError(
+                    "second expr expansion should not report missing symbols",
+                    symbol_names_missing
+                )
+            # --
+        # -- end if default missing and retry
+
+        expr_nodes = expr_builder.create_nodes(expr_pool, symtab, sym_exprs)
+
+        def create_expr(node_idx):
+            nonlocal expr_pool, expr_nodes
+            expr = expr_builder.create_from_node(
+                expr_pool, expr_nodes, node_idx
+            )
+            return None if expr is None else expr_pool.simplify(expr)
+        # ---
+
+        def create_exprv_or(node_indices):
+            nonlocal expr_pool, expr_nodes
+            exprv = [
+                expr_builder.create_from_node(expr_pool, expr_nodes, idx)
+                for idx in node_indices if idx >= 0
+            ]
+            if not exprv:
+                return None
+            elif len(exprv) == 1:
+                return expr_pool.simplify(exprv[0])
+            else:
+                return expr_pool.simplify(expr_pool.get_or(exprv))
+        # ---
+
+        # simplify and assign dir_dep to symbols
+        for sym, node_idx in self._dir_deps.items():
+            sym.dir_dep = create_expr(node_idx)
+
+        for sym, node_indices in self._vis_deps.items():
+            sym.vis_dep = create_exprv_or(node_indices)
+
+        for sym, def_node_indices in self._def_deps.items():
+            sym.defaults = None  # nop
+            if def_node_indices:
+                # construct KconfigSymbolDefault objects
+                #  FIXME: does it make sense to construct a default
+                #         if dir_dep is None?
+                #  FIXME: filter out constant "n"
+                defaultv = [
+                    symbol.KconfigSymbolDefault(
+                        dir_dep=dir_dep, vis_dep=vis_dep
+                    )
+                    for dir_dep, vis_dep in (
+                        (create_expr(dir_idx), create_expr(vis_idx))
+                        for dir_idx, vis_idx in def_node_indices
+                    )
+                    if (dir_dep is not None or vis_dep is not None)
+                ]
+
+                if defaultv:
+                    sym.defaults = defaultv
+                # -- end if set defaults?
+            # -- otherwise keep None
+        # --
+
+        self.logger.debug(
+            "Created %d distinct dependency expressions", len(expr_pool)
+        )
+    # --- end of _link_deps (...) ---
+
+    def get_symbols(self):
+        """
+        Imports Kconfig symbols, collects and expand dependencies,
+        and returns the result as KconfigSymbols object.
+
+        @return: kconfig symbols
+        @rtype:  L{KconfigSymbols}
+        """
+        # the expression caches of symbolexpr are module-global,
+        # and the symbol table cache compares the environment
+        # against its recorded values
+        with symbols.lkc_session_lock:
+            self.source_info.setenv()
+            symbolexpr.clear_cache()
+            try:
+                symtab = self._prepare_symbols()
+                self._link_deps(symtab)
+            finally:
+                self._dir_deps.clear()
+                self._vis_deps.clear()
+                self._def_deps.clear()
+                symbolexpr.clear_cache()
+        # --
+
+        # defer parsing until lkc is needed if symbols were read from cache
+        self._symbols.set_lkc_loader(self.read_lkc_symbols)
+        return self._symbols
+    # --- end of get_symbols (...) ---
+
+    def _read_lkc_symbols(self):
+        """Instructs the lkc parser to read kconfig symbols.
+        Unsafe, use read_lkc_symbols().
+        """
+        lkconfig.read_symbols(
+            self.source_info.get_toplevel_kconfig_filepath()
+        )
+    # --- end of _read_lkc_symbols (...) ---
+
+    def _get_lkc_symbols(self):
+        """Instructs the lkc parser to return a list of symbol view objects.
+        Does not make an attempt at reading the symbols, use get_lkc_symbols().
+        """
+        return lkconfig.get_symbols()
+    # --- end of _get_lkc_symbols (...) ---
+
+    def _get_lkc_symbol_table(self):
+        """Instructs the lkc parser to return the packed symbol table.
+        Does not make an attempt at reading the symbols,
+        use get_lkc_symbol_table().
+        """
+        return lkconfig.get_symbol_table()
+    # --- end of _get_lkc_symbol_table (...) ---
+
+# --- end of KconfigSymbolGenerator ---
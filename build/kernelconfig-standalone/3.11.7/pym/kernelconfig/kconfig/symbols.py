@@ -0,0 +1,160 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import contextlib
+import hashlib
+import threading
+
+from .abc import symbols as _symbols_abc
+
+__all__ = ["KconfigSymbols", "lkc_session_lock"]
+
+
+# lkc's active context and the symbol values of that context
+# are process-global, see KconfigSymbols.lkc_session()
+lkc_session_lock = threading.RLock()
+
+
+class KconfigSymbols(_symbols_abc.AbstractKconfigSymbols):
+
+    def __init__(self):
+        super().__init__()
+        self.name_map = {}  # this could be a weak-value weakref dict
+        # lkc symbol index => symbol or None, see AbstractKconfigSymbol.index
+        self.index_map = []
+        self._symbols = set()
+        self._lkc_loader = None
+        self._fingerprint = None
+
+    def set_lkc_loader(self, lkc_loader):
+        """Sets the function that makes the lkc parser read the symbols
+        if it has not done so yet, see prepare_lkc().
+
+        @param lkc_loader:  no-arg function or None
+        @type  lkc_loader:  callable or C{None}
+        """
+        self._lkc_loader = lkc_loader
+
+    def prepare_lkc(self):
+        """Makes sure that lkc knows about the symbols,
+        which is not the case if they have been loaded from a cache.
+
+        This needs to be called before using lkconfig functions
+        that operate on lkc's symbols, e.g. lkconfig.oldconfig().
+        """
+        if self._lkc_loader is not None:
+            self._lkc_loader()
+
+    @contextlib.contextmanager
+    def lkc_session(self):
+        """Context manager that makes lkc's symbols available
+        to the calling thread for the duration of the with-block,
+        see prepare_lkc().
+
+        Other threads cannot switch the lkc context or modify
+        lkc's symbol values until the block is left,
+        so a sequence of lkconfig function calls, e.g. loading values
+        with lkconfig.oldconfig_values() and then writing a defconfig,
+        needs to be run in one session.
+        Sessions may be nested.
+        """
+        with lkc_session_lock:
+            self.prepare_lkc()
+            yield
+    # --- end of lkc_session (...) ---
+
+    def normalize_symbol_name(self, sym_name):
+        return sym_name.upper()
+
+    def get_symbol(self, sym):
+        # check membership in _symbols
+        if sym in self._symbols:
+            return sym
+        else:
+            raise KeyError(sym)
+
+    def get_symbol_by_name(self, name):
+        return self.name_map[self.normalize_symbol_name(name)]
+
+    def get_symbol_by_index(self, index):
+        """Returns the symbol with the given lkc symbol index.
+
+        @raises KeyError: no such symbol
+
+        @param index:  symbol index
+        @type  index:  C{int}
+
+        @return:  symbol
+        """
+        try:
+            sym = self.index_map[index]
+        except IndexError:
+            sym = None
+
+        if sym is None:
+            raise KeyError(index)
+        return sym
+    # --- end of get_symbol_by_index (...) ---
+
+    def get_fingerprint(self):
+        """Returns a fingerprint of the lkc symbol indices,
+        which identifies the symbol names and their order.
+
+        Symbol indices can be stored along with this fingerprint,
+        and are valid for all symbol sets with the same fingerprint.
+
+        @return:  hex digest
+        @rtype:   C{str}
+        """
+        fingerprint = self._fingerprint
+        if fingerprint is None:
+            key_hash = hashlib.sha256()
+            for sym in self.index_map:
+                if sym is not None and sym.name:
+                    key_hash.update(sym.name.encode())
+                key_hash.update(b"\0")
+            # --
+
+            fingerprint = key_hash.hexdigest()
+            self._fingerprint = fingerprint
+        # --
+
+        return fingerprint
+    # --- end of get_fingerprint (...) ---
+
+    def get_index_count(self):
+        """
+        @return:  length of lists indexed by lkc symbol index
+        @rtype:   C{int}
+        """
+        return len(self.index_map)
+
+    def __iter__(self):
+        return iter(self._symbols)
+
+    def __len__(self):
+        return len(self._symbols)   # len(_symbols) >= len(name_map)
+
+    def _add_symbol(self, sym_name_key, sym):
+        if sym_name_key is self.name_map:
+            raise KeyError("redefiniton of named symbol %r" % sym_name_key)
+
+        if sym in self._symbols:
+            raise KeyError("redefinition of symbol %r" % sym)
+
+        if sym_name_key:
+            self.name_map[sym_name_key] = sym
+
+        if sym.index is not None:
+            index_map = self.index_map
+            if sym.index >= len(index_map):
+                index_map.extend([None] * (sym.index + 1 - len(index_map)))
+            index_map[sym.index] = sym
+            self._fingerprint = None
+
+        self._symbols.add(sym)
+
+        return sym
+    # ---
+
+# --- end of KconfigSymbols ---
@@ -0,0 +1,7 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+from .lookup import ModaliasLookup
+
+
+__all__ = ["ModaliasLookup"]
@@ -0,0 +1,499 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import fnmatch
+import mmap
+import os
+import struct
+import tempfile
+
+
+from ....util import fileio
+from ....util import fs
+
+from .abc import lookup as _lookup_abc
+
+
+__all__ = ["ModaliasIndex", "IndexModaliasLookup"]
+
+
+class ModaliasIndex(object):
+    """
+    A compiled modules.alias file that can be queried
+    without loading it into Python dicts.
+
+    The alias patterns are grouped by the length of their literal prefix
+    (the part before the first wildcard char), and each group is sorted
+    by that prefix. Looking up a modalias is then a binary search
+    for each prefix length, followed by a fnmatch() of the candidates.
+
+    File format (native byte order):
+
+      header   := magic, version, prefix length count, entry count,
+                  module count, 0, source size, source mtime_ns
+      lengths  := prefix length count * (prefix length, first entry, count)
+      entries  := entry count * (pattern offset, pattern length,
+                                 prefix length, module index)
+      modules  := module count * (name offset, name length)
+      strings  := <pattern and module name data>
+
+    String offsets are relative to the start of the strings area.
+    Patterns are stored in modules.alias order,
+    so that lookup results can be ordered by pattern offset.
+
+    @ivar source_stamp:  (size, mtime_ns) of the source the index
+                         has been created from, see AbstractModulesDir
+    @type source_stamp:  2-tuple (C{int}, C{int})
+
+    @ivar _data:         index data, mmap-ed file or bytes
+    @type _data:         C{mmap.mmap} or C{bytes}
+    """
+
+    FILE_MAGIC = b"KCMALIAS"
+    FILE_VERSION = 1
+    FILE_SUFFIX = ".maidx"
+
+    HEADER_STRUCT = struct.Struct("=8sIIIIIqq")
+    LENGTH_STRUCT = struct.Struct("=III")
+    ENTRY_STRUCT = struct.Struct("=IIII")
+    MODULE_STRUCT = struct.Struct("=II")
+
+    WILDCARD_CHARS = frozenset(b"*?[\\")
+
+    @classmethod
+    def get_literal_prefix_len(cls, pattern):
+        for k, c in enumerate(pattern):
+            if c in cls.WILDCARD_CHARS:
+                return k
+        return len(pattern)
+    # --- end of get_literal_prefix_len (...) ---
+
+    @classmethod
+    def iter_parse_modules_alias(cls, lines):
+        """
+        Parses modules.alias lines ("alias <pattern> <module>").
+
+        @param lines:  input lines
+        @type  lines:  iterable of C{str}
+
+        @return:  2-tuples (pattern, module name)
+        @rtype:   2-tuples (C{str}, C{str})
+        """
+        for line in lines:
+            fields = line.split()
+            if len(fields) == 3 and fields[0] == "alias":
+                yield (fields[1], fields[2])
+    # --- end of iter_parse_modules_alias (...) ---
+
+    @classmethod
+    def gen_index_chunks(cls, aliases, source_stamp):
+        """Generator that creates the index data in chunks.
+
+        @param aliases:       2-tuples (pattern, module name)
+        @type  aliases:       iterable of 2-tuple (C{str}, C{str})
+        @param source_stamp:  (size, mtime_ns) of the source or None
+        @type  source_stamp:  2-tuple (C{int}, C{int}) or C{None}
+
+        @return:  index data chunks
+        @rtype:   C{bytes}
+        """
+        strings = []
+        strings_len = 0
+        module_map = {}
+        module_chunks = []
+        entries = []
+
+        def add_string(data):
+            nonlocal strings_len
+            offset = strings_len
+            strings.append(data)
+            strings_len += len(data)
+            return offset
+
+        for pattern, module_name in aliases:
+            pattern_data = pattern.encode("utf-8", "surrogateescape")
+
+            try:
+                module_idx = module_map[module_name]
+            except KeyError:
+                module_data = module_name.encode("utf-8", "surrogateescape")
+                module_idx = len(module_chunks)
+                module_chunks.append(
+                    cls.MODULE_STRUCT.pack(
+                        add_string(module_data), len(module_data)
+                    )
+                )
+                module_map[module_name] = module_idx
+            # --
+
+            prefix_len = cls.get_literal_prefix_len(pattern_data)
+            entries.append((
+                prefix_len, pattern_data[:prefix_len],
+                add_string(pattern_data), len(pattern_data), module_idx
+            ))
+        # --
+
+        # sort by prefix length, then prefix, keep file order otherwise
+        entries.sort(key=lambda xv: (xv[0], xv[1], xv[2]))
+
+        length_chunks = []
+        k = 0
+        while k < len(entries):
+            prefix_len = entries[k][0]
+            first = k
+            while k < len(entries) and entries[k][0] == prefix_len:
+                k += 1
+            length_chunks.append(
+                cls.LENGTH_STRUCT.pack(prefix_len, first, k - first)
+            )
+        # --
+
+        stamp_size, stamp_mtime = source_stamp or (-1, -1)
+
+        yield cls.HEADER_STRUCT.pack(
+            cls.FILE_MAGIC, cls.FILE_VERSION,
+            len(length_chunks), len(entries), len(module_chunks), 0,
+            stamp_size, stamp_mtime
+        )
+        yield from length_chunks
+        for prefix_len, _, pattern_off, pattern_len, module_idx in entries:
+            yield cls.ENTRY_STRUCT.pack(
+                pattern_off, pattern_len, prefix_len, module_idx
+            )
+        yield from module_chunks
+        yield from strings
+    # --- end of gen_index_chunks (...) ---
+
+    @classmethod
+    def new_from_modules_alias(cls, alias_file, source_stamp=None):
+        """Compiles a modules.alias file into an in-memory index.
+
+        @param alias_file:    modules.alias file
+        @type  alias_file:    C{str}
+        @param source_stamp:  (size, mtime_ns) of the source or None
+        @type  source_stamp:  2-tuple (C{int}, C{int}) or C{None}
+
+        @return:  index
+        @rtype:   L{ModaliasIndex}
+        """
+        aliases = cls.iter_parse_modules_alias(
+            (l for k, l in fileio.read_text_file_lines(alias_file))
+        )
+        return cls(b"".join(cls.gen_index_chunks(aliases, source_stamp)))
+    # --- end of new_from_modules_alias (...) ---
+
+    @classmethod
+    def new_from_file(cls, index_file):
+        """Loads an index file.
+
+        @raises OSError:
+        @raises ValueError:  bad index file
+
+        @param index_file:  index file
+        @type  index_file:  C{str}
+
+        @return:  index
+        @rtype:   L{ModaliasIndex}
+        """
+        with open(index_file, "rb") as fh:
+            mmap_obj = mmap.mmap(fh.fileno(), 0, access=mmap.ACCESS_READ)
+
+        try:
+            return cls(mmap_obj)
+        except (struct.error, ValueError):
+            mmap_obj.close()
+            raise
+    # --- end of new_from_file (...) ---
+
+    def write_file(self, index_file):
+        """Writes the index data to a file.
+
+        The data is written to a temporary file first,
+        which is then renamed, other processes may be reading the index.
+
+        @raises OSError:
+
+        @param index_file:  index file
+        @type  index_file:  C{str}
+        """
+        tmp_file = None
+        try:
+            fs.dodir_for_file(index_file)
+
+            tmp_fd, tmp_file = tempfile.mkstemp(
+                prefix=".", suffix=self.FILE_SUFFIX,
+                dir=os.path.dirname(index_file)
+            )
+            os.fchmod(tmp_fd, 0o644)
+            with os.fdopen(tmp_fd, "wb") as fh:
+                fh.write(self._data)
+
+            os.replace(tmp_file, index_file)
+            tmp_file = None
+
+        finally:
+            if tmp_file is not None:
+                fs.rmfile(tmp_file)
+    # --- end of write_file (...) ---
+
+    def __init__(self, data):
+        super().__init__()
+        self._data = data
+
+        (
+            magic, version, num_lengths, num_entries, num_modules, _,
+            stamp_size, stamp_mtime
+        ) = self.HEADER_STRUCT.unpack_from(data, 0)
+
+        if magic != self.FILE_MAGIC or version != self.FILE_VERSION:
+            raise ValueError("modalias index format mismatch")
+
+        self.source_stamp = (stamp_size, stamp_mtime)
+
+        offset = self.HEADER_STRUCT.size
+        self._lengths = [
+            self.LENGTH_STRUCT.unpack_from(
+                data, offset + (k * self.LENGTH_STRUCT.size)
+            )
+            for k in range(num_lengths)
+        ]
+        offset += num_lengths * self.LENGTH_STRUCT.size
+
+        self._entries_offset = offset
+        offset += num_entries * self.ENTRY_STRUCT.size
+
+        self._modules_offset = offset
+        offset += num_modules * self.MODULE_STRUCT.size
+
+        self._strings_offset = offset
+        self._num_entries = num_entries
+        self._num_modules = num_modules
+
+        if offset > len(data):
+            raise ValueError("modalias index is truncated")
+    # --- end of __init__ (...) ---
+
+    def __len__(self):
+        return self._num_entries
+
+    def _get_entry(self, idx):
+        return self.ENTRY_STRUCT.unpack_from(
+            self._data, self._entries_offset + (idx * self.ENTRY_STRUCT.size)
+        )
+
+    def _get_string(self, offset, length):
+        start = self._strings_offset + offset
+        return self._data[start:start + length]
+
+    def get_module_name(self, module_idx):
+        name_off, name_len = self.MODULE_STRUCT.unpack_from(
+            self._data,
+            self._modules_offset + (module_idx * self.MODULE_STRUCT.size)
+        )
+        return self._get_string(name_off, name_len).decode(
+            "utf-8", "surrogateescape"
+        )
+    # --- end of get_module_name (...) ---
+
+    def iter_matching_entries(self, modalias_data):
+        """
+        Generator that yields the entries whose pattern matches a modalias,
+        in no particular order.
+
+        @param modalias_data:  modalias
+        @type  modalias_data:  C{bytes}
+
+        @return:  entries (pattern offset, pattern length,
+                           prefix length, module index)
+        @rtype:   4-tuple of C{int}
+        """
+        get_entry = self._get_entry
+        get_string = self._get_string
+        modalias_len = len(modalias_data)
+        modalias_str = None
+
+        for prefix_len, first, count in self._lengths:
+            if prefix_len > modalias_len:
+                break
+
+            prefix = modalias_data[:prefix_len]
+
+            # binary search for the first entry with prefix >= <prefix>
+            lo = first
+            hi = first + count
+            while lo < hi:
+                mid = (lo + hi) // 2
+                pattern_off = get_entry(mid)[0]
+                if get_string(pattern_off, prefix_len) < prefix:
+                    lo = mid + 1
+                else:
+                    hi = mid
+            # --
+
+            for k in range(lo, first + count):
+                entry = get_entry(k)
+                pattern = get_string(entry[0], entry[1])
+                if pattern[:prefix_len] != prefix:
+                    break
+
+                elif entry[1] == prefix_len:
+                    # literal pattern
+                    if pattern == modalias_data:
+                        yield entry
+
+                else:
+                    if modalias_str is None:
+                        modalias_str = modalias_data.decode(
+                            "utf-8", "surrogateescape"
+                        )
+
+                    if fnmatch.fnmatchcase(
+                        modalias_str,
+                        pattern.decode("utf-8", "surrogateescape")
+                    ):
+                        yield entry
+            # --
+        # --
+    # --- end of iter_matching_entries (...) ---
+
+    def lookup(self, modalias):
+        """
+        Returns the names of the modules matching a modalias,
+        in modules.alias order.
+
+        @param modalias:  modalias
+        @type  modalias:  C{str}
+
+        @return:  module names, possibly with duplicates
+        @rtype:   C{list} of C{str}
+        """
+        entries = sorted(
+            self.iter_matching_entries(
+                modalias.encode("utf-8", "surrogateescape")
+            )
+        )
+        return [self.get_module_name(entry[3]) for entry in entries]
+    # --- end of lookup (...) ---
+
+# --- end of ModaliasIndex ---
+
+
+class IndexModaliasLookup(_lookup_abc.AbstractModulesDirModaliasLookup):
+    """
+    Modalias lookup that queries a precompiled modules.alias index,
+    see L{ModaliasIndex}.
+
+    If the modules dir provides an index path, the index is loaded from
+    that file as long as it is up-to-date, without creating the modules dir
+    (i.e. without unpacking the modalias info tarball).
+    Otherwise, the index is compiled from the modules dir's modules.alias
+    file, and written to the index path, if any.
+
+    Unlike kmod's lookup, aliases from modprobe config files
+    and built-in module aliases are not considered.
+    """
+
+    AVAILABLE = True
+
+    ALIAS_FILE_NAME = "modules.alias"
+
+    def __init__(self, mod_dir, **kwargs):
+        super().__init__(mod_dir, **kwargs)
+        self._index = None
+    # --- end of __init__ (...) ---
+
+    def lazy_init(self):
+        if self._index is None:
+            self._index = self._init_index()
+        return bool(self._index)
+    # --- end of lazy_init (...) ---
+
+    def iter_lookup_v(self, modaliases):
+        if not self.lazy_init():
+            raise RuntimeError("could not initialize modalias index")
+
+        index = self._index
+        for modalias in modaliases:
+            yield from index.lookup(modalias)
+    # --- end of iter_lookup_v (...) ---
+
+    def _init_index(self):
+        """
+        @return:  index, or False if no index could be created
+        @rtype:   L{ModaliasIndex} or C{bool}
+        """
+        mod_dir = self._mod_dir
+
+        if mod_dir and not isinstance(mod_dir, (str, bytes)):
+            index_file = mod_dir.get_index_path()
+            source_stamp = mod_dir.get_source_stamp()
+        else:
+            index_file = None
+            source_stamp = None
+        # --
+
+        if index_file and source_stamp:
+            index = self._load_index_file(index_file, source_stamp)
+            if index is not None:
+                return index
+        # --
+
+        if not self._init_mod_dir():
+            return False
+
+        mod_dir_path = self.get_mod_dir_path()
+        if not mod_dir_path:
+            mod_dir_path = os.path.join("/lib/modules", os.uname().release)
+        elif isinstance(mod_dir_path, bytes):
+            mod_dir_path = os.fsdecode(mod_dir_path)
+
+        alias_file = os.path.join(mod_dir_path, self.ALIAS_FILE_NAME)
+        self.logger.debug("Compiling modalias index from %s", alias_file)
+        try:
+            index = ModaliasIndex.new_from_modules_alias(
+                alias_file, source_stamp
+            )
+        except OSError as err:
+            self.logger.warning(
+                "Cannot read %s: %s", self.ALIAS_FILE_NAME, err
+            )
+            return False
+        # --
+
+        if index_file and source_stamp:
+            try:
+                index.write_file(index_file)
+            except OSError as err:
+                self.logger.warning(
+                    "Failed to write modalias index file %s: %s",
+                    index_file, err
+                )
+            else:
+                self.logger.debug("Wrote modalias index %s", index_file)
+        # --
+
+        return index
+    # --- end of _init_index (...) ---
+
+    def _load_index_file(self, index_file, source_stamp):
+        try:
+            index = ModaliasIndex.new_from_file(index_file)
+        except OSError:
+            self.logger.debug("No modalias index file: %s", index_file)
+            return None
+        except (struct.error, ValueError) as err:
+            self.logger.warning(
+                "Failed to read modalias index file %s: %s", index_file, err
+            )
+            return None
+        # --
+
+        if index.source_stamp != tuple(source_stamp):
+            self.logger.debug("Discarding outdated modalias index")
+            return None
+
+        self.logger.debug("Using modalias index %s", index_file)
+        return index
+    # --- end of _load_index_file (...) ---
+
+# --- end of IndexModaliasLookup ---
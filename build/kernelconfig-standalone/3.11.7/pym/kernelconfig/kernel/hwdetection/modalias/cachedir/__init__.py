@@ -0,0 +1,7 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+from .lookup import ModaliasCache
+from .builder import ModaliasCacheBuilder
+
+__all__ = ["ModaliasCache", "ModaliasCacheBuilder"]
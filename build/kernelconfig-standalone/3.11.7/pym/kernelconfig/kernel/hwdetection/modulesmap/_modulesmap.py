@@ -0,0 +1,79 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import collections.abc
+
+from ....abc import informed
+
+from . import mkscanner
+from .. import util
+
+
+__all__ = ["ModulesMap"]
+
+
+class ModulesMap(informed.AbstractSourceInformed, collections.abc.Mapping):
+
+    normalize_module_name = staticmethod(util.normalize_module_name)
+
+    @property
+    def is_loaded(self):
+        return self._mk_modmap is not None
+
+    def load(self):
+        self._get_mk_modmap()
+    # --- end of load (...) ---
+
+    def __init__(self, source_info, *, cache_dir=None, **kwargs):
+        """Constructor.
+
+        @param   source_info:
+        @keyword cache_dir:    directory for caching the Makefile scan
+                               results, or None (disables caching).
+                               Defaults to None.
+        @type    cache_dir:    C{str} or C{None}
+        """
+        super().__init__(source_info=source_info, **kwargs)
+        self.cache_dir = cache_dir
+        self._mk_modmap = None
+    # --- end of __init__ (...) ---
+
+    def __iter__(self):
+        return iter(self._get_mk_modmap())
+
+    def __len__(self):
+        return len(self._get_mk_modmap())
+
+    def __getitem__(self, key):
+        normkey = self.normalize_module_name(key)
+
+        mk_modmap = self._get_mk_modmap()
+        return mk_modmap[normkey]
+    # --- end of __getitem__ (...) ---
+
+    def _get_mk_modmap(self):
+        mk_modmap = self._mk_modmap
+        if mk_modmap is None:
+            mk_modmap = self._load_new_mk_modmap()
+            self._mk_modmap = mk_modmap
+        return mk_modmap
+    # --- end of _get_mk_modmap (...) ---
+
+    def _create_scan_cache(self):
+        if not self.cache_dir:
+            return None
+
+        return self.create_source_informed(
+            mkscanner.MakefileScanCache, self.cache_dir
+        )
+    # --- end of _create_scan_cache (...) ---
+
+    def _load_new_mk_modmap(self):
+        scanner = self.create_loggable(
+            mkscanner.ModuleConfigOptionsScanner, self.source_info,
+            scan_cache=self._create_scan_cache()
+        )
+        return scanner.get_module_options_map()
+    # --- end of _load_new_mk_modmap (...) ---
+
+# --- end of ModulesMap (...) ---
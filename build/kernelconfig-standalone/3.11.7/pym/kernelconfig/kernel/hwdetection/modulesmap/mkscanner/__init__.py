@@ -0,0 +1,8 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+from .scanner import ModuleConfigOptionsScanner
+from .cache import MakefileScanCache
+
+
+__all__ = ["ModuleConfigOptionsScanner", "MakefileScanCache"]
@@ -0,0 +1,135 @@
+
+# parsetab.py
+# This file is automatically generated. Do not edit.
+_tabversion = '3.10'
+
+_lr_method = 'LALR'
+
+_lr_signature = 'nonassocNEGELEGTLTEQ_CMPEQCOL_EQPLUS_EQBITOR_EQrightNOTleftANDleftORSTR CMD_END LPAREN RPAREN KW_FALSE BITOR_EQ EQ_CMP EQ KW_MODALIAS OP_PACKAGES KW_IF OP_HWDETECT KW_PLACEHOLDER COL_EQ LE OP_DISABLE AND LT NE KW_TRUE OP_ADD KW_UNLESS KW_EXISTS OR GT OP_APPEND OP_INCLUDE PLUS_EQ KW_DRIVER OP_BUILTIN_OR_MODULE OP_MODULE NOT GE OP_SET_TO OP_BUILTINlang : command_listcommand_list : command_list : CMD_ENDcommand_list : conditional_commandcommand_list : conditional_command CMD_END command_listcommand_list : conditional_command errorconditional_command : commandconditional_command : command KW_IF cond_exprconditional_command : command KW_UNLESS cond_exprconditional_command : command KW_IF error\n                               | command KW_UNLESS errorcommand : OP_INCLUDE STRcommand : OP_INCLUDE errorcommand : OP_HWDETECTcommand : OP_PACKAGES STRcommand : OP_PACKAGEScommand : OP_DISABLE str_listcommand : OP_MODULE str_listcommand : OP_BUILTIN str_listcommand : OP_BUILTIN_OR_MODULE str_listcommand : OP_DISABLE error\n                   | OP_MODULE  error\n                   | OP_BUILTIN error\n                   | OP_BUILTIN_OR_MODULE error\n        command : OP_DISABLE OP_MODULE str_list\n                   | OP_DISABLE KW_DRIVER str_list\n        command : OP_MODULE OP_MODULE str_list\n                   | OP_MODULE KW_DRIVER str_list\n        command : OP_BUILTIN OP_MODULE str_list\n                   | OP_BUILTIN KW_DRIVER str_list\n        command : OP_BUILTIN_OR_MODULE OP_MODULE str_list\n                   | OP_BUILTIN_OR_MODULE KW_DRIVER str_list\n        command : OP_DISABLE OP_MODULE error\n                   | OP_DISABLE KW_DRIVER error\n                   | OP_MODULE  OP_MODULE error\n                   | OP_MODULE  KW_DRIVER error\n                   | OP_BUILTIN OP_MODULE error\n                   | OP_BUILTIN KW_DRIVER error\n                   | OP_BUILTIN_OR_MODULE OP_MODULE error\n                   | OP_BUILTIN_OR_MODULE KW_DRIVER error\n        command : OP_DISABLE KW_MODALIAS str_listcommand : OP_MODULE KW_MODALIAS str_listcommand : OP_BUILTIN KW_MODALIAS str_listcommand : OP_BUILTIN_OR_MODULE KW_MODALIAS str_listcommand : OP_DISABLE KW_MODALIAS error\n                   | OP_MODULE  KW_MODALIAS error\n                   | OP_BUILTIN KW_MODALIAS error\n                   | OP_BUILTIN_OR_MODULE KW_MODALIAS error\n        command : OP_SET_TO STR STRcommand : OP_APPEND STR STRcommand : OP_ADD STR STRcommand : OP_SET_TO error\n                   | OP_APPEND error\n                   | OP_ADD    error\n        command : OP_SET_TO STR error\n                   | OP_APPEND STR error\n                   | OP_ADD    STR error\n        command : STR EQ     OP_DISABLE\n                   | STR COL_EQ OP_DISABLE\n        command : STR EQ     OP_MODULE\n                   | STR COL_EQ OP_MODULE\n        command : STR EQ     OP_BUILTIN\n                   | STR COL_EQ OP_BUILTIN\n        command : STR EQ     OP_BUILTIN_OR_MODULE\n                   | STR COL_EQ OP_BUILTIN_OR_MODULE\n        command : STR EQ     STR\n                   | STR COL_EQ STR\n        command : STR PLUS_EQ STRcommand : STR BITOR_EQ STRcommand : STR EQ       error\n                   | STR COL_EQ   error\n                   | STR PLUS_EQ  error\n                   | STR BITOR_EQ errorcommand : OP_SET_TO STR EQ     OP_DISABLE\n                   | OP_SET_TO STR COL_EQ OP_DISABLE\n        command : OP_SET_TO STR EQ     OP_MODULE\n                   | OP_SET_TO STR COL_EQ OP_MODULE\n        command : OP_SET_TO STR EQ     OP_BUILTIN\n                   | OP_SET_TO STR COL_EQ OP_BUILTIN\n        command : OP_SET_TO STR EQ     OP_BUILTIN_OR_MODULE\n                   | OP_SET_TO STR COL_EQ OP_BUILTIN_OR_MODULE\n        command : OP_SET_TO STR EQ     STR\n                   | OP_SET_TO STR COL_EQ STR\n        command : OP_SET_TO STR EQ       error\n                   | OP_SET_TO STR COL_EQ   error\n                   | OP_SET_TO STR PLUS_EQ  error\n                   | OP_SET_TO STR BITOR_EQ errorstr_list : STRstr_list : STR str_listcond_expr : KW_PLACEHOLDERcond_expr : KW_TRUEcond_expr : KW_FALSEcond_expr : KW_EXISTS STRcond_expr : KW_EXISTS\n                     | KW_EXISTS KW_PLACEHOLDERcond_expr : LPAREN cond_expr RPARENcond_expr : NOT cond_exprcond_expr : cond_expr AND cond_expr\n                     | cond_expr OR  cond_expr\n        cond_expr : STR NE     STR\n                     | STR GE     STR\n                     | STR LE     STR\n                     | STR GT     STR\n                     | STR LT     STR\n                     | STR EQ_CMP STR\n                     | STR EQ     STR\n        '
+    
+_lr_action_items = {'$end':([0,1,2,3,4,5,8,9,17,18,21,22,27,28,29,33,35,36,39,40,44,45,50,52,54,55,56,57,58,59,60,61,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,114,115,116,117,120,121,130,131,132,133,134,135,136,137,138,139,140,141,142,143,144,145,146,147,148,149,150,151,152,153,154,],[-2,0,-1,-3,-4,-7,-14,-16,-2,-6,-12,-13,-15,-17,-21,-88,-18,-22,-19,-23,-20,-24,-52,-53,-54,-5,-8,-10,-90,-91,-92,-94,-9,-11,-66,-58,-60,-62,-64,-70,-67,-59,-61,-63,-65,-71,-68,-72,-69,-73,-25,-33,-26,-34,-41,-45,-89,-27,-35,-28,-36,-42,-46,-29,-37,-30,-38,-43,-47,-31,-39,-32,-40,-44,-48,-49,-55,-50,-56,-51,-57,-93,-95,-97,-82,-74,-76,-78,-80,-84,-83,-75,-77,-79,-81,-85,-86,-87,-98,-99,-100,-101,-102,-103,-104,-105,-106,-96,]),'CMD_END':([0,4,5,8,9,17,21,22,27,28,29,33,35,36,39,40,44,45,50,52,54,56,57,58,59,60,61,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,114,115,116,117,120,121,130,131,132,133,134,135,136,137,138,139,140,141,142,143,144,145,146,147,148,149,150,151,152,153,154,],[3,17,-7,-14,-16,3,-12,-13,-15,-17,-21,-88,-18,-22,-19,-23,-20,-24,-52,-53,-54,-8,-10,-90,-91,-92,-94,-9,-11,-66,-58,-60,-62,-64,-70,-67,-59,-61,-63,-65,-71,-68,-72,-69,-73,-25,-33,-26,-34,-41,-45,-89,-27,-35,-28,-36,-42,-46,-29,-37,-30,-38,-43,-47,-31,-39,-32,-40,-44,-48,-49,-55,-50,-56,-51,-57,-93,-95,-97,-82,-74,-76,-78,-80,-84,-83,-75,-77,-79,-81,-85,-86,-87,-98,-99,-100,-101,-102,-103,-104,-105,-106,-96,]),'OP_INCLUDE':([0,17,],[6,6,]),'OP_HWDETECT':([0,17,],[8,8,]),'OP_PACKAGES':([0,17,],[9,9,]),'OP_DISABLE':([0,17,23,24,110,111,],[10,10,68,74,132,138,]),'OP_MODULE':([0,10,11,12,13,17,23,24,110,111,],[11,30,34,41,46,11,69,75,133,139,]),'OP_BUILTIN':([0,17,23,24,110,111,],[12,12,70,76,134,140,]),'OP_BUILTIN_OR_MODULE':([0,17,23,24,110,111,],[13,13,71,77,135,141,]),'OP_SET_TO':([0,17,],[14,14,]),'OP_APPEND':([0,17,],[15,15,]),'OP_ADD':([0,17,],[16,16,]),'STR':([0,6,9,10,11,12,13,14,15,16,17,19,20,23,24,25,26,30,31,32,33,34,37,38,41,42,43,46,47,48,49,51,53,61,63,64,110,111,118,119,122,123,124,125,126,127,128,],[7,21,27,33,33,33,33,49,51,53,7,62,62,67,73,79,81,33,33,33,33,33,33,33,33,33,33,33,33,33,108,114,116,120,62,62,131,137,62,62,147,148,149,150,151,152,153,]),'error':([4,5,6,8,9,10,11,12,13,14,15,16,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,56,57,58,59,60,61,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,115,116,117,120,121,130,131,132,133,134,135,136,137,138,139,140,141,142,143,144,145,146,147,148,149,150,151,152,153,154,],[18,-7,22,-14,-16,29,36,40,45,50,52,54,57,66,-12,-13,72,78,80,82,-15,-17,-21,84,86,88,-88,91,-18,-22,93,95,-19,-23,97,99,101,-20,-24,103,105,107,109,-52,115,-53,117,-54,-8,-10,-90,-91,-92,-94,-9,-11,-66,-58,-60,-62,-64,-70,-67,-59,-61,-63,-65,-71,-68,-72,-69,-73,-25,-33,-26,-34,-41,-45,-89,-27,-35,-28,-36,-42,-46,-29,-37,-30,-38,-43,-47,-31,-39,-32,-40,-44,-48,-49,-55,136,142,143,144,-50,-56,-51,-57,-93,-95,-97,-82,-74,-76,-78,-80,-84,-83,-75,-77,-79,-81,-85,-86,-87,-98,-99,-100,-101,-102,-103,-104,-105,-106,-96,]),'KW_IF':([5,8,9,21,22,27,28,29,33,35,36,39,40,44,45,50,52,54,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,114,115,116,117,131,132,133,134,135,136,137,138,139,140,141,142,143,144,],[19,-14,-16,-12,-13,-15,-17,-21,-88,-18,-22,-19,-23,-20,-24,-52,-53,-54,-66,-58,-60,-62,-64,-70,-67,-59,-61,-63,-65,-71,-68,-72,-69,-73,-25,-33,-26,-34,-41,-45,-89,-27,-35,-28,-36,-42,-46,-29,-37,-30,-38,-43,-47,-31,-39,-32,-40,-44,-48,-49,-55,-50,-56,-51,-57,-82,-74,-76,-78,-80,-84,-83,-75,-77,-79,-81,-85,-86,-87,]),'KW_UNLESS':([5,8,9,21,22,27,28,29,33,35,36,39,40,44,45,50,52,54,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,114,115,116,117,131,132,133,134,135,136,137,138,139,140,141,142,143,144,],[20,-14,-16,-12,-13,-15,-17,-21,-88,-18,-22,-19,-23,-20,-24,-52,-53,-54,-66,-58,-60,-62,-64,-70,-67,-59,-61,-63,-65,-71,-68,-72,-69,-73,-25,-33,-26,-34,-41,-45,-89,-27,-35,-28,-36,-42,-46,-29,-37,-30,-38,-43,-47,-31,-39,-32,-40,-44,-48,-49,-55,-50,-56,-51,-57,-82,-74,-76,-78,-80,-84,-83,-75,-77,-79,-81,-85,-86,-87,]),'EQ':([7,49,62,],[23,110,128,]),'COL_EQ':([7,49,],[24,111,]),'PLUS_EQ':([7,49,],[25,112,]),'BITOR_EQ':([7,49,],[26,113,]),'KW_DRIVER':([10,11,12,13,],[31,37,42,47,]),'KW_MODALIAS':([10,11,12,13,],[32,38,43,48,]),'KW_PLACEHOLDER':([19,20,61,63,64,118,119,],[58,58,121,58,58,58,58,]),'KW_TRUE':([19,20,63,64,118,119,],[59,59,59,59,59,59,]),'KW_FALSE':([19,20,63,64,118,119,],[60,60,60,60,60,60,]),'KW_EXISTS':([19,20,63,64,118,119,],[61,61,61,61,61,61,]),'LPAREN':([19,20,63,64,118,119,],[63,63,63,63,63,63,]),'NOT':([19,20,63,64,118,119,],[64,64,64,64,64,64,]),'AND':([56,58,59,60,61,65,120,121,129,130,145,146,147,148,149,150,151,152,153,154,],[118,-90,-91,-92,-94,118,-93,-95,118,118,-98,-99,-100,-101,-102,-103,-104,-105,-106,-96,]),'OR':([56,58,59,60,61,65,120,121,129,130,145,146,147,148,149,150,151,152,153,154,],[119,-90,-91,-92,-94,119,-93,-95,119,119,119,-99,-100,-101,-102,-103,-104,-105,-106,-96,]),'RPAREN':([58,59,60,61,120,121,129,130,145,146,147,148,149,150,151,152,153,154,],[-90,-91,-92,-94,-93,-95,154,-97,-98,-99,-100,-101,-102,-103,-104,-105,-106,-96,]),'NE':([62,],[122,]),'GE':([62,],[123,]),'LE':([62,],[124,]),'GT':([62,],[125,]),'LT':([62,],[126,]),'EQ_CMP':([62,],[127,]),}
+
+_lr_action = {}
+for _k, _v in _lr_action_items.items():
+   for _x,_y in zip(_v[0],_v[1]):
+      if not _x in _lr_action:  _lr_action[_x] = {}
+      _lr_action[_x][_k] = _y
+del _lr_action_items
+
+_lr_goto_items = {'lang':([0,],[1,]),'command_list':([0,17,],[2,55,]),'conditional_command':([0,17,],[4,4,]),'command':([0,17,],[5,5,]),'str_list':([10,11,12,13,30,31,32,33,34,37,38,41,42,43,46,47,48,],[28,35,39,44,83,85,87,89,90,92,94,96,98,100,102,104,106,]),'cond_expr':([19,20,63,64,118,119,],[56,65,129,130,145,146,]),}
+
+_lr_goto = {}
+for _k, _v in _lr_goto_items.items():
+   for _x, _y in zip(_v[0], _v[1]):
+       if not _x in _lr_goto: _lr_goto[_x] = {}
+       _lr_goto[_x][_k] = _y
+del _lr_goto_items
+_lr_productions = [
+  ("S' -> lang","S'",1,None,None,None),
+  ('lang -> command_list','lang',1,'p_lang','parser.py',134),
+  ('command_list -> <empty>','command_list',0,'p_command_list_empty','parser.py',138),
+  ('command_list -> CMD_END','command_list',1,'p_command_list_nop','parser.py',142),
+  ('command_list -> conditional_command','command_list',1,'p_command_list_one','parser.py',146),
+  ('command_list -> conditional_command CMD_END command_list','command_list',3,'p_command_list_many','parser.py',150),
+  ('command_list -> conditional_command error','command_list',2,'p_command_list_bad_missing_sep','parser.py',154),
+  ('conditional_command -> command','conditional_command',1,'p_conditional_command_nocond','parser.py',160),
+  ('conditional_command -> command KW_IF cond_expr','conditional_command',3,'p_conditional_command_if','parser.py',168),
+  ('conditional_command -> command KW_UNLESS cond_expr','conditional_command',3,'p_conditional_command_unless','parser.py',172),
+  ('conditional_command -> command KW_IF error','conditional_command',3,'p_conditional_command_bad_missing_cond_expr','parser.py',176),
+  ('conditional_command -> command KW_UNLESS error','conditional_command',3,'p_conditional_command_bad_missing_cond_expr','parser.py',177),
+  ('command -> OP_INCLUDE STR','command',2,'p_command_include_file','parser.py',186),
+  ('command -> OP_INCLUDE error','command',2,'p_command_include_file_bad','parser.py',190),
+  ('command -> OP_HWDETECT','command',1,'p_command_hwdetect_basic','parser.py',200),
+  ('command -> OP_PACKAGES STR','command',2,'p_command_packages_one_arg','parser.py',208),
+  ('command -> OP_PACKAGES','command',1,'p_command_packages_basic','parser.py',221),
+  ('command -> OP_DISABLE str_list','command',2,'p_command_disable','parser.py',230),
+  ('command -> OP_MODULE str_list','command',2,'p_command_module','parser.py',234),
+  ('command -> OP_BUILTIN str_list','command',2,'p_command_builtin','parser.py',238),
+  ('command -> OP_BUILTIN_OR_MODULE str_list','command',2,'p_command_builtin_or_module','parser.py',242),
+  ('command -> OP_DISABLE error','command',2,'p_command_dmb_bad_no_options','parser.py',248),
+  ('command -> OP_MODULE error','command',2,'p_command_dmb_bad_no_options','parser.py',249),
+  ('command -> OP_BUILTIN error','command',2,'p_command_dmb_bad_no_options','parser.py',250),
+  ('command -> OP_BUILTIN_OR_MODULE error','command',2,'p_command_dmb_bad_no_options','parser.py',251),
+  ('command -> OP_DISABLE OP_MODULE str_list','command',3,'p_command_disable_driver','parser.py',263),
+  ('command -> OP_DISABLE KW_DRIVER str_list','command',3,'p_command_disable_driver','parser.py',264),
+  ('command -> OP_MODULE OP_MODULE str_list','command',3,'p_command_module_driver','parser.py',269),
+  ('command -> OP_MODULE KW_DRIVER str_list','command',3,'p_command_module_driver','parser.py',270),
+  ('command -> OP_BUILTIN OP_MODULE str_list','command',3,'p_command_builtin_driver','parser.py',275),
+  ('command -> OP_BUILTIN KW_DRIVER str_list','command',3,'p_command_builtin_driver','parser.py',276),
+  ('command -> OP_BUILTIN_OR_MODULE OP_MODULE str_list','command',3,'p_command_builtin_or_module_driver','parser.py',281),
+  ('command -> OP_BUILTIN_OR_MODULE KW_DRIVER str_list','command',3,'p_command_builtin_or_module_driver','parser.py',282),
+  ('command -> OP_DISABLE OP_MODULE error','command',3,'p_command_dmb_driver_bad_no_options','parser.py',289),
+  ('command -> OP_DISABLE KW_DRIVER error','command',3,'p_command_dmb_driver_bad_no_options','parser.py',290),
+  ('command -> OP_MODULE OP_MODULE error','command',3,'p_command_dmb_driver_bad_no_options','parser.py',291),
+  ('command -> OP_MODULE KW_DRIVER error','command',3,'p_command_dmb_driver_bad_no_options','parser.py',292),
+  ('command -> OP_BUILTIN OP_MODULE error','command',3,'p_command_dmb_driver_bad_no_options','parser.py',293),
+  ('command -> OP_BUILTIN KW_DRIVER error','command',3,'p_command_dmb_driver_bad_no_options','parser.py',294),
+  ('command -> OP_BUILTIN_OR_MODULE OP_MODULE error','command',3,'p_command_dmb_driver_bad_no_options','parser.py',295),
+  ('command -> OP_BUILTIN_OR_MODULE KW_DRIVER error','command',3,'p_command_dmb_driver_bad_no_options','parser.py',296),
+  ('command -> OP_DISABLE KW_MODALIAS str_list','command',3,'p_command_disable_modalias','parser.py',311),
+  ('command -> OP_MODULE KW_MODALIAS str_list','command',3,'p_command_module_modalias','parser.py',317),
+  ('command -> OP_BUILTIN KW_MODALIAS str_list','command',3,'p_command_builtin_modalias','parser.py',323),
+  ('command -> OP_BUILTIN_OR_MODULE KW_MODALIAS str_list','command',3,'p_command_builtin_or_module_modalias','parser.py',329),
+  ('command -> OP_DISABLE KW_MODALIAS error','command',3,'p_command_dmb_modalias_bad_no_options','parser.py',335),
+  ('command -> OP_MODULE KW_MODALIAS error','command',3,'p_command_dmb_modalias_bad_no_options','parser.py',336),
+  ('command -> OP_BUILTIN KW_MODALIAS error','command',3,'p_command_dmb_modalias_bad_no_options','parser.py',337),
+  ('command -> OP_BUILTIN_OR_MODULE KW_MODALIAS error','command',3,'p_command_dmb_modalias_bad_no_options','parser.py',338),
+  ('command -> OP_SET_TO STR STR','command',3,'p_command_set_to','parser.py',354),
+  ('command -> OP_APPEND STR STR','command',3,'p_command_append','parser.py',358),
+  ('command -> OP_ADD STR STR','command',3,'p_command_add','parser.py',362),
+  ('command -> OP_SET_TO error','command',2,'p_command_seapad_bad_missing_option','parser.py',366),
+  ('command -> OP_APPEND error','command',2,'p_command_seapad_bad_missing_option','parser.py',367),
+  ('command -> OP_ADD error','command',2,'p_command_seapad_bad_missing_option','parser.py',368),
+  ('command -> OP_SET_TO STR error','command',3,'p_command_seapad_bad_missing_value','parser.py',375),
+  ('command -> OP_APPEND STR error','command',3,'p_command_seapad_bad_missing_value','parser.py',376),
+  ('command -> OP_ADD STR error','command',3,'p_command_seapad_bad_missing_value','parser.py',377),
+  ('command -> STR EQ OP_DISABLE','command',3,'p_command_disable_assignop','parser.py',394),
+  ('command -> STR COL_EQ OP_DISABLE','command',3,'p_command_disable_assignop','parser.py',395),
+  ('command -> STR EQ OP_MODULE','command',3,'p_command_module_assignop','parser.py',400),
+  ('command -> STR COL_EQ OP_MODULE','command',3,'p_command_module_assignop','parser.py',401),
+  ('command -> STR EQ OP_BUILTIN','command',3,'p_command_builtin_assignop','parser.py',406),
+  ('command -> STR COL_EQ OP_BUILTIN','command',3,'p_command_builtin_assignop','parser.py',407),
+  ('command -> STR EQ OP_BUILTIN_OR_MODULE','command',3,'p_command_builtin_or_module_assignop','parser.py',412),
+  ('command -> STR COL_EQ OP_BUILTIN_OR_MODULE','command',3,'p_command_builtin_or_module_assignop','parser.py',413),
+  ('command -> STR EQ STR','command',3,'p_command_set_to_assignop','parser.py',420),
+  ('command -> STR COL_EQ STR','command',3,'p_command_set_to_assignop','parser.py',421),
+  ('command -> STR PLUS_EQ STR','command',3,'p_command_append_assignop','parser.py',426),
+  ('command -> STR BITOR_EQ STR','command',3,'p_command_add_assignop','parser.py',430),
+  ('command -> STR EQ error','command',3,'p_command_assignop_bad','parser.py',434),
+  ('command -> STR COL_EQ error','command',3,'p_command_assignop_bad','parser.py',435),
+  ('command -> STR PLUS_EQ error','command',3,'p_command_assignop_bad','parser.py',436),
+  ('command -> STR BITOR_EQ error','command',3,'p_command_assignop_bad','parser.py',437),
+  ('command -> OP_SET_TO STR EQ OP_DISABLE','command',4,'p_command_disable_seteq','parser.py',452),
+  ('command -> OP_SET_TO STR COL_EQ OP_DISABLE','command',4,'p_command_disable_seteq','parser.py',453),
+  ('command -> OP_SET_TO STR EQ OP_MODULE','command',4,'p_command_module_seteq','parser.py',458),
+  ('command -> OP_SET_TO STR COL_EQ OP_MODULE','command',4,'p_command_module_seteq','parser.py',459),
+  ('command -> OP_SET_TO STR EQ OP_BUILTIN','command',4,'p_command_builtin_seteq','parser.py',464),
+  ('command -> OP_SET_TO STR COL_EQ OP_BUILTIN','command',4,'p_command_builtin_seteq','parser.py',465),
+  ('command -> OP_SET_TO STR EQ OP_BUILTIN_OR_MODULE','command',4,'p_command_builtin_or_module_seteq','parser.py',470),
+  ('command -> OP_SET_TO STR COL_EQ OP_BUILTIN_OR_MODULE','command',4,'p_command_builtin_or_module_seteq','parser.py',471),
+  ('command -> OP_SET_TO STR EQ STR','command',4,'p_command_set_to_seteq','parser.py',478),
+  ('command -> OP_SET_TO STR COL_EQ STR','command',4,'p_command_set_to_seteq','parser.py',479),
+  ('command -> OP_SET_TO STR EQ error','command',4,'p_command_seteq_bad','parser.py',484),
+  ('command -> OP_SET_TO STR COL_EQ error','command',4,'p_command_seteq_bad','parser.py',485),
+  ('command -> OP_SET_TO STR PLUS_EQ error','command',4,'p_command_seteq_bad','parser.py',486),
+  ('command -> OP_SET_TO STR BITOR_EQ error','command',4,'p_command_seteq_bad','parser.py',487),
+  ('str_list -> STR','str_list',1,'p_str_list_one','parser.py',497),
+  ('str_list -> STR str_list','str_list',2,'p_str_list_many','parser.py',501),
+  ('cond_expr -> KW_PLACEHOLDER','cond_expr',1,'p_conditional_expr_prev_value','parser.py',509),
+  ('cond_expr -> KW_TRUE','cond_expr',1,'p_conditional_expr_true','parser.py',513),
+  ('cond_expr -> KW_FALSE','cond_expr',1,'p_conditional_expr_false','parser.py',517),
+  ('cond_expr -> KW_EXISTS STR','cond_expr',2,'p_conditional_expr_exists_explicit_arg','parser.py',521),
+  ('cond_expr -> KW_EXISTS','cond_expr',1,'p_conditional_expr_exists_implicit_arg','parser.py',525),
+  ('cond_expr -> KW_EXISTS KW_PLACEHOLDER','cond_expr',2,'p_conditional_expr_exists_implicit_arg','parser.py',526),
+  ('cond_expr -> LPAREN cond_expr RPAREN','cond_expr',3,'p_conditional_expr_in_parens','parser.py',530),
+  ('cond_expr -> NOT cond_expr','cond_expr',2,'p_conditional_expr_not','parser.py',534),
+  ('cond_expr -> cond_expr AND cond_expr','cond_expr',3,'p_conditional_expr_andor','parser.py',542),
+  ('cond_expr -> cond_expr OR cond_expr','cond_expr',3,'p_conditional_expr_andor','parser.py',543),
+  ('cond_expr -> STR NE STR','cond_expr',3,'p_conditional_expr_cmp','parser.py',552),
+  ('cond_expr -> STR GE STR','cond_expr',3,'p_conditional_expr_cmp','parser.py',553),
+  ('cond_expr -> STR LE STR','cond_expr',3,'p_conditional_expr_cmp','parser.py',554),
+  ('cond_expr -> STR GT STR','cond_expr',3,'p_conditional_expr_cmp','parser.py',555),
+  ('cond_expr -> STR LT STR','cond_expr',3,'p_conditional_expr_cmp','parser.py',556),
+  ('cond_expr -> STR EQ_CMP STR','cond_expr',3,'p_conditional_expr_cmp','parser.py',557),
+  ('cond_expr -> STR EQ STR','cond_expr',3,'p_conditional_expr_cmp','parser.py',558),
+]
@@ -0,0 +1,7 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+from .integrator import PMIntegration
+
+
+__all__ = ["PMIntegration"]
@@ -0,0 +1,190 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import json
+import os
+import tempfile
+import threading
+
+from ...abc import loggable
+from ...util import fs
+
+
+__all__ = ["PackageCache"]
+
+
+class PackageCache(loggable.AbstractLoggable):
+    """
+    Persistent cache for per-package results,
+    e.g. vdb variables or re-evaluated CONFIG_CHECK dicts.
+
+    Each entry records the mtime of the package's vdb directory,
+    which changes whenever the package gets (re-)installed,
+    and is only valid as long as the mtime does not change.
+    Entries of packages that were not accessed
+    since loading the cache are dropped when storing the cache.
+
+    The cache is loaded on first access, and may be accessed by
+    concurrent threads.
+
+    File format: JSON object
+      {"version": CACHE_FILE_VERSION, "packages": {cpv: [mtime_ns, value]}}
+    where value must be JSON-serializable.
+
+    @ivar cache_file:  cache file path
+    @type cache_file:  C{str}
+    """
+
+    CACHE_FILE_VERSION = 1
+
+    def __init__(self, cache_file, **kwargs):
+        super().__init__(**kwargs)
+        self.cache_file = cache_file
+        self._lock = threading.Lock()
+        self._entries = None
+        self._accessed = set()
+        self._modified = False
+    # --- end of __init__ (...) ---
+
+    def _load_entries(self):
+        cache_file = self.cache_file
+        try:
+            with open(cache_file, "rt") as fh:
+                data = json.load(fh)
+        except OSError:
+            self.logger.debug("No package cache file: %s", cache_file)
+            return {}
+        except ValueError as err:
+            self.logger.warning(
+                "Failed to read package cache file %s: %s", cache_file, err
+            )
+            return {}
+        # --
+
+        if (
+            not isinstance(data, dict)
+            or data.get("version") != self.CACHE_FILE_VERSION
+            or not isinstance(data.get("packages"), dict)
+        ):
+            self.logger.debug("Discarding package cache %s", cache_file)
+            return {}
+        # --
+
+        self.logger.debug("Read package cache %s", cache_file)
+        return data["packages"]
+    # --- end of _load_entries (...) ---
+
+    def _get_entries(self):
+        # must be called with the lock held
+        entries = self._entries
+        if entries is None:
+            entries = self._load_entries()
+            self._entries = entries
+        return entries
+    # --- end of _get_entries (...) ---
+
+    def get(self, cpv, mtime_ns):
+        """Returns the cached value for a package.
+
+        @raises KeyError:  if there is no valid entry for the package
+
+        @param cpv:       package cpv
+        @type  cpv:       C{str}
+        @param mtime_ns:  mtime of the package's vdb dir or None,
+                          entries are never valid for None
+        @type  mtime_ns:  C{int} or C{None}
+
+        @return:  value
+        """
+        if mtime_ns is None:
+            raise KeyError(cpv)
+
+        with self._lock:
+            entry = self._get_entries().get(cpv)
+            if not entry or entry[0] != mtime_ns:
+                raise KeyError(cpv)
+
+            self._accessed.add(cpv)
+            return entry[1]
+    # --- end of get (...) ---
+
+    def set(self, cpv, mtime_ns, value):
+        """Adds or replaces the cached value for a package.
+        Does nothing if mtime_ns is None.
+
+        @return:  None (implicit)
+        """
+        if mtime_ns is None:
+            return
+
+        with self._lock:
+            self._get_entries()[cpv] = [mtime_ns, value]
+            self._accessed.add(cpv)
+            self._modified = True
+    # --- end of set (...) ---
+
+    def store(self):
+        """Writes the cache file if entries have been added or dropped.
+
+        @return:  True on success or if there was nothing to write,
+                  else False
+        @rtype:   C{bool}
+        """
+        with self._lock:
+            entries = self._entries
+            if entries is None:
+                return True
+
+            accessed = self._accessed
+            if len(accessed) != len(entries):
+                entries = {
+                    cpv: entry for cpv, entry in entries.items()
+                    if cpv in accessed
+                }
+                self._entries = entries
+                self._modified = True
+            # --
+
+            if not self._modified:
+                return True
+
+            data = {
+                "version": self.CACHE_FILE_VERSION,
+                "packages": dict(entries)
+            }
+            self._modified = False
+        # --
+
+        cache_file = self.cache_file
+        tmp_file = None
+        try:
+            fs.dodir_for_file(cache_file)
+
+            # write to a temporary file and rename it afterwards,
+            # other processes may be reading the cache file concurrently
+            tmp_fd, tmp_file = tempfile.mkstemp(
+                prefix=".", suffix=".json", dir=os.path.dirname(cache_file)
+            )
+            os.fchmod(tmp_fd, 0o644)
+            with os.fdopen(tmp_fd, "wt") as fh:
+                json.dump(data, fh, separators=(",", ":"))
+
+            os.replace(tmp_file, cache_file)
+            tmp_file = None
+
+        except OSError as err:
+            self.logger.warning(
+                "Failed to write package cache file %s: %s", cache_file, err
+            )
+            return False
+
+        finally:
+            if tmp_file is not None:
+                fs.rmfile(tmp_file)
+        # --
+
+        self.logger.debug("Wrote package cache %s", cache_file)
+        return True
+    # --- end of store (...) ---
+
+# --- end of PackageCache ---
@@ -0,0 +1,320 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import hashlib
+import os
+
+from ...kconfig.abc import choicemodules
+from ...util import accudict
+from ...util import tmpdir as _tmpdir
+
+from . import overlay
+from . import base
+from . import util
+from . import _ebuildenv
+from . import _vdbcache
+
+__all__ = ["PMIntegration"]
+
+
+class PMIntegration(choicemodules.AbstractChoiceModule):
+    """
+    @ivar cache_dir:  cache directory for vdb variables and
+                      re-evaluated CONFIG_CHECK, or None
+    @type cache_dir:  C{str} or C{None}
+    """
+
+    # increment when changing the format of cached CONFIG_CHECK results
+    CONFIG_CHECK_CACHE_VERSION = 1
+
+    def __init__(
+        self, install_info, source_info,
+        tmpdir=None, parent_tmpdir=None,
+        port_iface=None,
+        **kwargs
+    ):
+        super().__init__(
+            install_info=install_info, source_info=source_info, **kwargs
+        )
+        self._tmpdir = _tmpdir.get_tmpdir_or_view(tmpdir, parent_tmpdir)
+
+        self._overlays = self.create_source_informed(
+            overlay.TemporaryOverlayUnion, self._tmpdir.dodir("overlays")
+        )
+
+        self.portage_tmpdir = self._tmpdir.get_subdir("tmp")
+
+        try:
+            self.cache_dir = (
+                self.install_info.get_cache_dirs("portagevdb").get_path()
+            )
+        except StopIteration:
+            self.cache_dir = None
+
+        if port_iface is None:
+            self.port_iface = self.create_loggable(
+                base.PortageInterface, cache_dir=self.cache_dir
+            )
+        else:
+            self.port_iface = port_iface
+        # --
+    # --- end of __init__ (...) ---
+
+    def enqueue_installed_packages(self):
+        port_iface = self.port_iface
+        overlays = self._overlays
+
+        any_package_added = False
+        for pkg_info in port_iface.map_packages(
+            port_iface.get_package_info,
+            port_iface.find_all_cpv_inheriting_linux_info()
+        ):
+            cpv = pkg_info.cpv
+
+#            # does *not* work: will ignore chromium,
+#            #                  for which CONFIG_CHECK is set in an eclass
+#            if not util.check_ebuild_file_uses_config_check(
+#                pkg_info.orig_ebuild_file
+#            ):
+#                self.logger.debug(
+#                    "Ignoring package %s: does not use CONFIG_CHECK",
+#                    pkg_info.cpv
+#                )
+#                continue
+
+            if overlays.add_package(pkg_info):
+                any_package_added = True
+            else:
+                self.logger.warning(
+                    (
+                        "Failed to enqueue package '%s' "
+                        "for CONFIG_CHECK re-evaluation"
+                    ),
+                    cpv
+                )
+        # --
+
+        return any_package_added
+    # --- end of enqueue_installed_packages (...) ---
+
+    def _create_config_check_map_from_accu(self, config_check_accu_map):
+        # dict: config_option => (dict :: value => cpv)
+        #   ==> dict: config_option => value
+
+        # build the actual config_check map, which is a normal dict
+        config_check_map = {}
+        for config_option, node in config_check_accu_map.items():
+            if not node:
+                raise AssertionError("empty config_check_accu_map node")
+
+            elif len(node) == 1:
+                value = next(iter(node))
+                assert value is True or value is False
+                config_check_map[config_option] = value
+
+            else:
+                assert True in node and False in node
+
+                # both True and False suggested for config_option
+                self.logger.warning(
+                    "Conflicting recommendations for config option %s",
+                    config_option
+                )
+                self.logger.warning(
+                    "want enabled: %s", ", ".join(node[True])
+                )
+                self.logger.warning(
+                    "want disabled: %s", ", ".join(node[False])
+                )
+                self.logger.warning(
+                    "Recommendation for %s will be ignored",
+                    config_option
+                )
+            # --
+        # --
+
+        return config_check_map
+    # --- end of _create_config_check_map_from_accu (...) ---
+
+    def get_config_check_cache(self):
+        """Returns the cache for re-evaluated CONFIG_CHECK results.
+
+        CONFIG_CHECK depends on the kernel sources,
+        so there is one cache file per srctree, arch and kernel version.
+
+        @return:  package cache or None if caching is disabled
+        @rtype:   L{PackageCache} or C{None}
+        """
+        if not self.cache_dir:
+            return None
+
+        env_vars = dict(self.source_info.iter_env_vars())
+        key_hash = hashlib.sha256()
+        for key_component in (
+            self.CONFIG_CHECK_CACHE_VERSION,
+            os.path.realpath(self.source_info.get_path()),
+            env_vars.get("ARCH"),
+            env_vars.get("SRCARCH"),
+            env_vars.get("KERNELVERSION")
+        ):
+            key_hash.update("{!s}\0".format(key_component).encode())
+        # --
+
+        return self.create_loggable(
+            _vdbcache.PackageCache,
+            os.path.join(
+                self.cache_dir,
+                "config-check-{}.json".format(key_hash.hexdigest())
+            )
+        )
+    # --- end of get_config_check_cache (...) ---
+
+    def eval_config_check(self):
+        """
+        Packages whose results are in the CONFIG_CHECK cache
+        are not re-evaluated, see get_config_check_cache().
+
+        @return: dict where keys are config option names,
+                 and values indicate whether an option should be enabled
+                 or disabled
+        @rtype:  C{dict} :: C{str} => C{bool}
+        """
+        overlays = self._overlays
+
+        if overlays.is_empty():
+            self.logger.info("No packages found - nothing to do")
+            return None
+        # --
+
+        config_check_cache = self.get_config_check_cache()
+        results = {}
+        uncached_packages = []
+
+        for package_info in overlays.iter_packages():
+            try:
+                if config_check_cache is None:
+                    raise KeyError(package_info.cpv)
+
+                results[package_info.cpv] = config_check_cache.get(
+                    package_info.cpv, package_info.vdb_mtime
+                )
+            except KeyError:
+                uncached_packages.append(package_info)
+            else:
+                self.logger.debug(
+                    "%s: using cached config recommendations",
+                    package_info.cpv
+                )
+        # --
+
+        if uncached_packages:
+            # the overlays and KBUILD_OUTPUT are only needed
+            # for running ebuild phases
+            overlays.setup(self.port_iface)
+            config_check_eval_env = self.create_informed(
+                _ebuildenv.ConfigCheckEbuildEnv,
+                tmpdir=self.portage_tmpdir
+            )
+            config_check_eval_env.setup(self.port_iface)
+
+            for package_info, (cpv, config_check_submap) in zip(
+                uncached_packages,
+                config_check_eval_env.iter_eval_config_check(
+                    uncached_packages
+                )
+            ):
+                results[cpv] = config_check_submap
+                if config_check_cache is not None:
+                    config_check_cache.set(
+                        cpv, package_info.vdb_mtime, config_check_submap
+                    )
+            # --
+        # --
+
+        if config_check_cache is not None:
+            config_check_cache.store()
+
+        config_check_accu_map = accudict.DictAccumulatorDict()
+        for package_info in overlays.iter_packages():
+            cpv = package_info.cpv
+            config_check_submap = results[cpv]
+            if config_check_submap:
+                for config_option, value in config_check_submap.items():
+                    config_check_accu_map.add(config_option, (value, cpv))
+        # --
+
+        return self._create_config_check_map_from_accu(config_check_accu_map)
+    # --- end of eval_config_check (...) ---
+
+    def get_package_build_time_config_check(self):
+        any_package_found = False
+
+        config_check_accu_map = accudict.DictAccumulatorDict()
+        for cpv, config_check_str in self.port_iface.zipmap_get_var(
+            self.port_iface.find_all_cpv_inheriting_linux_info(),
+            "CONFIG_CHECK"
+        ):
+            if config_check_str:
+                config_check_submap = util.parse_config_check(
+                    config_check_str, logger=self.logger
+                )
+                if config_check_submap:
+                    for config_option, value in config_check_submap.items():
+                        config_check_accu_map.add(config_option, (value, cpv))
+
+                    # unlikely enqueue_installed_packages(),
+                    # only packages with non-empty CONFIG_CHECK
+                    # count towards "any package found"
+                    any_package_found = True
+            # --
+        # --
+
+        if not any_package_found:
+            self.logger.info("No packages with non-empty CONFIG_CHECK found!")
+            return None
+        else:
+            return self._create_config_check_map_from_accu(
+                config_check_accu_map
+            )
+    # --- end of get_package_build_time_config_check (...) ---
+
+    def get_suggestions(self, *, re_eval=True, enqueue_installed=True):
+        """
+        @keyword re_eval:  whether to re-evaluate CONFIG_CHECK by running
+                           ebuild phases (True) or retrieve the package
+                           build-time value of CONFIG_CHECK (False).
+                           Defaults to "re-eval" (True).
+
+                           Note the re_eval=False does not work for
+                           packages that are not installed.
+        @type    re_eval:  C{bool}
+
+        @keyword enqueue_installed:  whether to add installed packages
+                                     to the temporary overlays
+                                     prior to getting suggestions
+                                     Defaults to True.
+
+                                     Has no effect when re_eval is False,
+                                     since "static CONFIG_CHECK" operates
+                                     on *all* installed packages only.
+        @type    enqueue_installed:  C{bool}
+
+        @return:  2-tuple (errors, config suggestions possibly None)
+        """
+        if re_eval:
+            if enqueue_installed:
+                if not self.enqueue_installed_packages():
+                    self.logger.info(
+                        "No packages inheriting linux-info found!"
+                    )
+            # --
+
+            config_check_map = self.eval_config_check()
+        else:
+            config_check_map = self.get_package_build_time_config_check()
+        # --
+
+        return (None, config_check_map)
+    # --- end of get_suggestions (...) ---
+
+# --- end of PMIntegration ---
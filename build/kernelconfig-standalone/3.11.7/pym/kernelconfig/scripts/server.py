@@ -0,0 +1,646 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import argparse
+import collections
+import concurrent.futures
+import copy
+import io
+import json
+import os
+import signal
+import socket
+import sys
+import tempfile
+import threading
+
+
+__all__ = ["KernelConfigServer", "send_request"]
+
+import kernelconfig.scripts.main
+
+import kernelconfig.abc.loggable
+import kernelconfig.kconfig.config.gen
+import kernelconfig.kernel.hwdetection.detector
+import kernelconfig.kernel.info
+import kernelconfig.util.osmisc
+
+
+class ServerRequestError(Exception):
+    """Invalid request, e.g. bad arguments."""
+    pass
+# ---
+
+
+class _RequestArgumentParser(argparse.ArgumentParser):
+    """
+    An argument parser that raises ServerRequestError
+    instead of exiting the process.
+    Help and usage messages are not sent to the client.
+    """
+
+    def _print_message(self, message, file=None):
+        pass
+
+    def exit(self, status=0, message=None):
+        raise ServerRequestError(message or "argument parser exited")
+
+    def error(self, message):
+        raise ServerRequestError(message)
+
+# --- end of _RequestArgumentParser ---
+
+
+class WarmSourceTree(kernelconfig.abc.loggable.AbstractLoggable):
+    """
+    The prepared source info, Kconfig symbols and hardware detectors
+    of a kernel sources directory and target architecture,
+    shared by all requests for that tree.
+
+    The Kconfig symbols are read-only, and lkc has already read
+    the Kconfig files into the tree's lkc context.
+    Hardware detectors are created on demand, one per modules dir config,
+    and have their modules map and modalias lookup loaded.
+
+    @ivar install_info:     install info
+    @type install_info:     L{InstallInfo}
+    @ivar source_info:      prepared source info,
+                            requests should work with a copy of it
+    @type source_info:      L{KernelInfo}
+    @ivar kconfig_symbols:  Kconfig symbols
+    @type kconfig_symbols:  L{KconfigSymbols}
+    @ivar stamp:            stats of the top-level Makefile and Kconfig file
+                            at creation time, see get_stamp()
+    @type stamp:            C{tuple}
+    """
+
+    @classmethod
+    def get_stamp(cls, srctree):
+        """Returns the stats of the files of a sources directory
+        that define the kernel version and the Kconfig symbols.
+        The tree needs to be recreated if they change.
+
+        @param srctree:  kernel sources directory
+        @type  srctree:  C{str}
+
+        @return:  stamp
+        @rtype:   C{tuple}
+        """
+        stamp = []
+        for name in ("Makefile", "Kconfig"):
+            try:
+                st = os.stat(os.path.join(srctree, name))
+            except OSError:
+                stamp.append(None)
+            else:
+                stamp.append((st.st_ino, st.st_size, st.st_mtime_ns))
+        # --
+        return tuple(stamp)
+    # --- end of get_stamp (...) ---
+
+    def __init__(self, install_info, source_info, **kwargs):
+        super().__init__(**kwargs)
+        self.install_info = install_info
+        self.source_info = source_info
+        self.stamp = self.get_stamp(source_info.srctree)
+        self.kconfig_symbols = None
+        self._hwdetectors = {}
+        self._lock = threading.Lock()
+    # --- end of __init__ (...) ---
+
+    def is_outdated(self):
+        return self.get_stamp(self.source_info.srctree) != self.stamp
+
+    def load(self):
+        """Prepares the source info and loads the Kconfig symbols.
+
+        @return: None (implicit)
+        """
+        source_info = self.source_info
+        source_info.prepare()
+
+        config_gen = self.create_loggable(
+            kernelconfig.kconfig.config.gen.KernelConfigGenerator,
+            install_info=self.install_info,
+            source_info=source_info,
+            modules_dir=False
+        )
+        kconfig_symbols = config_gen.get_kconfig_symbols()
+
+        # read the Kconfig files now if the symbols came from the cache
+        with kconfig_symbols.lkc_session():
+            pass
+
+        self.kconfig_symbols = kconfig_symbols
+        self.logger.info(
+            "Loaded %d Kconfig symbols from %s",
+            len(kconfig_symbols), source_info.srctree
+        )
+    # --- end of load (...) ---
+
+    def get_hwdetector(self, modules_dir_key, create_modules_dir):
+        """Returns the hardware detector for a modules dir config,
+        and creates it if necessary.
+
+        @param modules_dir_key:     hashable modules dir config
+        @param create_modules_dir:  no-arg function that creates
+                                    the modules dir, or returns None
+                                    if it is not available
+        @type  create_modules_dir:  callable
+
+        @return:  hardware detector or None
+        @rtype:   L{HWDetect} or C{None}
+        """
+        with self._lock:
+            try:
+                return self._hwdetectors[modules_dir_key]
+            except KeyError:
+                pass
+
+            modules_dir = create_modules_dir()
+            if modules_dir is None:
+                return None
+
+            hwdetector = self.create_loggable(
+                kernelconfig.kernel.hwdetection.detector.HWDetect,
+                install_info=self.install_info,
+                source_info=self.source_info,
+                modules_dir=modules_dir
+            )
+            hwdetector.get_modules_map().load()
+            hwdetector.get_modalias_map().lazy_init()
+
+            self._hwdetectors[modules_dir_key] = hwdetector
+            return hwdetector
+    # --- end of get_hwdetector (...) ---
+
+# --- end of WarmSourceTree ---
+
+
+class KernelConfigRequestScript(
+    kernelconfig.scripts.main.KernelConfigMainScript
+):
+    """
+    Runs the generate-config script mode for a server request,
+    using the server's warm source trees.
+
+    Log messages are written to log_stream.
+    If the request does not specify an output config file,
+    the config is written to the request directory
+    and config_file is set.
+
+    @ivar server:       server
+    @type server:       L{KernelConfigServer}
+    @ivar request_dir:  private temporary directory of the request
+    @type request_dir:  C{str}
+    @ivar log_stream:   log messages
+    @type log_stream:   L{io.StringIO}
+    @ivar warm_tree:    source tree of the request, set when parsing args
+    @type warm_tree:    L{WarmSourceTree} or C{None}
+    @ivar config_file:  output config file if it should be returned
+                        to the client, else None
+    @type config_file:  C{str} or C{None}
+    """
+
+    def __init__(self, prog, server, request_dir):
+        super().__init__(prog)
+        self.server = server
+        self.request_dir = request_dir
+        self.install_info = server.install_info
+        self.log_stream = io.StringIO()
+        self.warm_tree = None
+        self.config_file = None
+
+        # each worker thread handles one request at a time,
+        # so its loggers can be reused for later requests
+        self.set_logger(
+            logger_name=threading.current_thread().name,
+            parent_logger=server.logger
+        )
+    # --- end of __init__ (...) ---
+
+    def cleanup(self):
+        self.zap_log_handlers()
+        super().cleanup()
+
+    def new_arg_parser(self, **kwargs):
+        return _RequestArgumentParser(**kwargs)
+
+    def do_main_setup_logging(self, arg_config):
+        self.zap_log_handlers()
+        self.setup_console_logging(
+            self.get_log_level(arg_config), outstream=self.log_stream
+        )
+    # ---
+
+    def do_main_setup_source_info(self, arg_config, *, null_fallback=False):
+        srctree = arg_config.get("srctree")
+        if not srctree:
+            raise ServerRequestError("kernel sources directory not specified")
+
+        self.warm_tree = self.server.get_warm_tree(
+            srctree, arg_config.get("arch")
+        )
+        # the config generator takes over ownership of source_info
+        self.source_info = copy.copy(self.warm_tree.source_info)
+    # --- end of do_main_setup_source_info (...) ---
+
+    def do_main_create_config_generator(self, arg_config):
+        mod_dir_config = arg_config.get("modules_dir")
+        if mod_dir_config:
+            mod_dir_path = mod_dir_config.path
+            mod_dir_key = (
+                (
+                    mod_dir_path if mod_dir_path in {None, True}
+                    else str(mod_dir_path)
+                ),
+                mod_dir_config.is_optional
+            )
+        else:
+            mod_dir_key = mod_dir_config
+        # --
+
+        hwdetector = self.warm_tree.get_hwdetector(
+            (mod_dir_key, arg_config["unsafe_modalias"]),
+            lambda: self.do_main_get_modules_dir(arg_config)
+        )
+        if hwdetector is None:
+            # already logged
+            return None
+
+        return self.create_loggable(
+            kernelconfig.kconfig.config.gen.KernelConfigGenerator,
+            install_info=self.install_info,
+            source_info=self.source_info,
+            kconfig_symbols=self.warm_tree.kconfig_symbols,
+            hwdetector=hwdetector
+        )
+    # --- end of do_main_create_config_generator (...) ---
+
+    def do_main(self, arg_config):
+        script_mode_config = arg_config["script_mode"]
+        if isinstance(script_mode_config, tuple):
+            script_mode = script_mode_config[0]
+        else:
+            script_mode = script_mode_config
+
+        if script_mode and script_mode != "generate-config":
+            raise ServerRequestError(
+                "unsupported script mode: {}".format(script_mode)
+            )
+        # --
+
+        if not arg_config.get("outconfig"):
+            self.config_file = os.path.join(self.request_dir, "config")
+            arg_config["outconfig"] = self.config_file
+        # --
+
+        return self.do_main_script_genconfig(arg_config)
+    # --- end of do_main (...) ---
+
+# --- end of KernelConfigRequestScript ---
+
+
+class KernelConfigServer(kernelconfig.abc.loggable.AbstractLoggable):
+    """
+    Generates kernel configuration files for requests
+    received over a Unix socket.
+
+    The server keeps the Kconfig symbols and hardware detection data
+    of recently used kernel sources directories in memory
+    (see L{WarmSourceTree}), up to MAX_WARM_TREES trees.
+    Requests are handled concurrently by SERVER_JOBS worker threads,
+    which share the trees' symbols read-only.
+    Calls into lkc are serialized, see KconfigSymbols.lkc_session().
+
+    Protocol: the client sends requests as JSON objects,
+    one per line, and gets a JSON response line for each request.
+    All paths are interpreted by the server,
+    relative paths are relative to the server's working directory.
+
+    Request:
+      argv           := command line arguments for generate-config,
+                        "-k <srctree>" is required.
+                        Defaults to [].
+      settings_data  := settings file content (str), optional,
+                        overrides "-s" in argv
+      hwdetect_data  := hwcollect data (JSON object), optional,
+                        overrides "-H" in argv
+
+    Response:
+      exit_code      := kernelconfig exit code
+      error          := error message or None
+      config         := generated config (str) if argv has no "-O" option,
+                        else None
+      log            := log messages (str), as for the console
+
+    @ivar socket_path:   path to the Unix socket
+    @type socket_path:   C{str}
+    @ivar install_info:  install info
+    @type install_info:  L{InstallInfo}
+    """
+
+    SERVER_JOBS = kernelconfig.util.osmisc.envint(
+        "KERNELCONFIG_SERVER_JOBS",
+        (kernelconfig.util.osmisc.get_cpu_count() or 1)
+    )
+
+    MAX_WARM_TREES = kernelconfig.util.osmisc.envint(
+        "KERNELCONFIG_SERVER_TREES", 8
+    )
+
+    MAX_REQUEST_SIZE = 2**24
+
+    PROG_NAME = "kernelconfig"
+
+    EX_OK = kernelconfig.scripts.main.KernelConfigMainScript.EX_OK
+    EX_ERR = kernelconfig.scripts.main.KernelConfigMainScript.EX_ERR
+    EX_USAGE = kernelconfig.scripts.main.KernelConfigMainScript.EX_USAGE
+
+    def __init__(self, socket_path, *, install_info, **kwargs):
+        super().__init__(**kwargs)
+        self.socket_path = socket_path
+        self.install_info = install_info
+        # (srctree, arch) => warm tree, least recently used first
+        self._warm_trees = collections.OrderedDict()
+        self._warm_trees_lock = threading.Lock()
+    # --- end of __init__ (...) ---
+
+    def get_warm_tree(self, srctree, arch=None):
+        """Returns the warm source tree for a kernel sources directory
+        and target architecture, and loads it if necessary.
+
+        Trees are loaded one at a time.
+
+        @raises ServerRequestError:  not a kernel sources directory
+
+        @param srctree:  kernel sources directory
+        @type  srctree:  C{str}
+        @param arch:     target architecture or None
+        @type  arch:     C{str} or C{None}
+
+        @return:  warm tree
+        @rtype:   L{WarmSourceTree}
+        """
+        srctree = os.path.realpath(srctree)
+        key = (srctree, arch)
+
+        with self._warm_trees_lock:
+            warm_tree = self._warm_trees.get(key)
+            if warm_tree is not None:
+                if not warm_tree.is_outdated():
+                    self._warm_trees.move_to_end(key)
+                    return warm_tree
+
+                self.logger.info("Reloading changed tree %s", srctree)
+                del self._warm_trees[key]
+            # --
+
+            source_info = self.create_loggable(
+                kernelconfig.kernel.info.KernelInfo, srctree, arch=arch
+            )
+            if not source_info.check_srctree():
+                raise ServerRequestError(
+                    "{!r} does not appear to be a kernel sources directory"
+                    .format(srctree)
+                )
+            # --
+
+            warm_tree = self.create_loggable(
+                WarmSourceTree, self.install_info, source_info
+            )
+            warm_tree.load()
+
+            self._warm_trees[key] = warm_tree
+            while len(self._warm_trees) > max(1, self.MAX_WARM_TREES):
+                self._warm_trees.popitem(last=False)
+
+            return warm_tree
+    # --- end of get_warm_tree (...) ---
+
+    def handle_request(self, request):
+        """Handles a single request.
+
+        @param request:  request, see class docstring
+        @type  request:  C{dict}
+
+        @return:  response, see class docstring
+        @rtype:   C{dict}
+        """
+        def get_str_list(value):
+            if not isinstance(value, list) or not all(
+                isinstance(item, str) for item in value
+            ):
+                raise ServerRequestError("argv must be a list of str")
+            return list(value)
+        # ---
+
+        response = {
+            "exit_code": self.EX_ERR, "error": None,
+            "config": None, "log": None
+        }
+
+        try:
+            if not isinstance(request, dict):
+                raise ServerRequestError("request must be an object")
+
+            argv = get_str_list(request.get("argv", []))
+
+        except ServerRequestError as err:
+            response["exit_code"] = self.EX_USAGE
+            response["error"] = str(err)
+            return response
+        # --
+
+        with tempfile.TemporaryDirectory(
+            prefix="kernelconfig-request-"
+        ) as request_dir:
+            settings_data = request.get("settings_data")
+            if settings_data is not None:
+                settings_file = os.path.join(request_dir, "settings")
+                with open(settings_file, "wt") as fh:
+                    fh.write(str(settings_data))
+                argv.extend(["-s", settings_file])
+            # --
+
+            hwdetect_data = request.get("hwdetect_data")
+            if hwdetect_data is not None:
+                hwdetect_file = os.path.join(request_dir, "hwdetect.json")
+                with open(hwdetect_file, "wt") as fh:
+                    json.dump(hwdetect_data, fh)
+                argv.extend(["-H", hwdetect_file])
+            # --
+
+            with KernelConfigRequestScript(
+                self.PROG_NAME, self, request_dir
+            ) as script:
+                try:
+                    exit_code = script.run(argv)
+
+                except ServerRequestError as err:
+                    exit_code = self.EX_USAGE
+                    response["error"] = str(err)
+
+                except Exception as err:  # pylint: disable=W0703
+                    exit_code = self.EX_ERR
+                    response["error"] = str(err) or err.__class__.__name__
+                    script.logger.exception("Request failed")
+
+                else:
+                    if exit_code is True or exit_code is None:
+                        exit_code = self.EX_OK
+                    elif exit_code is False:
+                        exit_code = self.EX_ERR
+                # --
+
+                response["exit_code"] = exit_code
+                response["log"] = script.log_stream.getvalue()
+
+                if exit_code == self.EX_OK and script.config_file:
+                    with open(script.config_file, "rt") as fh:
+                        response["config"] = fh.read()
+            # --
+        # --
+
+        return response
+    # --- end of handle_request (...) ---
+
+    def handle_connection(self, conn):
+        """Reads requests from a client connection and sends responses,
+        until the client closes the connection.
+
+        @return: None (implicit)
+        """
+        with conn, conn.makefile("rwb") as conn_file:
+            keep_open = True
+            while keep_open:
+                line = conn_file.readline(self.MAX_REQUEST_SIZE + 1)
+                if not line:
+                    break
+
+                elif len(line) > self.MAX_REQUEST_SIZE:
+                    # the remainder of the line cannot be skipped reliably
+                    keep_open = False
+                    response = {
+                        "exit_code": self.EX_USAGE,
+                        "error": "request too large"
+                    }
+
+                else:
+                    try:
+                        request = json.loads(line.decode("utf-8"))
+                    except ValueError as err:
+                        response = {
+                            "exit_code": self.EX_USAGE,
+                            "error": "malformed request: {}".format(err)
+                        }
+                    else:
+                        response = self.handle_request(request)
+                # --
+
+                conn_file.write(json.dumps(response).encode("utf-8"))
+                conn_file.write(b"\n")
+                conn_file.flush()
+            # --
+        # --
+    # --- end of handle_connection (...) ---
+
+    def _handle_connection_noraise(self, conn):
+        try:
+            self.handle_connection(conn)
+        except OSError as err:
+            self.logger.warning("Lost client connection: %s", err)
+        except Exception:
+            self.logger.exception("Failed to handle client connection")
+    # --- end of _handle_connection_noraise (...) ---
+
+    def serve_forever(self):
+        """Accepts client connections until SIGTERM or SIGINT is received.
+
+        @return:  True
+        @rtype:   C{bool}
+        """
+        def handle_sigterm(signum, frame):
+            sys.exit(0)
+
+        if os.path.exists(self.socket_path):
+            # remove a stale socket file
+            try:
+                with socket.socket(socket.AF_UNIX) as sock:
+                    sock.connect(self.socket_path)
+            except OSError:
+                os.unlink(self.socket_path)
+            else:
+                raise OSError(
+                    "server is already running: {}".format(self.socket_path)
+                )
+        # --
+
+        prev_sigterm_handler = signal.signal(signal.SIGTERM, handle_sigterm)
+
+        server_sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            server_sock.bind(self.socket_path)
+            server_sock.listen()
+            self.logger.info(
+                "Listening on %s with %d workers",
+                self.socket_path, max(1, self.SERVER_JOBS)
+            )
+
+            with concurrent.futures.ThreadPoolExecutor(
+                max_workers=max(1, self.SERVER_JOBS),
+                thread_name_prefix="request"
+            ) as executor:
+                try:
+                    while True:
+                        conn, _ = server_sock.accept()
+                        executor.submit(self._handle_connection_noraise, conn)
+                except (KeyboardInterrupt, SystemExit):
+                    self.logger.info("Shutting down")
+            # --
+
+        finally:
+            server_sock.close()
+            try:
+                os.unlink(self.socket_path)
+            except OSError:
+                pass
+            signal.signal(signal.SIGTERM, prev_sigterm_handler)
+        # --
+
+        return True
+    # --- end of serve_forever (...) ---
+
+# --- end of KernelConfigServer ---
+
+
+def send_request(socket_path, argv, settings_data=None, hwdetect_data=None):
+    """Sends a request to a kernelconfig server and returns the response,
+    see L{KernelConfigServer} for details.
+
+    @param socket_path:    path to the server's Unix socket
+    @type  socket_path:    C{str}
+    @param argv:           command line arguments for generate-config
+    @type  argv:           C{list} of C{str}
+    @param settings_data:  settings file content or None
+    @type  settings_data:  C{str} or C{None}
+    @param hwdetect_data:  hwcollect data or None
+    @type  hwdetect_data:  C{dict} or C{None}
+
+    @return:  response
+    @rtype:   C{dict}
+    """
+    request = {"argv": list(argv)}
+    if settings_data is not None:
+        request["settings_data"] = settings_data
+    if hwdetect_data is not None:
+        request["hwdetect_data"] = hwdetect_data
+
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(socket_path)
+        with sock.makefile("rwb") as sock_file:
+            sock_file.write(json.dumps(request).encode("utf-8"))
+            sock_file.write(b"\n")
+            sock_file.flush()
+            return json.loads(sock_file.readline().decode("utf-8"))
+# --- end of send_request (...) ---
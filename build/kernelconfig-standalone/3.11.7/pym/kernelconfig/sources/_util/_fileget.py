@@ -0,0 +1,53 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+from ..abc import exc
+from ...util import fileget as _orig_fileget
+
+
+__all__ = ["get_file", "get_file_write_to_file", "get_files_write_to_files"]
+
+
+def get_file(url, data=None, **kwargs):
+    try:
+        return _orig_fileget.get_file(url, data=data, **kwargs)
+
+    except (OSError, IOError):
+        raise exc.ConfigurationSourceFileGetError(url) from None
+# ---
+
+
+def get_file_write_to_file(filepath, url, data=None, **kwargs):
+    try:
+        return _orig_fileget.get_file_write_to_file(
+            filepath, url, data=data, **kwargs
+        )
+    except (OSError, IOError):
+        raise exc.ConfigurationSourceFileGetError(url) from None
+# ---
+
+
+def get_files_write_to_files(
+    requests, data=None, *, return_exceptions=False, **kwargs
+):
+    requests = list(requests)
+    results = _orig_fileget.get_files_write_to_files(
+        requests, data=data, return_exceptions=True, **kwargs
+    )
+
+    for k, err in enumerate(results):
+        if isinstance(err, (OSError, IOError)):
+            results[k] = exc.ConfigurationSourceFileGetError(
+                requests[k][1], exc_info=(type(err), err, err.__traceback__)
+            )
+        elif err is not None and not return_exceptions:
+            raise err
+    # --
+
+    if return_exceptions:
+        return results
+
+    for err in results:
+        if err is not None:
+            raise err
+# ---
@@ -0,0 +1,19 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+from .command import CommandConfigurationSource
+from .fileuri import FileConfigurationSource
+from .locfile import LocalFileConfigurationSource
+from .mk import MakeConfigurationSource
+from .pym import PymConfigurationSource
+from .script import ScriptConfigurationSource
+
+
+__all__ = [
+    "CommandConfigurationSource",
+    "FileConfigurationSource",
+    "LocalFileConfigurationSource",
+    "MakeConfigurationSource",
+    "PymConfigurationSource",
+    "ScriptConfigurationSource",
+]
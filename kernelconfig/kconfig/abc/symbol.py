@@ -60,13 +60,17 @@ class AbstractKconfigSymbol(AbstractKconfigDepObject):
                     list of dependency expressions
     @type defaults: C{None} or undef
 
+    and, if it has been read from lkc, its dense lkc symbol index
+    @ivar index:    symbol index, see lkconfig.get_symbol_index(). May be None.
+    @type index:    C{None} or C{int}
+
     Additionally, a class-wide variables exists for str-formatting the
     option in case of "is not set" values:
     @cvar VALUE_NOT_SET_FMT_STR: used for formatting "not set" values
     @type VALUE_NOT_SET_FMT_STR: C{str}
     """
 
-    __slots__ = ["__weakref__", "name", "defaults"]
+    __slots__ = ["__weakref__", "name", "defaults", "index"]
 
     VALUE_NOT_SET_FMT_STR = "# {name} is not set"
 
@@ -235,10 +239,13 @@ class AbstractKconfigSymbol(AbstractKconfigDepObject):
         raise NotImplementedError()
     # ---
 
-    def __init__(self, name, dir_dep=None, vis_dep=None, defaults=None):
+    def __init__(
+        self, name, dir_dep=None, vis_dep=None, defaults=None, index=None
+    ):
         super().__init__(dir_dep=dir_dep, vis_dep=vis_dep)
         self.name = name
         self.defaults = None
+        self.index = index
 
     def __hash__(self):
         return hash((self.__class__, self.name))
@@ -49,10 +49,14 @@ class _ConfigChoiceModules(_choicemodules_abc.AbstractChoiceModules):
 class KernelConfigChoiceModules(_ConfigChoiceModules):
 
     def __init__(
-        self, *, modules_dir=True, tmpdir=None, parent_tmpdir=None, **kwargs
+        self, *, modules_dir=True, hwdetector=None,
+        tmpdir=None, parent_tmpdir=None, **kwargs
     ):
+        # hwdetector: initialized HWDetect object or None,
+        #             which may be shared with other choice modules
         self._config = {
-            "modules_dir": modules_dir
+            "modules_dir": modules_dir,
+            "hwdetector": hwdetector
         }
 
         if tmpdir is None and parent_tmpdir is None:
@@ -71,6 +75,9 @@ class KernelConfigChoiceModules(_ConfigChoiceModules):
 
     def create_dynamic_module_hwdetector(self):
         # NOTE: changes to _config will not affect already loaded modules
+        if self._config["hwdetector"] is not None:
+            return self._config["hwdetector"]
+
         return self.create_informed(
             detector.HWDetect, modules_dir=self._config["modules_dir"]
         )
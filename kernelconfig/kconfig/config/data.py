@@ -4,11 +4,9 @@
 import collections
 import collections.abc
 import re
-import shutil
 
 from ...abc import loggable
 from ...util import fileio
-from ...util import tmpdir
 from .. import symbol
 from .. import lkconfig
 
@@ -58,6 +56,22 @@ class ConfigFileReader(loggable.AbstractLoggable):
                   )
                 )
         """
+        if (
+            not kwargs
+            and isinstance(infile, str)
+            and not fileio.check_is_compressed(infile)
+        ):
+            entries = self._read_entries_lkconfig(infile)
+            if entries is not None:
+                for lino, option, value in entries:
+                    if value is None:
+                        yield (lino, option, None)
+                    else:
+                        yield (lino, option, symbol.unpack_value_str(value))
+                return
+            # -- else fall back to the regex-based reader
+        # --
+
         _unpack_value = symbol.unpack_value_str
 
         option_value_regexp = re.compile(
@@ -67,7 +81,7 @@ class ConfigFileReader(loggable.AbstractLoggable):
         )
 
         option_unset_regexp = re.compile(
-            r'^[#]\s*(?P<option>{oexpr})\s+is\s+not\s+set$'.format(
+            r'^[#]\s*(?P<option>{oexpr})\s+is\s+not\s+set'.format(
                 oexpr=self.option_expr_str
             )
         )
@@ -103,6 +117,28 @@ class ConfigFileReader(loggable.AbstractLoggable):
                 # -- end if opt=val?
             # -- end if line
     # --- end of read_file (...) ---
+
+    def _read_entries_lkconfig(self, infile):
+        """Reads a .config file with lkconfig's streaming reader,
+        which tokenizes the mmap-ed file in place.
+
+        Files with unexpected data and files that cannot be read
+        are not handled here, read_file() falls back to the regex-based
+        reader for them, which reports errors in the same order as always.
+
+        @param infile:  path to an uncompressed .config file
+        @type  infile:  C{str}
+
+        @return: None or list of 3-tuples (
+                   line number, option name, None or value str)
+        @rtype:  C{None} or C{list} of 3-tuple (
+                   C{int}, C{str}, C{None}|C{str})
+        """
+        try:
+            return lkconfig.read_config_file(infile)
+        except (ValueError, OSError):
+            return None
+    # --- end of _read_entries_lkconfig (...) ---
 # --- end of ConfigFileReader ---
 
 
@@ -261,6 +297,48 @@ class _Config(loggable.AbstractLoggable, collections.abc.Mapping):
     def __iter__(self):
         return iter(self._config)
 
+    def _normalize_symbol_value(self, sym, vtype, inval):
+        """Normalizes and validates a value read from a config file
+        or from lkconfig.
+
+        Improper values are normalized in lenient mode,
+        and a warning is logged.
+
+        @raises ValueError: value invalid even in lenient mode
+
+        @param sym:    kconfig symbol
+        @type  sym:    subclass of L{AbstractKconfigSymbol}
+        @param vtype:  value type, only used for logging
+        @type  vtype:  L{symbol.KconfigSymbolValueType} or C{str}
+        @param inval:  value
+
+        @return:  normalized value
+        """
+        try:
+            normval = sym.normalize_and_validate(inval)
+        except ValueError:
+            try:
+                normval = sym.normalize_and_validate(inval, lenient=True)
+            except ValueError:
+                self.logger.warning(
+                    "invalid %s value %r for %s symbol %s",
+                    vtype, inval, sym.type_name, sym.name
+                )
+                raise
+            else:
+                self.logger.warning(
+                    (
+                        'improper %s value %r for %s symbol %s, '
+                        'normalized to %r'
+                    ),
+                    vtype, inval, sym.type_name, sym.name, normval
+                )
+            # -- end try again
+        # -- end try
+
+        return normval
+    # --- end of _normalize_symbol_value (...) ---
+
     def _read_config_files(self, cfg_dict, infiles):
         """Reads a zero or (preferably) more config files and stores
         a mapping :: <kconfig symbol> => <value> in the given config dict.
@@ -278,31 +356,7 @@ class _Config(loggable.AbstractLoggable, collections.abc.Mapping):
         @return:          cfg_dict
         """
 
-        def normalize_sym_value(sym, vtype, inval):
-            try:
-                normval = sym.normalize_and_validate(inval)
-            except ValueError:
-                try:
-                    normval = sym.normalize_and_validate(inval, lenient=True)
-                except ValueError:
-                    self.logger.warning(
-                        "invalid %s value %r for %s symbol %s",
-                        vtype, inval, sym.type_name, sym.name
-                    )
-                    raise
-                else:
-                    self.logger.warning(
-                        (
-                            'improper %s value %r for %s symbol %s, '
-                            'normalized to %r'
-                        ),
-                        vtype, inval, sym.type_name, sym.name, normval
-                    )
-                # -- end try again
-            # -- end try
-
-            return normval
-        # --- end of normalize_sym_value (...) ---
+        normalize_sym_value = self._normalize_symbol_value
 
         get_symbol_name = self.convert_option_to_symbol_name
 
@@ -456,47 +510,129 @@ class _Config(loggable.AbstractLoggable, collections.abc.Mapping):
 
 
 class Config(_Config):
+    """
+    A config that keeps itself consistent by running lkconfig's oldconfig
+    whenever changes get incorporated.
+
+    oldconfig runs in-memory, the resolved config values are kept
+    as returned by lkconfig and converted lazily by prepare().
+
+    @ivar _decision_symbols:        symbols whose values should be passed
+                                    to oldconfig as decisions
+    @type _decision_symbols:        C{None} or iterable
+    @ivar _oldconfig_values:        resolved config values dict
+                                    from the last oldconfig run, or None
+    @type _oldconfig_values:        C{None} or C{dict} :: C{str} => _
+    @ivar _oldconfig_load_required: whether the config dict needs to be
+                                    replaced with the oldconfig values
+    @type _oldconfig_load_required: C{bool}
+    """
 
     def __init__(self, *args, **kwargs):
         super().__init__(*args, **kwargs)
         self._decision_symbols = None
-        self._tmpdir = None
-        self._tmpconfig = None
-        self._tmpconfig_load_required = False
+        self._oldconfig_values = None
+        self._oldconfig_load_required = False
     # --- end of __init__ (...) ---
 
-    def get_tmpdir(self):
-        tdir = self._tmpdir
-        if tdir is None:
-            self.logger.debug("Creating temporary directory for config files")
-            tdir = tmpdir.Tmpdir(suffix=".kernelconfig")
-            self._tmpdir = tdir
-            self.logger.debug("Temporary directory is %r", tdir.get_filepath())
+    def get_lkconfig_values(self):
+        """Returns the current configuration as config values dict,
+        suitable for passing it to lkconfig.oldconfig_values().
+
+        Disabled symbols are listed as "is not set" (None).
+
+        @return:  config values dict
+        @rtype:   C{dict} :: C{str} => C{None}|C{int}|C{str}
+        """
+        return {
+            sym.name: (sym.get_lkconfig_value_repr(val) if val else None)
+            for sym, val in self.iter_config()
+        }
+    # --- end of get_lkconfig_values (...) ---
+
+    def get_lkconfig_values_list(self):
+        """Returns the current configuration as config values list
+        indexed by lkc symbol index, see lkconfig.oldconfig_values(),
+        which saves the symbol name lookups in lkc.
+
+        Disabled tristate/boolean symbols are listed as 0,
+        other disabled symbols and symbols not in the config as None.
+
+        @return:  config values list, or None if the config contains
+                  symbols without lkc symbol index
+        @rtype:   C{list} of C{None}|C{int}|C{str}, or C{None}
+        """
+        values = [None] * self._kconfig_symbols.get_index_count()
+
+        for sym, val in self.iter_config():
+            if sym.index is None:
+                return None
+
+            elif val or not symbol.is_stringlike_symbol(sym):
+                values[sym.index] = sym.get_lkconfig_value_repr(val)
+        # --
+
+        return values
+    # --- end of get_lkconfig_values_list (...) ---
+
+    def _read_config_values(self, cfg_dict, config_values):
+        """Stores the values from a lkconfig config values dict
+        in the given config dict.
+
+        @raises ValueError: bad value
+
+        @param cfg_dict:       dict for storing config options
+        @type  cfg_dict:       C{dict}:: L{AbstractKconfigSymbol} => _
+        @param config_values:  config values dict
+        @type  config_values:  C{dict} :: C{str} => C{None}|C{int}|C{str}
+
+        @return:  cfg_dict
+        """
+        normalize_sym_value = self._normalize_symbol_value
+        kconfig_syms = self._kconfig_symbols
+
+        for symbol_name, value in config_values.items():
+            try:
+                sym = kconfig_syms[symbol_name]
+            except KeyError:
+                self.logger.debug(
+                    "oldconfig returned unknown symbol %s, ignoring",
+                    symbol_name
+                )
+            else:
+                if value is None:
+                    cfg_dict[sym] = None
+                else:
+                    cfg_dict[sym] = normalize_sym_value(
+                        sym, sym.type_name, value
+                    )
+            # --
         # --
-        return tdir
-    # --- end of get_tmpdir (...) ---
 
-    def _load_tmpconfig_if_needed(self):
-        if self._tmpconfig_load_required:
-            self.logger.debug("Loading temporary oldconfig")
+        return cfg_dict
+    # --- end of _read_config_values (...) ---
+
+    def _load_oldconfig_if_needed(self):
+        if self._oldconfig_load_required:
+            self.logger.debug("Loading oldconfig values")
             cfg_dict = self.get_new_config_dict(update=False)
-            self._read_config_files(cfg_dict, [(self._tmpconfig, None)])
-            self._replace_config_dict(cfg_dict, tmpconfig_invalidate=False)
+            self._read_config_values(cfg_dict, self._oldconfig_values)
+            self._replace_config_dict(cfg_dict, oldconfig_invalidate=False)
             # decision symbols do not accumulate when configuring
             # multiple times
             self._decision_symbols = None
-            self._tmpconfig_load_required = False
+            self._oldconfig_load_required = False
         # --
     # ---
 
     def prepare(self):
-        self._load_tmpconfig_if_needed()
+        self._load_oldconfig_if_needed()
     # ---
 
-    def _replace_config_dict(self, cfg_dict, tmpconfig_invalidate=True):
-        if tmpconfig_invalidate:
-            self._tmpconfig = None
-            self._tmpconfig_load_required = False
+    def _replace_config_dict(self, cfg_dict, oldconfig_invalidate=True):
+        if oldconfig_invalidate:
+            self._oldconfig_values = None
+            self._oldconfig_load_required = False
         # --
 
         super()._replace_config_dict(cfg_dict)
@@ -505,10 +641,10 @@ class Config(_Config):
     def _incorporate_changes(self, cfg_dict, decision_syms):
         super()._incorporate_changes(cfg_dict, decision_syms)
         self._decision_symbols = decision_syms
-        self._write_oldconfig()
+        self._run_oldconfig()
     # ---
 
-    def _write_oldconfig(self):
+    def _run_oldconfig(self):
         if self._decision_symbols:
             decisions = {
                 sym.name: sym.get_lkconfig_value_repr(self._config[sym])
@@ -518,42 +654,118 @@ class Config(_Config):
             decisions = {}
         # --
 
-        tdir = self.get_tmpdir()
-        tmp_inconfig = tdir.get_filepath("inconfig")
-        tmp_outconfig = tdir.get_filepath("outconfig")
+        self.logger.debug("Running oldconfig")
 
-        self._write_config_file(tmp_inconfig)
-
-        self.logger.debug("Running oldconfig, writing to %r", tmp_outconfig)
-        lkconfig.oldconfig(
-            tmp_inconfig, tmp_outconfig, decisions,
-            logger=self.get_child_logger("lkconfig.oldconfig")
-        )
+        config_values = self.get_lkconfig_values_list()
+        if config_values is None:
+            config_values = self.get_lkconfig_values()
 
-        self.logger.debug("Temporary oldconfig file is ready.")
-        self._tmpconfig = tmp_outconfig
-        self._tmpconfig_load_required = True
-    # --- end of _write_oldconfig (...) ---
+        with self._kconfig_symbols.lkc_session():
+            # full mode, incremental invalidation is checked by
+            # build-scripts/check-incremental-oldconfig.py only
+            self._oldconfig_values = lkconfig.oldconfig_values(
+                config_values, decisions,
+                logger=self.get_child_logger("lkconfig.oldconfig"),
+                incremental=False
+            )
+        self._oldconfig_load_required = True
+    # --- end of _run_oldconfig (...) ---
 
-    def _write_oldconfig_if_needed(self):
-        if self._decision_symbols and not self._tmpconfig:
-            self._write_oldconfig()
-            assert self._tmpconfig
-    # --- end of _write_oldconfig_if_needed (...) ---
+    def _run_oldconfig_if_needed(self):
+        if self._decision_symbols and self._oldconfig_values is None:
+            self._run_oldconfig()
+            assert self._oldconfig_values is not None
+    # --- end of _run_oldconfig_if_needed (...) ---
 
     def write_config_file(self, outfile, filename=None, **kwargs):
-        self._write_oldconfig_if_needed()
+        self._run_oldconfig_if_needed()
 
-        if self._tmpconfig:
+        if self._oldconfig_values is not None:
+            # the oldconfig values are already resolved,
+            # so running oldconfig again only writes the config file
             self.logger.debug(
-                "Copying temporary oldconfig file to %r",
-                filename or outfile
+                "Writing oldconfig file %r", filename or outfile
             )
-            shutil.copyfile(self._tmpconfig, outfile)
+            with self._kconfig_symbols.lkc_session():
+                lkconfig.oldconfig_values(
+                    self._oldconfig_values, {}, outfile=outfile,
+                    logger=self.get_child_logger("lkconfig.oldconfig")
+                )
         else:
             self._write_config_file(outfile, filename=filename, **kwargs)
     # ---
 
+    def _load_lkc_values(self):
+        """Loads the resolved config into lkc's symbols.
+
+        Must be called within a lkc session,
+        see KconfigSymbols.lkc_session().
+
+        @return: None (implicit)
+        """
+        self._run_oldconfig_if_needed()
+
+        if self._oldconfig_values is not None:
+            config_values = self._oldconfig_values
+        else:
+            config_values = self.get_lkconfig_values()
+
+        lkconfig.oldconfig_values(
+            config_values, {},
+            logger=self.get_child_logger("lkconfig.oldconfig")
+        )
+    # --- end of _load_lkc_values (...) ---
+
+    def write_defconfig_file(self, outfile):
+        """Writes the config to a minimal config file,
+        as created by "make savedefconfig".
+
+        @param outfile:  output file
+        @type  outfile:  C{str}
+
+        @return: None (implicit)
+        """
+        with self._kconfig_symbols.lkc_session():
+            self._load_lkc_values()
+            self.logger.debug("Writing defconfig file %r", outfile)
+            lkconfig.write_defconfig(outfile)
+    # --- end of write_defconfig_file (...) ---
+
+    def get_defconfig_values(self):
+        """Returns the symbols that differ from their default value,
+        i.e. the entries of a minimal config file,
+        see write_defconfig_file().
+
+        @return:  config values dict, see lkconfig.oldconfig_values()
+        @rtype:   C{dict} :: C{str} => C{None}|C{int}|C{str}
+        """
+        with self._kconfig_symbols.lkc_session():
+            self._load_lkc_values()
+            return lkconfig.get_defconfig_values()
+    # --- end of get_defconfig_values (...) ---
+
+    def write_autoconf(self, outdir, config_file=None):
+        """Writes the files generated by "make silentoldconfig"
+        (include/config/auto.conf, include/generated/autoconf.h and
+        the include/config/*.h dependency files) below outdir.
+
+        Only the dependency files of symbols whose value has changed
+        since the last run are touched.
+
+        @param outdir:       output directory (kernel build directory)
+        @type  outdir:       C{str}
+        @param config_file:  if set, also write the config to this file
+        @type  config_file:  C{str} or C{None}
+
+        @return:  number of touched dependency files
+        @rtype:   C{int}
+        """
+        with self._kconfig_symbols.lkc_session():
+            self._load_lkc_values()
+            self.logger.debug("Writing autoconf files to %r", outdir)
+            return lkconfig.write_autoconf(outdir, config_file=config_file)
+    # --- end of write_autoconf (...) ---
+
 # --- end of Config ---
 
 
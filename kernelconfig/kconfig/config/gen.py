@@ -4,9 +4,11 @@
 import abc
 
 from ...abc import informed
+from ...lang import cmdcache
 from ...lang import interpreter
 
 from .. import symbolgen
+from .. import symtabcache
 
 from . import data
 from . import choices
@@ -59,7 +61,19 @@ class AbstractConfigGenerator(informed.AbstractInformed):
 
 class _ConfigGenerator(AbstractConfigGenerator):
 
-    def __init__(self, install_info, source_info, **kwargs):
+    def __init__(
+        self, install_info, source_info, kconfig_symbols=None, **kwargs
+    ):
+        """Constructor.
+
+        @param   install_info:
+        @param   source_info:
+        @keyword kconfig_symbols:  already loaded Kconfig symbols of
+                                   source_info, which may be shared with
+                                   other generators, or None.
+                                   Defaults to None.
+        @type    kconfig_symbols:  L{KconfigSymbols} or C{None}
+        """
         # super().__init__() is kw-only
         super().__init__(
             install_info=install_info, source_info=source_info, **kwargs
@@ -68,15 +82,46 @@ class _ConfigGenerator(AbstractConfigGenerator):
         # take over ownership of source_info
         self.source_info.set_logger(parent_logger=self.logger)
 
-        self._kconfig_symbols = None
+        self._kconfig_symbols = kconfig_symbols
         self._config = None
         self._config_choices = None
         self._config_choices_interpreter = None
     # --- end of __init__ (...) ---
 
+    def _create_symtab_cache(self):
+        try:
+            cache_dir = self.install_info.get_cache_dirs("kconfig").get_path()
+        except StopIteration:
+            # no cache dir configured
+            return None
+
+        return self.create_source_informed(
+            symtabcache.SymbolTableCache, cache_dir
+        )
+    # --- end of _create_symtab_cache (...) ---
+
+    def _create_cmd_cache(self):
+        try:
+            cache_dir = self.install_info.get_cache_dirs("lang").get_path()
+        except StopIteration:
+            # no cache dir configured, cache command lists in memory
+            cache_dir = None
+
+        return self.create_loggable(cmdcache.KernelConfigLangCache, cache_dir)
+    # --- end of _create_cmd_cache (...) ---
+
+    def _create_symbol_binder(self):
+        return cmdcache.KconfigSymbolBinder(
+            self.get_kconfig_symbols(), self.get_config_choices().get_symbol
+        )
+    # --- end of _create_symbol_binder (...) ---
+
     def _create_kconfig_symbols(self):
         self.source_info.prepare()
-        symgen = self.create_source_informed(symbolgen.KconfigSymbolGenerator)
+        symgen = self.create_source_informed(
+            symbolgen.KconfigSymbolGenerator,
+            symtab_cache=self._create_symtab_cache()
+        )
         return symgen.get_symbols()
 
     def _create_config(self):
@@ -119,14 +164,17 @@ class _ConfigGenerator(AbstractConfigGenerator):
 
 class KernelConfigGenerator(_ConfigGenerator):
 
-    def __init__(self, install_info, source_info, modules_dir=True, **kwargs):
+    def __init__(
+        self, install_info, source_info, modules_dir=True, hwdetector=None,
+        **kwargs
+    ):
         super().__init__(
             install_info=install_info, source_info=source_info, **kwargs
         )
 
         self._config_choice_modules = self.create_informed(
             choicemodules.KernelConfigChoiceModules,
-            modules_dir=modules_dir
+            modules_dir=modules_dir, hwdetector=hwdetector
         )
     # --- end of __init__ (...) ---
 
@@ -159,7 +207,9 @@ class KernelConfigGenerator(_ConfigGenerator):
             self.install_info,
             self.source_info,
             self.get_config_choices(),
-            self.get_config_choice_modules()
+            self.get_config_choice_modules(),
+            cmd_cache=self._create_cmd_cache(),
+            symbol_binder=self._create_symbol_binder()
         )
 
 # --- end of KernelConfigGenerator ---
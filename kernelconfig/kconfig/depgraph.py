@@ -1,6 +1,7 @@
 # This file is part of kernelconfig.
 # -*- coding: utf-8 -*-
 
+import concurrent.futures
 import enum
 import logging
 
@@ -116,6 +117,17 @@ class ConfigGraph(loggable.AbstractLoggable):
         "KERNELCONFIG_DEPGRAPH_DISCARD_N", False
     )
 
+    # number of threads for solving independent decisions of a level,
+    # <= 1 disables threading.  Solving is pure python and holds the GIL,
+    # so threads rarely pay off and are opt-in.  One thread pool is
+    # shared by all levels of a resolve() call.
+    RESOLVE_JOBS = osmisc.envint("KERNELCONFIG_DEPGRAPH_JOBS", 1)
+
+    # whether to solve independent decisions of a level separately,
+    # see split_decision_level().  Disabling it gives the same result,
+    # and is meant for cross-checking the split variant.
+    SPLIT_DECISION_LEVELS = True
+
     def __init__(self, default_config, decisions, **kwargs):
         super().__init__(**kwargs)
         self.dep_graph = {}
@@ -244,7 +256,7 @@ class ConfigGraph(loggable.AbstractLoggable):
         self.value_nodes = self._create_value_nodes(default_config)
     # ---
 
-    def _resolve_upwards_propagation(self, in_decisions):
+    def _resolve_upwards_propagation(self, in_decisions, executor=None):
         first_grp = True
         decisions = {}
         decisions_to_expand = in_decisions
@@ -288,7 +300,8 @@ class ConfigGraph(loggable.AbstractLoggable):
                 }
 
                 decisions_to_expand = self.expand_decision_level_upward(
-                    k, sym_group, upward_decisions, decisions_at_this_level
+                    k, sym_group, upward_decisions, decisions_at_this_level,
+                    executor=executor
                 )
             # --
         else:
@@ -331,11 +344,83 @@ class ConfigGraph(loggable.AbstractLoggable):
     # --- end of _resolve_downwards_propagation (...) ---
 
     def resolve(self):
-        decisions = self._resolve_upwards_propagation(self.input_decisions)
+        if self.RESOLVE_JOBS > 1:
+            with concurrent.futures.ThreadPoolExecutor(
+                max_workers=self.RESOLVE_JOBS
+            ) as executor:
+                decisions = self._resolve_upwards_propagation(
+                    self.input_decisions, executor=executor
+                )
+        else:
+            decisions = self._resolve_upwards_propagation(self.input_decisions)
+        # --
+
         self._resolve_downwards_propagation(decisions)
         self.decisions = decisions
+    # --- end of resolve (...) ---
+
+    def split_decision_level(self, decisions_at_this_level):
+        """Splits the decisions of a level into independent groups.
+
+        Two decisions are dependent if their symbols share a direct
+        dependency, their solutions would need to be merged then.
+        Solutions of independent groups do not have symbols in common,
+        and can be computed and picked separately.
+
+        The groups are sorted by their lowest symbol name,
+        and each group keeps the order of decisions_at_this_level.
+
+        @param decisions_at_this_level:  symbol => value set mapping
+        @type  decisions_at_this_level:  C{dict}
+
+        @return:  list of 2-tuples (decisions, dependency symbols)
+        @rtype:   C{list} of 2-tuple (C{dict}, C{set})
+        """
+        def find(k):
+            while parent[k] != k:
+                parent[k] = parent[parent[k]]
+                k = parent[k]
+            return k
+        # ---
 
-    def accumulate_solutions(self, level, sym_group, decisions_at_this_level):
+        dep_graph = self.dep_graph
+        dec_syms = list(decisions_at_this_level)
+
+        # union-find over decisions, joining decisions with common deps
+        parent = list(range(len(dec_syms)))
+        dep_owner = {}
+        for k, sym in enumerate(dec_syms):
+            for dep_sym in dep_graph[sym]:
+                other = dep_owner.setdefault(dep_sym, k)
+                if other != k:
+                    root_a, root_b = find(k), find(other)
+                    if root_a != root_b:
+                        parent[max(root_a, root_b)] = min(root_a, root_b)
+        # --
+
+        groups = {}
+        for k, sym in enumerate(dec_syms):
+            root = find(k)
+            try:
+                group = groups[root]
+            except KeyError:
+                group = ({}, set())
+                groups[root] = group
+
+            group[0][sym] = decisions_at_this_level[sym]
+            group[1].update(dep_graph[sym])
+        # --
+
+        return sorted(
+            groups.values(),
+            key=lambda xv: min((sym.name or "" for sym in xv[0]))
+        )
+    # --- end of split_decision_level (...) ---
+
+    def accumulate_solutions(
+        self, level, sym_group, decisions_at_this_level,
+        symbol_value_map=None
+    ):
         def merge_sym_solutions(dir_dep_sol, vis_dep_sol):
             if dir_dep_sol is True:
                 return vis_dep_sol
@@ -371,7 +456,6 @@ class ConfigGraph(loggable.AbstractLoggable):
 
         want_debuglog = self.logger.isEnabledFor(logging.DEBUG)
         value_nodes = self.value_nodes
-        symbol_value_map = None
 
         accumulated_solutions = True
 
@@ -501,8 +585,11 @@ class ConfigGraph(loggable.AbstractLoggable):
                         for vsym in constify_syms
                     }
 
-                    dep_solutions = solcache.SolutionCache()
-                    dep_solutions.solutions = [constify_solution]
+                    dep_solutions = (
+                        solcache.BitsetSolutionCache.new_from_solutions(
+                            [constify_solution]
+                        )
+                    )
                 # --
 
             else:
@@ -711,8 +798,18 @@ class ConfigGraph(loggable.AbstractLoggable):
     # --- end of expand_decision_level_set_and_reduce (...) ---
 
     def expand_decision_level_upward(
-        self, level, sym_group, upward_decisions, decisions_at_this_level
+        self, level, sym_group, upward_decisions, decisions_at_this_level,
+        executor=None
     ):
+        if self.SPLIT_DECISION_LEVELS:
+            dec_groups = self.split_decision_level(decisions_at_this_level)
+
+            if len(dec_groups) > 1:
+                return self.expand_decision_level_upward_split(
+                    level, sym_group, upward_decisions, dec_groups, executor
+                )
+        # --
+
         # find solutions
         solutions = self.accumulate_solutions(
             level, sym_group, decisions_at_this_level
@@ -744,6 +841,93 @@ class ConfigGraph(loggable.AbstractLoggable):
         return upward_solution
     # --- end of expand_decision_level_upward (...) ---
 
+    def expand_decision_level_upward_split(
+        self, level, sym_group, upward_decisions, dec_groups, executor
+    ):
+        """Variant of expand_decision_level_upward()
+        for independent decision groups, see split_decision_level().
+
+        The groups are solved concurrently if an executor is given.
+        As their solutions do not overlap, picking a solution per group
+        is equivalent to picking one from the merged solutions,
+        and the results get merged in group order.
+        """
+        def solve_group(dec_group):
+            group_decisions, group_deps = dec_group
+
+            solutions = self.accumulate_solutions(
+                level, sym_group, group_decisions,
+                symbol_value_map=symbol_value_map
+            )
+
+            if not solutions:
+                raise ConfigUnresolvableError(
+                    "no solutions", group_decisions
+                )
+
+            elif solutions is True:
+                # no additional decisions
+                return True
+
+            else:
+                return self.pick_solution(
+                    {
+                        sym: val for sym, val in upward_decisions.items()
+                        if sym in group_deps
+                    },
+                    solutions
+                )
+        # --- end of solve_group (...) ---
+
+        # shared, read-only value map for constifying, all groups
+        # see the same values in upwards mode
+        symbol_value_map = {
+            sym: self.value_nodes[sym].value
+            for sym in self.iter_symbols_upto(level)
+        }
+
+        if executor is None:
+            group_solutions = map(solve_group, dec_groups)
+        else:
+            self.logger.debug(
+                "Solving %d independent decision groups at level %2d",
+                len(dec_groups), (level+1)
+            )
+            group_solutions = executor.map(solve_group, dec_groups)
+        # --
+
+        upward_solution = upward_decisions.copy()
+        have_solutions = False
+        for group_solution in group_solutions:
+            if group_solution is True:
+                pass
+
+            elif group_solution is None:
+                # no acceptable solution for this group,
+                # neither is there one in the merged solutions
+                upward_solution = None
+                have_solutions = True
+                break
+
+            else:
+                upward_solution.update(group_solution)
+                have_solutions = True
+        # --
+
+        if not have_solutions:
+            # no additional decisions, like expand_decision_level_upward()
+            return {}
+
+        elif not upward_solution and upward_decisions:
+            raise AssertionError(
+                "decision filtered out while computing upward solution",
+                upward_solution, upward_decisions
+            )
+        # --
+
+        return upward_solution
+    # --- end of expand_decision_level_upward_split (...) ---
+
     def pick_solution(self, upward_decisions, solutions):
         vset_no = {symbol.TristateKconfigSymbolValue.n, }
 
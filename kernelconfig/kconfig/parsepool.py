@@ -0,0 +1,395 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import collections
+import mmap
+import multiprocessing
+import multiprocessing.connection
+import os
+
+from ..abc import loggable
+from ..util import osmisc
+from . import lkconfig  # pylint: disable=E0611
+from . import symtabcache
+
+try:
+    from multiprocessing import resource_tracker, shared_memory
+except ImportError:
+    # Python < 3.8
+    resource_tracker = None
+    shared_memory = None
+
+
+__all__ = ["ParseTarget", "KconfigParsePool"]
+
+
+class ParseTarget(collections.namedtuple(
+    "ParseTarget", "srctree arch srcarch kernelversion"
+)):
+    """
+    A kernel source tree and the environment for parsing its Kconfig files.
+
+    Provides the parts of the source info interface
+    that are needed by L{SymbolTableCache}.
+
+    @ivar srctree:        kernel sources directory
+    @type srctree:        C{str}
+    @ivar arch:           ARCH
+    @type arch:           C{str}
+    @ivar srcarch:        SRCARCH
+    @type srcarch:        C{str}
+    @ivar kernelversion:  KERNELVERSION
+    @type kernelversion:  C{str} or L{KernelVersion}
+    """
+    __slots__ = []
+
+    @classmethod
+    def new_from_source_info(cls, source_info):
+        """Creates a parse target from a prepared source info object.
+
+        @param source_info:  source info
+        @type  source_info:  L{SourceInfo}
+
+        @return:  parse target
+        @rtype:   L{ParseTarget}
+        """
+        env_vars = dict(source_info.iter_env_vars())
+        return cls(
+            source_info.srctree,
+            env_vars["ARCH"], env_vars["SRCARCH"], env_vars["KERNELVERSION"]
+        )
+    # --- end of new_from_source_info (...) ---
+
+    def get_toplevel_kconfig_filepath(self):
+        return os.path.join(self.srctree, "Kconfig")
+
+    def iter_env_vars(self):
+        return [
+            ('ARCH', self.arch),
+            ('SRCARCH', self.srcarch),
+            ('srctree', self.srctree),
+            ('KERNELVERSION', self.kernelversion)
+        ]
+    # --- end of iter_env_vars (...) ---
+
+# --- end of ParseTarget ---
+
+
+def _worker_parse(target, cache_dir):
+    """Parses the Kconfig files of a target in a worker process,
+    and returns the symbol table in the cache file format.
+
+    @return:  cache file data
+    @rtype:   buffer object
+    """
+    # chdir to srctree, lkc looks up relative file names in the
+    # working directory first (see zconf_fopen())
+    os.chdir(target.srctree)
+    for name, value in target.iter_env_vars():
+        os.environ[name] = str(value)
+
+    symtab_cache = symtabcache.SymbolTableCache(
+        cache_dir, source_info=target
+    )
+
+    if cache_dir:
+        symtab = symtab_cache.load()
+        if symtab is not None:
+            # cache hit, pass on the file data as-is
+            # pylint: disable=W0212
+            return symtab._mmap
+    # --
+
+    lkc_context = lkconfig.Context()
+    prev_context = lkconfig.switch_context(lkc_context)
+    try:
+        # lkc may exit(1) here
+        lkconfig.read_symbols(target.get_toplevel_kconfig_filepath())
+
+        symtab = lkconfig.get_symbol_table()
+        kconfig_deps = lkconfig.get_kconfig_deps()
+
+        if cache_dir:
+            symtab_cache.store(symtab, kconfig_deps)
+
+        return symtab_cache.encode(symtab, kconfig_deps)
+
+    finally:
+        lkconfig.switch_context(prev_context)
+        lkc_context.clear()
+# --- end of _worker_parse (...) ---
+
+
+def _worker_main(conn, cache_dir):
+    """Main function of a parse worker process.
+
+    Receives (job id, target) jobs from conn until it gets None,
+    and replies with (job id, shared memory name, size) on success
+    or (job id, None, error message) on failure.
+    The shared memory block is unlinked by the receiver.
+    """
+    while True:
+        job = conn.recv()
+        if job is None:
+            break
+
+        job_id, target = job
+        try:
+            data = _worker_parse(ParseTarget(*target), cache_dir)
+
+        except Exception as err:  # pylint: disable=W0703
+            conn.send((job_id, None, str(err) or err.__class__.__name__))
+
+        else:
+            data_size = len(data)
+            shm = shared_memory.SharedMemory(
+                create=True, size=max(1, data_size)
+            )
+            # the receiver owns (and unlinks) the block
+            # pylint: disable=W0212
+            resource_tracker.unregister(shm._name, "shared_memory")
+            try:
+                shm.buf[:data_size] = data
+                conn.send((job_id, shm.name, data_size))
+            finally:
+                shm.close()
+        # --
+    # --
+# --- end of _worker_main (...) ---
+
+
+class _ParseWorker(object):
+    """
+    A parse worker process and the parent's end of its connection.
+    """
+
+    __slots__ = ["process", "conn", "job"]
+
+    def __init__(self, mp_context, cache_dir):
+        super().__init__()
+        self.conn, child_conn = mp_context.Pipe()
+        self.process = mp_context.Process(
+            target=_worker_main, args=(child_conn, cache_dir), daemon=True
+        )
+        self.job = None
+        self.process.start()
+        child_conn.close()
+    # --- end of __init__ (...) ---
+
+    def submit(self, job_id, target):
+        self.job = (job_id, target)
+        self.conn.send((job_id, tuple(target)))
+
+    def stop(self):
+        try:
+            self.conn.send(None)
+        except OSError:
+            pass
+        self.conn.close()
+        self.process.join()
+    # --- end of stop (...) ---
+
+# --- end of _ParseWorker ---
+
+
+class KconfigParsePool(loggable.AbstractLoggable):
+    """
+    A pool of worker processes for parsing the Kconfig files
+    of several targets (source trees, architectures) in parallel.
+
+    lkc's parser state is process-global and lkc exits on parse errors,
+    so each target is parsed in a worker process,
+    which stays alive between jobs unless lkc exits.
+    The symbol table gets passed back in the symbol table cache format
+    via shared memory, see L{SymbolTableCache}.
+    A failing parse is reported as lkconfig.KconfigParseError.
+
+    Workers are forked on demand, before the parent has parsed
+    Kconfig files in its own lkc contexts preferably.
+
+    @ivar num_workers:  max. number of worker processes
+    @type num_workers:  C{int}
+    @ivar cache_dir:    symbol table cache directory or None,
+                        used by the workers for skipping unchanged targets
+    @type cache_dir:    C{str} or C{None}
+    """
+
+    def __init__(self, num_workers=None, cache_dir=None, **kwargs):
+        super().__init__(**kwargs)
+        if shared_memory is None:
+            raise NotImplementedError("multiprocessing.shared_memory")
+
+        if not num_workers:
+            try:
+                num_workers = osmisc.get_cpu_count()
+            except NotImplementedError:
+                num_workers = None
+        # --
+
+        self.num_workers = max(1, num_workers or 1)
+        self.cache_dir = cache_dir
+        self._mp_context = multiprocessing.get_context("fork")
+        self._workers = []
+    # --- end of __init__ (...) ---
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, exc_tb):
+        self.close()
+    # ---
+
+    def close(self):
+        """Stops all worker processes.
+
+        @return: None (implicit)
+        """
+        workers = self._workers
+        self._workers = []
+        for worker in workers:
+            worker.stop()
+    # --- end of close (...) ---
+
+    def _get_idle_worker(self):
+        for worker in self._workers:
+            if worker.job is None:
+                return worker
+        # --
+
+        if len(self._workers) < self.num_workers:
+            worker = _ParseWorker(self._mp_context, self.cache_dir)
+            self._workers.append(worker)
+            return worker
+        # --
+
+        return None
+    # --- end of _get_idle_worker (...) ---
+
+    def _load_result(self, target, shm_name, data_size):
+        """Copies a symbol table from shared memory and decodes it.
+
+        @return:  symbol table or None
+        @rtype:   L{CachedSymbolTable} or C{None}
+        """
+        shm = shared_memory.SharedMemory(name=shm_name)
+        try:
+            shm.unlink()
+            mmap_obj = mmap.mmap(-1, max(1, data_size))
+            mmap_obj[:data_size] = shm.buf[:data_size]
+        finally:
+            shm.close()
+
+        symtab_cache = symtabcache.SymbolTableCache(
+            self.cache_dir, source_info=target, parent_logger=self.logger
+        )
+        # the deps refer to the worker's environment
+        return symtab_cache.load_from_mmap(mmap_obj, check_deps=False)
+    # --- end of _load_result (...) ---
+
+    def _handle_reply(self, worker, targets, results):
+        job_id, target = worker.job
+        worker.job = None
+
+        try:
+            reply_job_id, shm_name, data = worker.conn.recv()
+        except (EOFError, OSError):
+            reply_job_id = None
+
+        if reply_job_id != job_id:
+            # lkc has called exit(), or the worker has been killed
+            worker.process.join()
+            self._workers.remove(worker)
+            worker.conn.close()
+            results[job_id] = lkconfig.KconfigParseError(
+                "parser exited with status {!r} for {!r}".format(
+                    worker.process.exitcode, target
+                )
+            )
+            return
+        # --
+
+        if shm_name is None:
+            results[job_id] = lkconfig.KconfigParseError(
+                "failed to parse {!r}: {}".format(target, data)
+            )
+            return
+        # --
+
+        try:
+            symtab = self._load_result(target, shm_name, data)
+        except (OSError, ValueError, TypeError) as err:
+            symtab = None
+            self.logger.warning("Failed to load symbol table: %s", err)
+
+        if symtab is None:
+            results[job_id] = lkconfig.KconfigParseError(
+                "bad symbol table for {!r}".format(target)
+            )
+        else:
+            results[job_id] = symtab
+    # --- end of _handle_reply (...) ---
+
+    def parse(self, targets, return_exceptions=False):
+        """Parses the Kconfig files of the given targets
+        and returns their symbol tables, in order.
+
+        @raises lkconfig.KconfigParseError:  if a target could not be parsed
+                                             and return_exceptions is False
+
+        @param targets:            parse targets
+        @type  targets:            iterable of L{ParseTarget}
+        @param return_exceptions:  if True, failed targets are listed
+                                   as KconfigParseError objects
+                                   instead of raising the first one
+        @type  return_exceptions:  C{bool}
+
+        @return:  list of symbol tables (or exceptions)
+        @rtype:   C{list} of L{CachedSymbolTable}
+        """
+        targets = [ParseTarget(*target) for target in targets]
+        results = [None] * len(targets)
+        pending = collections.deque(enumerate(targets))
+
+        while True:
+            while pending:
+                worker = self._get_idle_worker()
+                if worker is None:
+                    break
+                job_id, target = pending.popleft()
+                self.logger.debug("Parsing %r", target)
+                worker.submit(job_id, target)
+            # --
+
+            busy_workers = {
+                worker.conn: worker
+                for worker in self._workers if worker.job is not None
+            }
+            if not busy_workers:
+                break
+
+            sentinels = {
+                worker.process.sentinel: worker
+                for worker in busy_workers.values()
+            }
+
+            # a dying worker's connection becomes readable (EOF) as well,
+            # _handle_reply() resets the worker's job
+            for ready in multiprocessing.connection.wait(
+                list(busy_workers) + list(sentinels)
+            ):
+                worker = busy_workers.get(ready) or sentinels[ready]
+                if worker.job is not None:
+                    self._handle_reply(worker, targets, results)
+            # --
+        # --
+
+        if not return_exceptions:
+            for result in results:
+                if isinstance(result, Exception):
+                    raise result
+        # --
+
+        return results
+    # --- end of parse (...) ---
+
+# --- end of KconfigParsePool ---
@@ -2,11 +2,14 @@
 # -*- coding: utf-8 -*-
 
 import itertools
+import threading
 
 from .abc import solcache as _solcache_abc
+from . import lkconfig  # pylint: disable=E0611
+from . import symbol
 
 
-__all__ = ["SolutionCache", "merge_solutions"]
+__all__ = ["SolutionCache", "BitsetSolutionCache", "merge_solutions"]
 
 
 class SolutionCache(_solcache_abc.AbstractSymbolExprSolutionCache):
@@ -16,6 +19,12 @@ class SolutionCache(_solcache_abc.AbstractSymbolExprSolutionCache):
         super().__init__()
         self.solutions = [{}]
 
+    @classmethod
+    def new_from_solutions(cls, solutions):
+        obj = cls()
+        obj.solutions = solutions
+        return obj
+
     def __bool__(self):
         return bool(self.solutions)
 
@@ -82,7 +91,7 @@ class SolutionCache(_solcache_abc.AbstractSymbolExprSolutionCache):
 
     def merge(self, sol_cache):
         merged_sol = self.merge_solutions_list_x_list(
-            self.solutions, sol_cache.solutions
+            self.solutions, sol_cache.get_solutions()
         )
 
         return self._replace_solutions(merged_sol)
@@ -96,7 +105,7 @@ class SolutionCache(_solcache_abc.AbstractSymbolExprSolutionCache):
         #
         for sol_cache in alternatives:
             subsol_merged = self.merge_solutions_list_x_list(
-                self.solutions, sol_cache.solutions
+                self.solutions, sol_cache.get_solutions()
             )
             merged_sol.extend(subsol_merged)
         # --
@@ -106,4 +115,275 @@ class SolutionCache(_solcache_abc.AbstractSymbolExprSolutionCache):
 # --- end of SolutionCache ---
 
 
+class SymbolIndex(object):
+    """
+    Assigns dense indices to symbols whose tristate values
+    can be represented as value bitmask, see lkconfig.SolutionStore.
+
+    @cvar TRISTATES:   tristate values, in order of their bitmask position
+    @type TRISTATES:   3-tuple of L{TristateKconfigSymbolValue}
+
+    @ivar symbols:     indexed symbols
+    @type symbols:     C{list} of L{AbstractKconfigSymbol}
+    @ivar normvalues:  normalized tristate values of each indexed symbol,
+                       None for invalid values
+    @type normvalues:  C{list} of 3-tuple
+
+    New indices are assigned under a lock,
+    the index is shared by the threads of ConfigGraph.resolve().
+    """
+
+    TRISTATES = (
+        symbol.TristateKconfigSymbolValue.n,
+        symbol.TristateKconfigSymbolValue.m,
+        symbol.TristateKconfigSymbolValue.y
+    )
+
+    def __init__(self):
+        super().__init__()
+        self.symbols = []
+        self.normvalues = []
+        self._index = {}
+        self._lock = threading.Lock()
+
+    @classmethod
+    def get_tristate_normvalues(cls, sym):
+        """
+        Returns the normalized n/m/y values of a symbol,
+        or None if they cannot be represented as bitmask
+        (different tristate values normalizing to the same value).
+
+        @param sym:  symbol
+        @type  sym:  L{AbstractKconfigSymbol}
+
+        @return: 3-tuple of normalized values or None, or None
+        """
+        normvalues = []
+        for value in cls.TRISTATES:
+            normval_set = sym.normalize_and_validate_set((value,))[1]
+            normvalues.append(next(iter(normval_set)) if normval_set else None)
+
+        normval_set = {v for v in normvalues if v is not None}
+        if len(normval_set) != sum((v is not None for v in normvalues)):
+            return None
+
+        return tuple(normvalues)
+    # --- end of get_tristate_normvalues (...) ---
+
+    def get_index(self, sym):
+        """
+        @return: index of the symbol, None if not representable
+        @rtype:  C{int} or C{None}
+        """
+        try:
+            return self._index[sym]
+        except KeyError:
+            pass
+
+        normvalues = self.get_tristate_normvalues(sym)
+        with self._lock:
+            if sym in self._index:
+                return self._index[sym]
+
+            if normvalues is None:
+                idx = None
+            else:
+                self.normvalues.append(normvalues)
+                idx = len(self.symbols)
+                self.symbols.append(sym)
+
+            self._index[sym] = idx
+        return idx
+    # --- end of get_index (...) ---
+
+    def get_value_mask(self, idx, values):
+        """
+        @return: bitmask of the given values, None if not representable
+        @rtype:  C{int} or C{None}
+        """
+        normvalues = self.normvalues[idx]
+        mask = 0
+        for value in values:
+            try:
+                mask |= (1 << normvalues.index(value))
+            except ValueError:
+                return None
+        return mask or None
+    # --- end of get_value_mask (...) ---
+
+    def convert_solutions(self, solutions):
+        """
+        Converts symbol => value set dicts to
+        lists of (index, value mask) pairs.
+
+        @return: converted solutions, or None if not representable
+        @rtype:  C{list} of C{list} of 2-tuple, or C{None}
+        """
+        converted = []
+        for sol in solutions:
+            pairs = []
+            for sym, values in sol.items():
+                idx = self.get_index(sym)
+                if idx is None:
+                    return None
+
+                mask = self.get_value_mask(idx, values)
+                if mask is None:
+                    return None
+
+                pairs.append((idx, mask))
+            # --
+            converted.append(pairs)
+        # --
+        return converted
+    # --- end of convert_solutions (...) ---
+
+# --- end of SymbolIndex ---
+
+
+class BitsetSolutionCache(_solcache_abc.AbstractSymbolExprSolutionCache):
+    """
+    A solution cache that keeps its solutions in a lkconfig.SolutionStore,
+    merging solutions word-wise instead of dict-wise.
+
+    Symbols are indexed in a shared L{SymbolIndex},
+    which is reset by clear_symbol_index().
+    Falls back to a dict-based L{SolutionCache} as soon as
+    a symbol or value set cannot be represented in the store.
+
+    Solution dicts returned by get_solutions() are in symbol index order,
+    and duplicate solutions are removed.
+
+    @ivar index:     symbol index, None after falling back
+    @type index:     L{SymbolIndex} or C{None}
+    @ivar store:     solutions, None after falling back
+    @type store:     C{lkconfig.SolutionStore} or C{None}
+    @ivar fallback:  dict-based solutions, None unless fallen back
+    @type fallback:  L{SolutionCache} or C{None}
+    """
+    __slots__ = ["index", "store", "fallback"]
+
+    _symbol_index = SymbolIndex()
+
+    @classmethod
+    def get_symbol_index(cls):
+        return cls._symbol_index
+
+    @classmethod
+    def clear_symbol_index(cls):
+        cls._symbol_index = SymbolIndex()
+
+    def __init__(self, store=None, index=None):
+        super().__init__()
+        self.index = self.get_symbol_index() if index is None else index
+        self.store = lkconfig.SolutionStore() if store is None else store
+        self.fallback = None
+
+    @classmethod
+    def new_from_solutions(cls, solutions):
+        """
+        Creates a new solution cache from symbol => value set dicts.
+        Returns a L{SolutionCache} if the solutions are not representable.
+        """
+        index = cls.get_symbol_index()
+        converted = index.convert_solutions(solutions)
+        if converted is None:
+            return SolutionCache.new_from_solutions(solutions)
+
+        store = lkconfig.SolutionStore(empty=True)
+        store.add_solutions(converted)
+        return cls(store, index)
+    # --- end of new_from_solutions (...) ---
+
+    def _fall_back(self):
+        if self.fallback is None:
+            self.fallback = SolutionCache.new_from_solutions(
+                self.get_solutions()
+            )
+            self.index = None
+            self.store = None
+        return self.fallback
+    # --- end of _fall_back (...) ---
+
+    def _get_other_store(self, sol_cache):
+        """
+        Returns the solution store of another solution cache
+        if it is compatible with this one, else None.
+        """
+        if (
+            isinstance(sol_cache, BitsetSolutionCache)
+            and sol_cache.index is self.index
+        ):
+            return sol_cache.store
+
+        converted = self.index.convert_solutions(sol_cache.get_solutions())
+        if converted is None:
+            return None
+
+        store = lkconfig.SolutionStore(empty=True)
+        store.add_solutions(converted)
+        return store
+    # --- end of _get_other_store (...) ---
+
+    def __bool__(self):
+        if self.fallback is not None:
+            return bool(self.fallback)
+        return bool(len(self.store))
+
+    def copy(self):
+        if self.fallback is not None:
+            return self.fallback.copy()
+        return self.__class__(self.store.copy(), self.index)
+
+    def push_symbol(self, sym, values):
+        if self.fallback is None:
+            idx = self.index.get_index(sym)
+            if idx is not None:
+                mask = self.index.get_value_mask(idx, values)
+                if mask is not None:
+                    return self.store.push_symbol(idx, mask)
+        # --
+
+        return self._fall_back().push_symbol(sym, values)
+    # --- end of push_symbol (...) ---
+
+    def get_solutions(self):
+        if self.fallback is not None:
+            return self.fallback.get_solutions()
+
+        return self.store.get_solutions(
+            self.index.symbols, self.index.normvalues
+        )
+    # --- end of get_solutions (...) ---
+
+    def merge(self, sol_cache):
+        if self.fallback is None:
+            other_store = self._get_other_store(sol_cache)
+            if other_store is not None:
+                return self.store.merge(other_store)
+        # --
+
+        return self._fall_back().merge(sol_cache)
+    # --- end of merge (...) ---
+
+    def merge_alternatives(self, alternatives):
+        alternatives = list(alternatives)
+
+        if self.fallback is None:
+            alt_stores = []
+            for sol_cache in alternatives:
+                other_store = self._get_other_store(sol_cache)
+                if other_store is None:
+                    break
+                alt_stores.append(other_store)
+            else:
+                return self.store.merge_alternatives(alt_stores)
+        # --
+
+        return self._fall_back().merge_alternatives(alternatives)
+    # --- end of merge_alternatives (...) ---
+
+# --- end of BitsetSolutionCache ---
+
+
 merge_solutions = SolutionCache.merge_solutions_list_x_list
@@ -5,8 +5,11 @@ import abc
 import collections.abc
 import operator
 
+from . import lkconfig  # pylint: disable=E0611
 from . import symbol
-from .solcache import SolutionCache, merge_solutions
+from .solcache import (
+    SolutionCache, BitsetSolutionCache, SymbolIndex, merge_solutions
+)
 
 
 __all__ = [
@@ -22,6 +25,7 @@ __all__ = [
     "Expr_SymbolEQ",
     "Expr_SymbolNEQ",
     "Expr_Impl",
+    "ExprPool",
 ]
 
 
@@ -31,9 +35,78 @@ def clear_cache():
     """
     Expr_Constant.clear_instance_cache()
     Expr_Symbol.clear_instance_cache()
+    BitsetSolutionCache.clear_symbol_index()
 # --- end of clear_cache (...) ---
 
 
+class _ExprNotCompilable(Exception):
+    pass
+# ---
+
+
+class _ExprCodeBuilder(object):
+    """
+    Collects the code, symbols and constants of an expression
+    that is being compiled into a lkconfig.ExprCode object.
+
+    @ivar code:        expression code
+    @type code:        C{list} of C{int}
+    @ivar symbols:     referenced symbols, indexed by slot
+    @type symbols:     C{list} of L{AbstractKconfigSymbol}
+    @ivar normvalues:  normalized tristate values of each symbol,
+                       None for invalid values
+    @type normvalues:  C{list} of 3-tuple
+    @ivar constants:   constant comparison operands
+    @type constants:   C{list} of undef
+    """
+
+    TRISTATES = SymbolIndex.TRISTATES
+
+    def __init__(self):
+        super().__init__()
+        self.code = []
+        self.symbols = []
+        self.normvalues = []
+        self.constants = []
+        self._symbol_slots = {}
+
+    def emit(self, *args):
+        """Appends code and returns the position of the first item."""
+        pos = len(self.code)
+        self.code.extend(args)
+        return pos
+
+    def get_symbol_slot(self, sym):
+        try:
+            return self._symbol_slots[sym]
+        except KeyError:
+            pass
+
+        normvalues = SymbolIndex.get_tristate_normvalues(sym)
+        if normvalues is None:
+            # values collapse, cannot be represented as bitmask
+            raise _ExprNotCompilable(sym)
+
+        slot = len(self.symbols)
+        self.symbols.append(sym)
+        self.normvalues.append(normvalues)
+        self._symbol_slots[sym] = slot
+        return slot
+
+    def get_constant_index(self, value):
+        idx = len(self.constants)
+        self.constants.append(value)
+        return idx
+
+    def get_code(self):
+        return lkconfig.ExprCode(
+            self.code, tuple(self.symbols), tuple(self.normvalues),
+            tuple(self.constants), self.TRISTATES
+        )
+
+# --- end of _ExprCodeBuilder ---
+
+
 class Visitable(collections.abc.Hashable):
     __slots__ = []
 
@@ -53,9 +126,14 @@ class Visitable(collections.abc.Hashable):
 
 
 class Expr(Visitable):
-    """Base class for dependency expressions."""
+    """Base class for dependency expressions.
+
+    @ivar _code:  compiled expression, see get_code(),
+                  None if not compiled yet, False if not compilable
+    @type _code:  C{None}|C{bool}|C{lkconfig.ExprCode}
+    """
     # use __slots__, there will be many Expr objects floating around
-    __slots__ = []
+    __slots__ = ["_code"]
 
     EXPR_VALUES_N = frozenset([symbol.TristateKconfigSymbolValue.n])
     EXPR_VALUES_M = frozenset([symbol.TristateKconfigSymbolValue.m])
@@ -63,6 +141,58 @@ class Expr(Visitable):
     EXPR_VALUES_YM = EXPR_VALUES_Y | EXPR_VALUES_M
     EXPR_VALUES_YMN = EXPR_VALUES_Y | EXPR_VALUES_M | EXPR_VALUES_N
 
+    def __init__(self):
+        super().__init__()
+        self._code = None
+
+    def compile(self):
+        """Compiles this expression for native evaluation.
+
+        @return: compiled expression,
+                 or None if the expression contains unexpanded symbol names
+                 or empty AND/OR subexpressions
+        @rtype:  C{lkconfig.ExprCode} or C{None}
+        """
+        builder = _ExprCodeBuilder()
+        try:
+            self._compile(builder)
+        except _ExprNotCompilable:
+            return None
+        return builder.get_code()
+    # --- end of compile (...) ---
+
+    def get_code(self):
+        """Returns the compiled expression, compiling it on first access.
+
+        The expression must not be modified afterwards,
+        except via its own methods, which call reset_code().
+
+        @return: compiled expression or None
+        @rtype:  C{lkconfig.ExprCode} or C{None}
+        """
+        code = self._code
+        if code is None:
+            code = self.compile()
+            self._code = False if code is None else code
+            return code
+        else:
+            return code or None
+    # --- end of get_code (...) ---
+
+    def reset_code(self):
+        self._code = None
+
+    @abc.abstractmethod
+    def _compile(self, builder):
+        """Appends the code of this expression to the builder.
+
+        @raises _ExprNotCompilable:
+
+        @param builder:  code builder
+        @type  builder:  L{_ExprCodeBuilder}
+        """
+        raise NotImplementedError()
+
     @abc.abstractmethod
     def add_expr(self, expr):
         """Adds a subordinate expression to this expression.
@@ -169,7 +299,6 @@ class Expr(Visitable):
         # --
     # --- end of expand_subexpr_symbols_shared (...) ---
 
-    @abc.abstractmethod
     def evaluate(self, symbol_value_map):
         """
         Given a symbol => value map,
@@ -182,9 +311,17 @@ class Expr(Visitable):
         @return: tristate value
         @rtype:  L{TristateKconfigSymbolValue}
         """
-        raise NotImplementedError()
+        code = self.get_code()
+        if code is None:
+            return self._evaluate(symbol_value_map)
+        else:
+            return code.evaluate(symbol_value_map)
     # --- end of evaluate (...) ---
 
+    @abc.abstractmethod
+    def _evaluate(self, symbol_value_map):
+        raise NotImplementedError()
+
     @abc.abstractmethod
     def simplify(self):
         """Simplifies the expression.
@@ -203,6 +340,20 @@ class Expr(Visitable):
         raise NotImplementedError()
 
     def find_solution(self, expr_values):
+        code = self.get_code()
+        if code is not None and code.solvable:
+            index = BitsetSolutionCache.get_symbol_index()
+            slot_index = [index.get_index(sym) for sym in code.symbols]
+
+            native_result = (
+                None if None in slot_index
+                else code.find_solution(expr_values, slot_index)
+            )
+            if native_result is not None:
+                ret, store = native_result
+                return (ret, BitsetSolutionCache(store, index))
+        # --
+
         sol_cache = SolutionCache()
         ret = self._find_solution(expr_values, sol_cache)
         return (ret, sol_cache)
@@ -230,6 +381,10 @@ class Expr(Visitable):
 
         @return: 2-tuple (solvable, set of symbols)
         """
+        code = self.get_code()
+        if code is not None:
+            return code.evaluate_solution(symbol_value_map, expr_values)
+
         solution = set()
         ret = self._evaluate_solution(symbol_value_map, expr_values, solution)
         return (ret, solution)
@@ -313,6 +468,10 @@ class _MultiExpr(Expr):
     def OP_STR(cls):  # pylint: disable=E0213
         raise NotImplementedError()
 
+    @abc.abstractproperty
+    def OP_CODE(cls):  # pylint: disable=E0213
+        raise NotImplementedError()
+
     def __hash__(self):
         static_hash = self.static_hash
         if static_hash is None:
@@ -338,6 +497,7 @@ class _MultiExpr(Expr):
         self.extend_expr(args)
 
     def add_expr(self, expr):
+        self.reset_code()
         self.exprv.append(expr)
         return expr
 
@@ -364,6 +524,7 @@ class _MultiExpr(Expr):
     def expand_symbols_shared(
         self, symbol_name_map, constants, symbols_names_missing
     ):
+        self.reset_code()
         self.exprv = [
             self.expand_subexpr_symbols_shared(
                 subexpr, symbol_name_map, constants, symbols_names_missing
@@ -381,9 +542,19 @@ class _MultiExpr(Expr):
             raise AssertionError("empty expr")
 
         for subexpr in self.exprv:
-            yield subexpr.evaluate(symbol_value_map)
+            yield subexpr._evaluate(symbol_value_map)
     # --- end of iter_evaluate_subexpr (...) ---
 
+    def _compile(self, builder):
+        if not self.exprv:
+            raise _ExprNotCompilable(self)
+
+        pos = builder.emit(self.OP_CODE, len(self.exprv), None)
+        for subexpr in self.exprv:
+            subexpr._compile(builder)
+        builder.code[pos + 2] = len(builder.code)
+    # --- end of _compile (...) ---
+
     def simplify_and_split_subexpr(self):
         """Splits self.exprv into constants, symbols and nested expressions.
 
@@ -455,6 +626,7 @@ class _MultiExpr(Expr):
     # --- end of join_simplified_subexpr (...) ---
 
     def move_negation_inwards(self):
+        self.reset_code()
         self.exprv = [e.move_negation_inwards() for e in self.exprv]
         return self
     # --- end of move_negation_inwards (...) ---
@@ -467,17 +639,77 @@ class _SelfConsumingMultiExpr(_MultiExpr):
     Base class for dependency expressions
     with a variable count of subexpressions,
     that also consume subordinate expressions of the same type.
+
+    @cvar VALUE_ABSORBING:  constant value that determines the value
+                            of the expression
+    @cvar VALUE_EMPTY:      value of the expression if it has
+                            no subexpressions
+    @cvar VALUE_NEUTRAL:    constant value that can be ignored
+                            if the expression depends on a dynamic value
+    @cvar VALUE_COMBINE:    function that combines constant values
     """
     # pylint: disable=W0223
     __slots__ = []
 
+    VALUE_ABSORBING = None
+    VALUE_EMPTY = None
+    VALUE_NEUTRAL = None
+    VALUE_COMBINE = None
+
     def add_expr(self, expr):
         if type(expr) is type(self):
+            self.reset_code()
             self.exprv.extend(expr.exprv)
             return self
         else:
             return super().add_expr(expr)
     # ---
+
+    @classmethod
+    def fold_constant_values(cls, constant_values, have_dynamic):
+        """Evaluates the constant subexpressions of an expression.
+
+        @param constant_values:  values of the constant subexpressions,
+                                 the neutral value gets removed
+                                 if the expression is not constant
+        @type  constant_values:  C{set} of C{TristateKconfigSymbolValue}
+        @param have_dynamic:     whether the expression has
+                                 non-constant subexpressions
+        @type  have_dynamic:     C{bool}
+
+        @return:  value of the expression if it is constant, else None
+        @rtype:   C{TristateKconfigSymbolValue} or C{None}
+        """
+        if cls.VALUE_ABSORBING in constant_values:
+            return cls.VALUE_ABSORBING
+
+        elif not have_dynamic:
+            if constant_values:
+                return cls.VALUE_COMBINE(constant_values)
+            else:
+                return cls.VALUE_EMPTY
+
+        else:
+            constant_values.discard(cls.VALUE_NEUTRAL)
+            # constant_values is now either empty or contains just m
+            return None
+    # --- end of fold_constant_values (...) ---
+
+    def simplify(self):
+        constant_values, symbol_exprs, nested_exprs = \
+            self.simplify_and_split_subexpr()
+
+        value = self.fold_constant_values(
+            constant_values, bool(symbol_exprs or nested_exprs)
+        )
+        if value is not None:
+            return Expr_Constant.get_instance(value)
+        else:
+            return self.join_simplified_subexpr(
+                constant_values, symbol_exprs, nested_exprs
+            )
+    # --- end of simplify (...) ---
+
 # ---
 
 
@@ -548,11 +780,14 @@ class _UnaryValueExpr(_UnaryExpr):
             return symbol.TristateKconfigSymbolValue.n
 
     def evaluate(self, symbol_value_map):
+        # not worth a native call
         return self._evaluate_value(
             self.get_value(symbol_value_map)
         )
     # --- end of evaluate (...) ---
 
+    _evaluate = evaluate
+
     def __repr__(self):
         return "{c.__qualname__}<{s.expr}>".format(s=self, c=self.__class__)
 
@@ -578,6 +813,9 @@ class Expr_Constant(_UnaryValueExpr):
         return self.expr
     # --- end of evaluate (...) ---
 
+    def _compile(self, builder):
+        builder.emit(lkconfig.ExprCode.OP_CONST, int(self.evaluate(None)))
+
     def _find_solution(self, expr_values, sol_cache):
         return self.evaluate(None) in expr_values
 
@@ -606,6 +844,11 @@ class Expr_Symbol(_UnaryValueExpr):
             return symbol.TristateKconfigSymbolValue.n
     # --- end of evaluate (...) ---
 
+    def _compile(self, builder):
+        builder.emit(
+            lkconfig.ExprCode.OP_SYM, builder.get_symbol_slot(self.expr)
+        )
+
     def _find_solution(self, expr_values, sol_cache):
         return sol_cache.push_symbol(
             self.expr,
@@ -668,9 +911,12 @@ class Expr_SymbolName(_UnaryExpr):
         raise TypeError()
     # --- end of get_value (...) ---
 
-    def evaluate(self, symbol_value_map):
+    def _evaluate(self, symbol_value_map):
         raise TypeError()
-    # --- end of evaluate (...) ---
+    # --- end of _evaluate (...) ---
+
+    def _compile(self, builder):
+        raise _ExprNotCompilable(self)
 
     def simplify(self):
         return self
@@ -713,6 +959,10 @@ class _Expr_SymbolValueComparison(Expr):
     def EXPR_FMT(cls):  # pylint: disable=E0213
         raise NotImplementedError()
 
+    @abc.abstractproperty
+    def OP_CODE(cls):  # pylint: disable=E0213
+        raise NotImplementedError()
+
     def __init__(self, lsym, rsym):
         super().__init__()
         self.lsym = lsym
@@ -748,6 +998,7 @@ class _Expr_SymbolValueComparison(Expr):
     def expand_symbols_shared(
         self, symbol_name_map, constants, symbols_names_missing
     ):
+        self.reset_code()
         self.lsym = self.expand_subexpr_symbols_shared(
             self.lsym, symbol_name_map, constants, symbols_names_missing
         )
@@ -761,7 +1012,7 @@ class _Expr_SymbolValueComparison(Expr):
         self.lsym.get_dependent_symbols_shared(symbol_set)
         self.rsym.get_dependent_symbols_shared(symbol_set)
 
-    def evaluate(self, symbol_value_map):
+    def _evaluate(self, symbol_value_map):
         loper = self.lsym.get_value(symbol_value_map)
         roper = self.rsym.get_value(symbol_value_map)
 
@@ -769,14 +1020,41 @@ class _Expr_SymbolValueComparison(Expr):
             return symbol.TristateKconfigSymbolValue.y
         else:
             return symbol.TristateKconfigSymbolValue.n
-    # --- end of evaluate (...) ---
+    # --- end of _evaluate (...) ---
+
+    def _compile_operand(self, builder, operand):
+        if isinstance(operand, Expr_Symbol):
+            return (
+                lkconfig.ExprCode.OPERAND_SYM,
+                builder.get_symbol_slot(operand.expr)
+            )
+
+        elif isinstance(operand, Expr_Constant):
+            return (
+                lkconfig.ExprCode.OPERAND_CONST,
+                builder.get_constant_index(operand.expr)
+            )
+
+        else:
+            raise _ExprNotCompilable(operand)
+    # --- end of _compile_operand (...) ---
+
+    def _compile(self, builder):
+        builder.emit(
+            lkconfig.ExprCode.OP_CMP, self.OP_CODE,
+            *(
+                self._compile_operand(builder, self.lsym)
+                + self._compile_operand(builder, self.rsym)
+            )
+        )
+    # --- end of _compile (...) ---
 
     def simplify(self):
         if (
             isinstance(self.lsym, Expr_Constant)
             and isinstance(self.rsym, Expr_Constant)
         ):
-            return Expr_Constant(self.evaluate(None))
+            return Expr_Constant(self._evaluate(None))
         else:
             return self
     # --- end of simplify (...) ---
@@ -806,7 +1084,7 @@ class _Expr_SymbolValueComparison(Expr):
         raise NotImplementedError("constant X symbol", lsym, rsym)
 
     def _solve_constant_x_constant(self, expr_value, sol_cache, lsym, rsym):
-        return bool(self.evaluate(None)) == bool(expr_value)
+        return bool(self._evaluate(None)) == bool(expr_value)
 
     def _get_solve_func_type(self):
         """
@@ -901,6 +1179,7 @@ class Expr_SymbolEQ(_Expr_SymbolValueComparison):
 
     EXPR_FMT = "{0!s}={1!s}"
     OP_EVAL = operator.__eq__
+    OP_CODE = lkconfig.ExprCode.CMP_EQ
 
     # def __eq__  allow swapped lsym,rsym
 
@@ -923,6 +1202,7 @@ class Expr_SymbolNEQ(_Expr_SymbolValueComparison):
 
     EXPR_FMT = "{0!s}!={1!s}"
     OP_EVAL = operator.__ne__
+    OP_CODE = lkconfig.ExprCode.CMP_NE
 
     # def __eq__  allow swapped lsym,rsym
 
@@ -944,6 +1224,7 @@ class Expr_SymbolLTH(_Expr_SymbolValueComparison):
 
     EXPR_FMT = "{0!s}<{1!s}"
     OP_EVAL = operator.__lt__
+    OP_CODE = lkconfig.ExprCode.CMP_LT
 # ---
 
 
@@ -952,6 +1233,7 @@ class Expr_SymbolLEQ(_Expr_SymbolValueComparison):
 
     EXPR_FMT = "{0!s}<={1!s}"
     OP_EVAL = operator.__le__
+    OP_CODE = lkconfig.ExprCode.CMP_LE
 # ---
 
 
@@ -960,6 +1242,7 @@ class Expr_SymbolGTH(_Expr_SymbolValueComparison):
 
     EXPR_FMT = "{0!s}!>{1!s}"
     OP_EVAL = operator.__gt__
+    OP_CODE = lkconfig.ExprCode.CMP_GT
 # ---
 
 
@@ -968,6 +1251,7 @@ class Expr_SymbolGEQ(_Expr_SymbolValueComparison):
 
     EXPR_FMT = "{0!s}!>={1!s}"
     OP_EVAL = operator.__ge__
+    OP_CODE = lkconfig.ExprCode.CMP_GE
 # ---
 
 
@@ -985,6 +1269,7 @@ class Expr_Not(_UnaryExpr):
     def expand_symbols_shared(
         self, symbol_name_map, constants, symbols_names_missing
     ):
+        self.reset_code()
         self.expr = self.expand_subexpr_symbols_shared(
             self.expr, symbol_name_map, constants, symbols_names_missing
         )
@@ -994,9 +1279,13 @@ class Expr_Not(_UnaryExpr):
     def get_dependent_symbols_shared(self, symbol_set):
         self.expr.get_dependent_symbols_shared(symbol_set)
 
-    def evaluate(self, symbol_value_map):
-        return self.expr.evaluate(symbol_value_map).__invert__()
-    # --- end of evaluate (...) ---
+    def _evaluate(self, symbol_value_map):
+        return self.expr._evaluate(symbol_value_map).__invert__()
+    # --- end of _evaluate (...) ---
+
+    def _compile(self, builder):
+        builder.emit(lkconfig.ExprCode.OP_NOT)
+        self.expr._compile(builder)
 
     def simplify(self):
         simpler_expr = self.expr.simplify()
@@ -1039,6 +1328,7 @@ class Expr_Not(_UnaryExpr):
             (_Expr_SymbolValueComparison, _UnaryValueExpr, Expr_SymbolName)
         ):
             subexpr_repl = subexpr.move_negation_inwards()
+            self.reset_code()
             self.expr = subexpr_repl
             return self
 
@@ -1083,11 +1373,18 @@ class Expr_And(_SelfConsumingMultiExpr):
     __slots__ = []
 
     OP_STR = " && "
+    OP_CODE = lkconfig.ExprCode.OP_AND
+
+    # constant "n" in AND => "n"; empty AND => "n"; "y" && _ <=> _
+    VALUE_ABSORBING = symbol.TristateKconfigSymbolValue.n
+    VALUE_EMPTY = symbol.TristateKconfigSymbolValue.n
+    VALUE_NEUTRAL = symbol.TristateKconfigSymbolValue.y
+    VALUE_COMBINE = min
 
     def visit(self, visitor):
         return visitor.visit_and(self)
 
-    def evaluate(self, symbol_value_map):
+    def _evaluate(self, symbol_value_map):
         # this is not identical to all(...),
         #  which would return a bool, whereas "y and m" == "m"
         ret_value = symbol.TristateKconfigSymbolValue.y
@@ -1097,7 +1394,7 @@ class Expr_And(_SelfConsumingMultiExpr):
                 break
 
         return ret_value
-    # --- end of evaluate (...) ---
+    # --- end of _evaluate (...) ---
 
     def _find_solution(self, expr_values, sol_cache):
         for subexpr in self.exprv:
@@ -1115,38 +1412,6 @@ class Expr_And(_SelfConsumingMultiExpr):
         return True
     # ---
 
-    def simplify(self):
-        constant_values, symbol_exprs, nested_exprs = \
-            self.simplify_and_split_subexpr()
-
-        if symbol.TristateKconfigSymbolValue.n in constant_values:
-            # constant "n" in AND
-            return Expr_Constant.get_instance(
-                symbol.TristateKconfigSymbolValue.n
-            )
-
-        elif not symbol_exprs and not nested_exprs:
-            if constant_values:
-                # any other constant in AND (and no symbols/exprs)
-                return Expr_Constant.get_instance(min(constant_values))
-            else:
-                # empty AND
-                return Expr_Constant.get_instance(
-                    symbol.TristateKconfigSymbolValue.n
-                )
-
-        else:
-            # AND depends on a dynamic value
-
-            # "y" && _ <=> _
-            constant_values.discard(symbol.TristateKconfigSymbolValue.y)
-            # constant_values is now either empty or contains just m
-
-            return self.join_simplified_subexpr(
-                constant_values, symbol_exprs, nested_exprs
-            )
-    # --- end of simplify (...) ---
-
     def gen_func_str(self, indent=None):
         yield (indent, "AND(")
         for expr in self.exprv:
@@ -1160,11 +1425,18 @@ class Expr_Or(_SelfConsumingMultiExpr):
     __slots__ = []
 
     OP_STR = " || "
+    OP_CODE = lkconfig.ExprCode.OP_OR
+
+    # constant "y" in OR => "y"; empty OR => "y"; "n" || _ <=> _
+    VALUE_ABSORBING = symbol.TristateKconfigSymbolValue.y
+    VALUE_EMPTY = symbol.TristateKconfigSymbolValue.y
+    VALUE_NEUTRAL = symbol.TristateKconfigSymbolValue.n
+    VALUE_COMBINE = max
 
     def visit(self, visitor):
         return visitor.visit_or(self)
 
-    def evaluate(self, symbol_value_map):
+    def _evaluate(self, symbol_value_map):
         ret_value = symbol.TristateKconfigSymbolValue.n
         for value in self.iter_evaluate_subexpr(symbol_value_map):
             ret_value = max(ret_value, value)
@@ -1173,39 +1445,7 @@ class Expr_Or(_SelfConsumingMultiExpr):
                 break
 
         return ret_value
-    # --- end of evaluate (...) ---
-
-    def simplify(self):
-        constant_values, symbol_exprs, nested_exprs = \
-            self.simplify_and_split_subexpr()
-
-        if symbol.TristateKconfigSymbolValue.y in constant_values:
-            # constant "y" in OR
-            return Expr_Constant.get_instance(
-                symbol.TristateKconfigSymbolValue.y
-            )
-
-        elif not symbol_exprs and not nested_exprs:
-            if constant_values:
-                # any other constant in OR (and no symbols/exprs)
-                return Expr_Constant.get_instance(max(constant_values))
-            else:
-                # empty OR
-                return Expr_Constant.get_instance(
-                    symbol.TristateKconfigSymbolValue.y
-                )
-
-        else:
-            # OR depends on a dynamic value
-
-            # "n" || _ <=> _
-            constant_values.discard(symbol.TristateKconfigSymbolValue.n)
-            # constant_values is now either empty or contains just m
-
-            return self.join_simplified_subexpr(
-                constant_values, symbol_exprs, nested_exprs
-            )
-    # --- end of simplify (...) ---
+    # --- end of _evaluate (...) ---
 
     def gen_func_str(self, indent=None):
         yield (indent, "OR(")
@@ -1231,10 +1471,10 @@ class Expr_Or(_SelfConsumingMultiExpr):
 
     def _evaluate_solution(self, symbol_value_map, expr_values, solution):
         for subexpr in self.exprv:
-            solvable, sub_solution = subexpr.evaluate_solution(
-                symbol_value_map, expr_values
-            )
-            if solvable:
+            sub_solution = set()
+            if subexpr._evaluate_solution(
+                symbol_value_map, expr_values, sub_solution
+            ):
                 solution.update(sub_solution)
                 return True
         # --
@@ -1247,3 +1487,259 @@ class Expr_Or(_SelfConsumingMultiExpr):
 def Expr_Impl(expr_premise, expr_conclusion):
     return Expr_Or(Expr_Not(expr_premise), expr_conclusion)
 # --- end of Expr_Impl ---
+
+
+class ExprPool(object):
+    """
+    Hash-consing table for dependency expressions.
+
+    Creates each structurally distinct expression only once,
+    so that shared subexpressions, e.g. "PCI && HAS_IOMEM",
+    are represented by a single object,
+    and memoizes normalize() and simplify() per expression.
+    AND/OR expressions get their static hash on creation.
+
+    Composite expressions are identified by their type
+    and the ids of their subexpressions, which are pooled as well.
+    The pool keeps all of its expressions alive,
+    it should be dropped after creating the symbol graph.
+
+    Expressions created by a pool must not be modified,
+    the pool's methods return new expressions instead.
+    """
+
+    __slots__ = ["_nodes", "_normalized", "_negated", "_simplified"]
+
+    def __init__(self):
+        super().__init__()
+        self._nodes = {}
+        self._normalized = {}
+        self._negated = {}
+        self._simplified = {}
+    # --- end of __init__ (...) ---
+
+    def __len__(self):
+        return len(self._nodes)
+
+    def _get_node(self, key, node_cls, *args):
+        try:
+            return self._nodes[key]
+        except KeyError:
+            pass
+
+        node = node_cls(*args)
+        self._nodes[key] = node
+        return node
+    # --- end of _get_node (...) ---
+
+    def get_constant(self, value):
+        # tristate "n" == 0, keep constants of different type apart
+        return self._get_node(
+            (Expr_Constant, type(value), value), Expr_Constant, value
+        )
+
+    def get_symbol(self, sym):
+        return self._get_node((Expr_Symbol, sym), Expr_Symbol, sym)
+
+    def get_symbol_name(self, name):
+        return self._get_node((Expr_SymbolName, name), Expr_SymbolName, name)
+
+    def get_not(self, expr):
+        return self._get_node((Expr_Not, id(expr)), Expr_Not, expr)
+
+    def get_cmp(self, cmp_cls, lsym, rsym):
+        return self._get_node(
+            (cmp_cls, id(lsym), id(rsym)), cmp_cls, lsym, rsym
+        )
+
+    def get_junction(self, junction_cls, exprv):
+        """Returns the AND/OR expression for the given subexpressions.
+        Subexpressions of the same type are consumed.
+
+        @param junction_cls:  Expr_And or Expr_Or
+        @type  junction_cls:  C{type}
+        @param exprv:         pooled subexpressions
+        @type  exprv:         iterable of subclass of L{Expr}
+
+        @return:  pooled expression
+        @rtype:   junction_cls
+        """
+        flat_exprv = []
+        for expr in exprv:
+            if type(expr) is junction_cls:
+                flat_exprv.extend(expr.exprv)
+            else:
+                flat_exprv.append(expr)
+        # --
+
+        key = (junction_cls,) + tuple(map(id, flat_exprv))
+        try:
+            return self._nodes[key]
+        except KeyError:
+            pass
+
+        node = junction_cls()
+        node.exprv = flat_exprv
+        node.static_hash = hash((junction_cls,) + tuple(flat_exprv))
+        self._nodes[key] = node
+        return node
+    # --- end of get_junction (...) ---
+
+    def get_and(self, exprv):
+        return self.get_junction(Expr_And, exprv)
+
+    def get_or(self, exprv):
+        return self.get_junction(Expr_Or, exprv)
+
+    def normalize(self, expr):
+        """Moves negations inwards, see Expr.move_negation_inwards().
+
+        @param expr:  pooled expression
+        @type  expr:  subclass of L{Expr}
+
+        @return:  pooled expression, may be expr
+        @rtype:   subclass of L{Expr}
+        """
+        try:
+            return self._normalized[id(expr)]
+        except KeyError:
+            pass
+
+        if isinstance(expr, Expr_Not):
+            result = self.negate(expr.expr)
+
+        elif isinstance(expr, _MultiExpr):
+            exprv = [self.normalize(e) for e in expr.exprv]
+            if all(a is b for a, b in zip(exprv, expr.exprv)):
+                result = expr
+            else:
+                result = self.get_junction(type(expr), exprv)
+
+        else:
+            result = expr
+        # --
+
+        self._normalized[id(expr)] = result
+        return result
+    # --- end of normalize (...) ---
+
+    def negate(self, expr):
+        """Returns the normalized negation of an expression.
+
+        @param expr:  pooled expression
+        @type  expr:  subclass of L{Expr}
+
+        @return:  pooled expression
+        @rtype:   subclass of L{Expr}
+        """
+        try:
+            return self._negated[id(expr)]
+        except KeyError:
+            pass
+
+        if isinstance(expr, Expr_Not):
+            # double negation
+            result = self.normalize(expr.expr)
+
+        elif isinstance(expr, Expr_And):
+            result = self.get_or([self.negate(e) for e in expr.exprv])
+
+        elif isinstance(expr, Expr_Or):
+            result = self.get_and([self.negate(e) for e in expr.exprv])
+
+        elif isinstance(
+            expr,
+            (_Expr_SymbolValueComparison, _UnaryValueExpr, Expr_SymbolName)
+        ):
+            result = self.get_not(expr)
+
+        else:
+            raise AssertionError("expr")
+        # --
+
+        self._negated[id(expr)] = result
+        return result
+    # --- end of negate (...) ---
+
+    def simplify(self, expr):
+        """Simplifies an expression, see Expr.simplify().
+
+        @param expr:  pooled expression
+        @type  expr:  subclass of L{Expr}
+
+        @return:  pooled expression, may be expr
+        @rtype:   subclass of L{Expr}
+        """
+        try:
+            return self._simplified[id(expr)]
+        except KeyError:
+            pass
+
+        if isinstance(expr, Expr_Not):
+            subexpr = self.simplify(expr.expr)
+
+            if isinstance(subexpr, Expr_Constant):
+                result = self.get_constant(
+                    subexpr.evaluate(None).__invert__()
+                )
+
+            elif isinstance(expr.expr, Expr_Not):
+                # not not expr => expr
+                result = self.simplify(expr.expr.expr)
+
+            elif subexpr is expr.expr:
+                result = expr
+
+            else:
+                result = self.get_not(subexpr)
+
+        elif isinstance(expr, _SelfConsumingMultiExpr):
+            result = self._simplify_junction(expr)
+
+        elif isinstance(expr, _Expr_SymbolValueComparison):
+            if (
+                isinstance(expr.lsym, Expr_Constant)
+                and isinstance(expr.rsym, Expr_Constant)
+            ):
+                result = self.get_constant(expr._evaluate(None))
+            else:
+                result = expr
+
+        else:
+            result = expr
+        # --
+
+        self._simplified[id(expr)] = result
+        return result
+    # --- end of simplify (...) ---
+
+    def _simplify_junction(self, expr):
+        constant_values = set()
+        # id => subexpr, drops duplicates and keeps the order
+        dynamic_exprs = {}
+
+        for subexpr in expr.exprv:
+            simpler_expr = self.simplify(subexpr)
+
+            if isinstance(simpler_expr, Expr_Constant):
+                constant_values.add(simpler_expr.evaluate(None))
+            else:
+                dynamic_exprs[id(simpler_expr)] = simpler_expr
+        # --
+
+        value = expr.fold_constant_values(
+            constant_values, bool(dynamic_exprs)
+        )
+        if value is not None:
+            return self.get_constant(value)
+
+        exprv = [self.get_constant(v) for v in constant_values]
+        exprv.extend(dynamic_exprs.values())
+
+        if len(exprv) == 1:
+            return exprv[0]
+        else:
+            return self.get_junction(type(expr), exprv)
+    # --- end of _simplify_junction (...) ---
+
+# --- end of ExprPool ---
@@ -39,8 +39,12 @@ class KconfigSymbolExpressionBuilder(loggable.AbstractLoggable):
         return list(self._gen_createv(top_expr_views))
 
     def _createv_junction(self, junction_cls, one_expr_cls, component_views):
-        expr_iter = self._gen_createv(component_views)
+        return self._join_junction(
+            junction_cls, one_expr_cls, self._gen_createv(component_views)
+        )
+    # --- end of _createv_junction (...) ---
 
+    def _join_junction(self, junction_cls, one_expr_cls, expr_iter):
         try:
             first_expr = next(expr_iter)
         except StopIteration:
@@ -60,7 +64,7 @@ class KconfigSymbolExpressionBuilder(loggable.AbstractLoggable):
         # add remaining exprs
         junction_expr.extend_expr(expr_iter)
         return junction_expr
-    # --- end of _createv_junction (...) ---
+    # --- end of _join_junction (...) ---
 
     def createv_and(self, component_views):
         return self._createv_junction(
@@ -74,6 +78,148 @@ class KconfigSymbolExpressionBuilder(loggable.AbstractLoggable):
         )
     # ---
 
+    def create_symbol_exprs(
+        self, expr_pool, symbol_names, symbol_name_map, constants
+    ):
+        """Converts the symbol names referenced by expressions
+        to symbol or constant expressions.
+
+        A name is first looked up in constants (resulting in a
+        Expr_Constant object), and then in symbol_name_map (Expr_Symbol).
+        Meta symbols (no name) are converted to constant "n".
+
+        @param expr_pool:        expression pool
+        @type  expr_pool:        L{ExprPool}
+        @param symbol_names:     symbol names
+        @type  symbol_names:     iterable of C{str} or C{None}
+        @param symbol_name_map:  symbol name to symbol map
+        @type  symbol_name_map:  C{dict}-like :: C{str} => _
+        @param constants:        symbol name to constant,hashable value map
+        @type  constants:        C{dict} :: C{str} => a, a.__hash__ != None
+
+        @return: 2-tuple (list of expressions, set of missing symbol names),
+                 names that could not be resolved are kept as
+                 Expr_SymbolName objects
+        @rtype:  2-tuple (C{list} of subclass of L{Expr}, C{set} of C{str})
+        """
+        const_false = expr_pool.get_constant(
+            symbol.TristateKconfigSymbolValue.n
+        )
+
+        symbol_names_missing = set()
+        sym_exprs = []
+
+        for name in symbol_names:
+            if not name:
+                sym_expr = const_false
+
+            elif name in constants:
+                sym_expr = expr_pool.get_constant(constants[name])
+
+            else:
+                sym = symbol_name_map.get(name)
+                if sym is None:
+                    symbol_names_missing.add(name)
+                    sym_expr = expr_pool.get_symbol_name(name)
+                else:
+                    sym_expr = expr_pool.get_symbol(sym)
+            # --
+
+            sym_exprs.append(sym_expr)
+        # --
+
+        return (sym_exprs, symbol_names_missing)
+    # --- end of create_symbol_exprs (...) ---
+
+    def create_nodes(self, expr_pool, symtab, sym_exprs):
+        """Converts the flat expression node table of a symbol table
+        to pooled Expr objects, in one linear pass.
+
+        The node table is in topological order,
+        so the operands of a node have already been converted
+        when reaching the node.
+        Shared subexpressions get converted only once
+        and are referenced by all parent expressions.
+
+        Note: the created expressions are not normalized,
+              see create_from_node().
+
+        @param expr_pool:  expression pool
+        @type  expr_pool:  L{ExprPool}
+        @param symtab:     symbol table
+        @type  symtab:     L{SymbolTable}
+        @param sym_exprs:  expressions for symtab.expr_symbol_names,
+                           see create_symbol_exprs()
+        @type  sym_exprs:  C{list} of subclass of L{Expr}
+
+        @return: list of expressions, indexed by node
+        @rtype:  C{list} of subclass of L{Expr}
+        """
+        E_OR = lkconfig.ExprView.E_OR
+        E_AND = lkconfig.ExprView.E_AND
+        E_NOT = lkconfig.ExprView.E_NOT
+        E_SYMBOL = lkconfig.ExprView.E_SYMBOL
+        sym_cmp_cls_map = self.SYM_CMP_CLS_MAP
+
+        const_false = expr_pool.get_constant(
+            symbol.TristateKconfigSymbolValue.n
+        )
+
+        nodes = []
+        for etype, lidx, ridx, sidx in zip(
+            memoryview(symtab.expr_types).cast("i"),
+            memoryview(symtab.expr_lefts).cast("i"),
+            memoryview(symtab.expr_rights).cast("i"),
+            memoryview(symtab.expr_syms).cast("i")
+        ):
+            if etype == E_SYMBOL:
+                expr = sym_exprs[sidx] if sidx >= 0 else const_false
+
+            elif etype == E_OR:
+                expr = expr_pool.get_or((nodes[lidx], nodes[ridx]))
+
+            elif etype == E_AND:
+                expr = expr_pool.get_and((nodes[lidx], nodes[ridx]))
+
+            elif etype == E_NOT:
+                expr = expr_pool.get_not(nodes[lidx])
+
+            else:
+                try:
+                    sym_cmp_cls = sym_cmp_cls_map[etype]
+                except KeyError:
+                    raise NotImplementedError(etype) from None
+
+                expr = expr_pool.get_cmp(
+                    sym_cmp_cls, nodes[lidx], nodes[ridx]
+                )
+            # --
+
+            nodes.append(expr)
+        # --
+
+        return nodes
+    # --- end of create_nodes (...) ---
+
+    def create_from_node(self, expr_pool, nodes, node_idx):
+        """Returns the normalized top-level expression for a node index.
+
+        @param expr_pool: expression pool
+        @type  expr_pool: L{ExprPool}
+        @param nodes:     expressions, see create_nodes()
+        @type  nodes:     C{list} of subclass of L{Expr}
+        @param node_idx:  node index, negative values mean "no expression"
+        @type  node_idx:  C{int}
+
+        @return: expr or None
+        @rtype:  subclass of L{Expr} or C{None}
+        """
+        if node_idx < 0:
+            return None
+        else:
+            return expr_pool.normalize(nodes[node_idx])
+    # --- end of create_from_node (...) ---
+
     def create(self, top_expr_view):
         """Recursively converts an ExprView to an Expr.
 
@@ -222,30 +368,36 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
     @cvar SYMBOL_TYPE_TO_CLS_MAP:  mapping from lkc symbol type to symbol class
     @type SYMBOL_TYPE_TO_CLS_MAP:  C{dict} :: C{int} => C{type}|C{None}
 
-    @cvar _did_read_lkc_symbols:   class-wide variable that is used to remember
-                                   whether lkconfig.read_symbols() has been
-                                   called, which should only be done once
-                                   per script run/process.
-    @type _did_read_lkc_symbols:   C{bool}
-
     @ivar source_info:  object that provides some information about the
                         kconfig structure being parsed
     @type source_info:  subclass of L{SourceInfo}
 
+    @ivar symtab_cache: symbol table cache, may be None
+    @type symtab_cache: L{SymbolTableCache} or C{None}
+
+    @ivar symtab:       already parsed symbol table, may be None,
+                        e.g. from a L{KconfigParsePool} worker
+    @type symtab:       L{CachedSymbolTable} or C{None}
+
+    @ivar lkc_context:  lkc parser state of the kconfig structure,
+                        created on demand
+    @type lkc_context:  L{lkconfig.Context} or C{None}
+
     @ivar _symbols:     kconfig symbols data structure
     @type _symbols:     L{KconfigSymbols}
-    @ivar _dir_deps:    a symbol -> dir_dep mapping,
+    @ivar _dir_deps:    a symbol -> dir_dep expression node index mapping,
                         used for linking symbols to Expr objects
-    @type _dir_deps:    C{dict} :: L{AbstractKconfigSymbol} => L{Expr}
-    @ivar _vis_deps:    a symbol -> vis_dep mapping
-    @type _vis_deps:    C{dict} :: L{AbstractKconfigSymbol} => L{Expr}
+    @type _dir_deps:    C{dict} :: L{AbstractKconfigSymbol} => C{int}
+    @ivar _vis_deps:    a symbol -> prompt vis_dep node indices mapping
+    @type _vis_deps:    C{dict} :: L{AbstractKconfigSymbol}
+                                => C{list} of C{int}
     @ivar _def_deps:    a symbol -> intermediate symbol defaults mapping
                         "intermediate symbol defaults" are
-                        2-tuples (dir_dep, vis_dep).
+                        2-tuples (dir_dep, vis_dep) of node indices.
                         They are converted to L{KconfigSymbolDefault} objects
                         during the "link deps" phase.
     @type _def_deps:    C{dict} :: L{AbstractKconfigSymbol}
-                                => C{list} of 2-tuple <L{Expr}>
+                                => C{list} of 2-tuple <C{int}>
     """
 
     SYMBOL_TYPE_TO_CLS_MAP = {
@@ -257,8 +409,6 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
         lkconfig.S_OTHER:       None
     }
 
-    _did_read_lkc_symbols = False
-
     @classmethod
     def get_default_symbol_constants(cls):
         return {
@@ -270,8 +420,13 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
         }
     # --- end of get_default_symbol_constants (...) ---
 
-    def __init__(self, source_info, **kwargs):
+    def __init__(
+        self, source_info, symtab_cache=None, symtab=None, **kwargs
+    ):
         super().__init__(source_info=source_info, **kwargs)
+        self.symtab_cache = symtab_cache
+        self.symtab = symtab
+        self.lkc_context = None
         self._symbols = symbols.KconfigSymbols()
         self._dir_deps = {}
         self._vis_deps = {}
@@ -279,16 +434,28 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
     # --- end of __init__ (...) ---
 
     def read_lkc_symbols(self):
-        """Instructs the lkc parser to read kconfig symbols.
+        """Makes the lkc context of this generator the active one,
+        and instructs the lkc parser to read kconfig symbols
+        if that has not been done yet for this context.
 
-        No-op if _did_read_lkc_symbols is True.
+        The context stays active only as long as the caller
+        holds symbols.lkc_session_lock, see KconfigSymbols.lkc_session().
 
         @return: None (implicit)
         """
-        # pylint: disable=W0212
-        if not self.__class__._did_read_lkc_symbols:
-            self.__class__._did_read_lkc_symbols = True
-            self._read_lkc_symbols()
+        with symbols.lkc_session_lock:
+            lkc_context = self.lkc_context
+            if lkc_context is None:
+                lkc_context = lkconfig.Context()
+                self.lkc_context = lkc_context
+
+            lkconfig.switch_context(lkc_context)
+
+            if not lkc_context.have_symbols:
+                # the environment may have been set up
+                # for another source tree in the meantime
+                self.source_info.setenv()
+                self._read_lkc_symbols()
     # --- end of read_lkc_symbols (...) ---
 
     def get_lkc_symbols(self):
@@ -297,10 +464,53 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
         @return: list of symbol view objects
         @rtype:  list of L{SymbolView}
         """
-        self.read_lkc_symbols()
-        return self._get_lkc_symbols()
+        with symbols.lkc_session_lock:
+            self.read_lkc_symbols()
+            return self._get_lkc_symbols()
     # --- end of get_lkc_symbols (...) ---
 
+    def get_lkc_symbol_table(self):
+        """Gets the packed symbol table from the lkc parser.
+
+        @return: symbol table
+        @rtype:  L{SymbolTable}
+        """
+        with symbols.lkc_session_lock:
+            self.read_lkc_symbols()
+            return self._get_lkc_symbol_table()
+    # --- end of get_lkc_symbol_table (...) ---
+
+    def get_symbol_table(self):
+        """Gets the packed symbol table, either the already parsed one,
+        from the symbol table cache or from the lkc parser.
+
+        Writes the symbol table to the cache after parsing Kconfig files.
+        Note that lkc does not know about the symbols
+        if they have been read from the cache.
+
+        @return: symbol table
+        @rtype:  L{SymbolTable} or L{CachedSymbolTable}
+        """
+        if self.symtab is not None:
+            return self.symtab
+
+        symtab_cache = self.symtab_cache
+
+        if symtab_cache is not None:
+            symtab = symtab_cache.load()
+            if symtab is not None:
+                return symtab
+        # --
+
+        with symbols.lkc_session_lock:
+            symtab = self.get_lkc_symbol_table()
+
+            if symtab_cache is not None:
+                symtab_cache.store(symtab, lkconfig.get_kconfig_deps())
+
+        return symtab
+    # --- end of get_symbol_table (...) ---
+
     def constify_missing_symbol(self, name):
         """Converts the name of a missing symbol into a constant value.
 
@@ -340,33 +550,44 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
         Imports kconfig symbols from the lkc parser
         and adds them to self._symbols.
 
-        Also collects dependencies, but does not "link" them to symbols,
+        Also collects the node indices of dependencies,
+        but does not "link" them to symbols,
         which needs to be done after reading all symbols.
+
+        @return: symbol table
+        @rtype:  L{SymbolTable} or L{CachedSymbolTable}
         """
         get_symbol_cls = self.SYMBOL_TYPE_TO_CLS_MAP.__getitem__
 
-        expr_builder = self.create_loggable(
-            KconfigSymbolExpressionBuilder, logger_name="ExpressionBuilder"
-        )
-
         kconfig_symbols = self._symbols
         dir_deps = self._dir_deps
         vis_deps = self._vis_deps
         def_deps = self._def_deps
 
-        for sym_view in self.get_lkc_symbols():
-            sym_cls = get_symbol_cls(sym_view.s_type)
-
-            if sym_view.name:
+        symtab = self.get_symbol_table()
+        s_types = memoryview(symtab.s_types).cast("i")
+        sym_dir_deps = memoryview(symtab.dir_deps).cast("i")
+        prompt_offsets = memoryview(symtab.prompt_offsets).cast("i")
+        prompt_counts = memoryview(symtab.prompt_counts).cast("i")
+        prompt_vis_deps = memoryview(symtab.prompt_vis_deps).cast("i")
+        default_offsets = memoryview(symtab.default_offsets).cast("i")
+        default_counts = memoryview(symtab.default_counts).cast("i")
+        default_dir_deps = memoryview(symtab.default_dir_deps).cast("i")
+        default_vis_deps = memoryview(symtab.default_vis_deps).cast("i")
+
+        # the symbol table row is also the lkc symbol index
+        for sym_idx, sym_name in enumerate(symtab.names):
+            if sym_name:
                 # do not create nameless symbols
-                sym = sym_cls(sym_view.name)
-                sym_prompts = sym_view.get_prompts()
+                sym = get_symbol_cls(s_types[sym_idx])(sym_name, index=sym_idx)
 
                 kconfig_symbols.add_symbol(sym)
-                dir_deps[sym] = expr_builder.create(sym_view.get_dir_dep())
-                vis_deps[sym] = expr_builder.createv_or(
-                    (p[1] for p in sym_prompts)
-                )
+                dir_deps[sym] = sym_dir_deps[sym_idx]
+
+                prompt_offset = prompt_offsets[sym_idx]
+                vis_deps[sym] = prompt_vis_deps[
+                    prompt_offset:prompt_offset + prompt_counts[sym_idx]
+                ].tolist()
 
                 # get symbol defaults
                 #  keep dependency and visibility depepencies separate,
@@ -376,68 +597,45 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
                 # spare the overhead if defaults
                 # are not supported for the symbol (type)
                 if sym.supports_defaults():
-                    def_deps[sym] = [
-                        (
-                            expr_builder.create(def_dir_dep),
-                            expr_builder.create(def_vis_dep),
-                        )
-                        for def_dir_dep, def_vis_dep in sym_view.get_defaults()
-                    ]
+                    default_offset = default_offsets[sym_idx]
+                    default_end = default_offset + default_counts[sym_idx]
+                    def_deps[sym] = list(zip(
+                        default_dir_deps[default_offset:default_end],
+                        default_vis_deps[default_offset:default_end]
+                    ))
                 # --
             # --
         # --
+
+        return symtab
     # --- end of _prepare_symbols (...) ---
 
-    def _link_deps(self):
+    def _link_deps(self, symtab):
         """
         Links the dependencies of all symbols to symbols,
         so that they can be evaluated.
 
-        Reports missing symbol names via self.logger.
-        """
-        def expand_once(symbol_map, constants):
-            def expand_dep_dict(dep_dict, symbol_names_missing):
-                nonlocal symbol_map, constants
-                for sym_key in list(dep_dict):
-                    dep_expr = dep_dict[sym_key]
-                    if dep_expr is not None:
-                        dep_dict[sym_key] = dep_expr.expand_symbols_shared(
-                            symbol_map, constants, symbol_names_missing
-                        )
-            # ---
-
-            def expand_def_dep_dict(def_dep_dict, symbol_names_missing):
-                # def_dep_dict: sym -> list of 2-tuple (dir_dep, vis_dep)
-                nonlocal symbol_map, constants
-                for sym_key in list(def_dep_dict):
-                    dep_exprv = def_dep_dict[sym_key]
-                    if dep_exprv:
-                        def_dep_dict[sym_key] = [
-                            [
-                                (
-                                    dep_expr.expand_symbols_shared(
-                                        symbol_map, constants,
-                                        symbol_names_missing
-                                    ) if dep_expr is not None else None
-                                ) for dep_expr in dep_tuple
-                            ]
-                            for dep_tuple in dep_exprv
-                        ]
-            # ---
+        The expressions are created in an expression pool,
+        so that each distinct (sub)expression gets created, normalized
+        and simplified only once and is shared by all symbols using it.
 
-            symbol_names_missing = set()
-            expand_dep_dict(self._dir_deps, symbol_names_missing)
-            expand_dep_dict(self._vis_deps, symbol_names_missing)
-            expand_def_dep_dict(self._def_deps, symbol_names_missing)
+        Reports missing symbol names via self.logger.
 
-            return symbol_names_missing
-        # ---
+        @param symtab:  symbol table, see _prepare_symbols()
+        @type  symtab:  L{SymbolTable} or L{CachedSymbolTable}
+        """
+        expr_builder = self.create_loggable(
+            KconfigSymbolExpressionBuilder, logger_name="ExpressionBuilder"
+        )
+        expr_pool = symbolexpr.ExprPool()
 
         sym_constants = self.get_default_symbol_constants()
 
-        # expand once, collect missing names
+        # resolve symbol names once, collect missing names
         self.logger.debug("Expanding dependency expressions")
-        symbol_names_missing = expand_once(self._symbols, sym_constants)
+        sym_exprs, symbol_names_missing = expr_builder.create_symbol_exprs(
+            expr_pool, symtab.expr_symbol_names, self._symbols, sym_constants
+        )
 
         if symbol_names_missing:
             self.logger.info(
@@ -461,7 +659,12 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
             # -- end debug | nodebug
 
             self.logger.debug("Expanding dependency expressions again")
-            symbol_names_missing = expand_once(self._symbols, sym_constants)
+            sym_exprs, symbol_names_missing = (
+                expr_builder.create_symbol_exprs(
+                    expr_pool, symtab.expr_symbol_names,
+                    self._symbols, sym_constants
+                )
+            )
             if symbol_names_missing:
                 raise AssertionError(
                     "second expr expansion should not report missing symbols",
@@ -470,23 +673,40 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
             # --
         # -- end if default missing and retry
 
+        expr_nodes = expr_builder.create_nodes(expr_pool, symtab, sym_exprs)
+
+        def create_expr(node_idx):
+            nonlocal expr_pool, expr_nodes
+            expr = expr_builder.create_from_node(
+                expr_pool, expr_nodes, node_idx
+            )
+            return None if expr is None else expr_pool.simplify(expr)
+        # ---
+
+        def create_exprv_or(node_indices):
+            nonlocal expr_pool, expr_nodes
+            exprv = [
+                expr_builder.create_from_node(expr_pool, expr_nodes, idx)
+                for idx in node_indices if idx >= 0
+            ]
+            if not exprv:
+                return None
+            elif len(exprv) == 1:
+                return expr_pool.simplify(exprv[0])
+            else:
+                return expr_pool.simplify(expr_pool.get_or(exprv))
+        # ---
+
         # simplify and assign dir_dep to symbols
-        for sym, dep_expr in self._dir_deps.items():
-            sym.dir_dep = None if dep_expr is None else dep_expr.simplify()
+        for sym, node_idx in self._dir_deps.items():
+            sym.dir_dep = create_expr(node_idx)
 
-        for sym, vis_expr in self._vis_deps.items():
-            sym.vis_dep = None if vis_expr is None else vis_expr.simplify()
+        for sym, node_indices in self._vis_deps.items():
+            sym.vis_dep = create_exprv_or(node_indices)
 
-        for sym, def_exprv in self._def_deps.items():
+        for sym, def_node_indices in self._def_deps.items():
             sym.defaults = None  # nop
-            if def_exprv:
-                simplified_def_exprv = [
-                    [
-                        (None if dep_expr is None else dep_expr.simplify())
-                        for dep_expr in dep_tuple
-                    ] for dep_tuple in def_exprv
-                ]
-
+            if def_node_indices:
                 # construct KconfigSymbolDefault objects
                 #  FIXME: does it make sense to construct a default
                 #         if dir_dep is None?
@@ -495,7 +715,10 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
                     symbol.KconfigSymbolDefault(
                         dir_dep=dir_dep, vis_dep=vis_dep
                     )
-                    for dir_dep, vis_dep in simplified_def_exprv
+                    for dir_dep, vis_dep in (
+                        (create_expr(dir_idx), create_expr(vis_idx))
+                        for dir_idx, vis_idx in def_node_indices
+                    )
                     if (dir_dep is not None or vis_dep is not None)
                 ]
 
@@ -504,6 +727,10 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
                 # -- end if set defaults?
             # -- otherwise keep None
         # --
+
+        self.logger.debug(
+            "Created %d distinct dependency expressions", len(expr_pool)
+        )
     # --- end of _link_deps (...) ---
 
     def get_symbols(self):
@@ -511,15 +738,32 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
         Imports Kconfig symbols, collects and expand dependencies,
         and returns the result as KconfigSymbols object.
 
+        If the symbol table came from the cache (or self.symtab),
+        lkc has not parsed the Kconfig files yet.
+        It parses them when the symbols' lkc session is entered,
+        see KconfigSymbols.prepare_lkc().
+
         @return: kconfig symbols
         @rtype:  L{KconfigSymbols}
         """
-        symbolexpr.clear_cache()
-        try:
-            self._prepare_symbols()
-            self._link_deps()
-        finally:
+        # the expression caches of symbolexpr are module-global,
+        # and the symbol table cache compares the environment
+        # against its recorded values
+        with symbols.lkc_session_lock:
+            self.source_info.setenv()
             symbolexpr.clear_cache()
+            try:
+                symtab = self._prepare_symbols()
+                self._link_deps(symtab)
+            finally:
+                self._dir_deps.clear()
+                self._vis_deps.clear()
+                self._def_deps.clear()
+                symbolexpr.clear_cache()
+        # --
+
+        # parse lazily when lkc is needed, if symbols were read from cache
+        self._symbols.set_lkc_loader(self.read_lkc_symbols)
         return self._symbols
     # --- end of get_symbols (...) ---
 
@@ -539,4 +783,12 @@ class KconfigSymbolGenerator(informed.AbstractSourceInformed):
         return lkconfig.get_symbols()
     # --- end of _get_lkc_symbols (...) ---
 
+    def _get_lkc_symbol_table(self):
+        """Instructs the lkc parser to return the packed symbol table.
+        Does not make an attempt at reading the symbols,
+        use get_lkc_symbol_table().
+        """
+        return lkconfig.get_symbol_table()
+    # --- end of _get_lkc_symbol_table (...) ---
+
 # --- end of KconfigSymbolGenerator ---
@@ -0,0 +1,561 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import hashlib
+import mmap
+import os
+import struct
+import sys
+
+from ..abc import informed
+from ..util import fileio
+from . import lkconfig  # pylint: disable=E0611
+
+__all__ = ["SymbolTableCache", "CachedSymbolTable"]
+
+
+class CachedSymbolTable(object):
+    """
+    A symbol table that has been loaded from a cache file.
+
+    Provides the same attributes as lkconfig's SymbolTable,
+    packed int columns are memoryviews of the mmap-ed cache file.
+
+    @ivar _mmap:  mmap-ed cache file, referenced by the memoryview columns
+    @type _mmap:  C{mmap.mmap}
+    """
+
+    def __init__(self, mmap_obj, fields):
+        super().__init__()
+        self._mmap = mmap_obj
+        for field_name, value in fields.items():
+            setattr(self, field_name, value)
+    # --- end of __init__ (...) ---
+
+# --- end of CachedSymbolTable ---
+
+
+class SymbolTableCache(informed.AbstractSourceInformed):
+    """
+    Persistent on-disk cache for lkconfig's SymbolTable,
+    so that the Kconfig symbols can be created without running
+    the lkc parser if the same kernel sources have been parsed before.
+
+    lkc does not know about the cached symbols, and it still needs
+    to parse the Kconfig files before its functions can be used,
+    see KconfigSymbols.prepare_lkc(). oldconfig needs lkc,
+    so a generate-config run parses the Kconfig files on a cache hit, too,
+    and only saves exporting the symbol table from lkc.
+    Runs that do not call into lkc afterwards skip parsing entirely,
+    e.g. KconfigParsePool workers.
+
+    Cache entries are identified by a cache key
+    that consists of the toplevel Kconfig file, the environment variables
+    that are relevant for lkc (srctree, ARCH, SRCARCH and KERNELVERSION),
+    and the lkconfig module itself.
+    Each cache entry records the Kconfig files that were read
+    and the environment variables referenced via "option env",
+    and is considered stale if any of them has changed.
+
+    File format (native byte order and int size, see CACHE_KEY_FORMAT):
+
+      header   := magic, version, section count, 0
+      sections := section count * (section type, offset, length)
+      <section data, each section is 8-byte aligned>
+
+    Section types are "i" (packed int array), "q" (packed int64 array)
+    and "s" (str list: count, count * int32 length (-1 for None), utf-8 data).
+    The first sections are the SymbolTable fields in SYMTAB_FIELDS order,
+    followed by the DEPS_FIELDS sections.
+
+    @cvar SYMTAB_FIELDS:  SymbolTable fields and their section types
+    @type SYMTAB_FIELDS:  C{tuple} of 2-tuple (C{str}, C{str})
+    @cvar DEPS_FIELDS:    dependency sections and their section types
+    @type DEPS_FIELDS:    C{tuple} of 2-tuple (C{str}, C{str})
+
+    @ivar cache_dir:      cache directory
+    @type cache_dir:      C{str}
+    """
+
+    CACHE_FILE_MAGIC = b"KCSYMTAB"
+    CACHE_FILE_VERSION = 1
+    CACHE_FILE_SUFFIX = ".symtab"
+
+    HEADER_STRUCT = struct.Struct("=8sIII")
+    SECTION_STRUCT = struct.Struct("=4sQQ")
+    INT32_STRUCT = struct.Struct("=i")
+
+    SYMTAB_FIELDS = (
+        ("names", "s"),
+        ("s_types", "i"),
+        ("flags", "i"),
+        ("dir_deps", "i"),
+        ("prompt_offsets", "i"),
+        ("prompt_counts", "i"),
+        ("prompt_texts", "s"),
+        ("prompt_vis_deps", "i"),
+        ("default_offsets", "i"),
+        ("default_counts", "i"),
+        ("default_dir_deps", "i"),
+        ("default_vis_deps", "i"),
+        ("select_offsets", "i"),
+        ("select_counts", "i"),
+        ("select_targets", "i"),
+        ("select_vis_deps", "i"),
+        ("choice_offsets", "i"),
+        ("choice_counts", "i"),
+        ("choice_values", "i"),
+        ("expr_types", "i"),
+        ("expr_lefts", "i"),
+        ("expr_rights", "i"),
+        ("expr_syms", "i"),
+        ("expr_symbol_names", "s")
+    )
+
+    DEPS_FIELDS = (
+        ("kconfig_files", "s"),
+        ("kconfig_file_stats", "q"),
+        ("env_names", "s"),
+        ("env_values", "s")
+    )
+
+    # anything that affects the binary representation of the cache file
+    CACHE_KEY_FORMAT = "{v}:{i}:{q}:{o}".format(
+        v=CACHE_FILE_VERSION,
+        i=struct.calcsize("i"),
+        q=struct.calcsize("q"),
+        o=sys.byteorder
+    )
+
+    def __init__(self, cache_dir, source_info, **kwargs):
+        super().__init__(source_info=source_info, **kwargs)
+        self.cache_dir = cache_dir
+        self._cache_file = None
+    # --- end of __init__ (...) ---
+
+    def get_cache_key_components(self):
+        """Returns the cache key as list of 2-tuples (name, value).
+
+        @return:  cache key components
+        @rtype:   C{list} of 2-tuple (C{str}, C{str})
+        """
+        key = [
+            ("format", self.CACHE_KEY_FORMAT),
+            (
+                "kconfig",
+                os.path.abspath(
+                    self.source_info.get_toplevel_kconfig_filepath()
+                )
+            )
+        ]
+
+        key.extend((
+            (name, str(value))
+            for name, value in self.source_info.iter_env_vars()
+        ))
+
+        # changes to the lkc parser or to the SymbolTable format
+        # invalidate the cache, detect them by the module's file stats
+        try:
+            lkconfig_stat = os.stat(lkconfig.__file__)
+        except (AttributeError, OSError):
+            pass
+        else:
+            key.append((
+                "lkconfig", "{0.st_size}:{0.st_mtime_ns}".format(lkconfig_stat)
+            ))
+
+        return key
+    # --- end of get_cache_key_components (...) ---
+
+    def get_cache_file_path(self):
+        """Returns the path to the cache file for the current sources.
+
+        @return:  cache file path
+        @rtype:   C{str}
+        """
+        cache_file = self._cache_file
+        if cache_file is None:
+            key_hash = hashlib.sha256()
+            for name, value in self.get_cache_key_components():
+                key_hash.update("{0}={1}\0".format(name, value).encode())
+
+            cache_file = os.path.join(
+                self.cache_dir, key_hash.hexdigest() + self.CACHE_FILE_SUFFIX
+            )
+            self._cache_file = cache_file
+        # --
+
+        return cache_file
+    # --- end of get_cache_file_path (...) ---
+
+    def resolve_kconfig_file(self, name):
+        """Converts a Kconfig file name as reported by the lkc parser
+        to an absolute file path.
+
+        lkc tries to open the file relative to the current working directory
+        first, and then relative to $srctree (see zconf_fopen()).
+
+        @param name:  Kconfig file name
+        @type  name:  C{str}
+
+        @return:  absolute file path
+        @rtype:   C{str}
+        """
+        if os.path.isabs(name) or os.path.exists(name):
+            return os.path.abspath(name)
+        else:
+            return os.path.abspath(
+                os.path.join(self.source_info.srctree, name)
+            )
+    # --- end of resolve_kconfig_file (...) ---
+
+    def _get_kconfig_file_stats(self, kconfig_files):
+        """Stats the given Kconfig files.
+
+        @raises OSError:  if a file cannot be stat-ed
+
+        @return:  list of (size, mtime_ns) pairs (flattened)
+        @rtype:   C{list} of C{int}
+        """
+        file_stats = []
+        for filepath in kconfig_files:
+            stat_info = os.stat(filepath)
+            file_stats.append(stat_info.st_size)
+            file_stats.append(stat_info.st_mtime_ns)
+        return file_stats
+    # --- end of _get_kconfig_file_stats (...) ---
+
+    def _check_deps(self, deps):
+        """Checks whether the recorded dependencies of a cache entry
+        are still up-to-date.
+
+        @param deps:  decoded DEPS_FIELDS sections
+        @type  deps:  C{dict} :: C{str} => C{object}
+
+        @return:  True if cache entry is valid, else False
+        @rtype:   C{bool}
+        """
+        for name, value in zip(deps["env_names"], deps["env_values"]):
+            if os.environ.get(name, "") != value:
+                self.logger.debug("env var %s has changed", name)
+                return False
+        # --
+
+        try:
+            file_stats = self._get_kconfig_file_stats(deps["kconfig_files"])
+        except OSError:
+            self.logger.debug("Kconfig file(s) missing")
+            return False
+
+        if file_stats != list(deps["kconfig_file_stats"]):
+            self.logger.debug("Kconfig file(s) modified")
+            return False
+
+        return True
+    # --- end of _check_deps (...) ---
+
+    def _decode_section(self, mview, stype, offset, length):
+        data = mview[offset:offset + length]
+
+        if stype == "i" or stype == "q":
+            return data
+
+        elif stype == "s":
+            (count,) = self.INT32_STRUCT.unpack_from(data, 0)
+            lengths = data[4:4 + (4 * count)].cast("i")
+            strv = []
+            str_off = 4 + (4 * count)
+            for str_len in lengths:
+                if str_len < 0:
+                    strv.append(None)
+                else:
+                    strv.append(
+                        str(data[str_off:str_off + str_len], "utf-8")
+                    )
+                    str_off += str_len
+            # --
+            return strv
+
+        else:
+            raise ValueError("unknown section type", stype)
+    # --- end of _decode_section (...) ---
+
+    def load_from_mmap(self, mmap_obj, check_deps=True):
+        """Decodes a mmap-ed cache file.
+
+        @raises struct.error, ValueError, TypeError:  malformed data
+
+        @param mmap_obj:    cache file data, referenced by the symbol table
+        @type  mmap_obj:    C{mmap.mmap}
+        @param check_deps:  whether to check that the recorded dependencies
+                            are still up-to-date (in the current environment)
+        @type  check_deps:  C{bool}
+
+        @return:  symbol table or None if cache entry is invalid
+        @rtype:   L{CachedSymbolTable} or C{None}
+        """
+        all_fields = self.SYMTAB_FIELDS + self.DEPS_FIELDS
+
+        magic, version, num_sections, _ = self.HEADER_STRUCT.unpack_from(
+            mmap_obj, 0
+        )
+
+        if (
+            magic != self.CACHE_FILE_MAGIC
+            or version != self.CACHE_FILE_VERSION
+            or num_sections != len(all_fields)
+        ):
+            self.logger.debug("cache file format mismatch")
+            return None
+        # --
+
+        mview = memoryview(mmap_obj)
+        mview_len = len(mview)
+        sections = []
+        for k, (field_name, field_type) in enumerate(all_fields):
+            stype, offset, length = self.SECTION_STRUCT.unpack_from(
+                mmap_obj,
+                self.HEADER_STRUCT.size + (k * self.SECTION_STRUCT.size)
+            )
+            stype = stype.rstrip(b"\0").decode("ascii")
+
+            if stype != field_type or (offset + length) > mview_len:
+                self.logger.debug("cache file section mismatch")
+                return None
+
+            sections.append((field_name, stype, offset, length))
+        # --
+
+        num_symtab_fields = len(self.SYMTAB_FIELDS)
+
+        deps = {
+            field_name: self._decode_section(mview, stype, offset, length)
+            for field_name, stype, offset, length
+            in sections[num_symtab_fields:]
+        }
+        deps["kconfig_file_stats"] = deps["kconfig_file_stats"].cast("q")
+
+        if check_deps and not self._check_deps(deps):
+            return None
+
+        return CachedSymbolTable(
+            mmap_obj,
+            {
+                field_name: self._decode_section(mview, stype, offset, length)
+                for field_name, stype, offset, length
+                in sections[:num_symtab_fields]
+            }
+        )
+    # --- end of load_from_mmap (...) ---
+
+    def load(self):
+        """Loads the symbol table from the cache, if possible.
+
+        @return:  symbol table or None if there is no valid cache entry
+        @rtype:   L{CachedSymbolTable} or C{None}
+        """
+        cache_file = self.get_cache_file_path()
+
+        try:
+            with open(cache_file, "rb") as fh:
+                mmap_obj = mmap.mmap(
+                    fh.fileno(), 0, access=mmap.ACCESS_READ
+                )
+        except (OSError, ValueError):
+            # ValueError: cannot mmap an empty file
+            self.logger.debug("No symbol table cache file: %s", cache_file)
+            return None
+        # --
+
+        try:
+            symtab = self.load_from_mmap(mmap_obj)
+        except (struct.error, ValueError, TypeError) as err:
+            self.logger.warning(
+                "Failed to read symbol table cache file %s: %s",
+                cache_file, err
+            )
+            symtab = None
+        # --
+
+        if symtab is None:
+            self.logger.debug("Discarding symbol table cache %s", cache_file)
+            # mmap_obj cannot be closed explicitly if memoryviews still exist,
+            # rely on garbage collection then
+            try:
+                mmap_obj.close()
+            except BufferError:
+                pass
+        else:
+            self.logger.info("Read symbol table from cache %s", cache_file)
+
+        return symtab
+    # --- end of load (...) ---
+
+    def _encode_section(self, stype, value):
+        if stype == "i" or stype == "q":
+            return bytes(memoryview(value))
+
+        elif stype == "s":
+            encoded_strv = [
+                (None if s is None else s.encode("utf-8")) for s in value
+            ]
+
+            lengths = struct.pack(
+                "={0:d}i".format(len(encoded_strv)),
+                *[(-1 if s is None else len(s)) for s in encoded_strv]
+            )
+
+            return b"".join(
+                [self.INT32_STRUCT.pack(len(encoded_strv)), lengths]
+                + [s for s in encoded_strv if s]
+            )
+
+        else:
+            raise ValueError("unknown section type", stype)
+    # --- end of _encode_section (...) ---
+
+    def _gen_cache_file_chunks(self, symtab, deps):
+        all_fields = self.SYMTAB_FIELDS + self.DEPS_FIELDS
+
+        def get_field_value(field_name):
+            nonlocal symtab, deps
+            if field_name in deps:
+                return deps[field_name]
+            else:
+                return getattr(symtab, field_name)
+        # ---
+
+        chunks = [
+            self._encode_section(stype, get_field_value(field_name))
+            for field_name, stype in all_fields
+        ]
+
+        # section data starts after the section table
+        data_offset = self.HEADER_STRUCT.size + (
+            len(all_fields) * self.SECTION_STRUCT.size
+        )
+
+        # align each section to 8 bytes
+        chunk_offsets = []
+        offset = data_offset
+        for chunk in chunks:
+            offset += (-offset) % 8
+            chunk_offsets.append(offset)
+            offset += len(chunk)
+        # --
+
+        yield self.HEADER_STRUCT.pack(
+            self.CACHE_FILE_MAGIC, self.CACHE_FILE_VERSION, len(all_fields), 0
+        )
+
+        for (_, stype), chunk_offset, chunk in zip(
+            all_fields, chunk_offsets, chunks
+        ):
+            yield self.SECTION_STRUCT.pack(
+                stype.encode("ascii"), chunk_offset, len(chunk)
+            )
+
+        offset = data_offset
+        for chunk_offset, chunk in zip(chunk_offsets, chunks):
+            yield bytes(chunk_offset - offset)
+            yield chunk
+            offset = chunk_offset + len(chunk)
+    # --- end of _gen_cache_file_chunks (...) ---
+
+    def _get_deps(self, kconfig_deps):
+        """Creates the DEPS_FIELDS sections for a symbol table
+        that has just been read by the lkc parser.
+
+        @raises OSError:  if a Kconfig file cannot be stat-ed
+
+        @param kconfig_deps:  see store()
+
+        @return:  dependency sections
+        @rtype:   C{dict} :: C{str} => C{object}
+        """
+        kconfig_files_in, env_names = kconfig_deps
+
+        kconfig_files = [
+            self.resolve_kconfig_file(name) for name in kconfig_files_in
+        ]
+
+        file_stats = self._get_kconfig_file_stats(kconfig_files)
+
+        return {
+            "kconfig_files": kconfig_files,
+            "kconfig_file_stats": struct.pack(
+                "={0:d}q".format(len(file_stats)), *file_stats
+            ),
+            "env_names": env_names,
+            "env_values": [os.environ.get(name, "") for name in env_names]
+        }
+    # --- end of _get_deps (...) ---
+
+    def encode(self, symtab, kconfig_deps):
+        """Encodes a symbol table in the cache file format,
+        without writing it to the cache.
+
+        The result can be decoded with load_from_mmap().
+
+        @raises OSError:  if a Kconfig file cannot be stat-ed
+
+        @param symtab:        symbol table
+        @type  symtab:        L{SymbolTable}
+        @param kconfig_deps:  see store()
+
+        @return:  cache file data
+        @rtype:   C{bytes}
+        """
+        return b"".join(
+            self._gen_cache_file_chunks(symtab, self._get_deps(kconfig_deps))
+        )
+    # --- end of encode (...) ---
+
+    def store(self, symtab, kconfig_deps):
+        """Writes a symbol table to the cache.
+
+        Errors are logged, but not propagated,
+        since the cache is not essential.
+
+        @param symtab:        symbol table
+        @type  symtab:        L{SymbolTable}
+        @param kconfig_deps:  2-tuple (kconfig files, env var names),
+                              see lkconfig.get_kconfig_deps()
+        @type  kconfig_deps:  2-tuple (C{list} of C{str}, C{list} of C{str})
+
+        @return:  True if the cache file has been written, else False
+        @rtype:   C{bool}
+        """
+        cache_file = self.get_cache_file_path()
+
+        try:
+            deps = self._get_deps(kconfig_deps)
+        except OSError as err:
+            self.logger.warning("Cannot cache symbol table: %s", err)
+            return False
+
+        def write_cache_file(fh):
+            for chunk in self._gen_cache_file_chunks(symtab, deps):
+                fh.write(chunk)
+        # ---
+
+        try:
+            fileio.write_file_atomic(
+                cache_file, write_cache_file,
+                suffix=self.CACHE_FILE_SUFFIX, binary=True
+            )
+
+        except OSError as err:
+            self.logger.warning(
+                "Failed to write symbol table cache file %s: %s",
+                cache_file, err
+            )
+            return False
+        # --
+
+        self.logger.debug("Wrote symbol table cache %s", cache_file)
+        return True
+    # --- end of store (...) ---
+
+# --- end of SymbolTableCache ---
@@ -72,6 +72,14 @@ class HWDetect(choicemodules.AbstractChoiceModule):
             raise ValueError(modules_dir_arg)
     # --- end of create_modules_dir (...) ---
 
+    def _get_modules_map_cache_dir(self):
+        try:
+            return self.install_info.get_cache_dirs("modulesmap").get_path()
+        except StopIteration:
+            # no cache dir configured
+            return None
+    # --- end of _get_modules_map_cache_dir (...) ---
+
     def __init__(self, install_info, source_info, modules_dir=None, **kwargs):
         """Constructor.
 
@@ -86,7 +94,9 @@ class HWDetect(choicemodules.AbstractChoiceModule):
             install_info=install_info, source_info=source_info, **kwargs
         )
 
-        self.modules_map = self.create_source_informed(modulesmap.ModulesMap)
+        self.modules_map = self.create_source_informed(
+            modulesmap.ModulesMap, cache_dir=self._get_modules_map_cache_dir()
+        )
 
         self.modalias_map = self.create_loggable(
             modalias.ModaliasLookup,
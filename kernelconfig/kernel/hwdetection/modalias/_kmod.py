@@ -17,7 +17,7 @@ __all__ = ["KmodModaliasLookup"]
 
 if HAVE_KMOD:
 
-    class KmodModaliasLookup(_lookup_abc.AbstractModaliasLookup):
+    class KmodModaliasLookup(_lookup_abc.AbstractModulesDirModaliasLookup):
 
         AVAILABLE = HAVE_KMOD
 
@@ -51,8 +51,7 @@ if HAVE_KMOD:
         # --- end of get_kmod (...) ---
 
         def __init__(self, mod_dir, **kwargs):
-            super().__init__(**kwargs)
-            self._mod_dir = mod_dir
+            super().__init__(mod_dir, **kwargs)
             self._kmod = None
         # --- end of __init__ (...) ---
 
@@ -72,56 +71,6 @@ if HAVE_KMOD:
             return kmod.Kmod(mod_dir=self._convert_to_bytes(mod_dir_path))
         # --- end of _init_kmod (...) ---
 
-        def lazy_init(self):
-            return self._init_mod_dir()
-        # --- end of lazy_init (...) ---
-
-        def get_mod_dir_path(self):
-            mod_dir = self._mod_dir
-
-            if not mod_dir:
-                return mod_dir
-
-            elif isinstance(mod_dir, (str, bytes)):
-                return mod_dir
-
-            else:
-                return mod_dir.get_path()
-        # --- end of get_mod_dir_path (...) ---
-
-        def _init_mod_dir(self):
-            mod_dir = self._mod_dir
-            if mod_dir is None:
-                # None  -->  usable, but discouraged,
-                #            since /lib/modules/$(uname -r) is an unreliable
-                #            source
-                self.logger.warning(
-                    (
-                        "Using /lib/modules for modalias lookup,"
-                        " this is an unreliable info source."
-                    )
-                )
-                return True
-
-            elif not mod_dir:
-                # False, ""  -->  not usable
-                return False
-
-            elif isinstance(mod_dir, (str, bytes)):
-                # non-empty str/bytes  -->  usable
-                return True
-
-            else:
-                # modules dir obj  -->  return from prepare()
-                if mod_dir is True:
-                    raise AssertionError(
-                        "auto-set modules dir must be done at an upper level"
-                    )
-                # --
-
-                return mod_dir.prepare()
-        # --- end of _init_mod_dir (...) ---
-
         @classmethod
         def _convert_to_bytes(cls, seq):
             if seq is None:
@@ -8,7 +8,11 @@ from .....util import fileio
 from .....util import misc
 
 
-__all__ = ["AbstractModaliasLookup"]
+__all__ = [
+    "AbstractModaliasLookup",
+    "AbstractModulesDirModaliasLookup",
+    "UnavailableModaliasLookup",
+]
 
 
 class AbstractModaliasLookup(loggable.AbstractLoggable):
@@ -123,6 +127,73 @@ class AbstractModaliasLookup(loggable.AbstractLoggable):
 # --- end of AbstractModaliasLookup ---
 
 
+class AbstractModulesDirModaliasLookup(AbstractModaliasLookup):
+    """
+    Base class for lookup implementations that read their information
+    from a modules directory (/lib/modules/<kernel release>).
+
+    The modules dir is given as modules dir object, str or None,
+    where None means "use the default directory", see _init_mod_dir().
+    """
+
+    def __init__(self, mod_dir, **kwargs):
+        super().__init__(**kwargs)
+        self._mod_dir = mod_dir
+    # --- end of __init__ (...) ---
+
+    def lazy_init(self):
+        return self._init_mod_dir()
+    # --- end of lazy_init (...) ---
+
+    def get_mod_dir_path(self):
+        mod_dir = self._mod_dir
+
+        if not mod_dir:
+            return mod_dir
+
+        elif isinstance(mod_dir, (str, bytes)):
+            return mod_dir
+
+        else:
+            return mod_dir.get_path()
+    # --- end of get_mod_dir_path (...) ---
+
+    def _init_mod_dir(self):
+        mod_dir = self._mod_dir
+        if mod_dir is None:
+            # None  -->  usable, but discouraged,
+            #            since /lib/modules/$(uname -r) is an unreliable
+            #            source
+            self.logger.warning(
+                (
+                    "Using /lib/modules for modalias lookup,"
+                    " this is an unreliable info source."
+                )
+            )
+            return True
+
+        elif not mod_dir:
+            # False, ""  -->  not usable
+            return False
+
+        elif isinstance(mod_dir, (str, bytes)):
+            # non-empty str/bytes  -->  usable
+            return True
+
+        else:
+            # modules dir obj  -->  return from prepare()
+            if mod_dir is True:
+                raise AssertionError(
+                    "auto-set modules dir must be done at an upper level"
+                )
+            # --
+
+            return mod_dir.prepare()
+    # --- end of _init_mod_dir (...) ---
+
+# --- end of AbstractModulesDirModaliasLookup ---
+
+
 class UnavailableModaliasLookup(AbstractModaliasLookup):
     """
     This class is a complete modalias lookup implementation
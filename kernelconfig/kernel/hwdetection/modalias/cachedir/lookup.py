@@ -2,9 +2,11 @@
 # -*- coding: utf-8 -*-
 
 import collections
+import os.path
 
 
 from .. import modulesdir
+from .. import _index
 
 from . import _base
 
@@ -66,7 +68,8 @@ class ModaliasCache(_base.ModaliasCacheBase):
         if modalias_info_source:
             self.logger.info("Found a suitable modalias info source")
             return self.create_loggable(
-                modulesdir.ModulesDir, modalias_info_source
+                modulesdir.ModulesDir, modalias_info_source,
+                index_path=self.get_index_file_path(modalias_info_source)
             )
         else:
             self.logger.info(
@@ -78,6 +81,29 @@ class ModaliasCache(_base.ModaliasCacheBase):
             return self.create_loggable(modulesdir.NullModulesDir)
     # --- end of get_modules_dir (...) ---
 
+    def get_index_file_path(self, modalias_info_source):
+        """
+        Returns the path to the precompiled modalias index
+        of a modalias info source.
+
+        Index files are kept in the (writable) cache dir,
+        even if the info source has been found in a system-wide dir.
+
+        @param modalias_info_source:  path to the info source
+        @type  modalias_info_source:  C{str}
+
+        @return:  index file path
+        @rtype:   C{str}
+        """
+        source_name = os.path.basename(modalias_info_source.rstrip("/"))
+        if source_name.endswith(".txz"):
+            source_name = source_name.rpartition(".")[0]
+
+        return self.get_cache_dir_path(
+            "%s%s" % (source_name, _index.ModaliasIndex.FILE_SUFFIX)
+        )
+    # --- end of get_index_file_path (...) ---
+
     def _locate_cache_entry_iter_candidates(self):
         """
         Iterates over all cache entries,
@@ -3,6 +3,7 @@
 
 
 from .abc import lookup as _lookup_abc
+from . import _index
 from . import _kmod
 
 
@@ -21,6 +22,7 @@ def _get_lookup_cls(*candidates):
 
 
 ModaliasLookup = _get_lookup_cls(
+    _index.IndexModaliasLookup,
     _kmod.KmodModaliasLookup,
 )
 
@@ -57,6 +57,29 @@ class AbstractModulesDir(loggable.AbstractLoggable, fs.AbstractFsView):
         return self.check_dirpath_available(self.get_path())
     # --- end of is_available (...) ---
 
+    def get_index_path(self):
+        """
+        Returns the path to the precompiled modalias index
+        for this modules dir, see IndexModaliasLookup.
+
+        @return:  path or None if the index should not be stored
+        @rtype:   C{str} or C{None}
+        """
+        return None
+    # --- end of get_index_path (...) ---
+
+    def get_source_stamp(self):
+        """
+        Returns a (size, mtime_ns) 2-tuple identifying the current state
+        of the modules dir source, without creating the modules dir.
+        A precompiled modalias index is valid only for the same stamp.
+
+        @return:  source stamp or None if unknown
+        @rtype:   2-tuple (C{int}, C{int}) or C{None}
+        """
+        return None
+    # --- end of get_source_stamp (...) ---
+
     @abc.abstractmethod
     def is_ready(self):
         raise NotImplementedError()
@@ -99,12 +122,16 @@ class NullModulesDir(AbstractModulesDir):
 
 
 class ModulesDir(AbstractModulesDir):
-    __slots__ = ["source", "path", "_tmpdir"]
+    __slots__ = ["source", "path", "index_path", "_tmpdir"]
 
-    def __init__(self, source, **kwargs):
+    # files that identify a directory source, see get_source_stamp()
+    SOURCE_STAMP_FILES = ["modules.alias", "data.txz"]
+
+    def __init__(self, source, index_path=None, **kwargs):
         super().__init__(**kwargs)
         self.source = source
         self.path = None
+        self.index_path = index_path
         self._tmpdir = None
 
     def __repr__(self):
@@ -122,6 +149,26 @@ class ModulesDir(AbstractModulesDir):
         path = self.get_path()
         return path and os.path.isdir(path)
 
+    def get_index_path(self):
+        return self.index_path
+
+    def get_source_stamp(self):
+        source = self.source
+
+        if os.path.isdir(source):
+            fname, source = _get_first_file(source, self.SOURCE_STAMP_FILES)
+            if not source:
+                return None
+        # --
+
+        try:
+            stat_info = os.stat(source)
+        except OSError:
+            return None
+
+        return (stat_info.st_size, stat_info.st_mtime_ns)
+    # --- end of get_source_stamp (...) ---
+
     def _check_tarfile(self, filepath, tarfile_fh):
         """
         @return:  list of members that may be unpacked, possibly empty
@@ -24,8 +24,17 @@ class ModulesMap(informed.AbstractSourceInformed, collections.abc.Mapping):
         self._get_mk_modmap()
     # --- end of load (...) ---
 
-    def __init__(self, source_info, **kwargs):
+    def __init__(self, source_info, *, cache_dir=None, **kwargs):
+        """Constructor.
+
+        @param   source_info:
+        @keyword cache_dir:    directory for caching the Makefile scan
+                               results, or None (disables caching).
+                               Defaults to None.
+        @type    cache_dir:    C{str} or C{None}
+        """
         super().__init__(source_info=source_info, **kwargs)
+        self.cache_dir = cache_dir
         self._mk_modmap = None
     # --- end of __init__ (...) ---
 
@@ -50,9 +59,19 @@ class ModulesMap(informed.AbstractSourceInformed, collections.abc.Mapping):
         return mk_modmap
     # --- end of _get_mk_modmap (...) ---
 
+    def _create_scan_cache(self):
+        if not self.cache_dir:
+            return None
+
+        return self.create_source_informed(
+            mkscanner.MakefileScanCache, self.cache_dir
+        )
+    # --- end of _create_scan_cache (...) ---
+
     def _load_new_mk_modmap(self):
         scanner = self.create_loggable(
-            mkscanner.ModuleConfigOptionsScanner, self.source_info
+            mkscanner.ModuleConfigOptionsScanner, self.source_info,
+            scan_cache=self._create_scan_cache()
         )
         return scanner.get_module_options_map()
     # --- end of _load_new_mk_modmap (...) ---
@@ -2,6 +2,7 @@
 # -*- coding: utf-8 -*-
 
 from .scanner import ModuleConfigOptionsScanner
+from .cache import MakefileScanCache
 
 
-__all__ = ["ModuleConfigOptionsScanner"]
+__all__ = ["ModuleConfigOptionsScanner", "MakefileScanCache"]
@@ -0,0 +1,339 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import hashlib
+import mmap
+import os
+import struct
+import sys
+
+from .....abc import informed
+from .....util import fileio
+
+
+__all__ = ["MakefileScanCache"]
+
+
+class MakefileScanCache(informed.AbstractSourceInformed):
+    """
+    Persistent on-disk cache for the results of scanning
+    the kernel sources' Makefiles, see ModuleConfigOptionsScanner.
+
+    Cache entries are identified by a source tree fingerprint
+    that consists of the (real) srctree path, the kernel arch
+    and the scanner module itself.
+    Each cache entry records the Makefiles that were scanned,
+    together with their size and mtime,
+    so that only modified Makefiles need to be rescanned.
+
+    File format (native byte order and int size, see CACHE_KEY_FORMAT):
+
+      header    := magic, version, makefile count, entry count, strings len
+      makefiles := makefile count * (
+                      path offset, path len, size, mtime_ns,
+                      first entry, entry count
+                   )
+      entries   := entry count * (
+                      option offset, option len, module offset, module len
+                   )
+      strings   := utf-8 data, referenced by (offset, len) pairs
+
+    The record format passed to/returned by store()/load() is
+    a dict :: makefile relpath => 3-tuple (size, mtime_ns, entries),
+    where entries is a tuple of 2-tuples (option name, module name).
+
+    @ivar cache_dir:  cache directory
+    @type cache_dir:  C{str}
+    """
+
+    CACHE_FILE_MAGIC = b"KCMKSCAN"
+    CACHE_FILE_VERSION = 1
+    CACHE_FILE_SUFFIX = ".mkscan"
+
+    HEADER_STRUCT = struct.Struct("=8sIIII")
+    MAKEFILE_STRUCT = struct.Struct("=IIqqII")
+    ENTRY_STRUCT = struct.Struct("=IIII")
+
+    # anything that affects the binary representation of the cache file
+    CACHE_KEY_FORMAT = "{v}:{q}:{o}".format(
+        v=CACHE_FILE_VERSION,
+        q=struct.calcsize("q"),
+        o=sys.byteorder
+    )
+
+    def __init__(self, cache_dir, source_info, **kwargs):
+        super().__init__(source_info=source_info, **kwargs)
+        self.cache_dir = cache_dir
+        self._cache_file = None
+    # --- end of __init__ (...) ---
+
+    def get_cache_key_components(self):
+        """Returns the source tree fingerprint as list of 2-tuples
+        (name, value).
+
+        @return:  cache key components
+        @rtype:   C{list} of 2-tuple (C{str}, C{str})
+        """
+        from . import scanner
+
+        key = [
+            ("format", self.CACHE_KEY_FORMAT),
+            ("srctree", os.path.realpath(self.source_info.srctree)),
+            ("karch", str(self.source_info.karch))
+        ]
+
+        # changes to the scanner invalidate the cache,
+        # detect them by the module's file stats
+        try:
+            scanner_stat = os.stat(scanner.__file__)
+        except (AttributeError, OSError):
+            pass
+        else:
+            key.append((
+                "scanner", "{0.st_size}:{0.st_mtime_ns}".format(scanner_stat)
+            ))
+
+        return key
+    # --- end of get_cache_key_components (...) ---
+
+    def get_cache_file_path(self):
+        """Returns the path to the cache file for the current sources.
+
+        @return:  cache file path
+        @rtype:   C{str}
+        """
+        cache_file = self._cache_file
+        if cache_file is None:
+            key_hash = hashlib.sha256()
+            for name, value in self.get_cache_key_components():
+                key_hash.update("{0}={1}\0".format(name, value).encode())
+
+            cache_file = os.path.join(
+                self.cache_dir, key_hash.hexdigest() + self.CACHE_FILE_SUFFIX
+            )
+            self._cache_file = cache_file
+        # --
+
+        return cache_file
+    # --- end of get_cache_file_path (...) ---
+
+    def _load_from_mmap(self, mmap_obj):
+        """Decodes a mmap-ed cache file.
+
+        @return:  makefile records or None if cache entry is invalid
+        @rtype:   C{dict} or C{None}
+        """
+        magic, version, num_makefiles, num_entries, strings_len = (
+            self.HEADER_STRUCT.unpack_from(mmap_obj, 0)
+        )
+
+        if (
+            magic != self.CACHE_FILE_MAGIC
+            or version != self.CACHE_FILE_VERSION
+        ):
+            self.logger.debug("cache file format mismatch")
+            return None
+        # --
+
+        makefiles_offset = self.HEADER_STRUCT.size
+        entries_offset = makefiles_offset + (
+            num_makefiles * self.MAKEFILE_STRUCT.size
+        )
+        strings_offset = entries_offset + (
+            num_entries * self.ENTRY_STRUCT.size
+        )
+
+        if (strings_offset + strings_len) != len(mmap_obj):
+            self.logger.debug("cache file size mismatch")
+            return None
+        # --
+
+        mview = memoryview(mmap_obj)
+        try:
+            strings = mview[strings_offset:]
+
+            str_cache = {}
+
+            def get_str(str_off, str_len):
+                nonlocal str_cache
+
+                # an empty string has the same offset as the next string
+                str_key = (str_off, str_len)
+                try:
+                    return str_cache[str_key]
+                except KeyError:
+                    pass
+
+                if (str_off + str_len) > strings_len:
+                    raise ValueError("string out of bounds")
+
+                sval = str(strings[str_off:str_off + str_len], "utf-8")
+                str_cache[str_key] = sval
+                return sval
+            # ---
+
+            entries = [
+                (get_str(opt_off, opt_len), get_str(mod_off, mod_len))
+                for opt_off, opt_len, mod_off, mod_len
+                in self.ENTRY_STRUCT.iter_unpack(
+                    mview[entries_offset:strings_offset]
+                )
+            ]
+
+            records = {}
+            for (
+                path_off, path_len, size, mtime_ns, first_entry, entry_count
+            ) in self.MAKEFILE_STRUCT.iter_unpack(
+                mview[makefiles_offset:entries_offset]
+            ):
+                if (first_entry + entry_count) > num_entries:
+                    raise ValueError("entries out of bounds")
+
+                records[get_str(path_off, path_len)] = (
+                    size, mtime_ns,
+                    tuple(entries[first_entry:first_entry + entry_count])
+                )
+            # --
+
+            del strings
+        finally:
+            mview.release()
+
+        return records
+    # --- end of _load_from_mmap (...) ---
+
+    def load(self):
+        """Loads the makefile records from the cache, if possible.
+
+        The records still need to be checked for modified Makefiles.
+
+        @return:  makefile records or None if there is no valid cache entry
+        @rtype:   C{dict} or C{None}
+        """
+        cache_file = self.get_cache_file_path()
+
+        try:
+            with open(cache_file, "rb") as fh:
+                mmap_obj = mmap.mmap(
+                    fh.fileno(), 0, access=mmap.ACCESS_READ
+                )
+        except (OSError, ValueError):
+            # ValueError: cannot mmap an empty file
+            self.logger.debug("No makefile scan cache file: %s", cache_file)
+            return None
+        # --
+
+        try:
+            records = self._load_from_mmap(mmap_obj)
+        except (struct.error, ValueError, UnicodeDecodeError) as err:
+            self.logger.warning(
+                "Failed to read makefile scan cache file %s: %s",
+                cache_file, err
+            )
+            records = None
+        finally:
+            mmap_obj.close()
+        # --
+
+        if records is None:
+            self.logger.debug("Discarding makefile scan cache %s", cache_file)
+        else:
+            self.logger.debug(
+                "Read %d makefile records from cache %s",
+                len(records), cache_file
+            )
+
+        return records
+    # --- end of load (...) ---
+
+    def _gen_cache_file_chunks(self, records):
+        strings = []
+        strings_len = 0
+        str_offsets = {}
+
+        def add_str(sval):
+            nonlocal strings, strings_len, str_offsets
+
+            try:
+                return str_offsets[sval]
+            except KeyError:
+                pass
+
+            encoded = sval.encode("utf-8")
+            ref = (strings_len, len(encoded))
+            strings.append(encoded)
+            strings_len += len(encoded)
+            str_offsets[sval] = ref
+            return ref
+        # ---
+
+        makefile_chunks = []
+        entry_chunks = []
+
+        for relpath, (size, mtime_ns, entries) in records.items():
+            path_off, path_len = add_str(relpath)
+            makefile_chunks.append(
+                self.MAKEFILE_STRUCT.pack(
+                    path_off, path_len, size, mtime_ns,
+                    len(entry_chunks), len(entries)
+                )
+            )
+
+            for option, module in entries:
+                opt_off, opt_len = add_str(option)
+                mod_off, mod_len = add_str(module)
+                entry_chunks.append(
+                    self.ENTRY_STRUCT.pack(opt_off, opt_len, mod_off, mod_len)
+                )
+        # --
+
+        yield self.HEADER_STRUCT.pack(
+            self.CACHE_FILE_MAGIC, self.CACHE_FILE_VERSION,
+            len(makefile_chunks), len(entry_chunks), strings_len
+        )
+        yield b"".join(makefile_chunks)
+        yield b"".join(entry_chunks)
+        yield b"".join(strings)
+    # --- end of _gen_cache_file_chunks (...) ---
+
+    def store(self, records):
+        """Writes makefile records to the cache.
+
+        Errors are logged, but not propagated,
+        since the cache is not essential.
+
+        @param records:  makefile records
+        @type  records:  C{dict} :: C{str} => 3-tuple (
+                            C{int}, C{int},
+                            C{tuple} of 2-tuple (C{str}, C{str})
+                         )
+
+        @return:  True if the cache file has been written, else False
+        @rtype:   C{bool}
+        """
+        cache_file = self.get_cache_file_path()
+
+        def write_cache_file(fh):
+            for chunk in self._gen_cache_file_chunks(records):
+                fh.write(chunk)
+        # ---
+
+        try:
+            fileio.write_file_atomic(
+                cache_file, write_cache_file,
+                suffix=self.CACHE_FILE_SUFFIX, binary=True
+            )
+
+        except OSError as err:
+            self.logger.warning(
+                "Failed to write makefile scan cache file %s: %s",
+                cache_file, err
+            )
+            return False
+        # --
+
+        self.logger.debug("Wrote makefile scan cache %s", cache_file)
+        return True
+    # --- end of store (...) ---
+
+# --- end of MakefileScanCache ---
@@ -1,6 +1,8 @@
 # This file is part of kernelconfig.
 # -*- coding: utf-8 -*-
 
+import collections
+import concurrent.futures
 import os
 import re
 import shlex
@@ -9,6 +11,7 @@ from .....abc import loggable
 from .....util import fileio
 from .....util import fs
 from .....util import accudict
+from .....util import osmisc
 
 from ... import util
 from . import preference
@@ -18,9 +21,23 @@ __all__ = ["ModuleConfigOptionsScanner"]
 
 
 class ModuleConfigOptionsScanner(loggable.AbstractLoggable):
+    """
+    Scans the kernel sources' Makefiles for option => module relations.
+
+    @cvar SCAN_JOBS:    number of threads for scanning directories,
+                        <= 1 disables threading (the default,
+                        the regexp matching holds the GIL)
+    @type SCAN_JOBS:    C{int}
+
+    @ivar scan_cache:   cache for the results of previous scans,
+                        only modified Makefiles get rescanned
+    @type scan_cache:   L{MakefileScanCache} or C{None}
+    """
 
     normalize_module_name = staticmethod(util.normalize_module_name)
 
+    SCAN_JOBS = osmisc.envint("KERNELCONFIG_MODULESMAP_JOBS", 1)
+
     def get_module_options_map(self):
         # create a dict that maps object names to config options
         #   some of the object names are kernel modules,
@@ -54,9 +71,10 @@ class ModuleConfigOptionsScanner(loggable.AbstractLoggable):
         )
     # --- end of get_module_options_origin_map (...) ---
 
-    def __init__(self, source_info, **kwargs):
+    def __init__(self, source_info, *, scan_cache=None, **kwargs):
         super().__init__(**kwargs)
         self.source_info = source_info
+        self.scan_cache = scan_cache
         self.scanpol = (
             preference.ModuleConfigOptionsScannerStrategy.new_default()
         )
@@ -220,15 +238,25 @@ class ModuleConfigOptionsScanner(loggable.AbstractLoggable):
         # --
     # --- end of _iter_dir_candidates (...) ---
 
-    def _iter_mk_input_files(self):
+    def _iter_mk_input_dirs(self):
         _osp_join = os.path.join
 
         for dirpath, dirpath_rel, dirnames, filenames in (
             self._iter_dir_candidates()
         ):
-            for fname in filenames:
-                if fname in {"Kbuild", "Makefile"}:
-                    yield (dirpath_rel, _osp_join(dirpath, fname))
+            makefiles = [
+                (_osp_join(dirpath_rel, fname), _osp_join(dirpath, fname))
+                for fname in filenames if fname in {"Kbuild", "Makefile"}
+            ]
+
+            if makefiles:
+                yield (dirpath_rel, makefiles)
+    # --- end of _iter_mk_input_dirs (...) ---
+
+    def _iter_mk_input_files(self):
+        for dirpath_rel, makefiles in self._iter_mk_input_dirs():
+            for _, makefile in makefiles:
+                yield (dirpath_rel, makefile)
     # --- end of _iter_mk_input_files (...) ---
 
     def _pre_scan_makefile(self, makefile):
@@ -283,12 +311,136 @@ class ModuleConfigOptionsScanner(loggable.AbstractLoggable):
                     yield (option, vpart[:-1])
     # --- end of _scan_makefile (...) ---
 
-    def _scan_module_config_options(self):
+    def _scan_makefile_record(self, makefile, old_record):
+        """Scans a Makefile unless it is unchanged since the previous scan.
+
+        @param makefile:    path to the Makefile
+        @type  makefile:    C{str}
+        @param old_record:  cached record of the previous scan or None
+        @type  old_record:  3-tuple (C{int}, C{int}, C{tuple}) or C{None}
+
+        @return:  2-tuple (is new record, record (size, mtime_ns, entries))
+        @rtype:   2-tuple (C{bool}, 3-tuple (C{int}, C{int}, C{tuple}))
+        """
         normalize_module_name = self.normalize_module_name
 
-        for dirpath_rel, makefile in self._iter_mk_input_files():
-            for option, module in self._scan_makefile(makefile):
-                yield (dirpath_rel, option, normalize_module_name(module))
+        # stat before reading, modifications made while scanning
+        # then get detected by the next scan
+        stat_info = os.stat(makefile)
+        size = stat_info.st_size
+        mtime_ns = stat_info.st_mtime_ns
+
+        if (
+            old_record is not None
+            and old_record[0] == size
+            and old_record[1] == mtime_ns
+        ):
+            return (False, old_record)
+
+        entries = tuple((
+            (option, normalize_module_name(module))
+            for option, module in self._scan_makefile(makefile)
+        ))
+        return (True, (size, mtime_ns, entries))
+    # --- end of _scan_makefile_record (...) ---
+
+    def _scan_dir_records(self, dir_item, old_records):
+        """Scans the Makefiles of a directory.
+
+        @return:  2-tuple (number of rescanned Makefiles,
+                           list of 2-tuple (makefile relpath, record))
+        @rtype:   2-tuple (C{int}, C{list} of 2-tuple (C{str}, 3-tuple))
+        """
+        _, makefiles = dir_item
+
+        num_rescanned = 0
+        dir_records = []
+        for makefile_rel, makefile in makefiles:
+            is_new, record = self._scan_makefile_record(
+                makefile, old_records.get(makefile_rel)
+            )
+            if is_new:
+                num_rescanned += 1
+            dir_records.append((makefile_rel, record))
+        # --
+
+        return (num_rescanned, dir_records)
+    # --- end of _scan_dir_records (...) ---
+
+    def _scan_makefile_records(self):
+        """Scans all Makefiles,
+        reusing the results of the previous scan for unmodified files.
+
+        Directories are scanned concurrently if SCAN_JOBS > 1,
+        while walking the sources, with up to 2 * SCAN_JOBS directories
+        waiting for a thread. The order of the records does not depend
+        on that.
+
+        @return:  makefile records,
+                  dict :: makefile relpath => (size, mtime_ns, entries)
+        @rtype:   C{dict}
+        """
+        scan_cache = self.scan_cache
+        old_records = None
+        if scan_cache is not None:
+            old_records = scan_cache.load()
+        if old_records is None:
+            old_records = {}
+
+        def scan_dir(dir_item):
+            nonlocal old_records
+            return self._scan_dir_records(dir_item, old_records)
+        # ---
+
+        dir_items = self._iter_mk_input_dirs()
+
+        if self.SCAN_JOBS > 1:
+            # executor.map() would walk the whole tree before scanning
+            max_pending = 2 * self.SCAN_JOBS
+            dir_results = []
+            with concurrent.futures.ThreadPoolExecutor(
+                max_workers=self.SCAN_JOBS
+            ) as executor:
+                pending = collections.deque()
+                for dir_item in dir_items:
+                    if len(pending) >= max_pending:
+                        dir_results.append(pending.popleft().result())
+                    pending.append(executor.submit(scan_dir, dir_item))
+
+                dir_results.extend((future.result() for future in pending))
+            # --
+        else:
+            dir_results = [scan_dir(dir_item) for dir_item in dir_items]
+        # --
+
+        num_rescanned = 0
+        records = {}
+        for dir_num_rescanned, dir_records in dir_results:
+            num_rescanned += dir_num_rescanned
+            records.update(dir_records)
+        # --
+
+        self.logger.debug(
+            "Scanned %d of %d Makefiles", num_rescanned, len(records)
+        )
+
+        if scan_cache is not None and (
+            num_rescanned or len(records) != len(old_records)
+        ):
+            scan_cache.store(records)
+
+        return records
+    # --- end of _scan_makefile_records (...) ---
+
+    def _scan_module_config_options(self):
+        _osp_dirname = os.path.dirname
+
+        for makefile_rel, (_, _, entries) in (
+            self._scan_makefile_records().items()
+        ):
+            dirpath_rel = _osp_dirname(makefile_rel)
+            for option, module in entries:
+                yield (dirpath_rel, option, module)
     # --- end of _scan_module_config_options (...) ---
 
 # --- end of ModuleConfigOptionsScanner ---
@@ -0,0 +1,387 @@
+# This file is part of kernelconfig.
+# -*- coding: utf-8 -*-
+
+import hashlib
+import json
+import locale
+import os
+import sys
+
+from ..abc import loggable
+from ..util import fileio
+from . import parser
+
+
+__all__ = ["KernelConfigLangCache", "KconfigSymbolBinder"]
+
+
+class KconfigSymbolBinder(object):
+    """
+    Resolves config option names to lkc symbol indices and back,
+    for binding the config options of cached command lists.
+
+    @ivar kconfig_symbols:  kconfig symbols
+    @type kconfig_symbols:  L{KconfigSymbols}
+    @ivar lookup_func:      function that returns the symbol
+                            for a config option name,
+                            raises KeyError or ValueError if there is none
+    @type lookup_func:      callable c :: C{str} -> L{AbstractKconfigSymbol}
+    """
+
+    __slots__ = ["kconfig_symbols", "lookup_func"]
+
+    def __init__(self, kconfig_symbols, lookup_func):
+        super().__init__()
+        self.kconfig_symbols = kconfig_symbols
+        self.lookup_func = lookup_func
+
+    def get_fingerprint(self):
+        return self.kconfig_symbols.get_fingerprint()
+
+    def get_symbol_index(self, config_option):
+        """
+        @return:  symbol index, or -1 if the option cannot be bound
+        @rtype:   C{int}
+        """
+        try:
+            sym = self.lookup_func(config_option)
+        except (KeyError, ValueError):
+            return -1
+
+        index = sym.index
+        return -1 if index is None else index
+    # --- end of get_symbol_index (...) ---
+
+    def get_symbol(self, index):
+        return self.kconfig_symbols.get_symbol_by_index(index)
+
+# --- end of KconfigSymbolBinder ---
+
+
+class KernelConfigLangCache(loggable.AbstractLoggable):
+    """
+    Cache for the command lists of parsed kernelconfig-lang files.
+
+    Cache entries are identified by a hash of the file's content
+    and the parser's fingerprint, so that the lexer and parser
+    can be skipped for files that have been parsed before.
+    Each entry may also contain bindings of the entry's config options
+    to lkc symbol indices, for up to MAX_BINDINGS Kconfig fingerprints
+    (see KconfigSymbols.get_fingerprint()),
+    which saves option name resolution in the interpreter.
+    Options that could not be bound are left as-is,
+    so that the interpreter reports them as usual.
+
+    File format: JSON object with the following keys:
+
+      cmdlist   := command list, opcodes are encoded as int,
+                   operator functions as {"f": <op_map key>}
+      bindings  := dict :: Kconfig fingerprint => list of symbol indices,
+                   one per config option of the command list, -1 if unbound
+
+    Entries that have been loaded or created are kept in memory.
+
+    @ivar cache_dir:  cache directory or None (in-memory only)
+    @type cache_dir:  C{str} or C{None}
+    """
+
+    CACHE_FILE_VERSION = 1
+    CACHE_FILE_SUFFIX = ".kcl"
+
+    MAX_BINDINGS = 4
+
+    def __init__(self, cache_dir, **kwargs):
+        super().__init__(**kwargs)
+        self.cache_dir = cache_dir
+        self._key_prefix = None
+        self._entries = {}
+        self._func_names = {
+            func: name for name, func in parser.KernelConfigLangParser.
+            op_map.items()
+        }
+    # --- end of __init__ (...) ---
+
+    def get_cache_key_components(self):
+        """Returns the parser fingerprint as list of 2-tuples (name, value).
+
+        @return:  cache key components
+        @rtype:   C{list} of 2-tuple (C{str}, C{str})
+        """
+        from . import lexer
+
+        key = [
+            ("format", self.CACHE_FILE_VERSION),
+            ("python", "{0}.{1}".format(*sys.version_info))
+        ]
+
+        # changes to the parser invalidate the cache,
+        # detect them by the modules' file stats
+        for mod in (lexer, parser):
+            try:
+                mod_stat = os.stat(mod.__file__)
+            except (AttributeError, OSError):
+                pass
+            else:
+                key.append((
+                    mod.__name__,
+                    "{0.st_size}:{0.st_mtime_ns}".format(mod_stat)
+                ))
+        # --
+
+        return key
+    # --- end of get_cache_key_components (...) ---
+
+    def get_digest(self, data):
+        """Returns the cache entry digest for the given file content.
+
+        @param data:  file content
+        @type  data:  C{bytes}
+
+        @return:  hex digest
+        @rtype:   C{str}
+        """
+        key_prefix = self._key_prefix
+        if key_prefix is None:
+            key_prefix = "".join((
+                "{0}={1}\0".format(name, value)
+                for name, value in self.get_cache_key_components()
+            )).encode()
+            self._key_prefix = key_prefix
+        # --
+
+        key_hash = hashlib.sha256(key_prefix)
+        key_hash.update(data)
+        return key_hash.hexdigest()
+    # --- end of get_digest (...) ---
+
+    def get_cache_file_path(self, digest):
+        return os.path.join(self.cache_dir, digest + self.CACHE_FILE_SUFFIX)
+
+    def _encode_value(self, value):
+        if isinstance(value, list):
+            return [self._encode_value(item) for item in value]
+
+        elif value is None or isinstance(value, (bool, str)):
+            return value
+
+        elif isinstance(value, parser.KernelConfigOp):
+            return int(value)
+
+        else:
+            # KeyError for unknown functions
+            return {"f": self._func_names[value]}
+    # --- end of _encode_value (...) ---
+
+    def _decode_value(
+        self, value, *,
+        _op_map=parser.KernelConfigLangParser.op_map,
+        _KernelConfigOp=parser.KernelConfigOp
+    ):
+        if isinstance(value, list):
+            return [self._decode_value(item) for item in value]
+
+        elif value is None or isinstance(value, (bool, str)):
+            return value
+
+        elif isinstance(value, int):
+            return _KernelConfigOp(value)
+
+        else:
+            return _op_map[value["f"]]
+    # --- end of _decode_value (...) ---
+
+    def _iter_option_lists(
+        self, cmdlist, *, _KernelConfigOp=parser.KernelConfigOp
+    ):
+        """Generator that yields the config option lists of a command list,
+        in encoded or decoded form.
+        """
+        for cmdv in cmdlist:
+            if (
+                cmdv[0] == _KernelConfigOp.cond_if
+                or cmdv[0] == _KernelConfigOp.cond_unless
+            ):
+                cmdv = cmdv[2]
+
+            if len(cmdv) > 2 and cmdv[1] == _KernelConfigOp.oper_option:
+                yield cmdv[2]
+        # --
+    # --- end of _iter_option_lists (...) ---
+
+    def _bind(self, cmdlist, symbol_binder):
+        get_symbol_index = symbol_binder.get_symbol_index
+        return [
+            get_symbol_index(option)
+            for options in self._iter_option_lists(cmdlist)
+            for option in options
+        ]
+    # --- end of _bind (...) ---
+
+    def _get_binding(self, entry, symbol_binder):
+        """Returns the binding of a cache entry for the current Kconfig,
+        and creates it if necessary.
+
+        @return:  2-tuple (binding, whether the binding is new)
+        @rtype:   2-tuple (C{list} of C{int}, C{bool})
+        """
+        fingerprint = symbol_binder.get_fingerprint()
+        bindings = entry["bindings"]
+
+        binding = bindings.get(fingerprint)
+        if binding is not None:
+            return (binding, False)
+
+        binding = self._bind(entry["cmdlist"], symbol_binder)
+
+        while len(bindings) >= self.MAX_BINDINGS:
+            # dicts preserve insertion order, drop the oldest
+            del bindings[next(iter(bindings))]
+        bindings[fingerprint] = binding
+
+        return (binding, True)
+    # --- end of _get_binding (...) ---
+
+    def _decode_cmdlist(self, cmdlist, binding, symbol_binder):
+        """Decodes a cached command list and replaces bound config options
+        with their symbols.
+
+        @raises KeyError, ValueError, TypeError:  malformed data
+        """
+        decoded_cmdlist = self._decode_value(cmdlist)
+
+        if binding:
+            binding_iter = iter(binding)
+
+            for options in self._iter_option_lists(decoded_cmdlist):
+                for k, index in zip(range(len(options)), binding_iter):
+                    if index >= 0:
+                        options[k] = symbol_binder.get_symbol(index)
+            # --
+        # --
+
+        return decoded_cmdlist
+    # --- end of _decode_cmdlist (...) ---
+
+    def _load_entry(self, digest):
+        """Loads a cache entry from disk.
+
+        @return:  entry or None
+        @rtype:   C{dict} or C{None}
+        """
+        cache_file = self.get_cache_file_path(digest)
+        try:
+            with open(cache_file, "rt") as fh:
+                entry = json.load(fh)
+        except OSError:
+            return None
+        except ValueError as err:
+            self.logger.warning(
+                "Failed to read command cache file %s: %s", cache_file, err
+            )
+            return None
+        # --
+
+        if (
+            not isinstance(entry, dict)
+            or not isinstance(entry.get("cmdlist"), list)
+            or not isinstance(entry.get("bindings"), dict)
+        ):
+            self.logger.warning("Discarding command cache %s", cache_file)
+            return None
+        # --
+
+        self.logger.debug("Read command cache %s", cache_file)
+        return entry
+    # --- end of _load_entry (...) ---
+
+    def _store_entry(self, digest, entry):
+        """Writes a cache entry to disk.
+
+        @return:  True on success, else False
+        @rtype:   C{bool}
+        """
+        cache_file = self.get_cache_file_path(digest)
+        try:
+            fileio.write_file_atomic(
+                cache_file,
+                lambda fh: json.dump(entry, fh, separators=(",", ":")),
+                suffix=self.CACHE_FILE_SUFFIX
+            )
+
+        except OSError as err:
+            self.logger.warning(
+                "Failed to write command cache file %s: %s", cache_file, err
+            )
+            return False
+        # --
+
+        self.logger.debug("Wrote command cache %s", cache_file)
+        return True
+    # --- end of _store_entry (...) ---
+
+    def parse_file(self, lang_parser, infile, symbol_binder=None):
+        """Returns the command list of a file,
+        either from the cache or by parsing the file.
+
+        A file that cannot be parsed does not get cached,
+        the parser reports its errors whenever it is read.
+
+        @raises OSError:  file cannot be read
+
+        @param lang_parser:    initialized parser
+        @type  lang_parser:    L{KernelConfigLangParser}
+        @param infile:         input file
+        @type  infile:         C{str}
+        @param symbol_binder:  binder for config options or None
+        @type  symbol_binder:  L{KconfigSymbolBinder} or C{None}
+
+        @return:  command list or None
+        @rtype:   C{list} or C{None}
+        """
+        with open(infile, "rb") as fh:
+            data = fh.read()
+
+        digest = self.get_digest(data)
+        entry = self._entries.get(digest)
+        modified = False
+
+        if entry is None and self.cache_dir:
+            entry = self._load_entry(digest)
+
+        if entry is None:
+            cmdlist = lang_parser.parse_file_data(
+                data.decode(locale.getpreferredencoding(False)), infile
+            )
+            if cmdlist is None:
+                return None
+
+            entry = {"cmdlist": self._encode_value(cmdlist), "bindings": {}}
+            modified = True
+        # --
+
+        try:
+            if symbol_binder is not None:
+                binding, new_binding = self._get_binding(entry, symbol_binder)
+                modified = modified or new_binding
+            else:
+                binding = None
+
+            cmdlist = self._decode_cmdlist(
+                entry["cmdlist"], binding, symbol_binder
+            )
+        except (KeyError, ValueError, TypeError, IndexError) as err:
+            self.logger.warning("Discarding command cache entry: %s", err)
+            self._entries.pop(digest, None)
+            return lang_parser.parse_file_data(
+                data.decode(locale.getpreferredencoding(False)), infile
+            )
+        # --
+
+        self._entries[digest] = entry
+        if modified and self.cache_dir:
+            self._store_entry(digest, entry)
+
+        return cmdlist
+    # --- end of parse_file (...) ---
+
+# --- end of KernelConfigLangCache ---
@@ -37,12 +37,24 @@ class AbstractKernelConfigLangInterpreter(loggable.AbstractLoggable):
 
     @ivar _parser:            parser
     @type _parser:            L{KernelConfigLangParser}
+
+    @ivar cmd_cache:          cache for the command lists of input files,
+                              or None
+    @type cmd_cache:          L{KernelConfigLangCache} or C{None}
+    @ivar symbol_binder:      binder for the config options
+                              of cached command lists, or None
+    @type symbol_binder:      L{KconfigSymbolBinder} or C{None}
     """
 
     DEFAULT_COND_RESULT_BUFFER_SIZE = 1
 
-    def __init__(self, cond_result_buffer_size=True, **kwargs):
+    def __init__(
+        self, cond_result_buffer_size=True, *,
+        cmd_cache=None, symbol_binder=None, **kwargs
+    ):
         super().__init__(**kwargs)
+        self.cmd_cache = cmd_cache
+        self.symbol_binder = symbol_binder
         self._file_input_queue = filequeue.FileInputQueue()
         self._parser = self.create_loggable(
             parser.KernelConfigLangParser, logger_name="Parser"
@@ -694,9 +706,15 @@ class AbstractKernelConfigLangInterpreter(loggable.AbstractLoggable):
         """
         combined_cmdlist = []
         p = self.get_parser()
+        cmd_cache = self.cmd_cache
 
         for infile in infiles:
-            cmdlist = p.parse_file(infile)
+            if cmd_cache is None:
+                cmdlist = p.parse_file(infile)
+            else:
+                cmdlist = cmd_cache.parse_file(
+                    p, infile, symbol_binder=self.symbol_binder
+                )
             if cmdlist is None:
                 self.logger.error("Error while parsing file %r", infile)
                 return None
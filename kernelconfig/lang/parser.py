@@ -619,14 +619,18 @@ class KernelConfigLangParser(loggable.AbstractLoggable):
         return self._parse(data, **kwargs)
 
     def parse_file(self, infile, filename=None, **kwargs):
+        # COULDFIX: MAYBE: fileio compress open
+        with open(infile, "rt") as fh:
+            data = fh.read()
+        return self.parse_file_data(data, infile, filename=filename, **kwargs)
+
+    def parse_file_data(self, data, infile, filename=None, **kwargs):
+        # parse_file() variant for files that have already been read,
+        # infile and filename are used for error messages only
         self.reset()
         self.infile = infile
         self.filename = filename or infile
-
-        # COULDFIX: MAYBE: fileio compress open
-        with open(infile, "rt") as fh:
-            ret = self._parse(fh.read(), **kwargs)
-        return ret
+        return self._parse(data, **kwargs)
 
     def handle_parse_error(self, p, tok_idx, message):
         self.logger.error(
@@ -1,6 +1,7 @@
 # This file is part of kernelconfig.
 # -*- coding: utf-8 -*-
 
+import concurrent.futures
 import os
 import subprocess
 
@@ -209,6 +210,15 @@ class EbuildEnv(informed.AbstractInformed):
 
 
 class ConfigCheckEbuildEnv(EbuildEnv):
+    """
+    @cvar EVAL_JOBS:  number of ebuild processes running concurrently
+                      in iter_eval_config_check(), <= 1 disables threading
+    @type EVAL_JOBS:  C{int}
+    """
+
+    EVAL_JOBS = osmisc.envint(
+        "KERNELCONFIG_PORTAGEVDB_EVAL_JOBS", (osmisc.get_cpu_count() or 1)
+    )
 
     _did_warn_about_ebuild_phase_errors = False
 
@@ -309,28 +319,64 @@ class ConfigCheckEbuildEnv(EbuildEnv):
         return util.parse_config_check(config_check_str, logger=self.logger)
     # --- end of _read_config_check_outfile (...) ---
 
+    def eval_config_check(self, package_info, idx=None, num_pkgs=None):
+        """
+        Re-evaluates CONFIG_CHECK of a single package.
+
+        Packages have separate build directories in PORTAGE_TMPDIR,
+        and each ebuild process gets its own private tmpdir,
+        so this method may be called by concurrent threads.
+
+        @return:  2-tuple (cpv, config check dict or None)
+        """
+        cpv = package_info.cpv
+        if idx is None:
+            self.logger.info("Getting config recommendations for %s", cpv)
+        else:
+            self.logger.info(
+                "Getting config recommendations for %s (%d/%d)",
+                cpv, (idx + 1), num_pkgs
+            )
+        # --
+
+        outfile = self.run_ebuild_get_config_check_outfile(package_info)
+        if outfile:
+            self.logger.debug("%s: has config recommendations", cpv)
+            return (cpv, self._read_config_check_outfile(outfile))
+
+        else:
+            self.logger.debug("%s: no config recommendations", cpv)
+            return (cpv, None)
+    # --- end of eval_config_check (...) ---
+
     def iter_eval_config_check(self, package_info_iterable):
         """
+        Re-evaluates CONFIG_CHECK of several packages,
+        running up to EVAL_JOBS ebuild processes concurrently.
+        The results are in the same order as the input packages.
+
         @return:  2-tuple(s) (cpv, config check dict)
         """
         package_info_list = list(package_info_iterable)
         num_pkgs = len(package_info_list)
 
-        for idx, package_info in enumerate(package_info_list):
-            cpv = package_info.cpv
-            self.logger.info(
-                "Getting config recommendations for %s (%d/%d)",
-                cpv, (idx + 1), num_pkgs
+        def eval_config_check(idx):
+            nonlocal package_info_list
+            nonlocal num_pkgs
+
+            return self.eval_config_check(
+                package_info_list[idx], idx, num_pkgs
             )
-            outfile = self.run_ebuild_get_config_check_outfile(package_info)
-            if outfile:
-                self.logger.debug("%s: has config recommendations", cpv)
-                yield (cpv, self._read_config_check_outfile(outfile))
-
-            else:
-                self.logger.debug("%s: no config recommendations", cpv)
-                yield (cpv, None)
-        # --
+        # ---
+
+        if self.EVAL_JOBS > 1 and num_pkgs > 1:
+            with concurrent.futures.ThreadPoolExecutor(
+                max_workers=min(self.EVAL_JOBS, num_pkgs)
+            ) as executor:
+                yield from executor.map(eval_config_check, range(num_pkgs))
+        else:
+            for idx in range(num_pkgs):
+                yield eval_config_check(idx)
     # --- end of iter_eval_config_check (...) ---
 
 # --- end of ConfigCheckEbuildEnv ---
@@ -1,13 +1,18 @@
 # This file is part of kernelconfig.
 # -*- coding: utf-8 -*-
 
+import concurrent.futures
+import os
 import portage
 import re
+import threading
 
 
 from ...abc import loggable
+from ...util import osmisc
 from . import pkginfo
 from . import util
+from . import _vdbcache
 
 
 __all__ = ["PortageInterface"]
@@ -18,15 +23,26 @@ class PortageInterface(loggable.AbstractLoggable):
     Interface for querying information relevant
     for CONFIG_CHECK-based pm integration via the portage API.
 
+    @cvar SCAN_JOBS:   number of threads for reading vdb entries,
+                       <= 1 disables threading
+    @type SCAN_JOBS:   C{int}
+
     @ivar settings:    portage config
     @ivar port_db:     portage db
     @ivar vartree:     portage vartree
     @ivar vdb:         portage vdb
+    @ivar cache_dir:   directory for caching vdb variables per package,
+                       or None (disables caching)
+    @type cache_dir:   C{str} or C{None}
     """
 
     __hash__ = None
 
-    def __init__(self, **kwargs):
+    SCAN_JOBS = osmisc.envint(
+        "KERNELCONFIG_PORTAGEVDB_JOBS", (osmisc.get_cpu_count() or 1)
+    )
+
+    def __init__(self, cache_dir=None, **kwargs):
         super().__init__(**kwargs)
         # There is no point in lazy-loading these portage objects.
         # At the time an object this class (PortageInterface) is created,
@@ -38,27 +54,137 @@ class PortageInterface(loggable.AbstractLoggable):
         self.port_db = portage.db[portage.root]
         self.vartree = self.port_db["vartree"]
         self.vdb = self.vartree.dbapi
+
+        self.cache_dir = cache_dir
+        self._var_caches = {}
+
+        # vdb lookups of variables that are kept in portage's aux cache
+        # modify that cache, serialize them
+        self._vdb_aux_cache_keys = getattr(
+            self.vdb, "_aux_cache_keys", frozenset()
+        )
+        self._vdb_aux_cache_lock = threading.Lock()
     # --- end of __init__ (...) ---
 
+    def get_vdb_mtime(self, cpv):
+        """Returns the mtime of a package's vdb directory,
+        which identifies the installed instance of the package.
+
+        @param cpv:  package cpv
+
+        @return:  mtime in nanoseconds, or None if unknown
+        @rtype:   C{int} or C{None}
+        """
+        try:
+            return os.stat(self.vdb.getpath(cpv)).st_mtime_ns
+        except OSError:
+            return None
+    # --- end of get_vdb_mtime (...) ---
+
+    def get_var_cache(self, varname):
+        """Returns the per-package cache for a vdb variable.
+
+        @param varname:  name of the variable
+        @type  varname:  C{str}
+
+        @return:  package cache or None if caching is disabled
+        @rtype:   L{PackageCache} or C{None}
+        """
+        if not self.cache_dir:
+            return None
+
+        try:
+            var_cache = self._var_caches[varname]
+        except KeyError:
+            var_cache = self.create_loggable(
+                _vdbcache.PackageCache,
+                os.path.join(self.cache_dir, "var-{}.json".format(varname))
+            )
+            self._var_caches[varname] = var_cache
+        # --
+
+        return var_cache
+    # --- end of get_var_cache (...) ---
+
+    def map_packages(self, func, cpv_iterable):
+        """Calls func for each package, concurrently if SCAN_JOBS > 1,
+        and returns the results in order.
+
+        @param func:          function, must be thread-safe
+        @type  func:          callable f :: cpv -> _
+        @param cpv_iterable:  package cpv list (or iterable)
+        @type  cpv_iterable:  iterable of cpv
+
+        @return:  results
+        @rtype:   C{list}
+        """
+        if self.SCAN_JOBS > 1:
+            with concurrent.futures.ThreadPoolExecutor(
+                max_workers=self.SCAN_JOBS
+            ) as executor:
+                return list(executor.map(func, cpv_iterable))
+        else:
+            return [func(cpv) for cpv in cpv_iterable]
+    # --- end of map_packages (...) ---
+
+    def aux_get_var(self, cpv, varname):
+        """Retrieves a single var from vdb, thread-safe.
+
+        Variables that are not in the aux cache are read from
+        the package's environment.bz2, without holding a lock.
+
+        @return:  var value
+        @rtype:   C{str}
+        """
+        wants = [varname]
+        if varname in self._vdb_aux_cache_keys:
+            with self._vdb_aux_cache_lock:
+                return self.vdb.aux_get(cpv, wants)[0]
+        else:
+            return self.vdb.aux_get(cpv, wants)[0]
+    # --- end of aux_get_var (...) ---
+
     def zipmap_get_var(self, cpv_iterable, varname):
         """
-        Generator that retrieves a single var
+        Retrieves a single var
         from vdb//environment.bz2 for a sequence of packages
         and returns (cpv, value) pairs.
 
+        Packages are queried concurrently, see map_packages(),
+        and values are cached per package, see get_var_cache().
+
         @param cpv_iterable:  package cpv list (or iterable)
         @type  cpv_iterable:  iterable of cpv
         @param varname:       name of the variable
         @type  varname:       C{str}
 
         @return:  2-tuples (cpv, var_value)
-        @rtype:   2-tuples (cpv, C{str})
+        @rtype:   iterable of 2-tuples (cpv, C{str})
         """
-        vdb = self.vdb
-        wants = [varname]
+        var_cache = self.get_var_cache(varname)
+
+        def get_var(cpv):
+            if var_cache is None:
+                return self.aux_get_var(cpv, varname)
+
+            mtime_ns = self.get_vdb_mtime(cpv)
+            try:
+                return var_cache.get(cpv, mtime_ns)
+            except KeyError:
+                pass
+
+            value = self.aux_get_var(cpv, varname)
+            var_cache.set(cpv, mtime_ns, value)
+            return value
+        # ---
 
-        for cpv in cpv_iterable:
-            yield (cpv, vdb.aux_get(cpv, wants)[0])
+        cpv_list = list(cpv_iterable)
+        values = self.map_packages(get_var, cpv_list)
+
+        if var_cache is not None:
+            var_cache.store()
+
+        return zip(cpv_list, values)
     # --- end of zipmap_get_var (...) ---
 
     def get_package_info(self, cpv):
@@ -72,15 +198,13 @@ class PortageInterface(loggable.AbstractLoggable):
         @return:  package info object
         @rtype:   L{PackageInfo}
         """
-        vdb = self.vdb
         vartree = self.vartree
 
-        (repo_name, ) = vdb.aux_get(cpv, ["repository"])
-
         return pkginfo.PackageInfo(
             cpv=cpv,
-            repo_name=repo_name,
-            ebuild_file=vartree.getebuildpath(cpv)
+            repo_name=self.aux_get_var(cpv, "repository"),
+            ebuild_file=vartree.getebuildpath(cpv),
+            vdb_mtime=self.get_vdb_mtime(cpv)
         )
     # --- end of get_package_info (...) ---
 
@@ -111,10 +235,9 @@ class PortageInterface(loggable.AbstractLoggable):
             re_inherited_filter = eclass_name_expr
         # --
 
-        vdb = self.vdb
-        for cpv in vdb.cpv_all():
-            inherited = vdb.aux_get(cpv, ["INHERITED"])[0]
-
+        for cpv, inherited in self.zipmap_get_var(
+            self.vdb.cpv_all(), "INHERITED"
+        ):
             if re_inherited_filter.search(inherited):
                 yield cpv
             # --
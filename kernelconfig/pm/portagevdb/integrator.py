@@ -1,6 +1,9 @@
 # This file is part of kernelconfig.
 # -*- coding: utf-8 -*-
 
+import hashlib
+import os
+
 from ...kconfig.abc import choicemodules
 from ...util import accudict
 from ...util import tmpdir as _tmpdir
@@ -9,11 +12,20 @@ from . import overlay
 from . import base
 from . import util
 from . import _ebuildenv
+from . import _vdbcache
 
 __all__ = ["PMIntegration"]
 
 
 class PMIntegration(choicemodules.AbstractChoiceModule):
+    """
+    @ivar cache_dir:  cache directory for vdb variables and
+                      re-evaluated CONFIG_CHECK, or None
+    @type cache_dir:  C{str} or C{None}
+    """
+
+    # increment when changing the format of cached CONFIG_CHECK results
+    CONFIG_CHECK_CACHE_VERSION = 1
 
     def __init__(
         self, install_info, source_info,
@@ -32,8 +44,17 @@ class PMIntegration(choicemodules.AbstractChoiceModule):
 
         self.portage_tmpdir = self._tmpdir.get_subdir("tmp")
 
+        try:
+            self.cache_dir = (
+                self.install_info.get_cache_dirs("portagevdb").get_path()
+            )
+        except StopIteration:
+            self.cache_dir = None
+
         if port_iface is None:
-            self.port_iface = self.create_loggable(base.PortageInterface)
+            self.port_iface = self.create_loggable(
+                base.PortageInterface, cache_dir=self.cache_dir
+            )
         else:
             self.port_iface = port_iface
         # --
@@ -44,8 +65,11 @@ class PMIntegration(choicemodules.AbstractChoiceModule):
         overlays = self._overlays
 
         any_package_added = False
-        for cpv in port_iface.find_all_cpv_inheriting_linux_info():
-            pkg_info = port_iface.get_package_info(cpv)
+        for pkg_info in port_iface.map_packages(
+            port_iface.get_package_info,
+            port_iface.find_all_cpv_inheriting_linux_info()
+        ):
+            cpv = pkg_info.cpv
 
 #            # does *not* work: will ignore chromium,
 #            #                  for which CONFIG_CHECK is set in an eclass
@@ -112,8 +136,44 @@ class PMIntegration(choicemodules.AbstractChoiceModule):
         return config_check_map
     # --- end of _create_config_check_map_from_accu (...) ---
 
+    def get_config_check_cache(self):
+        """Returns the cache for re-evaluated CONFIG_CHECK results.
+
+        CONFIG_CHECK depends on the kernel sources,
+        so there is one cache file per srctree, arch and kernel version.
+
+        @return:  package cache or None if caching is disabled
+        @rtype:   L{PackageCache} or C{None}
+        """
+        if not self.cache_dir:
+            return None
+
+        env_vars = dict(self.source_info.iter_env_vars())
+        key_hash = hashlib.sha256()
+        for key_component in (
+            self.CONFIG_CHECK_CACHE_VERSION,
+            os.path.realpath(self.source_info.get_path()),
+            env_vars.get("ARCH"),
+            env_vars.get("SRCARCH"),
+            env_vars.get("KERNELVERSION")
+        ):
+            key_hash.update("{!s}\0".format(key_component).encode())
+        # --
+
+        return self.create_loggable(
+            _vdbcache.PackageCache,
+            os.path.join(
+                self.cache_dir,
+                "config-check-{}.json".format(key_hash.hexdigest())
+            )
+        )
+    # --- end of get_config_check_cache (...) ---
+
     def eval_config_check(self):
         """
+        Packages whose results are in the CONFIG_CHECK cache
+        are not re-evaluated, see get_config_check_cache().
+
         @return: dict where keys are config option names,
                  and values indicate whether an option should be enabled
                  or disabled
@@ -126,19 +186,58 @@ class PMIntegration(choicemodules.AbstractChoiceModule):
             return None
         # --
 
-        overlays.setup(self.port_iface)
-        config_check_eval_env = self.create_informed(
-            _ebuildenv.ConfigCheckEbuildEnv,
-            tmpdir=self.portage_tmpdir
-        )
-        config_check_eval_env.setup(self.port_iface)
+        config_check_cache = self.get_config_check_cache()
+        results = {}
+        uncached_packages = []
 
-        config_check_accu_map = accudict.DictAccumulatorDict()
-        for cpv, config_check_submap in (
-            config_check_eval_env.iter_eval_config_check(
-                overlays.iter_packages()
+        for package_info in overlays.iter_packages():
+            try:
+                if config_check_cache is None:
+                    raise KeyError(package_info.cpv)
+
+                results[package_info.cpv] = config_check_cache.get(
+                    package_info.cpv, package_info.vdb_mtime
+                )
+            except KeyError:
+                uncached_packages.append(package_info)
+            else:
+                self.logger.debug(
+                    "%s: using cached config recommendations",
+                    package_info.cpv
+                )
+        # --
+
+        if uncached_packages:
+            # the overlays and KBUILD_OUTPUT are only needed
+            # for running ebuild phases
+            overlays.setup(self.port_iface)
+            config_check_eval_env = self.create_informed(
+                _ebuildenv.ConfigCheckEbuildEnv,
+                tmpdir=self.portage_tmpdir
             )
-        ):
+            config_check_eval_env.setup(self.port_iface)
+
+            for package_info, (cpv, config_check_submap) in zip(
+                uncached_packages,
+                config_check_eval_env.iter_eval_config_check(
+                    uncached_packages
+                )
+            ):
+                results[cpv] = config_check_submap
+                if config_check_cache is not None:
+                    config_check_cache.set(
+                        cpv, package_info.vdb_mtime, config_check_submap
+                    )
+            # --
+        # --
+
+        if config_check_cache is not None:
+            config_check_cache.store()
+
+        config_check_accu_map = accudict.DictAccumulatorDict()
+        for package_info in overlays.iter_packages():
+            cpv = package_info.cpv
+            config_check_submap = results[cpv]
             if config_check_submap:
                 for config_option, value in config_check_submap.items():
                     config_check_accu_map.add(config_option, (value, cpv))
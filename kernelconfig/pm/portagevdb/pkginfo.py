@@ -27,10 +27,12 @@ class PackageInfo(object):
     @ivar name:              the package's name (from cpv)
     @ivar repo_name:         the package's origin
     @ivar orig_ebuild_file:  path to the package's ebuild (in vdb)
+    @ivar vdb_mtime:         mtime of the package's vdb dir (in ns) or None,
+                             identifies the installed instance
     """
     __slots__ = [
         "cpv", "category", "name", "repo_name",
-        "orig_ebuild_file", "tmp_ebuild_file"
+        "orig_ebuild_file", "tmp_ebuild_file", "vdb_mtime"
     ]
 
     __hash__ = None
@@ -39,7 +41,7 @@ class PackageInfo(object):
     def ebuild_name(self):
         return os.path.basename(self.orig_ebuild_file)
 
-    def __init__(self, cpv, repo_name, ebuild_file):
+    def __init__(self, cpv, repo_name, ebuild_file, vdb_mtime=None):
         super().__init__()
         self.cpv = None
         self.category = None
@@ -48,6 +50,7 @@ class PackageInfo(object):
         self.repo_name = repo_name
         self.orig_ebuild_file = ebuild_file
         self.tmp_ebuild_file = None
+        self.vdb_mtime = vdb_mtime
 
         self._set_cpv(cpv)
     # --- end of __init__ (...) ---
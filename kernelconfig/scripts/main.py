@@ -258,6 +258,19 @@ class KernelConfigMainScript(kernelconfig.scripts._base.MainScriptBase):
                     ),
                     None
                 ),
+                ScriptMode(
+                    "serve", None,
+                    (
+                        "run a server that generates .config files\n"
+                        "for requests received on a Unix socket"
+                    ),
+                    {
+                        "metavar": "<socket>",
+                        "type": lambda w: (
+                            ("serve", arg_types.arg_fspath(w))
+                        ),
+                    }
+                ),
             ]
 
             script_mode_group = parser.add_argument_group(title="script mode")
@@ -469,6 +482,9 @@ class KernelConfigMainScript(kernelconfig.scripts._base.MainScriptBase):
         add_script_mode_args()
     # --- end of _setup_arg_parser_args (...) ---
 
+    def new_arg_parser(self, **kwargs):
+        return argparse.ArgumentParser(**kwargs)
+
     def init_arg_parser(self):
         arg_types = self.arg_types
         if arg_types is None:
@@ -476,7 +492,7 @@ class KernelConfigMainScript(kernelconfig.scripts._base.MainScriptBase):
             self.arg_types = arg_types
         # --
 
-        parser = argparse.ArgumentParser(
+        parser = self.new_arg_parser(
             prog=self.get_prog_name(),
             description="Generate Linux kernel configuration files",
             formatter_class=argparse.RawTextHelpFormatter
@@ -486,8 +502,7 @@ class KernelConfigMainScript(kernelconfig.scripts._base.MainScriptBase):
         self.arg_parser = parser
     # --- end of init_arg_parser (...) ---
 
-    def do_main_setup_logging(self, arg_config):
-        # logging
+    def get_log_level(self, arg_config):
         log_levels = [
             logging.DEBUG, logging.INFO, logging.WARNING,
             logging.ERROR, logging.CRITICAL
@@ -503,8 +518,12 @@ class KernelConfigMainScript(kernelconfig.scripts._base.MainScriptBase):
             log_level = log_levels[k]
         # ---
 
+        return log_level
+    # ---
+
+    def do_main_setup_logging(self, arg_config):
         self.zap_log_handlers()
-        self.setup_console_logging(log_level)
+        self.setup_console_logging(self.get_log_level(arg_config))
     # ---
 
     def do_main_load_settings(self, arg_config):
@@ -722,6 +741,30 @@ class KernelConfigMainScript(kernelconfig.scripts._base.MainScriptBase):
         return modules_dir
     # --- end of do_main_get_modules_dir (...) ---
 
+    def do_main_create_config_generator(self, arg_config):
+        """
+        Creates the config generator for generate-config.
+
+        @param arg_config:  parsed args
+
+        @return:  config generator,
+                  or None if the modalias info source is not available
+        @rtype:   L{KernelConfigGenerator} or C{None}
+        """
+        #   ** modalias lookup info source
+        modules_dir = self.do_main_get_modules_dir(arg_config)
+        if modules_dir is None:
+            # already logged
+            return None
+
+        return self.create_loggable(
+            kernelconfig.kconfig.config.gen.KernelConfigGenerator,
+            install_info=self.install_info,
+            source_info=self.source_info,
+            modules_dir=modules_dir
+        )
+    # --- end of do_main_create_config_generator (...) ---
+
     def do_main_script_genconfig(self, arg_config):
         def get_interpreter():
             nonlocal arg_config
@@ -758,20 +801,11 @@ class KernelConfigMainScript(kernelconfig.scripts._base.MainScriptBase):
 
         # config creation
         # * init
-        #
-        #   ** modalias lookup info source
-        modules_dir = self.do_main_get_modules_dir(arg_config)
-        if modules_dir is None:
+        config_gen = self.do_main_create_config_generator(arg_config)
+        if config_gen is None:
             # already logged
             return False
 
-        config_gen = self.create_loggable(
-            kernelconfig.kconfig.config.gen.KernelConfigGenerator,
-            install_info=self.install_info,
-            source_info=self.source_info,
-            modules_dir=modules_dir
-        )
-
         config = config_gen.get_config()
 
         #  the output config file must be backed up
@@ -1030,6 +1064,19 @@ class KernelConfigMainScript(kernelconfig.scripts._base.MainScriptBase):
         return modalias_cache_builder.run_create()
     # --- end of do_main_script_genmodalias (...) ---
 
+    def do_main_script_serve(self, arg_config, socket_path):
+        # the server module depends on this module
+        import kernelconfig.scripts.server
+
+        self.do_main_setup_logging(arg_config)
+
+        server = self.create_loggable(
+            kernelconfig.scripts.server.KernelConfigServer,
+            socket_path, install_info=self.install_info
+        )
+        return server.serve_forever()
+    # --- end of do_main_script_serve (...) ---
+
     def do_main(self, arg_config):
         script_mode_config = arg_config["script_mode"]
 
@@ -1071,6 +1118,9 @@ class KernelConfigMainScript(kernelconfig.scripts._base.MainScriptBase):
         elif script_mode == "print-installinfo":
             return self.do_main_script_print_installinfo(arg_config)
 
+        elif script_mode == "serve":
+            return self.do_main_script_serve(arg_config, script_arg)
+
         else:
             raise NotImplementedError("script mode", script_mode)
     # --- end of do_main (...) ---
@@ -537,10 +537,54 @@ class PymConfigurationSourceRunEnv(loggable.AbstractLoggable):
         outfile = self.get_tmpfile()
         self.logger.info("Downloading %s to file", url)
         _fileget.get_file_write_to_file(
-            outfile, url, data=data, logger=self.logger
+            outfile, url, data=data,
+            cache=self._senv.get_file_cache(), logger=self.logger
         )
         return outfile
 
+    def download_files(self, urls, data=None, *, missing_ok=False):
+        """
+        Downloads several files concurrently
+        and stores their content in temporary files,
+        whose paths are then returned in the same order as urls.
+
+        A ConfigurationSourceFileGetError is raised on errors,
+        after all downloads have been attempted.
+
+        @param   urls:        remote file paths
+        @type    urls:        iterable of C{str}
+        @keyword data:        request data, defaults to None
+        @keyword missing_ok:  whether to tolerate 404 errors,
+                              the path of files not found is None then.
+                              Defaults to False.
+        @type    missing_ok:  C{bool}
+
+        @return:  paths to downloaded files
+        @rtype:   C{list} of C{str}|C{None}
+        """
+        requests = [(self.get_tmpfile(), url) for url in urls]
+        self.logger.info("Downloading %d files", len(requests))
+        errors = _fileget.get_files_write_to_files(
+            requests, data=data, return_exceptions=True,
+            cache=self._senv.get_file_cache(), logger=self.logger
+        )
+
+        outfiles = []
+        for (outfile, url), err in zip(requests, errors):
+            if err is None:
+                outfiles.append(outfile)
+            elif (
+                missing_ok
+                and getattr(err.orig_exc[1], "code", None) == 404
+            ):
+                self.logger.debug("File not found: %s", url)
+                outfiles.append(None)
+            else:
+                raise err
+        # --
+
+        return outfiles
+
     def download(self, url, data=None):
         """
         Downloads a file from the given url
@@ -555,9 +599,17 @@ class PymConfigurationSourceRunEnv(loggable.AbstractLoggable):
         @return:  received data
         @rtype:   C{bytes}
         """
-        self.logger.info("Downloading %s", url)
-        # get_file() returns bytearray
-        return bytes(_fileget.get_file(url, data=data, logger=self.logger))
+        file_cache = self._senv.get_file_cache()
+        if file_cache is None or data is not None:
+            self.logger.info("Downloading %s", url)
+            # get_file() returns bytearray
+            return bytes(
+                _fileget.get_file(url, data=data, logger=self.logger)
+            )
+        # --
+
+        with open(self.download_file(url), "rb") as fh:
+            return fh.read()
 
     def create_subproc(self, cmdv, *, cwd=None, **kwargs):
         """
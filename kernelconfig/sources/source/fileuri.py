@@ -152,7 +152,8 @@ class FileConfigurationSource(_sourcebase.PhasedConfigurationSourceBase):
         if self.file_uri_scheme:
             _fileget.get_file_write_to_file(
                 arg_config.get_outconfig_path(),
-                arg_config.file_uri, logger=self.logger
+                arg_config.file_uri,
+                cache=self.senv.get_file_cache(), logger=self.logger
             )
 
         return self.create_conf_basis_for_arg_config(arg_config)
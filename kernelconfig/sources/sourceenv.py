@@ -6,6 +6,7 @@ import re
 import stat
 
 from ..abc import informed
+from ..util import fileget
 from ..util import fspath
 from ..util import tmpdir
 
@@ -47,6 +48,10 @@ class ConfigurationSourcesEnv(informed.AbstractInformed):
     @ivar source_info:
     @ivar install_info:
 
+    @ivar _file_cache:  shared cache for downloaded files or None,
+                        lazy-init, see get_file_cache()
+    @type _file_cache:  L{FileCache} or C{None}
+
     @ivar _tmpdir:    shared tmpdir, config sources should request
                       a subdirectory with get_tmpdir().get_new_subdir()
                       or individual files with get_tmpdir().open_new_file()
@@ -85,6 +90,7 @@ class ConfigurationSourcesEnv(informed.AbstractInformed):
         self._tmpdir = None
         self._fmt_vars = None
         self._env_vars = None
+        self._file_cache = False
 
     def get_kernelversion(self):
         source_info = self.source_info
@@ -267,6 +273,27 @@ class ConfigurationSourcesEnv(informed.AbstractInformed):
             self._tmpdir = tmpdir_obj
         return tmpdir_obj
 
+    def get_file_cache(self):
+        """Returns the shared cache for downloaded files.
+
+        @return:  file cache or None if no cache dir is configured
+        @rtype:   L{FileCache} or C{None}
+        """
+        file_cache = self._file_cache
+        if file_cache is False:
+            try:
+                cache_dir = self.install_info.get_cache_dir_path("fetch")
+            except StopIteration:
+                file_cache = None
+            else:
+                file_cache = self.create_loggable(
+                    fileget.FileCache, cache_dir
+                )
+            self._file_cache = file_cache
+        # --
+        return file_cache
+    # --- end of get_file_cache (...) ---
+
     def _create_base_vars(self):
         """
         Creates the dict of "base" variables that will be available
@@ -1,14 +1,28 @@
 # This file is part of kernelconfig.
 # -*- coding: utf-8 -*-
 
+import concurrent.futures
+import fcntl
+import hashlib
+import json
+import os
+import re
+import shutil
+import tempfile
+import urllib.error
 import urllib.parse
 import urllib.request
 
 from ..abc import loggable
+from . import fileio
 from . import fs
+from . import osmisc
 
 
-__all__ = ["GetFile", "get_file", "get_file_write_to_file"]
+__all__ = [
+    "GetFile", "FileCache",
+    "get_file", "get_file_write_to_file", "get_files_write_to_files"
+]
 
 
 def get_file(url, data=None, **kwargs):
@@ -18,12 +32,96 @@ def get_file(url, data=None, **kwargs):
 # --- end of get_file (...) ---
 
 
-def get_file_write_to_file(filepath, url, data=None, **kwargs):
-    with GetFile(url, data, **kwargs) as file_getter:
-        file_getter.write_to_file(filepath)
+def get_file_write_to_file(filepath, url, data=None, *, cache=None, **kwargs):
+    """Downloads a file and writes it to filepath.
+
+    @param   filepath:  output file
+    @type    filepath:  C{str}
+    @param   url:       remote file
+    @keyword data:      request data, requests with data are never cached
+    @keyword cache:     file cache or None
+    @type    cache:     L{FileCache} or C{None}
+    @param   kwargs:    additional keyword arguments for L{GetFile}
+
+    @return:  None (implicit)
+    """
+    if cache is not None and data is None:
+        cache.fetch(url, filepath, **kwargs)
+    else:
+        with GetFile(url, data, **kwargs) as file_getter:
+            file_getter.write_to_file(filepath)
 # --- end of get_file_write_to_file (...) ---
 
 
+def get_files_write_to_files(
+    requests, data=None, *,
+    cache=None, max_workers=None, return_exceptions=False, **kwargs
+):
+    """Downloads several files concurrently.
+
+    Files are downloaded by up to max_workers threads,
+    which defaults to FileCache.FETCH_JOBS.
+    Concurrent downloads of the same url are serialized by the cache,
+    so that the url gets downloaded only once.
+
+    All downloads are attempted, even if one of them fails.
+
+    @param   requests:     2-tuples (filepath, url)
+    @type    requests:     iterable of 2-tuples (C{str}, C{str})
+    @keyword data:         request data, see get_file_write_to_file()
+    @keyword cache:        file cache or None
+    @type    cache:        L{FileCache} or C{None}
+    @keyword max_workers:  max. number of threads or None
+    @type    max_workers:  C{int} or C{None}
+    @keyword return_exceptions:  if True, return the errors instead of
+                                 raising the first one
+    @type    return_exceptions:  C{bool}
+    @param   kwargs:       additional keyword arguments for L{GetFile}
+
+    @return:  list of errors (or None), one per request,
+              if return_exceptions is True, else None
+    @rtype:   C{list} of (C{Exception} or C{None}) or C{None}
+    """
+    def get_file_write_to_file_or_exc(request):
+        nonlocal data
+        nonlocal cache
+        nonlocal kwargs
+
+        filepath, url = request
+        try:
+            get_file_write_to_file(
+                filepath, url, data, cache=cache, **kwargs
+            )
+        except Exception as err:  # pylint: disable=W0703
+            return err
+        else:
+            return None
+    # ---
+
+    requests = list(requests)
+    if max_workers is None:
+        max_workers = FileCache.FETCH_JOBS
+
+    if max_workers > 1 and len(requests) > 1:
+        with concurrent.futures.ThreadPoolExecutor(
+            max_workers=min(max_workers, len(requests))
+        ) as executor:
+            results = list(
+                executor.map(get_file_write_to_file_or_exc, requests)
+            )
+    else:
+        results = [get_file_write_to_file_or_exc(r) for r in requests]
+    # --
+
+    if return_exceptions:
+        return results
+
+    for err in results:
+        if err is not None:
+            raise err
+# --- end of get_files_write_to_files (...) ---
+
+
 class GetFile(loggable.AbstractLoggable):
     """Provides methods for getting files via urlopen().
 
@@ -32,8 +130,9 @@ class GetFile(loggable.AbstractLoggable):
     >>>     file_getter.write_to_file("./file")
     """
     __slots__ = [
-        "_webh", "block_size", "info",
-        "request_url", "request_data", "request_timeout", "request_kwargs"
+        "_webh", "block_size", "info", "status",
+        "request_url", "request_data", "request_headers",
+        "request_timeout", "request_kwargs"
     ]
 
     # TODO: exception handling: some status codes/timeouts are worth a retry
@@ -43,11 +142,13 @@ class GetFile(loggable.AbstractLoggable):
 
     def __init__(
         self, url, data=None, *,
-        timeout=True, urlopen_kwargs=None, block_size=None, **kwargs
+        timeout=True, urlopen_kwargs=None, block_size=None, headers=None,
+        **kwargs
     ):
         super().__init__(**kwargs)
         self.request_url = url
         self.request_data = data
+        self.request_headers = headers
         self.request_timeout = (
             self.DEFAULT_TIMEOUT if timeout is True else timeout
         )
@@ -58,6 +159,7 @@ class GetFile(loggable.AbstractLoggable):
         self.block_size = block_size
 
         self.info = None
+        self.status = None
         self._webh = None
     # ---
 
@@ -76,8 +178,16 @@ class GetFile(loggable.AbstractLoggable):
 
     def _urlopen(self):
         self.logger.debug("Opening file uri %r", self.request_url)
+
+        if self.request_headers:
+            request = urllib.request.Request(
+                self.request_url, headers=self.request_headers
+            )
+        else:
+            request = self.request_url
+
         return urllib.request.urlopen(
-            self.request_url,
+            request,
             data=self.request_data,
             timeout=self.request_timeout,
             **self.request_kwargs
@@ -86,9 +196,22 @@ class GetFile(loggable.AbstractLoggable):
 
     def __enter__(self):
         self.assert_webh_not_open()
-        webh = self._urlopen()
+        try:
+            webh = self._urlopen()
+        except urllib.error.HTTPError as err:
+            if err.code != 304:
+                raise
+
+            # conditional request, see is_not_modified()
+            err.close()
+            self.info = err.headers
+            self.status = err.code
+            return self
+        # --
+
         try:
             self.info = webh.info()
+            self.status = webh.getcode()
             self._webh = webh
         except:
             webh.close()
@@ -99,11 +222,23 @@ class GetFile(loggable.AbstractLoggable):
 
     def __exit__(self, exc_type, exc_value, exc_traceback):
         self.info = None
+        self.status = None
         webh = self._webh
         if webh is not None:
+            self._webh = None
             webh.close()
     # ---
 
+    def is_not_modified(self):
+        """
+        @return:  True if the server replied to a conditional request
+                  with "304 Not Modified", in which case there is nothing
+                  to read, else False
+        @rtype:   C{bool}
+        """
+        return self.status == 304
+    # ---
+
     def read_blocks(self):
         block_size = self.block_size or self.DEFAULT_BLOCK_SIZE
         if not block_size:
@@ -150,3 +285,265 @@ class GetFile(loggable.AbstractLoggable):
     # ---
 
 # --- end of GetFile ---
+
+
+class FileCache(loggable.AbstractLoggable):
+    """
+    Content-addressed cache for downloaded files,
+    which may be shared by several processes.
+
+    Layout of the cache directory:
+
+      objects/<xx>/<digest>   file content, named after its sha256 digest
+      urls/<url key>.json     {"url", "digest", "etag", "last_modified"}
+      partial/<url key>       incomplete download
+      partial/<url key>.json  {"url", "etag", "last_modified"}
+      partial/<url key>.lock  lock file, serializes downloads of the url
+
+    where <url key> is the sha256 digest of the url.
+
+    Cached urls are revalidated with a conditional request
+    (If-None-Match, If-Modified-Since) if the server has sent
+    an ETag or a Last-Modified header, and are downloaded again otherwise.
+    Interrupted downloads are resumed with a Range request
+    if the server has sent a validator for If-Range.
+
+    @cvar FETCH_JOBS:  default number of concurrent downloads,
+                       see get_files_write_to_files()
+    @type FETCH_JOBS:  C{int}
+
+    @ivar cache_dir:   cache directory
+    @type cache_dir:   C{str}
+    """
+
+    FETCH_JOBS = osmisc.envint("KERNELCONFIG_FETCH_JOBS", 4)
+
+    RE_DIGEST = re.compile(r'^[0-9a-f]{64}$')
+    RE_CONTENT_RANGE = re.compile(r'^bytes\s+(?P<start>\d+)-', re.IGNORECASE)
+
+    def __init__(self, cache_dir, **kwargs):
+        super().__init__(**kwargs)
+        self.cache_dir = cache_dir
+    # --- end of __init__ (...) ---
+
+    def get_url_key(self, url):
+        return hashlib.sha256(url.encode()).hexdigest()
+
+    def get_object_path(self, digest):
+        return os.path.join(self.cache_dir, "objects", digest[:2], digest)
+
+    def get_file_digest(self, filepath, block_size=GetFile.DEFAULT_BLOCK_SIZE):
+        file_hash = hashlib.sha256()
+        with open(filepath, "rb") as fh:
+            block = fh.read(block_size)
+            while block:
+                file_hash.update(block)
+                block = fh.read(block_size)
+        return file_hash.hexdigest()
+    # --- end of get_file_digest (...) ---
+
+    def _read_json(self, filepath):
+        try:
+            with open(filepath, "rt") as fh:
+                data = json.load(fh)
+        except OSError:
+            return None
+        except ValueError as err:
+            self.logger.warning(
+                "Failed to read fetch cache file %s: %s", filepath, err
+            )
+            return None
+        # --
+
+        return data if isinstance(data, dict) else None
+    # --- end of _read_json (...) ---
+
+    def _write_json(self, filepath, data):
+        # other processes may be reading the file concurrently
+        fileio.write_file_atomic(
+            filepath,
+            lambda fh: json.dump(data, fh, separators=(",", ":")),
+            suffix=".json"
+        )
+    # --- end of _write_json (...) ---
+
+    def _get_validators(self, info):
+        return {
+            "etag": info.get("ETag"),
+            "last_modified": info.get("Last-Modified")
+        }
+    # --- end of _get_validators (...) ---
+
+    def _get_cached_object(self, url, url_file):
+        """Returns the path to the cached content of url,
+        and the headers for revalidating it.
+
+        @return:  2-tuple (object path or None, headers dict)
+        """
+        entry = self._read_json(url_file)
+        if not entry or entry.get("url") != url:
+            return (None, {})
+
+        digest = entry.get("digest")
+        if not isinstance(digest, str) or not self.RE_DIGEST.match(digest):
+            return (None, {})
+
+        obj_path = self.get_object_path(digest)
+        if not os.path.isfile(obj_path):
+            return (None, {})
+
+        headers = {}
+        if entry.get("etag"):
+            headers["If-None-Match"] = entry["etag"]
+        if entry.get("last_modified"):
+            headers["If-Modified-Since"] = entry["last_modified"]
+
+        return (obj_path, headers)
+    # --- end of _get_cached_object (...) ---
+
+    def _get_partial_size(self, url, partial_file, partial_meta_file):
+        """Returns the size of an interrupted download of url
+        and the headers for resuming it.
+
+        @return:  2-tuple (size, headers dict), size is 0 if the download
+                  cannot be resumed
+        """
+        partial_meta = self._read_json(partial_meta_file)
+        if not partial_meta or partial_meta.get("url") != url:
+            return (0, {})
+
+        # If-Range takes a single validator, prefer the etag
+        validator = partial_meta.get("etag") or partial_meta.get(
+            "last_modified"
+        )
+        if not validator:
+            return (0, {})
+
+        try:
+            partial_size = os.stat(partial_file).st_size
+        except OSError:
+            return (0, {})
+
+        if not partial_size:
+            return (0, {})
+
+        return (
+            partial_size,
+            {
+                "Range": "bytes={:d}-".format(partial_size),
+                "If-Range": validator
+            }
+        )
+    # --- end of _get_partial_size (...) ---
+
+    def _fetch_locked(self, url, url_key, **kwargs):
+        """Downloads url to the cache, unless the cached content is
+        still valid. Must be called with the url's lock held.
+
+        @return:  path to the cached content
+        @rtype:   C{str}
+        """
+        url_file = os.path.join(self.cache_dir, "urls", url_key + ".json")
+        partial_file = os.path.join(self.cache_dir, "partial", url_key)
+        partial_meta_file = partial_file + ".json"
+
+        obj_path, headers = self._get_cached_object(url, url_file)
+        partial_size, range_headers = self._get_partial_size(
+            url, partial_file, partial_meta_file
+        )
+        headers.update(range_headers)
+
+        kwargs.setdefault("parent_logger", self.logger)
+        with GetFile(url, headers=(headers or None), **kwargs) as getter:
+            if getter.is_not_modified():
+                if obj_path is None:
+                    raise OSError("unexpected 304 reply for {!r}".format(url))
+
+                self.logger.debug("Using cached file for %r", url)
+                return obj_path
+            # --
+
+            resume = False
+            if partial_size and getter.status == 206:
+                match = self.RE_CONTENT_RANGE.match(
+                    getter.info.get("Content-Range", "")
+                )
+                if not match or int(match.group("start")) != partial_size:
+                    fs.rmfile(partial_file)
+                    raise OSError(
+                        "unexpected Content-Range for {!r}".format(url)
+                    )
+                # --
+
+                resume = True
+                self.logger.debug(
+                    "Resuming download of %r at %d bytes", url, partial_size
+                )
+
+            else:
+                validators = self._get_validators(getter.info)
+                if any(validators.values()):
+                    self._write_json(
+                        partial_meta_file, dict(validators, url=url)
+                    )
+                else:
+                    # cannot be resumed
+                    fs.rmfile(partial_meta_file)
+            # --
+
+            fs.dodir_for_file(partial_file)
+            with open(partial_file, ("ab" if resume else "wb")) as fh:
+                getter.write_to_fh(fh)
+
+            validators = self._get_validators(getter.info)
+        # --
+
+        digest = self.get_file_digest(partial_file)
+        obj_path = self.get_object_path(digest)
+        fs.dodir_for_file(obj_path)
+        os.chmod(partial_file, 0o644)
+        os.replace(partial_file, obj_path)
+        fs.rmfile(partial_meta_file)
+
+        self._write_json(url_file, dict(validators, url=url, digest=digest))
+        self.logger.debug("Added %r to fetch cache: %s", url, digest)
+        return obj_path
+    # --- end of _fetch_locked (...) ---
+
+    def fetch(self, url, filepath, **kwargs):
+        """Downloads a file via the cache and writes it to filepath.
+
+        Falls back to downloading the file directly to filepath
+        if the cache directory cannot be written.
+
+        @param url:       remote file
+        @type  url:       C{str}
+        @param filepath:  output file
+        @type  filepath:  C{str}
+        @param kwargs:    additional keyword arguments for L{GetFile}
+
+        @return:  None (implicit)
+        """
+        url_key = self.get_url_key(url)
+        lock_file = os.path.join(self.cache_dir, "partial", url_key + ".lock")
+
+        try:
+            fs.dodir_for_file(lock_file)
+            lock_fh = open(lock_file, "ab")
+        except OSError as err:
+            self.logger.warning("Cannot use fetch cache: %s", err)
+            with GetFile(url, **kwargs) as file_getter:
+                file_getter.write_to_file(filepath)
+            return
+        # --
+
+        with lock_fh:
+            # also serializes threads, the lock is per open file
+            fcntl.flock(lock_fh.fileno(), fcntl.LOCK_EX)
+            obj_path = self._fetch_locked(url, url_key, **kwargs)
+
+            fs.prepare_output_file(filepath, move=True)
+            shutil.copyfile(obj_path, filepath)
+    # --- end of fetch (...) ---
+
+# --- end of FileCache ---
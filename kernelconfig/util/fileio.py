@@ -7,9 +7,14 @@ import gzip
 import io
 import mimetypes
 import os
+import tempfile
 
+from . import fs
 
-__all__ = ["read_text_file_lines", "write_text_file_lines"]
+
+__all__ = [
+    "read_text_file_lines", "write_text_file_lines", "write_file_atomic"
+]
 
 
 class _Compression(object):
@@ -36,6 +41,18 @@ def check_is_fileobj(suspect):
 # ---
 
 
+def check_is_compressed(filepath):
+    """Returns whether read_text_file_lines() would decompress a file.
+
+    @param filepath:  file path
+    @type  filepath:  C{str}
+
+    @rtype: C{bool}
+    """
+    return _Compression.guess_compression(filepath) is not None
+# ---
+
+
 def read_text_file_lines_from_fh(infile_fh, filename=None, rstrip=True):
     """Generator that reads lines from an already opened text file.
 
@@ -175,6 +192,53 @@ def write_text_file_lines(outfile, lines, filename=None, **kwargs):
 # --- end of write_text_file_lines (...) ---
 
 
+def write_file_atomic(
+    filepath, writer, suffix=None, binary=False, file_mode=0o644
+):
+    """Writes a file by passing a temporary file in the same directory
+    to writer(fh) and renaming it to filepath afterwards,
+    so that other processes reading filepath concurrently
+    see either the old or the new content.
+
+    Creates the file's directory if necessary.
+    The temporary file gets removed on errors.
+
+    @raises OSError:
+
+    @param   filepath:   output file
+    @type    filepath:   C{str}
+    @param   writer:     function that writes the content to an open file
+    @type    writer:     callable f(fh)
+    @keyword suffix:     suffix of the temporary file name, defaults to None
+    @type    suffix:     C{str} or C{None}
+    @keyword binary:     whether to open the file in binary mode
+                         instead of text mode. Defaults to False.
+    @type    binary:     C{bool}
+    @keyword file_mode:  permissions of the file, defaults to 0o644
+    @type    file_mode:  C{int}
+
+    @return: None (implicit)
+    """
+    tmp_file = None
+    try:
+        fs.dodir_for_file(filepath)
+
+        tmp_fd, tmp_file = tempfile.mkstemp(
+            prefix=".", suffix=suffix, dir=os.path.dirname(filepath)
+        )
+        os.fchmod(tmp_fd, file_mode)
+        with os.fdopen(tmp_fd, ("wb" if binary else "wt")) as fh:
+            writer(fh)
+
+        os.replace(tmp_file, filepath)
+        tmp_file = None
+
+    finally:
+        if tmp_file is not None:
+            fs.rmfile(tmp_file)
+# --- end of write_file_atomic (...) ---
+
+
 class LineContBuffer(object):
 
     def __init__(self):
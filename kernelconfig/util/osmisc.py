@@ -14,6 +14,7 @@ __all__ = [
     "which",
     "which_sbin",
     "envbool_nonempty",
+    "envint",
     "Pushd",
 ]
 
@@ -99,6 +100,28 @@ def envbool_nonempty(env_varname, fallback=None, *, env=None):
 # --- end of envbool_nonempty (...) ---
 
 
+def envint(env_varname, fallback=None, *, env=None):
+    """
+    Returns the int value of env_varname in env (or os.environ),
+    and fallback or None if it is not set, empty or not an int.
+
+    @param   env_varname:
+    @type    env_varname:  C{str}
+    @keyword fallback:     fallback value in case then env_varname is not set
+    @type    fallback:     undefined
+    @keyword env:          env dict, defaults to None (-> os.environ)
+    @type    env:
+
+    @return:  int/fallback
+    @rtype:   C{int} | undefined
+    """
+    try:
+        return int((os.environ if env is None else env)[env_varname])
+    except (KeyError, ValueError):
+        return fallback
+# --- end of envint (...) ---
+
+
 class Pushd(object):
     """
     Temporarily changes the working directory,
@@ -48,6 +48,32 @@ class ProjectSetup(object):
         # get_lkc_src_include(name):  "\"" lkc_src "/" name "\""
         get_lkc_src_include = lambda n: "\"%s\"" % _get_lkc_src_include(n)
 
+        define_macros = [
+            ("LKCONFIG_LKC", get_lkc_src_include("lkc.h"))
+        ]
+
+        # lkc from src/lkc-bundled, the parse phases can be profiled
+        # separately, see lkconfig__conf_parse_phases() in src/lkconfig.c
+        if (
+            os.path.realpath(lkc_src)
+            == os.path.realpath(get_lkconfig_src("lkc-bundled"))
+        ):
+            define_macros.append(("LKCONFIG_LKC_BUNDLED", None))
+        extra_link_args = []
+
+        # arena allocator for lkc's parser, see src/lkconfig_arena.c
+        #  requires GNU ld's --wrap, can be disabled with LKCONFIG_ARENA=0
+        if (
+            sys.platform.startswith("linux")
+            and os.getenv("LKCONFIG_ARENA", "1") != "0"
+        ):
+            define_macros.append(("LKCONFIG_ARENA", None))
+            extra_link_args.extend((
+                "-Wl,--wrap=%s" % func
+                for func in ("malloc", "calloc", "realloc", "free", "strdup")
+            ))
+        # --
+
         kernelconfig_lkconfig_pyext = distutils.core.Extension(
             cls.pym_name("kconfig.lkconfig"),
             sources = (
@@ -57,9 +83,8 @@ class ProjectSetup(object):
                 ]
             ),
             extra_compile_args = ["-Wall"],
-            define_macros = [
-                ("LKCONFIG_LKC", get_lkc_src_include("lkc.h"))
-            ]
+            extra_link_args = extra_link_args,
+            define_macros = define_macros
         )
 
         return [kernelconfig_lkconfig_pyext]
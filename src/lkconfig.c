@@ -1,9 +1,21 @@
 #include "lkconfig_objdef.h"
 
 #include "lkconfig_utilfuncs.c"
+#include "lkconfig_ptrmap.c"
+#include "lkconfig_arena.c"
+#include "lkconfig_viewcache.c"
+#include "lkconfig_symindex.c"
+#include "lkconfig_depgraph.c"
+#include "lkconfig_context.c"
+#include "lkconfig_prof.c"
 #include "lkconfig_symbol.c"
 #include "lkconfig_expr.c"
+#include "lkconfig_solstore.c"
+#include "lkconfig_exprcode.c"
+#include "lkconfig_confread.c"
 #include "lkconfig_conf.c"
+#include "lkconfig_autoconf.c"
+#include "lkconfig_symtab.c"
 
 /* exceptions */
 static PyObject* lkconfigKconfigParseError;
@@ -12,9 +24,34 @@ static PyObject* lkconfigKconfigParseError;
 /* function sig */
 static PyObject* lkconfig_read_symbols ( PyObject* self, PyObject* args );
 static PyObject* lkconfig_get_symbols ( PyObject* self, PyObject* noargs );
+static PyObject* lkconfig_get_symbol_table ( PyObject* self, PyObject* noargs );
+static PyObject* lkconfig_get_kconfig_deps ( PyObject* self, PyObject* noargs );
+static PyObject* lkconfig_get_symbol_count ( PyObject* self, PyObject* noargs );
+static PyObject* lkconfig_get_symbol_index ( PyObject* self, PyObject* args );
+static PyObject* lkconfig_get_symbol_value ( PyObject* self, PyObject* args );
+static PyObject* lkconfig_get_symbol_values ( PyObject* self, PyObject* noargs );
+static PyObject* lkconfig_set_symbol_value ( PyObject* self, PyObject* args );
+static PyObject* lkconfig_get_context ( PyObject* self, PyObject* noargs );
+static PyObject* lkconfig_switch_context ( PyObject* self, PyObject* args );
 static PyObject* lkconfig_oldconfig (
     PyObject* self, PyObject* args, PyObject* kwargs
 );
+static PyObject* lkconfig_oldconfig_values (
+    PyObject* self, PyObject* args, PyObject* kwargs
+);
+static PyObject* lkconfig_oldconfig_batch (
+    PyObject* self, PyObject* args, PyObject* kwargs
+);
+static PyObject* lkconfig_write_defconfig ( PyObject* self, PyObject* args );
+static PyObject* lkconfig_get_defconfig_values (
+    PyObject* self, PyObject* noargs
+);
+static PyObject* lkconfig_write_autoconf (
+    PyObject* self, PyObject* args, PyObject* kwargs
+);
+static PyObject* lkconfig_read_config_file ( PyObject* self, PyObject* args );
+static PyObject* lkconfig_set_profiling ( PyObject* self, PyObject* args );
+static PyObject* lkconfig_get_profile ( PyObject* self, PyObject* args );
 
 PyMODINIT_FUNC PyInit_lkconfig (void);
 
@@ -36,7 +73,8 @@ static PyMethodDef lkconfig_MethodTable[] = {
             "Notes:\n"
             "* environment sensitive: ARCH, SRCARCH and KERNELVERSION need to be set\n"
             "                         in os.environ prior to calling this function.\n"
-            "* must not be called more than once\n"  /* due to how lkc stores symbols */
+            "* must not be called more than once per context,\n"
+            "  see Context, switch_context()\n"
         )
     },
     {
@@ -51,23 +89,346 @@ static PyMethodDef lkconfig_MethodTable[] = {
             "Note: read_symbols() must be called before calling this function!\n"
         )
     },
+    {
+        "get_symbol_table",
+        lkconfig_get_symbol_table,
+        METH_NOARGS,
+        PyDoc_STR (
+            "get_symbol_table()\n"
+            "\n"
+            "Returns all kconfig symbols as packed SymbolTable,\n"
+            "which consists of parallel per-symbol columns\n"
+            "and shared prompt, default and expression tables.\n"
+            "\n"
+            "Note: read_symbols() must be called before calling this function!\n"
+        )
+    },
+    {
+        "get_kconfig_deps",
+        lkconfig_get_kconfig_deps,
+        METH_NOARGS,
+        PyDoc_STR (
+            "get_kconfig_deps()\n"
+            "\n"
+            "Returns a 2-tuple (kconfig files, env var names)\n"
+            "of all Kconfig files that have been read\n"
+            "and all environment variables referenced via 'option env'.\n"
+            "File names are in the form passed to the lkc parser,\n"
+            "i.e. relative file names may be relative to $srctree.\n"
+            "\n"
+            "Note: read_symbols() must be called before calling this function!\n"
+        )
+    },
+    {
+        "get_symbol_count",
+        lkconfig_get_symbol_count,
+        METH_NOARGS,
+        PyDoc_STR (
+            "get_symbol_count()\n"
+            "\n"
+            "Returns the number of indexed symbols.\n"
+            "Symbol indices range from 0 to get_symbol_count() - 1,\n"
+            "in the order of get_symbols() and get_symbol_table().\n"
+            "\n"
+            "Note: read_symbols() must be called before calling this function!\n"
+        )
+    },
+    {
+        "get_symbol_index",
+        lkconfig_get_symbol_index,
+        METH_VARARGS,
+        PyDoc_STR (
+            "get_symbol_index(name)\n"
+            "\n"
+            "Returns the index of the named symbol, or None if not indexed.\n"
+        )
+    },
+    {
+        "get_symbol_value",
+        lkconfig_get_symbol_value,
+        METH_VARARGS,
+        PyDoc_STR (
+            "get_symbol_value(index)\n"
+            "\n"
+            "Returns the current value of a symbol,\n"
+            "represented as in a config values dict, see oldconfig_values().\n"
+        )
+    },
+    {
+        "get_symbol_values",
+        lkconfig_get_symbol_values,
+        METH_NOARGS,
+        PyDoc_STR (
+            "get_symbol_values()\n"
+            "\n"
+            "Returns the current values of all indexed symbols\n"
+            "as list indexed by symbol index, see get_symbol_value().\n"
+        )
+    },
+    {
+        "set_symbol_value",
+        lkconfig_set_symbol_value,
+        METH_VARARGS,
+        PyDoc_STR (
+            "set_symbol_value(index, value)\n"
+            "\n"
+            "Sets the user value of a symbol, like lkc's sym_set_*_value().\n"
+            "Tristate/boolean values are int 0/1/2 (or None for 0),\n"
+            "string-like values are str (or int for int/hex symbols).\n"
+            "\n"
+            "Returns True if the value has been set,\n"
+            "and False if it is out of range.\n"
+        )
+    },
+    {
+        "get_context",
+        lkconfig_get_context,
+        METH_NOARGS,
+        PyDoc_STR (
+            "get_context()\n"
+            "\n"
+            "Returns the active lkc context.\n"
+        )
+    },
+    {
+        "switch_context",
+        lkconfig_switch_context,
+        METH_VARARGS,
+        PyDoc_STR (
+            "switch_context(context)\n"
+            "\n"
+            "Makes the given context the active one\n"
+            "and returns the previously active context.\n"
+            "\n"
+            "All other functions operate on the symbols of the active context.\n"
+        )
+    },
     {
         "oldconfig",
         (PyCFunction) lkconfig_oldconfig,
         METH_VARARGS | METH_KEYWORDS,
         PyDoc_STR (
-            "oldconfig(input_file, output_file, decisions_dict)\n"
+            "oldconfig(input_file, output_file, decisions_dict,\n"
+            "          *, logger=None, record_changes=False,\n"
+            "          incremental=False)\n"
             "\n"
             "Runs oldconfig.\n"
             "\n"
+            "Messages are only formatted for log levels\n"
+            "enabled by the logger's getEffectiveLevel().\n"
+            "If record_changes is true, returns a list of change records\n"
+            "(name, old value or None, new value) for all symbols\n"
+            "changed by oldconfig, with values as str. Otherwise, returns None.\n"
+            "If incremental is true, a symbol change invalidates only\n"
+            "the symbols depending on it instead of all symbols.\n"
+            "\n"
+            "Raises OSError if the input file cannot be read.\n"
+            "\n"
             "Note: read_symbols() must be called before this function!\n"
         )
     },
+    {
+        "oldconfig_values",
+        (PyCFunction) lkconfig_oldconfig_values,
+        METH_VARARGS | METH_KEYWORDS,
+        PyDoc_STR (
+            "oldconfig_values(config_values, decisions_dict,\n"
+            "                 *, outfile=None, logger=None, record_changes=False,\n"
+            "                 incremental=False)\n"
+            "\n"
+            "Runs oldconfig without reading a .config file\n"
+            "and returns the resolved config values.\n"
+            "\n"
+            "Config values are passed as dict :: symbol name => value,\n"
+            "where tristate/boolean values are int 0/1/2,\n"
+            "string-like values are str (or int for int/hex symbols)\n"
+            "and 'is not set' is None. The returned dict lists all symbols\n"
+            "that would be written to a .config file, in order,\n"
+            "with int/hex values as int and disabled tristate/boolean\n"
+            "symbols as None.\n"
+            "\n"
+            "config_values may also be a list indexed by symbol index,\n"
+            "see get_symbol_index(), with None meaning \"no value\"\n"
+            "and int 0 for disabled tristate/boolean symbols.\n"
+            "\n"
+            "Arguments:\n"
+            "* config_values    -- input config values dict\n"
+            "* decisions_dict   -- decisions dict, see oldconfig()\n"
+            "* outfile          -- if not None, also write a .config file\n"
+            "* logger           -- logger, see oldconfig()\n"
+            "* record_changes   -- if true, return a 2-tuple\n"
+            "                      (config values, change records),\n"
+            "                      see oldconfig()\n"
+            "* incremental      -- incremental invalidation, see oldconfig()\n"
+            "\n"
+            "Note: read_symbols() must be called before this function!\n"
+        )
+    },
+    {
+        "oldconfig_batch",
+        (PyCFunction) lkconfig_oldconfig_batch,
+        METH_VARARGS | METH_KEYWORDS,
+        PyDoc_STR (
+            "oldconfig_batch(config, decisions_list,\n"
+            "                *, outfiles=None, logger=None,\n"
+            "                record_changes=False, incremental=False)\n"
+            "\n"
+            "Runs oldconfig once per decisions dict on the same input config\n"
+            "and returns a list of resolved config values dicts,\n"
+            "see oldconfig_values().\n"
+            "\n"
+            "The input config is read only once, the symbol values are\n"
+            "restored to the input config before each run.\n"
+            "\n"
+            "Arguments:\n"
+            "* config           -- input .config file (str)\n"
+            "                      or config values dict or list\n"
+            "* decisions_list   -- list of decisions dicts, see oldconfig()\n"
+            "* outfiles         -- if not None, list of output .config files\n"
+            "                      (str or None), one per decisions dict\n"
+            "* logger           -- logger, see oldconfig()\n"
+            "* record_changes   -- if true, each list item is a 2-tuple\n"
+            "                      (config values, change records),\n"
+            "                      see oldconfig()\n"
+            "* incremental      -- incremental invalidation, see oldconfig()\n"
+            "\n"
+            "Note: read_symbols() must be called before this function!\n"
+        )
+    },
+    {
+        "write_defconfig",
+        lkconfig_write_defconfig,
+        METH_VARARGS,
+        PyDoc_STR (
+            "write_defconfig(outfile)\n"
+            "\n"
+            "Writes the current symbol values to a minimal config file,\n"
+            "like 'make savedefconfig' does, i.e. only symbols\n"
+            "that differ from their default value are written.\n"
+            "\n"
+            "The symbol values are not resolved, this should be done\n"
+            "by running one of the oldconfig functions before.\n"
+            "\n"
+            "Raises OSError if the file cannot be written.\n"
+            "\n"
+            "Note: read_symbols() must be called before this function!\n"
+        )
+    },
+    {
+        "get_defconfig_values",
+        lkconfig_get_defconfig_values,
+        METH_NOARGS,
+        PyDoc_STR (
+            "get_defconfig_values()\n"
+            "\n"
+            "In-memory variant of write_defconfig().\n"
+            "\n"
+            "Returns the symbols that would be written to a minimal\n"
+            "config file as config values dict, in order,\n"
+            "see oldconfig_values().\n"
+            "\n"
+            "Note: read_symbols() must be called before this function!\n"
+        )
+    },
+    {
+        "write_autoconf",
+        (PyCFunction) lkconfig_write_autoconf,
+        METH_VARARGS | METH_KEYWORDS,
+        PyDoc_STR (
+            "write_autoconf(outdir, *, config_file=None)\n"
+            "\n"
+            "Writes the files that 'make silentoldconfig' would create\n"
+            "for the current symbol values to the kbuild output directory:\n"
+            "include/config/auto.conf, include/config/auto.conf.cmd,\n"
+            "include/config/tristate.conf, include/generated/autoconf.h\n"
+            "and the split config files include/config/<symbol>.h.\n"
+            "Optionally, also writes the .config file first.\n"
+            "\n"
+            "Only the split config files of symbols whose value differs\n"
+            "from the previous auto.conf in outdir are touched,\n"
+            "and generated files whose content does not change are kept.\n"
+            "\n"
+            "The symbol values are not resolved, this should be done\n"
+            "by running one of the oldconfig functions before.\n"
+            "\n"
+            "Returns the number of split config files touched.\n"
+            "Raises OSError if a file cannot be written.\n"
+            "\n"
+            "Note: read_symbols() must be called before this function!\n"
+        )
+    },
+    {
+        "read_config_file",
+        lkconfig_read_config_file,
+        METH_VARARGS,
+        PyDoc_STR (
+            "read_config_file(filename)\n"
+            "\n"
+            "Reads a .config file and returns its entries as list of\n"
+            "3-tuples (line number, option name, value str or None).\n"
+            "\n"
+            "Values are returned as they appear in the file,\n"
+            "i.e. string values are still quoted and escaped,\n"
+            "and None means 'is not set'.\n"
+            "Comments and blank lines are skipped.\n"
+            "\n"
+            "This is the same tokenizer that is used by oldconfig()\n"
+            "for reading its input file, it does not depend on lkc's symbols.\n"
+            "\n"
+            "Raises OSError if the file cannot be read\n"
+            "and ValueError if it contains unexpected data.\n"
+        )
+    },
+    {
+        "set_profiling",
+        lkconfig_set_profiling,
+        METH_VARARGS,
+        PyDoc_STR (
+            "set_profiling(enabled)\n"
+            "\n"
+            "Enables or disables profiling of read_symbols()\n"
+            "and the oldconfig functions, see get_profile().\n"
+            "Profiling is disabled by default.\n"
+            "\n"
+            "Returns whether profiling was enabled before.\n"
+        )
+    },
+    {
+        "get_profile",
+        lkconfig_get_profile,
+        METH_VARARGS,
+        PyDoc_STR (
+            "get_profile(reset=False)\n"
+            "\n"
+            "Returns the accumulated profile as dict with the keys\n"
+            "* phases   -- phase name => dict with keys 'calls' (int),\n"
+            "              'wall' and 'cpu' (float, seconds)\n"
+            "* counters -- counter name => int\n"
+            "* enabled  -- whether profiling is currently enabled\n"
+            "\n"
+            "Phases: parse, menu_finalize, symindex, conf_read,\n"
+            "conf_check, conf_values and conf_write.\n"
+            "Counters: kconfig_files, symbols, exprs, sym_calc_value,\n"
+            "conf_runs, conf_passes and bytes_written.\n"
+            "\n"
+            "Lexing is not timed separately, it is part of parse.\n"
+            "menu_finalize is only recorded if lkconfig has been built\n"
+            "with the bundled lkc, otherwise parse covers all of\n"
+            "lkc's conf_parse().\n"
+            "sym_calc_value counts the calls issued by lkconfig,\n"
+            "lkc's own (recursive) calls are not included.\n"
+            "\n"
+            "The profile is global, i.e. not bound to a context,\n"
+            "and gets cleared afterwards if reset is set.\n"
+        )
+    },
     /* and returns a list of all symbols.\n"*/
     { NULL, NULL, 0, NULL }  /* Sentinel */
 };
 
 
+static void lkconfig_module_free ( void* const m );
+
 static struct PyModuleDef lkconfig_Module = {
    /* m_base:            */ PyModuleDef_HEAD_INIT,
    /* m_name:            */ LKCONFIG_PYMOD_NAME,
@@ -76,8 +437,8 @@ static struct PyModuleDef lkconfig_Module = {
    /* m_methods:         */ lkconfig_MethodTable,
    /* m_slots|m_reload:  */ NULL,
    /* m_traverse:        */ NULL,
-   /* m_clear:           */ NULL,   /* FIXME: required, free symbols! */
-   /* m_free:            */ NULL
+   /* m_clear:           */ NULL,
+   /* m_free:            */ lkconfig_module_free
 };
 
 
@@ -133,6 +494,12 @@ static int lkconfig_init_constants ( PyObject* const m ) {
     LKCONFIG_INT_CONST ( S_STRING );
     LKCONFIG_INT_CONST ( S_OTHER );
 
+    LKCONFIG_INT_CONST ( SYMBOL_CONST );
+    LKCONFIG_INT_CONST ( SYMBOL_CHOICE );
+    LKCONFIG_INT_CONST ( SYMBOL_CHOICEVAL );
+    LKCONFIG_INT_CONST ( SYMBOL_OPTIONAL );
+    LKCONFIG_INT_CONST ( SYMBOL_AUTO );
+
     return 0;
 
 #undef LKCONFIG_INT_CONST
@@ -149,6 +516,26 @@ PyMODINIT_FUNC PyInit_lkconfig (void) {
         return NULL;
     }
 
+    if ( PyType_Ready(&lkconfig_SolutionStoreType) < 0 ) {
+        return NULL;
+    }
+
+    if ( lkconfig_ExprCodeObject_cls_init ( &lkconfig_ExprCodeType ) < 0 ) {
+        return NULL;
+    }
+
+    if ( lkconfig_SymbolTable_cls_init ( &lkconfig_SymbolTableType ) < 0 ) {
+        return NULL;
+    }
+
+    if ( PyType_Ready(&lkconfig_ContextType) < 0 ) {
+        return NULL;
+    }
+
+    if ( lkconfig_context_module_init() != 0 ) {
+        return NULL;
+    }
+
     m = PyModule_Create ( &lkconfig_Module );
     if ( m == NULL ) { return NULL; }
 
@@ -165,12 +552,108 @@ PyMODINIT_FUNC PyInit_lkconfig (void) {
         m, lkconfig_ExprViewName, (PyObject*) &lkconfig_ExprViewType
     );
 
+    Py_INCREF ( &lkconfig_SolutionStoreType );
+    PyModule_AddObject (
+        m, lkconfig_SolutionStoreName,
+        (PyObject*) &lkconfig_SolutionStoreType
+    );
+
+    Py_INCREF ( &lkconfig_ExprCodeType );
+    PyModule_AddObject (
+        m, lkconfig_ExprCodeName, (PyObject*) &lkconfig_ExprCodeType
+    );
+
+    Py_INCREF ( &lkconfig_SymbolTableType );
+    PyModule_AddObject (
+        m, lkconfig_SymbolTableName, (PyObject*) &lkconfig_SymbolTableType
+    );
+
+    Py_INCREF ( &lkconfig_ContextType );
+    PyModule_AddObject (
+        m, lkconfig_ContextName, (PyObject*) &lkconfig_ContextType
+    );
+
     return m;
 }
 
 
+static void lkconfig_module_free ( void* const m ) {
+    lkconfig_ContextObject* ctx;
+
+    /* free the active context's symbols */
+    ctx = lkconfig_active_context;
+    if ( ctx != NULL ) {
+        lkconfig_active_context = NULL;
+        lkconfig_lkc_state_save ( &(ctx->state) );
+        lkconfig_lkc_state_reset_globals();
+        Py_DECREF ( ctx );
+    }
+}
+
+
 /* functions */
 
+#ifdef LKCONFIG_LKC_BUNDLED
+/**
+ * conf_parse() from the bundled zconf.tab.c,
+ * with separate profiling phases for zconfparse()
+ * and menu_finalize() plus the dependency checks.
+ *
+ * Needs to be kept in sync with conf_parse(),
+ * and exits on errors just like conf_parse().
+ *
+ * @param kconfig_file   path to the top-level Kconfig file
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig__conf_parse_phases ( const char* const kconfig_file ) {
+    struct lkconfig_prof_timer timer;
+    struct symbol* sym;
+    int i;
+
+    lkconfig_prof_timer_start ( &timer );
+    zconf_initscan ( kconfig_file );
+
+    sym_init();
+    _menu_init();
+    rootmenu.prompt = menu_add_prompt (
+        P_MENU, "Linux Kernel Configuration", NULL
+    );
+
+    if ( getenv ( "ZCONF_DEBUG" ) ) { zconfdebug = 1; }
+    zconfparse();
+    if ( zconfnerrs ) { exit ( 1 ); }
+    if ( ! modules_sym ) { modules_sym = sym_find ( "n" ); }
+
+    rootmenu.prompt->text = _( rootmenu.prompt->text );
+    rootmenu.prompt->text = sym_expand_string_value (
+        rootmenu.prompt->text
+    );
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_parse );
+
+    lkconfig_prof_timer_start ( &timer );
+    menu_finalize ( &rootmenu );
+    for_all_symbols ( i, sym ) {
+        if ( sym_check_deps ( sym ) ) { zconfnerrs++; }
+    }
+    if ( zconfnerrs ) { exit ( 1 ); }
+    sym_set_change_count ( 1 );
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_menu_finalize );
+}
+
+#else
+
+/* conf_parse(), profiled as a single phase */
+static void lkconfig__conf_parse_phases ( const char* const kconfig_file ) {
+    struct lkconfig_prof_timer timer;
+
+    lkconfig_prof_timer_start ( &timer );
+    conf_parse ( kconfig_file );
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_parse );
+}
+#endif  /* LKCONFIG_LKC_BUNDLED */
+
+
 /**
  * Helper function.
  *
@@ -183,13 +666,43 @@ PyMODINIT_FUNC PyInit_lkconfig (void) {
  *
  * */
 static int lkconfig__conf_parse ( const char* const kconfig_file ) {
+    struct lkconfig_prof_timer timer;
+    int ret;
+
+    if ( lkconfig_active_context->have_symbols ) {
+        PyErr_SetString (
+            lkconfigKconfigParseError,
+            "symbols have already been read in this context"
+        );
+        return -1;
+    }
+
+    /* drop the (empty) dependency graph of the unparsed symbols */
+    lkconfig_ContextObject__free_depgraph ( lkconfig_active_context );
+
     /*
      * FIXME:
      * conf_parse() from zconf.tab.c calls exit(1) on errors;
      * could modify it to return non-zero int on error
      * */
-    conf_parse ( kconfig_file );
-    return 0;
+    Py_BEGIN_ALLOW_THREADS
+    /* the parsed objects go into the context's arena */
+    lkconfig_arena_enter ( &lkconfig_lkc_arena );
+    lkconfig_lkc_sym_init();
+    lkconfig__conf_parse_phases ( kconfig_file );
+    lkconfig_lkc_lexer_reset();
+    lkconfig_arena_leave();
+    Py_END_ALLOW_THREADS
+
+    lkconfig_active_context->have_symbols = 1;
+
+    lkconfig_prof_timer_start ( &timer );
+    ret = lkconfig_symindex_build ( &(lkconfig_active_context->symindex) );
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_symindex );
+
+    if ( ret == 0 ) { ret = lkconfig_prof_count_parse_results(); }
+
+    return ret;
 }
 
 
@@ -197,46 +710,250 @@ static PyObject* lkconfig_oldconfig (
     PyObject* self, PyObject* args, PyObject* kwargs
 ) {
     static const char* arg_kwlist[] = {
-        "infile", "outfile", "decisions", "logger", NULL
+        "infile", "outfile", "decisions", "logger", "record_changes",
+        "incremental", NULL
     };
 
     PyObject* logger              = NULL;
     PyDictObject* conf_decisions  = NULL;
     const char* infile            = NULL;
     const char* outfile           = NULL;
+    int record_changes            = 0;
+    int incremental               = 0;
+    PyObject* changes             = NULL;
     int ret;
 
     if (
         ! PyArg_ParseTupleAndKeywords (
-            args, kwargs, "ssO!|$O", (char**) arg_kwlist,
-            &infile, &outfile, &PyDict_Type, &conf_decisions, &logger
+            args, kwargs, "ssO!|$Opp", (char**) arg_kwlist,
+            &infile, &outfile, &PyDict_Type, &conf_decisions, &logger,
+            &record_changes, &incremental
         )
     ) {
         return NULL;
     }
 
-    ret = lkconfig_conf_main ( infile, outfile, conf_decisions, logger );
+    if ( logger == Py_None ) { logger = NULL; }
+
+    if ( record_changes ) {
+        changes = PyList_New(0);
+        if ( changes == NULL ) { return NULL; }
+    }
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) {
+        Py_XDECREF ( changes );
+        return NULL;
+    }
+    ret = lkconfig_conf_main (
+        infile, outfile, conf_decisions, logger, changes, incremental
+    );
+    lkconfig_lkc_lock_release();
+
     if ( ret < 0 ) {
+        Py_XDECREF ( changes );
         return NULL;
+    } else if ( changes != NULL ) {
+        return changes;
     } else {
         Py_RETURN_NONE;
     }
 }
 
 
+static PyObject* lkconfig_oldconfig_values (
+    PyObject* self, PyObject* args, PyObject* kwargs
+) {
+    static const char* arg_kwlist[] = {
+        "config_values", "decisions", "outfile", "logger", "record_changes",
+        "incremental", NULL
+    };
+
+    PyObject* logger              = NULL;
+    PyObject* config_values       = NULL;
+    PyDictObject* conf_decisions  = NULL;
+    const char* outfile           = NULL;
+    int record_changes            = 0;
+    int incremental               = 0;
+    PyObject* changes             = NULL;
+    PyObject* result;
+
+    if (
+        ! PyArg_ParseTupleAndKeywords (
+            args, kwargs, "OO!|$zOpp", (char**) arg_kwlist,
+            &config_values,
+            &PyDict_Type, &conf_decisions,
+            &outfile, &logger, &record_changes, &incremental
+        )
+    ) {
+        return NULL;
+    }
+
+    if ( ! (PyDict_Check ( config_values ) || PyList_Check ( config_values )) ) {
+        PyErr_SetString (
+            PyExc_TypeError, "config_values must be a dict or a list"
+        );
+        return NULL;
+    }
+
+    if ( logger == Py_None ) { logger = NULL; }
+
+    if ( record_changes ) {
+        changes = PyList_New(0);
+        if ( changes == NULL ) { return NULL; }
+    }
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) {
+        Py_XDECREF ( changes );
+        return NULL;
+    }
+    result = lkconfig_conf_main_values (
+        config_values, conf_decisions, outfile, logger, changes, incremental
+    );
+    lkconfig_lkc_lock_release();
+
+    if ( (result == NULL) || (changes == NULL) ) {
+        Py_XDECREF ( changes );
+        return result;
+    }
+
+    return Py_BuildValue ( "(NN)", result, changes );
+}
+
+
+static PyObject* lkconfig_oldconfig_batch (
+    PyObject* self, PyObject* args, PyObject* kwargs
+) {
+    static const char* arg_kwlist[] = {
+        "config", "decisions_list", "outfiles", "logger", "record_changes",
+        "incremental", NULL
+    };
+
+    PyObject* config              = NULL;
+    PyObject* decisions_list      = NULL;
+    PyObject* outfiles            = NULL;
+    PyObject* logger              = NULL;
+    int record_changes            = 0;
+    int incremental               = 0;
+    const char* infile            = NULL;
+    PyObject* config_values       = NULL;
+    PyObject* decisions_seq       = NULL;
+    PyObject* outfiles_seq        = NULL;
+    PyObject* item;
+    PyObject* result;
+    Py_ssize_t k;
+
+    if (
+        ! PyArg_ParseTupleAndKeywords (
+            args, kwargs, "OO|$OOpp", (char**) arg_kwlist,
+            &config, &decisions_list, &outfiles, &logger,
+            &record_changes, &incremental
+        )
+    ) {
+        return NULL;
+    }
+
+    if ( logger == Py_None ) { logger = NULL; }
+
+    if ( PyUnicode_Check ( config ) ) {
+        infile = PyUnicode_AsUTF8 ( config );
+        if ( infile == NULL ) { return NULL; }
+
+    } else if ( PyDict_Check ( config ) || PyList_Check ( config ) ) {
+        config_values = config;
+
+    } else {
+        PyErr_SetString (
+            PyExc_TypeError, "config must be a str, a dict or a list"
+        );
+        return NULL;
+    }
+
+    decisions_seq = PySequence_Fast (
+        decisions_list, "decisions_list must be a sequence"
+    );
+    if ( decisions_seq == NULL ) { return NULL; }
+
+    for ( k = 0; k < PySequence_Fast_GET_SIZE ( decisions_seq ); k++ ) {
+        item = PySequence_Fast_GET_ITEM ( decisions_seq, k );
+        if ( ! PyDict_Check ( item ) ) {
+            PyErr_SetString (
+                PyExc_TypeError, "decisions_list items must be dicts"
+            );
+            Py_DECREF ( decisions_seq );
+            return NULL;
+        }
+    }
+
+    if ( (outfiles != NULL) && (outfiles != Py_None) ) {
+        outfiles_seq = PySequence_Fast (
+            outfiles, "outfiles must be a sequence or None"
+        );
+        if ( outfiles_seq == NULL ) {
+            Py_DECREF ( decisions_seq );
+            return NULL;
+        }
+
+        if (
+            PySequence_Fast_GET_SIZE ( outfiles_seq )
+            != PySequence_Fast_GET_SIZE ( decisions_seq )
+        ) {
+            PyErr_SetString (
+                PyExc_ValueError,
+                "outfiles and decisions_list must have the same length"
+            );
+            Py_DECREF ( outfiles_seq );
+            Py_DECREF ( decisions_seq );
+            return NULL;
+        }
+
+        for ( k = 0; k < PySequence_Fast_GET_SIZE ( outfiles_seq ); k++ ) {
+            item = PySequence_Fast_GET_ITEM ( outfiles_seq, k );
+            if ( (item != Py_None) && ! PyUnicode_Check ( item ) ) {
+                PyErr_SetString (
+                    PyExc_TypeError, "outfiles items must be str or None"
+                );
+                Py_DECREF ( outfiles_seq );
+                Py_DECREF ( decisions_seq );
+                return NULL;
+            }
+        }
+    }
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) {
+        Py_XDECREF ( outfiles_seq );
+        Py_DECREF ( decisions_seq );
+        return NULL;
+    }
+    result = lkconfig_conf_main_batch (
+        infile, config_values, decisions_seq, outfiles_seq,
+        logger, record_changes, incremental
+    );
+    lkconfig_lkc_lock_release();
+
+    Py_XDECREF ( outfiles_seq );
+    Py_DECREF ( decisions_seq );
+    return result;
+}
+
+
 static PyObject* lkconfig_read_symbols ( PyObject* self, PyObject* args ) {
     const char* kconfig_file = NULL;
+    int ret;
 
     /* parse args */
     if ( ! PyArg_ParseTuple ( args, "s", &kconfig_file ) ) { return NULL; }
 
     /* read symbols */
-    if ( lkconfig__conf_parse ( kconfig_file ) != 0 ) { return NULL; }
+    if ( lkconfig_lkc_lock_acquire() != 0 ) { return NULL; }
+    ret = lkconfig__conf_parse ( kconfig_file );
+    lkconfig_lkc_lock_release();
+
+    if ( ret != 0 ) { return NULL; }
 
     Py_RETURN_NONE;
 }
 
-static PyObject* lkconfig_get_symbols ( PyObject* self, PyObject* noargs ) {
+static PyObject* lkconfig__get_symbols ( PyObject* self, PyObject* noargs ) {
     unsigned int i;
     const struct symbol* sym;
 
@@ -260,7 +977,9 @@ static PyObject* lkconfig_get_symbols ( PyObject* self, PyObject* noargs ) {
                 if (
                     lkconfig_list_append_steal_ref (
                         pysym_list,
-                        lkconfig_SymbolViewObject_new_from_struct ( sym )
+                        lkconfig_SymbolViewObject_new_from_struct (
+                            lkconfig_active_context, sym
+                        )
                     ) != 0
                 ) {
                     Py_DECREF ( pysym_list );
@@ -273,3 +992,383 @@ static PyObject* lkconfig_get_symbols ( PyObject* self, PyObject* noargs ) {
 
     return pysym_list;
 }
+
+static PyObject* lkconfig__get_kconfig_deps ( PyObject* self, PyObject* noargs ) {
+    /* see file_write_dep() in lkc's util.c */
+    const struct file* file;
+    struct expr* e;
+    struct symbol* sym;
+    struct symbol* env_sym;
+    PyObject* file_list_obj;
+    PyObject* env_list_obj;
+
+    file_list_obj = PyList_New(0);
+    if ( file_list_obj == NULL ) { return NULL; }
+
+    env_list_obj = PyList_New(0);
+    if ( env_list_obj == NULL ) {
+        Py_DECREF ( file_list_obj );
+        return NULL;
+    }
+
+    for ( file = file_list; file != NULL; file = file->next ) {
+        if (
+            lkconfig_list_append_steal_ref (
+                file_list_obj, PyUnicode_FromString ( file->name )
+            ) != 0
+        ) {
+            goto err;
+        }
+    }
+
+    expr_list_for_each_sym ( sym_env_list, e, sym ) {
+        env_sym = prop_get_symbol ( sym_get_env_prop ( sym ) );
+
+        if ( (env_sym != NULL) && (env_sym->name != NULL) ) {
+            if (
+                lkconfig_list_append_steal_ref (
+                    env_list_obj, PyUnicode_FromString ( env_sym->name )
+                ) != 0
+            ) {
+                goto err;
+            }
+        }
+    }
+
+    return Py_BuildValue ( "(NN)", file_list_obj, env_list_obj );
+
+err:
+    Py_DECREF ( file_list_obj );
+    Py_DECREF ( env_list_obj );
+    return NULL;
+}
+
+
+/**
+ * Helper function.
+ *
+ * Calls a METH_NOARGS/METH_VARARGS function while holding the lkc lock.
+ *
+ * @param func   function
+ * @param self   module
+ * @param args   args passed to func
+ *
+ * @return func's return value
+ * */
+static PyObject* lkconfig__call_locked (
+    PyCFunction func, PyObject* const self, PyObject* const args
+) {
+    PyObject* ret;
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) { return NULL; }
+    ret = func ( self, args );
+    lkconfig_lkc_lock_release();
+
+    return ret;
+}
+
+static PyObject* lkconfig_get_symbols ( PyObject* self, PyObject* noargs ) {
+    return lkconfig__call_locked ( lkconfig__get_symbols, self, noargs );
+}
+
+static PyObject* lkconfig_get_symbol_table ( PyObject* self, PyObject* noargs ) {
+    return lkconfig__call_locked ( lkconfig__get_symbol_table, self, noargs );
+}
+
+static PyObject* lkconfig_get_kconfig_deps ( PyObject* self, PyObject* noargs ) {
+    return lkconfig__call_locked ( lkconfig__get_kconfig_deps, self, noargs );
+}
+
+
+static PyObject* lkconfig__get_symbol_count ( PyObject* self, PyObject* noargs ) {
+    return PyLong_FromSize_t ( lkconfig_active_context->symindex.nsyms );
+}
+
+static PyObject* lkconfig__get_symbol_index ( PyObject* self, PyObject* args ) {
+    const char* name;
+    int idx;
+
+    if ( ! PyArg_ParseTuple ( args, "s", &name ) ) { return NULL; }
+
+    idx = lkconfig_symindex_find_name (
+        &(lkconfig_active_context->symindex), name
+    );
+    if ( idx < 0 ) { Py_RETURN_NONE; }
+
+    return PyLong_FromLong ( idx );
+}
+
+static PyObject* lkconfig__get_symbol_value ( PyObject* self, PyObject* args ) {
+    struct symbol* sym;
+    Py_ssize_t idx;
+
+    if ( ! PyArg_ParseTuple ( args, "n", &idx ) ) { return NULL; }
+
+    sym = lkconfig_symindex_get_active_symbol ( idx );
+    if ( sym == NULL ) { return NULL; }
+
+    lkconfig_prof_sym_calc_value ( sym );
+    return lkconfig_conf__get_value_object ( sym );
+}
+
+static PyObject* lkconfig__get_symbol_values (
+    PyObject* self, PyObject* noargs
+) {
+    const struct lkconfig_symindex* const symindex = (
+        &(lkconfig_active_context->symindex)
+    );
+    PyObject* values;
+    PyObject* value;
+    size_t k;
+
+    values = PyList_New ( (Py_ssize_t) symindex->nsyms );
+    if ( values == NULL ) { return NULL; }
+
+    for ( k = 0; k < symindex->nsyms; k++ ) {
+        lkconfig_prof_sym_calc_value ( symindex->syms [k] );
+
+        value = lkconfig_conf__get_value_object ( symindex->syms [k] );
+        if ( value == NULL ) {
+            Py_DECREF ( values );
+            return NULL;
+        }
+        PyList_SET_ITEM ( values, (Py_ssize_t) k, value );  /* steal ref */
+    }
+
+    return values;
+}
+
+static PyObject* lkconfig__set_symbol_value ( PyObject* self, PyObject* args ) {
+    struct symbol* sym;
+    PyObject* value;
+    PyObject* str_obj;
+    const char* strval;
+    Py_ssize_t idx;
+    long tval;
+    bool ret;
+
+    if ( ! PyArg_ParseTuple ( args, "nO", &idx, &value ) ) { return NULL; }
+
+    sym = lkconfig_symindex_get_active_symbol ( idx );
+    if ( sym == NULL ) { return NULL; }
+
+    /* sym_set_*_value() compare against the current value */
+    lkconfig_prof_sym_calc_value ( sym );
+
+    switch ( sym->type ) {
+        case S_BOOLEAN:
+        case S_TRISTATE:
+            tval = 0;
+            if ( value != Py_None ) {
+                tval = PyLong_AsLong ( value );
+                if ( (tval == -1) && PyErr_Occurred() ) { return NULL; }
+            }
+
+            if ( (tval < no) || (tval > yes) ) {
+                PyErr_Format (
+                    PyExc_ValueError,
+                    "bad value for tristate symbol %s", sym->name
+                );
+                return NULL;
+            }
+
+            ret = sym_set_tristate_value ( sym, (tristate) tval );
+            break;
+
+        case S_INT:
+        case S_HEX:
+        case S_STRING:
+            str_obj = lkconfig_conf__get_string_value_object ( sym, value );
+            if ( str_obj == NULL ) { return NULL; }
+
+            strval = PyUnicode_AsUTF8 ( str_obj );
+            ret = (strval != NULL) && sym_set_string_value ( sym, strval );
+            Py_DECREF ( str_obj );
+            if ( PyErr_Occurred() ) { return NULL; }
+            break;
+
+        default:
+            PyErr_Format (
+                PyExc_TypeError, "cannot set value of symbol %s", sym->name
+            );
+            return NULL;
+    }
+
+    return PyBool_FromLong ( ret );
+}
+
+static PyObject* lkconfig_get_symbol_count ( PyObject* self, PyObject* noargs ) {
+    return lkconfig__call_locked ( lkconfig__get_symbol_count, self, noargs );
+}
+
+static PyObject* lkconfig_get_symbol_index ( PyObject* self, PyObject* args ) {
+    return lkconfig__call_locked ( lkconfig__get_symbol_index, self, args );
+}
+
+static PyObject* lkconfig_get_symbol_value ( PyObject* self, PyObject* args ) {
+    return lkconfig__call_locked ( lkconfig__get_symbol_value, self, args );
+}
+
+static PyObject* lkconfig_get_symbol_values ( PyObject* self, PyObject* noargs ) {
+    return lkconfig__call_locked ( lkconfig__get_symbol_values, self, noargs );
+}
+
+static PyObject* lkconfig_set_symbol_value ( PyObject* self, PyObject* args ) {
+    return lkconfig__call_locked ( lkconfig__set_symbol_value, self, args );
+}
+
+
+static PyObject* lkconfig_get_context ( PyObject* self, PyObject* noargs ) {
+    Py_INCREF ( lkconfig_active_context );
+    return (PyObject*) lkconfig_active_context;
+}
+
+static PyObject* lkconfig_switch_context ( PyObject* self, PyObject* args ) {
+    lkconfig_ContextObject* ctx = NULL;
+    lkconfig_ContextObject* prev_ctx;
+
+    if ( ! PyArg_ParseTuple ( args, "O!", &lkconfig_ContextType, &ctx ) ) {
+        return NULL;
+    }
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) { return NULL; }
+    prev_ctx = lkconfig_context_activate ( ctx );
+    lkconfig_lkc_lock_release();
+
+    return (PyObject*) prev_ctx;
+}
+
+
+static PyObject* lkconfig_write_defconfig ( PyObject* self, PyObject* args ) {
+    const char* outfile;
+    int ret;
+
+    if ( ! PyArg_ParseTuple ( args, "s", &outfile ) ) { return NULL; }
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) { return NULL; }
+    ret = lkconfig_conf__write_defconfig_file ( outfile );
+    lkconfig_lkc_lock_release();
+
+    if ( ret != 0 ) {
+        PyErr_Format (
+            PyExc_OSError, "failed to write defconfig file %s", outfile
+        );
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* lkconfig__get_defconfig_values (
+    PyObject* self, PyObject* noargs
+) {
+    return lkconfig_conf__get_defconfig_values();
+}
+
+static PyObject* lkconfig_get_defconfig_values (
+    PyObject* self, PyObject* noargs
+) {
+    return lkconfig__call_locked (
+        lkconfig__get_defconfig_values, self, noargs
+    );
+}
+
+
+static PyObject* lkconfig_write_autoconf (
+    PyObject* self, PyObject* args, PyObject* kwargs
+) {
+    static const char* arg_kwlist[] = { "outdir", "config_file", NULL };
+
+    const char* outdir      = NULL;
+    const char* config_file = NULL;
+    struct lkconfig_autoconf ac;
+    struct lkconfig_prof_timer timer;
+    PyObject* result;
+    int ret;
+
+    if (
+        ! PyArg_ParseTupleAndKeywords (
+            args, kwargs, "s|$z", (char**) arg_kwlist, &outdir, &config_file
+        )
+    ) {
+        return NULL;
+    }
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) { return NULL; }
+
+    if (
+        (config_file != NULL)
+        && (lkconfig_conf__write_file ( config_file ) != 0)
+    ) {
+        lkconfig_lkc_lock_release();
+        PyErr_Format (
+            PyExc_OSError, "failed to write config file %s", config_file
+        );
+        return NULL;
+    }
+
+    lkconfig_autoconf_init ( &ac, outdir );
+
+    Py_BEGIN_ALLOW_THREADS
+    lkconfig_prof_timer_start ( &timer );
+    ret = lkconfig_autoconf_write (
+        &ac, &(lkconfig_active_context->symindex)
+    );
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_conf_write );
+    Py_END_ALLOW_THREADS
+
+    lkconfig_lkc_lock_release();
+
+    if ( ret != 0 ) {
+        if ( ac.errpath [0] != '\0' ) {
+            PyErr_SetFromErrnoWithFilename ( PyExc_OSError, ac.errpath );
+        } else {
+            PyErr_SetFromErrno ( PyExc_OSError );
+        }
+        result = NULL;
+    } else {
+        result = PyLong_FromSize_t ( ac.split_touched );
+    }
+
+    lkconfig_autoconf_free ( &ac );
+    return result;
+}
+
+
+static PyObject* lkconfig_read_config_file ( PyObject* self, PyObject* args ) {
+    const char* filename;
+
+    if ( ! PyArg_ParseTuple ( args, "s", &filename ) ) { return NULL; }
+
+    return lkconfig_confread_read_entries ( filename );
+}
+
+
+static PyObject* lkconfig_set_profiling ( PyObject* self, PyObject* args ) {
+    int enabled;
+    int prev_enabled;
+
+    if ( ! PyArg_ParseTuple ( args, "p", &enabled ) ) { return NULL; }
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) { return NULL; }
+    prev_enabled = lkconfig_prof_enabled;
+    lkconfig_prof_enabled = enabled;
+    lkconfig_lkc_lock_release();
+
+    return PyBool_FromLong ( prev_enabled );
+}
+
+
+static PyObject* lkconfig_get_profile ( PyObject* self, PyObject* args ) {
+    int reset = 0;
+    PyObject* profile;
+
+    if ( ! PyArg_ParseTuple ( args, "|p", &reset ) ) { return NULL; }
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) { return NULL; }
+    profile = lkconfig_prof_get_dict();
+    if ( (profile != NULL) && reset ) { lkconfig_prof_reset(); }
+    lkconfig_lkc_lock_release();
+
+    return profile;
+}
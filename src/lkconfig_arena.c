@@ -0,0 +1,370 @@
+/*
+ * Arena allocator for the objects created by lkc's parser.
+ *
+ * lkc allocates each symbol, property, expression, menu and string
+ * separately with malloc() and friends, and never frees them.
+ * While conf_parse() runs, these allocations are served from the
+ * active context's arena instead, which is a list of large chunks
+ * that get filled sequentially, and the whole graph is freed at once
+ * when the context's state is freed, see lkconfig_lkc_state_free().
+ *
+ * lkc's sources are not modified, instead the module is linked with
+ * --wrap=malloc,calloc,realloc,free,strdup (see setup.py),
+ * which redirects the calls from lkconfig.c and zconf.tab.c
+ * to the __wrap_*() functions below.
+ * Outside of conf_parse(), or in threads other than the parsing one,
+ * these simply pass through to the libc functions.
+ *
+ * All chunks are carved from a single reserved address range,
+ * so that free() can tell arena memory from malloc() memory
+ * with a range check. Freeing arena memory is a no-op,
+ * and realloc() copies it to a new allocation.
+ * Allocations that do not fit into a chunk, and all allocations
+ * if the address range could not be reserved, are passed to malloc().
+ *
+ * Without LKCONFIG_ARENA, the arena is never used.
+ *
+ * */
+
+#ifdef LKCONFIG_ARENA
+#include <sys/mman.h>   /* mmap(), madvise() */
+#endif
+
+
+/* chunk size, also the alignment of chunks */
+#define LKCONFIG_ARENA_CHUNK_SIZE  ((size_t) 1 << 20)
+
+/* max. size of an allocation served by the arena */
+#define LKCONFIG_ARENA_MAX_ALLOC  (LKCONFIG_ARENA_CHUNK_SIZE / 8)
+
+/*
+ * each allocation is preceded by a header that stores its size,
+ * the header size keeps allocations aligned to max_align_t
+ * */
+#define LKCONFIG_ARENA_ALIGN  ((size_t) 16)
+#define LKCONFIG_ARENA_HDR    LKCONFIG_ARENA_ALIGN
+
+
+/* the active context's arena, moved along with lkc's globals */
+static struct lkconfig_arena lkconfig_lkc_arena;
+
+/*
+ * the arena that serves allocations, and the thread it serves,
+ * see lkconfig_arena_enter()
+ * */
+static struct lkconfig_arena* lkconfig_arena_current = NULL;
+static unsigned long lkconfig_arena_owner = 0;
+
+/*
+ * reserved address range and its chunk free list,
+ * modified while holding lkconfig_arena_lock
+ * */
+static char*  lkconfig_arena_region_base = NULL;
+static size_t lkconfig_arena_region_size = 0;
+static size_t lkconfig_arena_region_used = 0;
+static void*  lkconfig_arena_free_chunks = NULL;
+static PyThread_type_lock lkconfig_arena_lock = NULL;
+
+
+#ifdef LKCONFIG_ARENA
+void* __real_malloc ( size_t size );
+void* __real_calloc ( size_t nmemb, size_t size );
+void* __real_realloc ( void* ptr, size_t size );
+void  __real_free ( void* ptr );
+
+void* __wrap_malloc ( size_t size );
+void* __wrap_calloc ( size_t nmemb, size_t size );
+void* __wrap_realloc ( void* ptr, size_t size );
+void  __wrap_free ( void* ptr );
+char* __wrap_strdup ( const char* s );
+#endif
+
+
+static void lkconfig_arena_init ( struct lkconfig_arena* const arena ) {
+    memset ( arena, 0, sizeof *arena );
+}
+
+
+/**
+ * Returns whether ptr points to arena memory (of any arena).
+ * */
+static int lkconfig_arena_contains ( const void* const ptr ) {
+#ifdef LKCONFIG_ARENA
+    /* the region base is set before the size, see reserve_region() */
+    const size_t size = __atomic_load_n (
+        &lkconfig_arena_region_size, __ATOMIC_ACQUIRE
+    );
+
+    return (
+        ((uintptr_t) ptr - (uintptr_t) lkconfig_arena_region_base) < size
+    );
+#else
+    return 0;
+#endif
+}
+
+
+/**
+ * Creates the arena lock. Must be called once during module init.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_arena_module_init (void) {
+    if ( lkconfig_arena_lock == NULL ) {
+        lkconfig_arena_lock = PyThread_allocate_lock();
+        if ( lkconfig_arena_lock == NULL ) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+#ifdef LKCONFIG_ARENA
+/**
+ * Reserves the address range, tries smaller sizes on failure.
+ * Must be called with the arena lock held.
+ *
+ * @return 0 on success, else non-zero
+ * */
+static int lkconfig_arena__reserve_region (void) {
+    size_t size;
+    void* base;
+
+    if ( lkconfig_arena_region_base != NULL ) { return 0; }
+
+    /* reserving address space does not commit memory */
+    for (
+        size = ((size_t) 1 << ((sizeof (size_t) > 4) ? 36 : 28));
+        size >= 16 * LKCONFIG_ARENA_CHUNK_SIZE;
+        size >>= 2
+    ) {
+        base = mmap (
+            NULL, size + LKCONFIG_ARENA_CHUNK_SIZE, PROT_NONE,
+            (MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE), -1, 0
+        );
+
+        if ( base != MAP_FAILED ) {
+            /* align to the chunk size, the surplus stays reserved */
+            lkconfig_arena_region_base = (char*) (
+                ((uintptr_t) base + LKCONFIG_ARENA_CHUNK_SIZE - 1)
+                & ~((uintptr_t) LKCONFIG_ARENA_CHUNK_SIZE - 1)
+            );
+            __atomic_store_n (
+                &lkconfig_arena_region_size, size, __ATOMIC_RELEASE
+            );
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+
+/**
+ * Gets a chunk from the free list or from the reserved address range.
+ *
+ * @return chunk or NULL
+ * */
+static void* lkconfig_arena__get_chunk (void) {
+    void* chunk;
+
+    chunk = NULL;
+    PyThread_acquire_lock ( lkconfig_arena_lock, WAIT_LOCK );
+
+    if ( lkconfig_arena_free_chunks != NULL ) {
+        chunk = lkconfig_arena_free_chunks;
+        lkconfig_arena_free_chunks = *((void**) chunk);
+
+    } else if (
+        (lkconfig_arena__reserve_region() == 0)
+        && (
+            (lkconfig_arena_region_size - lkconfig_arena_region_used)
+            >= LKCONFIG_ARENA_CHUNK_SIZE
+        )
+    ) {
+        chunk = lkconfig_arena_region_base + lkconfig_arena_region_used;
+
+        if (
+            mprotect (
+                chunk, LKCONFIG_ARENA_CHUNK_SIZE, (PROT_READ | PROT_WRITE)
+            ) == 0
+        ) {
+            lkconfig_arena_region_used += LKCONFIG_ARENA_CHUNK_SIZE;
+        } else {
+            chunk = NULL;
+        }
+    }
+
+    PyThread_release_lock ( lkconfig_arena_lock );
+    return chunk;
+}
+
+
+/**
+ * Allocates size bytes from the current arena.
+ *
+ * @return pointer to uninitialized memory or NULL
+ * */
+static void* lkconfig_arena__alloc ( size_t size ) {
+    struct lkconfig_arena* const arena = lkconfig_arena_current;
+    void* chunk;
+    char* ptr;
+    size_t need;
+
+    if ( size > LKCONFIG_ARENA_MAX_ALLOC ) { return NULL; }
+
+    need = LKCONFIG_ARENA_HDR + (
+        (size + LKCONFIG_ARENA_ALIGN - 1) & ~(LKCONFIG_ARENA_ALIGN - 1)
+    );
+
+    if ( (size_t) (arena->end - arena->pos) < need ) {
+        chunk = lkconfig_arena__get_chunk();
+        if ( chunk == NULL ) { return NULL; }
+
+        /* the first word links the chunks of the arena */
+        *((void**) chunk) = arena->chunks;
+        arena->chunks = chunk;
+        (arena->nchunks)++;
+
+        arena->pos = (char*) chunk + LKCONFIG_ARENA_HDR;
+        arena->end = (char*) chunk + LKCONFIG_ARENA_CHUNK_SIZE;
+    }
+
+    ptr = arena->pos;
+    arena->pos += need;
+
+    *((size_t*) ptr) = size;
+    return ptr + LKCONFIG_ARENA_HDR;
+}
+
+
+/* whether allocations of the current thread are served by the arena */
+static int lkconfig_arena__in_use (void) {
+    return (
+        (lkconfig_arena_current != NULL)
+        && (lkconfig_arena_owner == PyThread_get_thread_ident())
+    );
+}
+
+
+void* __wrap_malloc ( size_t size ) {
+    void* ptr;
+
+    if ( lkconfig_arena__in_use() ) {
+        ptr = lkconfig_arena__alloc ( size );
+        if ( ptr != NULL ) { return ptr; }
+    }
+
+    return __real_malloc ( size );
+}
+
+
+void* __wrap_calloc ( size_t nmemb, size_t size ) {
+    void* ptr;
+
+    if (
+        lkconfig_arena__in_use()
+        && ((size == 0) || (nmemb <= (LKCONFIG_ARENA_MAX_ALLOC / size)))
+    ) {
+        ptr = lkconfig_arena__alloc ( nmemb * size );
+        if ( ptr != NULL ) {
+            memset ( ptr, 0, nmemb * size );
+            return ptr;
+        }
+    }
+
+    return __real_calloc ( nmemb, size );
+}
+
+
+void* __wrap_realloc ( void* ptr, size_t size ) {
+    void* new_ptr;
+    size_t old_size;
+
+    if ( ! lkconfig_arena_contains ( ptr ) ) {
+        if ( ptr == NULL ) { return __wrap_malloc ( size ); }
+        return __real_realloc ( ptr, size );
+    }
+
+    old_size = *((const size_t*) ((const char*) ptr - LKCONFIG_ARENA_HDR));
+    if ( size <= old_size ) { return ptr; }
+
+    new_ptr = __wrap_malloc ( size );
+    if ( new_ptr != NULL ) { memcpy ( new_ptr, ptr, old_size ); }
+    return new_ptr;
+}
+
+
+void __wrap_free ( void* ptr ) {
+    /* arena memory is freed along with its arena */
+    if ( ! lkconfig_arena_contains ( ptr ) ) { __real_free ( ptr ); }
+}
+
+
+char* __wrap_strdup ( const char* const s ) {
+    size_t size;
+    char* ptr;
+
+    size = strlen ( s ) + 1;
+    ptr = __wrap_malloc ( size );
+    if ( ptr != NULL ) { memcpy ( ptr, s, size ); }
+    return ptr;
+}
+#endif  /* LKCONFIG_ARENA */
+
+
+/**
+ * Makes arena serve the allocations of the current thread,
+ * until lkconfig_arena_leave() gets called.
+ * Must be called with the lkc lock held.
+ *
+ * @param arena  arena
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_arena_enter ( struct lkconfig_arena* const arena ) {
+#ifdef LKCONFIG_ARENA
+    lkconfig_arena_owner   = PyThread_get_thread_ident();
+    lkconfig_arena_current = arena;
+#endif
+}
+
+
+static void lkconfig_arena_leave (void) {
+    lkconfig_arena_current = NULL;
+    lkconfig_arena_owner   = 0;
+}
+
+
+/**
+ * Frees all memory of an arena and clears it.
+ * Chunks are given back to the system, but stay reserved for reuse.
+ *
+ * @param arena  arena, must not be in use
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_arena_free ( struct lkconfig_arena* const arena ) {
+#ifdef LKCONFIG_ARENA
+    void* chunk;
+    void* next;
+
+    if ( arena->chunks != NULL ) {
+        PyThread_acquire_lock ( lkconfig_arena_lock, WAIT_LOCK );
+
+        for ( chunk = arena->chunks; chunk != NULL; chunk = next ) {
+            next = *((void**) chunk);
+
+            madvise ( chunk, LKCONFIG_ARENA_CHUNK_SIZE, MADV_DONTNEED );
+            *((void**) chunk) = lkconfig_arena_free_chunks;
+            lkconfig_arena_free_chunks = chunk;
+        }
+
+        PyThread_release_lock ( lkconfig_arena_lock );
+    }
+#endif
+
+    lkconfig_arena_init ( arena );
+}
@@ -0,0 +1,830 @@
+/*
+ * Native "make silentoldconfig" output, see lkconfig_autoconf_write().
+ *
+ * Writes the files that kbuild expects in the output directory
+ * after configuring:
+ *
+ *   include/config/auto.conf      -- set symbols, in .config format
+ *   include/config/auto.conf.cmd  -- make dependencies of auto.conf
+ *   include/config/tristate.conf  -- set tristate symbols, uppercase
+ *   include/generated/autoconf.h  -- one #define per set symbol
+ *   include/config/<sym>.h        -- split config files
+ *
+ * in the same format as lkc's conf_write_autoconf(),
+ * but relative to the output directory instead of the working directory.
+ * (The KCONFIG_AUTOCONFIG, KCONFIG_AUTOHEADER and KCONFIG_TRISTATE
+ * environment variables are respected.)
+ *
+ * The split config files are empty, only their mtime matters:
+ * fixdep makes each object depend on the files of the symbols it uses.
+ * Like conf_split_config(), only the files of symbols whose value differs
+ * from the previous auto.conf are touched.  Additionally, the generated
+ * files other than auto.conf are only replaced if their content changes.
+ * auto.conf is always written, and last, since it marks the successful
+ * completion of the other steps for kbuild.
+ *
+ * The functions do not involve python objects
+ * and may be called without holding the GIL (but with the lkc lock held).
+ * */
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/**
+ * A growable char buffer for the content of generated files.
+ * */
+struct lkconfig_autoconf_buf {
+    char*  data;
+    size_t len;
+    size_t cap;
+};
+
+/**
+ * Previous value of a symbol, span of the mapped old auto.conf.
+ * */
+struct lkconfig_autoconf_oldval {
+    const char* value;
+    size_t      value_len;
+};
+
+/**
+ * State of lkconfig_autoconf_write().
+ * */
+struct lkconfig_autoconf {
+    const char* outdir;
+
+    /* previous auto.conf, mapped */
+    struct lkconfig_confread old_autoconf;
+    /* symbol index => previous value (value NULL if unset) */
+    struct lkconfig_autoconf_oldval* oldvals;
+
+    struct lkconfig_autoconf_buf auto_conf;
+    struct lkconfig_autoconf_buf auto_conf_cmd;
+    struct lkconfig_autoconf_buf tristate_conf;
+    struct lkconfig_autoconf_buf autoconf_h;
+
+    /* scratch buffer for file paths */
+    struct lkconfig_autoconf_buf path;
+
+    /* number of split config files that have been touched */
+    size_t split_touched;
+
+    /* path of the file whose creation failed, for error reporting */
+    char errpath[PATH_MAX+1];
+};
+
+
+static void lkconfig_autoconf_buf_init (
+    struct lkconfig_autoconf_buf* const buf
+) {
+    buf->data = NULL;
+    buf->len  = 0;
+    buf->cap  = 0;
+}
+
+static void lkconfig_autoconf_buf_free (
+    struct lkconfig_autoconf_buf* const buf
+) {
+    PyMem_RawFree ( buf->data );
+    lkconfig_autoconf_buf_init ( buf );
+}
+
+/**
+ * Makes room for at least len more chars and a terminating NUL char.
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_autoconf_buf_reserve (
+    struct lkconfig_autoconf_buf* const buf, const size_t len
+) {
+    char* new_data;
+    size_t new_cap;
+
+    if ( (buf->len + len) < buf->cap ) { return 0; }
+
+    new_cap = (buf->cap == 0) ? 4096 : buf->cap;
+    while ( new_cap <= (buf->len + len) ) { new_cap *= 2; }
+
+    new_data = PyMem_RawRealloc ( buf->data, new_cap );
+    if ( new_data == NULL ) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    buf->data = new_data;
+    buf->cap  = new_cap;
+    return 0;
+}
+
+static int lkconfig_autoconf_buf_append (
+    struct lkconfig_autoconf_buf* const buf,
+    const char* const s, const size_t len
+) {
+    if ( lkconfig_autoconf_buf_reserve ( buf, len ) != 0 ) { return -1; }
+
+    memcpy ( (buf->data + buf->len), s, len );
+    buf->len += len;
+    buf->data [buf->len] = '\0';
+    return 0;
+}
+
+__attribute__((format (printf, 2, 3)))
+static int lkconfig_autoconf_buf_appendf (
+    struct lkconfig_autoconf_buf* const buf, const char* const format, ...
+) {
+    va_list vargs;
+    int len;
+
+    va_start ( vargs, format );
+    len = vsnprintf ( NULL, 0, format, vargs );
+    va_end ( vargs );
+
+    if ( len < 0 ) { return -1; }
+    if ( lkconfig_autoconf_buf_reserve ( buf, (size_t) len ) != 0 ) {
+        return -1;
+    }
+
+    va_start ( vargs, format );
+    vsnprintf ( (buf->data + buf->len), (size_t) len + 1, format, vargs );
+    va_end ( vargs );
+
+    buf->len += (size_t) len;
+    return 0;
+}
+
+
+static void lkconfig_autoconf_init (
+    struct lkconfig_autoconf* const ac, const char* const outdir
+) {
+    ac->outdir  = outdir;
+    lkconfig_confread_init ( &(ac->old_autoconf) );
+    ac->oldvals = NULL;
+
+    lkconfig_autoconf_buf_init ( &(ac->auto_conf) );
+    lkconfig_autoconf_buf_init ( &(ac->auto_conf_cmd) );
+    lkconfig_autoconf_buf_init ( &(ac->tristate_conf) );
+    lkconfig_autoconf_buf_init ( &(ac->autoconf_h) );
+    lkconfig_autoconf_buf_init ( &(ac->path) );
+
+    ac->split_touched = 0;
+    ac->errpath [0]   = '\0';
+}
+
+static void lkconfig_autoconf_free ( struct lkconfig_autoconf* const ac ) {
+    lkconfig_confread_close ( &(ac->old_autoconf) );
+    PyMem_RawFree ( ac->oldvals );
+    ac->oldvals = NULL;
+
+    lkconfig_autoconf_buf_free ( &(ac->auto_conf) );
+    lkconfig_autoconf_buf_free ( &(ac->auto_conf_cmd) );
+    lkconfig_autoconf_buf_free ( &(ac->tristate_conf) );
+    lkconfig_autoconf_buf_free ( &(ac->autoconf_h) );
+    lkconfig_autoconf_buf_free ( &(ac->path) );
+}
+
+
+/**
+ * Remembers a path for error reporting.
+ *
+ * @return -1
+ * */
+static int lkconfig_autoconf__fail (
+    struct lkconfig_autoconf* const ac, const char* const path
+) {
+    snprintf ( ac->errpath, sizeof ac->errpath, "%s", path );
+    return -1;
+}
+
+
+/**
+ * Sets the path buffer to <outdir>/<relpath>, or to relpath if absolute.
+ *
+ * @return path, NULL on error (errno set)
+ * */
+static const char* lkconfig_autoconf__get_path (
+    struct lkconfig_autoconf* const ac, const char* const relpath
+) {
+    struct lkconfig_autoconf_buf* const path = &(ac->path);
+
+    path->len = 0;
+    if ( relpath[0] != '/' ) {
+        if (
+            lkconfig_autoconf_buf_appendf ( path, "%s/", ac->outdir ) != 0
+        ) {
+            return NULL;
+        }
+    }
+
+    if (
+        lkconfig_autoconf_buf_append ( path, relpath, strlen ( relpath ) )
+        != 0
+    ) {
+        return NULL;
+    }
+
+    return path->data;
+}
+
+
+/**
+ * Gets the name of a generated file from the environment,
+ * like conf_write_autoconf() does.
+ * */
+static const char* lkconfig_autoconf__getenv_name (
+    const char* const varname, const char* const fallback
+) {
+    const char* name;
+
+    name = getenv ( varname );
+    return ( (name != NULL) && (*name != '\0') ) ? name : fallback;
+}
+
+
+/**
+ * Creates the missing parent directories of a file path.
+ *
+ * @param path  file path, temporarily modified
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_autoconf__mkdir_parents ( char* const path ) {
+    struct stat stat_info;
+    char* d;
+
+    for ( d = strchr ( (path + 1), '/' ); d != NULL; d = strchr ( d, '/' ) ) {
+        *d = '\0';
+        if (
+            (stat ( path, &stat_info ) != 0)
+            && (mkdir ( path, 0755 ) != 0)
+            && (errno != EEXIST)
+        ) {
+            *d = '/';
+            return -1;
+        }
+        *d++ = '/';
+    }
+
+    return 0;
+}
+
+
+/**
+ * Reads the symbol values of the previous auto.conf, if any.
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_autoconf__read_old (
+    struct lkconfig_autoconf* const ac,
+    const struct lkconfig_symindex* const sidx
+) {
+    struct lkconfig_confread_line tok;
+    struct lkconfig_conf_strbuf sbuf;
+    const char* const prefix = CONFIG_;
+    const size_t prefix_len  = strlen ( prefix );
+    const char* path;
+    const char* name;
+    int idx;
+
+    ac->oldvals = PyMem_RawCalloc (
+        ((sidx->nsyms > 0) ? sidx->nsyms : 1), sizeof *(ac->oldvals)
+    );
+    if ( ac->oldvals == NULL ) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    path = lkconfig_autoconf__get_path ( ac, conf_get_autoconfig_name() );
+    if ( path == NULL ) { return -1; }
+
+    if ( lkconfig_confread_open ( &(ac->old_autoconf), path ) != 0 ) {
+        /* no previous auto.conf, touch all split config files */
+        return ( errno == ENOENT ) ? 0 : lkconfig_autoconf__fail ( ac, path );
+    }
+
+    sbuf.data = NULL;
+    sbuf.cap  = 0;
+
+    while ( lkconfig_confread_next ( &(ac->old_autoconf), &tok ) ) {
+        if (
+            (tok.kind != LKCONFIG_CONFREAD_VALUE)
+            || (tok.name_len <= prefix_len)
+            || (strncmp ( tok.name, prefix, prefix_len ) != 0)
+        ) {
+            continue;
+        }
+
+        name = lkconfig_conf_strbuf_set (
+            &sbuf, (tok.name + prefix_len), (tok.name_len - prefix_len)
+        );
+        if ( name == NULL ) {
+            PyMem_RawFree ( sbuf.data );
+            errno = ENOMEM;
+            return -1;
+        }
+
+        idx = lkconfig_symindex_find_name ( sidx, name );
+        if ( idx >= 0 ) {
+            ac->oldvals [idx].value     = tok.value;
+            ac->oldvals [idx].value_len = tok.value_len;
+        }
+    }
+
+    PyMem_RawFree ( sbuf.data );
+    return 0;
+}
+
+
+/**
+ * Appends the "Automatically generated file" heading to a buffer,
+ * as "#" comment or as C comment.
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_autoconf__append_heading (
+    struct lkconfig_autoconf_buf* const buf, const int c_comment
+) {
+    const char* const title = (
+        ( (rootmenu.prompt != NULL) && (rootmenu.prompt->text != NULL) )
+        ? rootmenu.prompt->text : ""
+    );
+    const char* const line_prefix = c_comment ? " *" : "#";
+
+    if ( c_comment && (lkconfig_autoconf_buf_appendf ( buf, "/*\n" ) != 0) ) {
+        return -1;
+    }
+
+    if (
+        lkconfig_autoconf_buf_appendf (
+            buf,
+            "%s\n"
+            "%s Automatically generated file; DO NOT EDIT.\n"
+            "%s %s\n"
+            "%s\n",
+            line_prefix, line_prefix, line_prefix, title, line_prefix
+        ) != 0
+    ) {
+        return -1;
+    }
+
+    if ( c_comment && (lkconfig_autoconf_buf_appendf ( buf, " */\n" ) != 0) ) {
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Appends a symbol to auto.conf, tristate.conf and autoconf.h.
+ *
+ * @param ac     autoconf state
+ * @param sym    symbol
+ * @param value  value as written to auto.conf, NULL if not set
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_autoconf__append_symbol (
+    struct lkconfig_autoconf* const ac,
+    const struct symbol* const sym, const char* const value
+) {
+    const char* const prefix = CONFIG_;
+    const char* hex_prefix;
+
+    if ( value == NULL ) { return 0; }
+
+    if (
+        lkconfig_autoconf_buf_appendf (
+            &(ac->auto_conf), "%s%s=%s\n", prefix, sym->name, value
+        ) != 0
+    ) {
+        return -1;
+    }
+
+    switch ( sym->type ) {
+        case S_TRISTATE:
+            if (
+                lkconfig_autoconf_buf_appendf (
+                    &(ac->tristate_conf), "%s%s=%c\n",
+                    prefix, sym->name, (char) toupper ( *value )
+                ) != 0
+            ) {
+                return -1;
+            }
+            /* fall through */
+
+        case S_BOOLEAN:
+            return lkconfig_autoconf_buf_appendf (
+                &(ac->autoconf_h), "#define %s%s%s 1\n",
+                prefix, sym->name, ((*value == 'm') ? "_MODULE" : "")
+            );
+
+        case S_HEX:
+            hex_prefix = (
+                (value[0] == '0') && ((value[1] == 'x') || (value[1] == 'X'))
+            ) ? "" : "0x";
+            return lkconfig_autoconf_buf_appendf (
+                &(ac->autoconf_h), "#define %s%s %s%s\n",
+                prefix, sym->name, hex_prefix, value
+            );
+
+        case S_STRING:
+        case S_INT:
+            return lkconfig_autoconf_buf_appendf (
+                &(ac->autoconf_h), "#define %s%s %s\n",
+                prefix, sym->name, value
+            );
+
+        default:
+            return 0;
+    }
+}
+
+
+/**
+ * Touches the split config file of a symbol,
+ * creating its directory if necessary.
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_autoconf__touch_split_file (
+    struct lkconfig_autoconf* const ac, const struct symbol* const sym
+) {
+    struct lkconfig_autoconf_buf* const path = &(ac->path);
+    size_t name_start;
+    size_t k;
+    char c;
+    int fd;
+
+    path->len = 0;
+    if (
+        lkconfig_autoconf_buf_appendf (
+            path, "%s/include/config/", ac->outdir
+        ) != 0
+    ) {
+        return -1;
+    }
+
+    /* "<sym name, lowercase, '_' replaced by '/'>.h" */
+    name_start = path->len;
+    if (
+        lkconfig_autoconf_buf_appendf ( path, "%s.h", sym->name ) != 0
+    ) {
+        return -1;
+    }
+    for ( k = name_start; k < (path->len - 2); k++ ) {
+        c = (char) tolower ( path->data [k] );
+        path->data [k] = (c == '_') ? '/' : c;
+    }
+
+    fd = open (
+        path->data, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644
+    );
+    if ( (fd < 0) && (errno == ENOENT) ) {
+        if ( lkconfig_autoconf__mkdir_parents ( path->data ) != 0 ) {
+            return lkconfig_autoconf__fail ( ac, path->data );
+        }
+        fd = open (
+            path->data, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644
+        );
+    }
+
+    if ( fd < 0 ) { return lkconfig_autoconf__fail ( ac, path->data ); }
+
+    /* O_TRUNC does not update the mtime of files that are already empty */
+    futimens ( fd, NULL );
+    close ( fd );
+
+    (ac->split_touched)++;
+    return 0;
+}
+
+
+/**
+ * Computes the auto.conf values of all symbols, fills the output buffers
+ * and touches the split config files of changed symbols.
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_autoconf__process_symbols (
+    struct lkconfig_autoconf* const ac,
+    const struct lkconfig_symindex* const sidx
+) {
+    struct symbol* sym;
+    const char* value;
+    const char* escaped;
+    const struct lkconfig_autoconf_oldval* oldval;
+    int changed;
+    int idx;
+    int i;
+    int ret;
+
+    ret = 0;
+    for_all_symbols ( i, sym ) {
+        sym_calc_value ( sym );
+        if ( sym->name == NULL ) { continue; }
+
+        /* the value as written to auto.conf, NULL if not set */
+        value   = NULL;
+        escaped = NULL;
+
+        if ( sym->flags & SYMBOL_WRITE ) {
+            switch ( sym->type ) {
+                case S_BOOLEAN:
+                case S_TRISTATE:
+                    value = sym_get_string_value ( sym );
+                    if ( *value == 'n' ) { value = NULL; }
+                    break;
+
+                case S_STRING:
+                    value = escaped = sym_escape_string_value (
+                        sym_get_string_value ( sym )
+                    );
+                    break;
+
+                case S_INT:
+                case S_HEX:
+                    value = sym_get_string_value ( sym );
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if ( lkconfig_autoconf__append_symbol ( ac, sym, value ) != 0 ) {
+            ret = -1;
+
+        } else if ( ! (sym->flags & SYMBOL_AUTO) ) {
+            idx    = lkconfig_symindex_get ( sidx, sym );
+            oldval = (idx >= 0) ? &(ac->oldvals [idx]) : NULL;
+
+            if ( (oldval == NULL) || (oldval->value == NULL) ) {
+                changed = (value != NULL);
+            } else {
+                changed = (
+                    (value == NULL)
+                    || (strlen ( value ) != oldval->value_len)
+                    || (memcmp ( value, oldval->value, oldval->value_len ))
+                );
+            }
+
+            if ( changed ) {
+                ret = lkconfig_autoconf__touch_split_file ( ac, sym );
+            }
+        }
+
+        free ( (void*) escaped );
+        if ( ret != 0 ) { return -1; }
+    }
+
+    return 0;
+}
+
+
+/**
+ * Creates the content of auto.conf.cmd, see lkc's file_write_dep().
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_autoconf__create_dep (
+    struct lkconfig_autoconf* const ac
+) {
+    struct lkconfig_autoconf_buf* const buf = &(ac->auto_conf_cmd);
+    const char* const autoconfig_name = conf_get_autoconfig_name();
+    const struct file* file;
+    struct symbol* sym;
+    struct symbol* env_sym;
+    struct expr* e;
+    const char* value;
+
+    if ( lkconfig_autoconf_buf_appendf ( buf, "deps_config := \\\n" ) ) {
+        return -1;
+    }
+
+    for ( file = file_list; file != NULL; file = file->next ) {
+        if (
+            lkconfig_autoconf_buf_appendf (
+                buf, "\t%s%s\n", file->name, ((file->next) ? " \\" : "")
+            ) != 0
+        ) {
+            return -1;
+        }
+    }
+
+    if (
+        lkconfig_autoconf_buf_appendf (
+            buf, "\n%s: \\\n\t$(deps_config)\n\n", autoconfig_name
+        ) != 0
+    ) {
+        return -1;
+    }
+
+    expr_list_for_each_sym ( sym_env_list, e, sym ) {
+        env_sym = prop_get_symbol ( sym_get_env_prop ( sym ) );
+        if ( env_sym == NULL ) { continue; }
+
+        value = getenv ( env_sym->name );
+        if (
+            lkconfig_autoconf_buf_appendf (
+                buf,
+                "ifneq \"$(%s)\" \"%s\"\n%s: FORCE\nendif\n",
+                env_sym->name, ((value != NULL) ? value : ""),
+                autoconfig_name
+            ) != 0
+        ) {
+            return -1;
+        }
+    }
+
+    return lkconfig_autoconf_buf_appendf ( buf, "\n$(deps_config): ;\n" );
+}
+
+
+/**
+ * Checks whether a file has the given content.
+ *
+ * @return non-zero if the file exists and has the same content, else 0
+ * */
+static int lkconfig_autoconf__file_has_content (
+    const char* const path, const struct lkconfig_autoconf_buf* const buf
+) {
+    struct lkconfig_confread cr;
+    int same;
+
+    lkconfig_confread_init ( &cr );
+    if ( lkconfig_confread_open ( &cr, path ) != 0 ) { return 0; }
+
+    same = (
+        (cr.size == buf->len)
+        && (
+            (buf->len == 0)
+            || (memcmp ( cr.data, buf->data, buf->len ) == 0)
+        )
+    );
+
+    lkconfig_confread_close ( &cr );
+    return same;
+}
+
+
+/**
+ * Writes a generated file via a temporary file in the same directory.
+ *
+ * @param ac               autoconf state
+ * @param relpath          file path, relative to the output directory
+ * @param buf              file content
+ * @param only_if_changed  whether to keep the file if its content is equal
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_autoconf__write_file (
+    struct lkconfig_autoconf* const ac, const char* const relpath,
+    const struct lkconfig_autoconf_buf* const buf, const int only_if_changed
+) {
+    char tmp_path[PATH_MAX+1];
+    const char* path;
+    size_t pos;
+    ssize_t wlen;
+    int fd;
+    int esav;
+
+    path = lkconfig_autoconf__get_path ( ac, relpath );
+    if ( path == NULL ) { return -1; }
+
+    if (
+        only_if_changed && lkconfig_autoconf__file_has_content ( path, buf )
+    ) {
+        return 0;
+    }
+
+    if (
+        snprintf ( tmp_path, sizeof tmp_path, "%s.tmp.XXXXXX", path )
+        >= (int) sizeof tmp_path
+    ) {
+        errno = ENAMETOOLONG;
+        return lkconfig_autoconf__fail ( ac, path );
+    }
+
+    if ( lkconfig_autoconf__mkdir_parents ( tmp_path ) != 0 ) {
+        return lkconfig_autoconf__fail ( ac, path );
+    }
+
+    fd = mkostemp ( tmp_path, O_CLOEXEC );
+    if ( fd < 0 ) { return lkconfig_autoconf__fail ( ac, tmp_path ); }
+
+    fchmod ( fd, 0644 );
+
+    for ( pos = 0; pos < buf->len; pos += (size_t) wlen ) {
+        wlen = write ( fd, (buf->data + pos), (buf->len - pos) );
+        if ( wlen < 0 ) {
+            if ( errno == EINTR ) {
+                wlen = 0;
+                continue;
+            }
+            esav = errno;
+            close ( fd );
+            unlink ( tmp_path );
+            errno = esav;
+            return lkconfig_autoconf__fail ( ac, tmp_path );
+        }
+    }
+
+    if ( close ( fd ) != 0 ) {
+        esav = errno;
+        unlink ( tmp_path );
+        errno = esav;
+        return lkconfig_autoconf__fail ( ac, tmp_path );
+    }
+
+    if ( rename ( tmp_path, path ) != 0 ) {
+        esav = errno;
+        unlink ( tmp_path );
+        errno = esav;
+        return lkconfig_autoconf__fail ( ac, path );
+    }
+
+    lkconfig_prof_count ( lkconfig_prof_bytes_written, buf->len );
+    return 0;
+}
+
+
+/**
+ * Writes auto.conf, auto.conf.cmd, tristate.conf, autoconf.h
+ * and the split config files of the current config to outdir.
+ * The lkc lock must be held, the GIL may be released.
+ *
+ * @param ac      autoconf state, initialized for outdir
+ * @param sidx    symbol index of the active context
+ *
+ * @return 0 on success, else -1 (errno set,
+ *         ac->errpath is set if a file operation failed)
+ * */
+static int lkconfig_autoconf_write (
+    struct lkconfig_autoconf* const ac,
+    const struct lkconfig_symindex* const sidx
+) {
+    char auto_conf_cmd_name[PATH_MAX+1];
+
+    sym_clear_all_valid();
+
+    if ( lkconfig_autoconf__read_old ( ac, sidx ) != 0 ) { return -1; }
+
+    if (
+        (lkconfig_autoconf__append_heading ( &(ac->auto_conf), 0 ) != 0)
+        || (lkconfig_autoconf__append_heading ( &(ac->tristate_conf), 0 ) != 0)
+        || (lkconfig_autoconf__append_heading ( &(ac->autoconf_h), 1 ) != 0)
+        || (lkconfig_autoconf__create_dep ( ac ) != 0)
+    ) {
+        return -1;
+    }
+
+    if ( lkconfig_autoconf__process_symbols ( ac, sidx ) != 0 ) { return -1; }
+
+    if (
+        snprintf (
+            auto_conf_cmd_name, sizeof auto_conf_cmd_name,
+            "%s.cmd", conf_get_autoconfig_name()
+        ) >= (int) sizeof auto_conf_cmd_name
+    ) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    if (
+        (
+            lkconfig_autoconf__write_file (
+                ac, auto_conf_cmd_name, &(ac->auto_conf_cmd), 1
+            ) != 0
+        ) || (
+            lkconfig_autoconf__write_file (
+                ac,
+                lkconfig_autoconf__getenv_name (
+                    "KCONFIG_TRISTATE", "include/config/tristate.conf"
+                ),
+                &(ac->tristate_conf), 1
+            ) != 0
+        ) || (
+            lkconfig_autoconf__write_file (
+                ac,
+                lkconfig_autoconf__getenv_name (
+                    "KCONFIG_AUTOHEADER", "include/generated/autoconf.h"
+                ),
+                &(ac->autoconf_h), 1
+            ) != 0
+        ) || (
+            /* last step, see above */
+            lkconfig_autoconf__write_file (
+                ac, conf_get_autoconfig_name(), &(ac->auto_conf), 0
+            ) != 0
+        )
+    ) {
+        return -1;
+    }
+
+    return 0;
+}
@@ -5,129 +5,1902 @@
  *
  * */
 
+/**
+ * A decision converted from the decisions dict,
+ * see lkconfig_conf__load_decisions().
+ * */
+struct lkconfig_conf_decision {
+    /* tristate value, no for disabling string-like symbols */
+    tristate      tri;
+    /* string value (string-like symbols) or NULL */
+    char*         strval;
+};
+
 struct lkconfig_conf_vars {
     int           conf_cnt;
     struct menu*  rootEntry;
-    PyObject*     conf_decisions;
     PyObject*     logger;
+    /* lowest enabled log level, see lkconfig_logger_get_level() */
+    int           log_level;
+    /* list of change records or NULL, see lkconfig_conf_log_set_symbol() */
+    PyObject*     changes;
+    /* incremental mode: dependency graph or NULL, see lkconfig_depgraph */
+    struct lkconfig_depgraph* depgraph;
+
+    /* decisions table :: symbol => index into decisionv */
+    struct lkconfig_ptrmap               decision_index;
+    struct lkconfig_conf_decision*       decisionv;
+    size_t                               decision_count;
+};
+
+#define lkconfig_conf_get_tristate_str(tval) \
+    (((tval) == yes) ? "y" : (((tval) == mod) ? "m" : "n"))
+
+#define lkconfig_conf_log_enabled(cvars, lvl)  ((lvl) >= (cvars)->log_level)
+
+
+/* this is used by lkconfig_conf_main()'s config message callback */
+static PyObject* lkconfig_conf_main_logger;
+static int lkconfig_conf_main_log_level = lkconfig__log_level_count;
+
+/*
+ * the config message callback may be called with the GIL released,
+ * messages are buffered and passed to the logger afterwards,
+ * see lkconfig_conf_main_flush_messages()
+ * */
+static struct lkconfig_msgbuf lkconfig_conf_main_msgbuf;
+
+
+/**
+ * Logs that a symbol is about to be set to a new value
+ * and appends a change record to cvars->changes if requested.
+ *
+ * Change records are 3-tuples (name, old value or None, new value),
+ * where the old value is None if the symbol had no value.
+ * Nothing is logged or recorded if the value does not change.
+ *
+ * @return 0 => success, non-zero => failure
+ * */
+static int lkconfig_conf_log_set_symbol (
+    struct lkconfig_conf_vars* const cvars,
+    struct symbol* const sym,
+    const char* const newval_str,
+    const char* const oldval_str
+) {
+    bool had_value;
+
+    if ( sym->name == NULL ) { return 0; }
+
+    had_value = sym_has_value(sym);
+    if ( had_value && (strcmp ( newval_str, oldval_str ) == 0) ) {
+        return 0;
+    }
+
+    if ( cvars->changes != NULL ) {
+        if (
+            lkconfig_list_append_steal_ref (
+                cvars->changes,
+                Py_BuildValue (
+                    "(szs)",
+                    sym->name, (had_value ? oldval_str : NULL), newval_str
+                )
+            ) != 0
+        ) {
+            return -1;
+        }
+    }
+
+    if ( ! lkconfig_conf_log_enabled ( cvars, lkconfig_debug ) ) {
+        return 0;
+
+    } else if ( ! had_value ) {
+        return lkconfig_log (
+            cvars->logger, lkconfig_debug,
+            "Setting symbol %s to \"%s\"",
+            sym->name, newval_str
+        );
+
+    } else {
+        return lkconfig_log (
+            cvars->logger, lkconfig_debug,
+            "Setting symbol %s to \"%s\" (from \"%s\")",
+            sym->name, newval_str, oldval_str
+        );
+    }
+}
+
+
+static int lkconfig_conf__conf (
+    struct lkconfig_conf_vars* const cvars, struct menu* const menu
+);
+
+static int lkconfig_conf__check_conf (
+    struct lkconfig_conf_vars* const cvars, struct menu* const menu
+);
+
+static void lkconfig_conf__free_decisions (
+    struct lkconfig_conf_vars* const cvars
+);
+
+static int lkconfig_conf__load_decisions (
+    struct lkconfig_conf_vars* const cvars, PyObject* const conf_decisions
+);
+
+static int lkconfig_conf__read_file (
+    struct lkconfig_conf_vars* const cvars, const char* const filename
+);
+
+
+static void lkconfig_conf_main_message_callback (
+    const char* fmt, va_list ap
+) {
+    /* also skips formatting if debug messages are disabled */
+    if ( lkconfig_conf_main_log_level > lkconfig_debug ) { return; }
+
+    lkconfig_msgbuf_appendv ( &lkconfig_conf_main_msgbuf, fmt, ap );
+}
+
+/**
+ * Passes buffered config messages to the logger.
+ * The GIL must be held.
+ *
+ * @return 0 => success, non-zero => failure
+ * */
+static int lkconfig_conf_main_flush_messages (void) {
+    return lkconfig_msgbuf_flush (
+        &lkconfig_conf_main_msgbuf, lkconfig_conf_main_logger, lkconfig_debug
+    );
+}
+
+/**
+ * Initializes the conf vars and sets up the config message callback.
+ * The conf vars must be freed with lkconfig_conf_main_free() afterwards,
+ * also on error.
+ *
+ * @param cvars           conf vars, uninitialized
+ * @param conf_decisions  decisions dict or NULL
+ * @param logger          logger or NULL
+ * @param changes         change records list or NULL
+ * @param incremental     whether to use the context's dependency graph
+ *                        for incremental invalidation
+ *
+ * @return 0 => success, non-zero => failure
+ * */
+static int lkconfig_conf_main_init (
+    struct lkconfig_conf_vars* const cvars,
+    PyDictObject* const conf_decisions,
+    PyObject* const logger,
+    PyObject* const changes,
+    const int incremental
+) {
+    struct symbol* sym;
+    int i;
+
+    cvars->conf_cnt       = 0;
+    cvars->rootEntry      = NULL;
+    cvars->logger         = logger;
+    cvars->changes        = changes;
+    cvars->depgraph       = NULL;
+    cvars->decisionv      = NULL;
+    cvars->decision_count = 0;
+    lkconfig_ptrmap_init ( &(cvars->decision_index) );
+
+    if ( lkconfig_logger_get_level ( logger, &(cvars->log_level) ) != 0 ) {
+        return -1;
+    }
+
+    if (
+        (conf_decisions != NULL)
+        && (
+            lkconfig_conf__load_decisions (
+                cvars, (PyObject*) conf_decisions
+            ) != 0
+        )
+    ) {
+        return -1;
+    }
+
+    if ( incremental ) {
+        cvars->depgraph = lkconfig_context_get_depgraph();
+        if ( cvars->depgraph == NULL ) { return -1; }
+        /* loading the config resets the state of all symbols */
+        lkconfig_depgraph_defer_all ( cvars->depgraph );
+    }
+
+    /*
+     * sym_calc_value() never clears SYMBOL_WRITE for choice values,
+     * reset it so that the outcome does not depend on previous runs
+     * */
+    for_all_symbols(i, sym) {
+        sym->flags &= ~SYMBOL_WRITE;
+    }
+
+    lkconfig_conf_main_logger    = logger;
+    lkconfig_conf_main_log_level = cvars->log_level;
+    conf_set_message_callback ( lkconfig_conf_main_message_callback );
+    return 0;
+}
+
+static void lkconfig_conf_main_clear_logger_and_callback (void) {
+    conf_set_message_callback ( NULL );
+    lkconfig_conf_main_logger    = NULL;
+    lkconfig_conf_main_log_level = lkconfig__log_level_count;
+    lkconfig_msgbuf_free ( &lkconfig_conf_main_msgbuf );
+}
+
+/**
+ * Frees the conf vars and resets the config message callback,
+ * counterpart to lkconfig_conf_main_init().
+ * */
+static void lkconfig_conf_main_free (
+    struct lkconfig_conf_vars* const cvars
+) {
+    lkconfig_conf__free_decisions ( cvars );
+    lkconfig_conf_main_clear_logger_and_callback();
+}
+
+
+/* see sym_set_changed() in lkc's symbol.c */
+static void lkconfig_conf__sym_set_changed ( struct symbol* const sym ) {
+    struct property* prop;
+
+    sym->flags |= SYMBOL_CHANGED;
+    for ( prop = sym->prop; prop; prop = prop->next ) {
+        if ( prop->menu ) {
+            prop->menu->flags |= MENU_CHANGED;
+        }
+    }
+}
+
+/**
+ * Invalidates the values of all symbols that depend on a changed symbol,
+ * or of all symbols if not in incremental mode.
+ * Changing the modules symbol always invalidates all symbols.
+ * */
+static void lkconfig_conf__sym_invalidate (
+    struct lkconfig_conf_vars* const cvars, struct symbol* const sym
+) {
+    if ( cvars->depgraph == NULL ) {
+        sym_clear_all_valid();
+
+    } else if ( (sym == modules_sym) || cvars->depgraph->pending_all ) {
+        sym_clear_all_valid();
+        lkconfig_depgraph_clear_pending ( cvars->depgraph );
+
+    } else {
+        lkconfig_depgraph_invalidate ( cvars->depgraph, sym );
+        /* same as sym_clear_all_valid() */
+        sym_add_change_count(1);
+        lkconfig_prof_sym_calc_value ( modules_sym );
+    }
+}
+
+/**
+ * Marks a symbol whose state has been changed without invalidating it,
+ * lkc recalculates it with the next invalidation (incremental mode only).
+ * */
+static void lkconfig_conf__sym_defer_invalidate (
+    struct lkconfig_conf_vars* const cvars, struct symbol* const sym
+) {
+    if ( cvars->depgraph != NULL ) {
+        lkconfig_depgraph_defer ( cvars->depgraph, sym );
+    }
+}
+
+/**
+ * Variant of lkc's sym_set_tristate_value()
+ * that supports incremental invalidation.
+ * */
+static bool lkconfig_conf__sym_set_tristate_value (
+    struct lkconfig_conf_vars* const cvars,
+    struct symbol* const sym,
+    const tristate val
+) {
+    tristate oldval;
+
+    if ( cvars->depgraph == NULL ) {
+        return sym_set_tristate_value ( sym, val );
+    }
+
+    oldval = sym_get_tristate_value ( sym );
+
+    if ( oldval != val && !sym_tristate_within_range ( sym, val ) ) {
+        return false;
+    }
+
+    if ( !(sym->flags & SYMBOL_DEF_USER) ) {
+        sym->flags |= SYMBOL_DEF_USER;
+        lkconfig_conf__sym_set_changed ( sym );
+    }
+
+    /*
+     * setting a choice value also resets the new flag of the choice
+     * symbol and all other choice values.
+     */
+    if ( sym_is_choice_value(sym) && val == yes ) {
+        struct symbol* cs = prop_get_symbol ( sym_get_choice_prop ( sym ) );
+        struct property* prop;
+        struct expr* e;
+
+        cs->def[S_DEF_USER].val = sym;
+        cs->flags |= SYMBOL_DEF_USER;
+        lkconfig_conf__sym_defer_invalidate ( cvars, cs );
+        prop = sym_get_choice_prop ( cs );
+        for ( e = prop->expr; e; e = e->left.expr ) {
+            if ( e->right.sym->visible != no ) {
+                e->right.sym->flags |= SYMBOL_DEF_USER;
+                lkconfig_conf__sym_defer_invalidate ( cvars, e->right.sym );
+            }
+        }
+    }
+
+    sym->def[S_DEF_USER].tri = val;
+    if ( oldval != val ) {
+        lkconfig_conf__sym_invalidate ( cvars, sym );
+    } else {
+        lkconfig_conf__sym_defer_invalidate ( cvars, sym );
+    }
+
+    return true;
+}
+
+/**
+ * Variant of lkc's sym_set_string_value()
+ * that supports incremental invalidation.
+ * */
+static bool lkconfig_conf__sym_set_string_value (
+    struct lkconfig_conf_vars* const cvars,
+    struct symbol* const sym,
+    const char* const newval
+) {
+    const char* oldval;
+    char* val;
+    size_t size;
+
+    if ( cvars->depgraph == NULL ) {
+        return sym_set_string_value ( sym, newval );
+    }
+
+    switch ( sym->type ) {
+        case S_BOOLEAN:
+        case S_TRISTATE:
+            switch ( newval[0] ) {
+                case 'y': case 'Y':
+                    return lkconfig_conf__sym_set_tristate_value (
+                        cvars, sym, yes
+                    );
+                case 'm': case 'M':
+                    return lkconfig_conf__sym_set_tristate_value (
+                        cvars, sym, mod
+                    );
+                case 'n': case 'N':
+                    return lkconfig_conf__sym_set_tristate_value (
+                        cvars, sym, no
+                    );
+            }
+            return false;
+
+        default:
+            ;
+    }
+
+    if ( !sym_string_within_range ( sym, newval ) ) {
+        return false;
+    }
+
+    if ( !(sym->flags & SYMBOL_DEF_USER) ) {
+        sym->flags |= SYMBOL_DEF_USER;
+        lkconfig_conf__sym_set_changed ( sym );
+    }
+
+    oldval = sym->def[S_DEF_USER].val;
+    size = strlen ( newval ) + 1;
+    if (
+        sym->type == S_HEX
+        && (newval[0] != '0' || (newval[1] != 'x' && newval[1] != 'X'))
+    ) {
+        size += 2;
+        sym->def[S_DEF_USER].val = val = xmalloc ( size );
+        *val++ = '0';
+        *val++ = 'x';
+    } else if ( !oldval || strcmp ( oldval, newval ) ) {
+        sym->def[S_DEF_USER].val = val = xmalloc ( size );
+    } else {
+        lkconfig_conf__sym_defer_invalidate ( cvars, sym );
+        return true;
+    }
+
+    strcpy ( val, newval );
+    free ( (void*) oldval );
+    lkconfig_conf__sym_invalidate ( cvars, sym );
+
+    return true;
+}
+
+
+/**
+ * Runs the oldconfig passes until no more symbols need to be configured.
+ *
+ * @param cvars  conf vars
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_conf__run_passes (
+    struct lkconfig_conf_vars* const cvars
+) {
+    struct lkconfig_prof_timer timer;
+    int ret;
+
+    lkconfig_prof_timer_start ( &timer );
+    lkconfig_prof_count ( lkconfig_prof_conf_runs, 1 );
+
+    do {
+        lkconfig_prof_count ( lkconfig_prof_conf_passes, 1 );
+        cvars->conf_cnt = 0;
+        ret = lkconfig_conf__check_conf ( cvars, &rootmenu );
+    } while ( (ret >= 0) && cvars->conf_cnt );
+
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_conf_check );
+    return ( (ret < 0) ? -1 : 0 );
+}
+
+
+/**
+ * Writes the current config to a .config file, with the GIL released.
+ *
+ * @param config_file_out  output .config file
+ *
+ * @return return value of conf_write(), 0 on success
+ * */
+static int lkconfig_conf__write_file ( const char* const config_file_out ) {
+    struct lkconfig_prof_timer timer;
+    int ret;
+
+    Py_BEGIN_ALLOW_THREADS
+    lkconfig_prof_timer_start ( &timer );
+    ret = conf_write ( config_file_out );
+    if ( ret == 0 ) { lkconfig_prof_count_file_size ( config_file_out ); }
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_conf_write );
+    Py_END_ALLOW_THREADS
+
+    return ret;
+}
+
+
+static int lkconfig_conf_main (
+    const char* const config_file_in,
+    const char* const config_file_out,
+    PyDictObject* const conf_decisions,
+    PyObject* const logger,
+    PyObject* const changes,
+    const int incremental
+) {
+    struct lkconfig_conf_vars cvars;
+    struct lkconfig_prof_timer timer;
+    int ret;
+
+    if (
+        lkconfig_conf_main_init (
+            &cvars, conf_decisions, logger, changes, incremental
+        ) != 0
+    ) {
+        lkconfig_conf_main_free ( &cvars );
+        return -1;
+    }
+
+    lkconfig_prof_timer_start ( &timer );
+    ret = lkconfig_conf__read_file ( &cvars, config_file_in );
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_conf_read );
+
+    if ( (ret < 0) || (lkconfig_conf_main_flush_messages() != 0) ) {
+        lkconfig_conf_main_free ( &cvars );
+        return -1;
+    }
+
+    if ( lkconfig_conf__run_passes ( &cvars ) != 0 ) {
+        lkconfig_conf_main_free ( &cvars );
+        return -1;
+    }
+
+    lkconfig_conf__write_file ( config_file_out );
+
+    ret = lkconfig_conf_main_flush_messages();
+
+    lkconfig_conf_main_free ( &cvars );
+    return ret;
+}
+
+
+/**
+ * Sets the user value of a tristate/boolean symbol
+ * from a config values dict entry.
+ *
+ * @param sym        symbol
+ * @param def_flags  sym def flags for S_DEF_USER
+ * @param value      value (None or int 0/1/2)
+ *
+ * @return 0 if value has been set, 1 if value is invalid,
+ *         -1 on errors (python exception set)
+ * */
+static int lkconfig_conf__set_tristate_from_value (
+    struct symbol* const sym, const int def_flags, PyObject* const value
+) {
+    long tval;
+
+    if ( value == Py_None ) {
+        tval = 0;
+
+    } else if ( PyLong_Check ( value ) ) {
+        tval = PyLong_AsLong ( value );
+        if ( (tval == -1) && PyErr_Occurred() ) { return -1; }
+
+    } else {
+        PyErr_Format (
+            PyExc_ValueError,
+            "bad config value for tristate symbol %s", sym->name
+        );
+        return -1;
+    }
+
+    switch ( tval ) {
+        case 0:
+            sym->def[S_DEF_USER].tri = no;
+            break;
+
+        case 1:
+            if ( sym->type != S_TRISTATE ) { return 1; }
+            sym->def[S_DEF_USER].tri = mod;
+            break;
+
+        case 2:
+            sym->def[S_DEF_USER].tri = yes;
+            break;
+
+        default:
+            return 1;
+    }
+
+    sym->flags |= def_flags;
+    return 0;
+}
+
+
+/**
+ * Converts a config value of a string-like symbol to str.
+ *
+ * @param sym    symbol
+ * @param value  value (str, or int for int/hex symbols)
+ *
+ * @return new reference to str object, NULL on error (python exception set)
+ * */
+static PyObject* lkconfig_conf__get_string_value_object (
+    struct symbol* const sym, PyObject* const value
+) {
+    if ( PyUnicode_Check ( value ) ) {
+        Py_INCREF ( value );
+        return value;
+
+    } else if ( PyLong_Check ( value ) && (sym->type == S_INT) ) {
+        return PyObject_Str ( value );
+
+    } else if ( PyLong_Check ( value ) && (sym->type == S_HEX) ) {
+        return PyNumber_ToBase ( value, 16 );
+
+    } else {
+        PyErr_Format (
+            PyExc_ValueError,
+            "bad config value for string symbol %s", sym->name
+        );
+        return NULL;
+    }
+}
+
+
+/**
+ * Sets the user value of a string-like symbol
+ * from a config values dict entry.
+ *
+ * @param sym        symbol
+ * @param def_flags  sym def flags for S_DEF_USER
+ * @param value      value (None or str, or int for int/hex symbols)
+ *
+ * @return 0 if value has been set or was None, 1 if value is invalid,
+ *         -1 on errors (python exception set)
+ * */
+static int lkconfig_conf__set_string_from_value (
+    struct symbol* const sym, const int def_flags, PyObject* const value
+) {
+    PyObject* str_obj;
+    const char* strval;
+    int ret;
+
+    if ( value == Py_None ) { return 0; }
+
+    str_obj = lkconfig_conf__get_string_value_object ( sym, value );
+    if ( str_obj == NULL ) { return -1; }
+
+    strval = PyUnicode_AsUTF8 ( str_obj );
+    if ( strval == NULL ) {
+        ret = -1;
+
+    } else if ( ! sym_string_valid ( sym, strval ) ) {
+        ret = 1;
+
+    } else {
+        sym->def[S_DEF_USER].val = strdup ( strval );
+        if ( sym->def[S_DEF_USER].val == NULL ) {
+            PyErr_NoMemory();
+            ret = -1;
+        } else {
+            sym->flags |= def_flags;
+            ret = 0;
+        }
+    }
+
+    Py_DECREF ( str_obj );
+    return ret;
+}
+
+
+/**
+ * Updates the user value of a choice symbol
+ * after the user value of one of its choice values has been set,
+ * see conf_read_simple() in lkc's confdata.c.
+ *
+ * @param sym            symbol, may be a non-choice value
+ * @param def_flags      sym def flags for S_DEF_USER
+ * @param conf_warnings  pointer to the config warnings counter
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_conf__read_choice_value (
+    struct symbol* const sym,
+    const int def_flags,
+    int* const conf_warnings
+) {
+    struct symbol* cs;
+
+    if ( ! sym_is_choice_value(sym) ) { return; }
+
+    cs = prop_get_symbol ( sym_get_choice_prop ( sym ) );
+    switch ( sym->def[S_DEF_USER].tri ) {
+        case no:
+            break;
+
+        case mod:
+            if ( cs->def[S_DEF_USER].tri == yes ) {
+                (*conf_warnings)++;
+                cs->flags &= ~def_flags;
+            }
+            break;
+
+        case yes:
+            cs->def[S_DEF_USER].val = sym;
+            break;
+    }
+    cs->def[S_DEF_USER].tri = EXPR_OR (
+        cs->def[S_DEF_USER].tri, sym->def[S_DEF_USER].tri
+    );
+}
+
+
+/**
+ * Sets the user value of a symbol from a config values entry,
+ * see lkconfig_conf__read_values().
+ *
+ * @param cvars          conf vars, only the logger is used
+ * @param sym            symbol
+ * @param def_flags      sym def flags for S_DEF_USER
+ * @param value          value
+ * @param conf_warnings  pointer to the config warnings counter
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_conf__read_value (
+    struct lkconfig_conf_vars* const cvars,
+    struct symbol* const sym,
+    const int def_flags,
+    PyObject* const value,
+    int* const conf_warnings
+) {
+    int ret;
+
+    switch ( sym->type ) {
+        case S_BOOLEAN:
+        case S_TRISTATE:
+            ret = lkconfig_conf__set_tristate_from_value (
+                sym, def_flags, value
+            );
+            break;
+
+        case S_INT:
+        case S_HEX:
+        case S_STRING:
+            ret = lkconfig_conf__set_string_from_value (
+                sym, def_flags, value
+            );
+            break;
+
+        default:
+            ret = 0;
+            break;
+    }
+
+    if ( ret < 0 ) {
+        return -1;
+
+    } else if ( ret > 0 ) {
+        (*conf_warnings)++;
+        if (
+            lkconfig_conf_log_enabled ( cvars, lkconfig_warning )
+            && lkconfig_log (
+                cvars->logger, lkconfig_warning,
+                "invalid config value for symbol %s", sym->name
+            ) != 0
+        ) {
+            return -1;
+        }
+        return 0;
+    }
+
+    lkconfig_conf__read_choice_value ( sym, def_flags, conf_warnings );
+    return 0;
+}
+
+
+/**
+ * Resets the user values of all symbols before loading a config,
+ * see conf_read_simple() in lkc's confdata.c.
+ *
+ * @return sym def flags for S_DEF_USER
+ * */
+static int lkconfig_conf__reset_user_values (void) {
+    struct symbol* sym;
+    int i;
+    int def_flags;
+
+    sym_set_change_count(0);
+
+    def_flags = SYMBOL_DEF << S_DEF_USER;
+    for_all_symbols(i, sym) {
+        sym->flags |= SYMBOL_CHANGED;
+        sym->flags &= ~(def_flags|SYMBOL_VALID);
+        if ( sym_is_choice(sym) ) {
+            sym->flags |= def_flags;
+        }
+        switch ( sym->type ) {
+            case S_INT:
+            case S_HEX:
+            case S_STRING:
+                if ( sym->def[S_DEF_USER].val ) {
+                    free ( sym->def[S_DEF_USER].val );
+                }
+                /* fall through */
+            default:
+                sym->def[S_DEF_USER].val = NULL;
+                sym->def[S_DEF_USER].tri = no;
+        }
+    }
+
+    return def_flags;
+}
+
+
+/**
+ * Checks the user values of all symbols after loading a config
+ * and updates the change count, see conf_read() in lkc's confdata.c.
+ *
+ * @param conf_warnings  number of warnings while loading the config
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_conf__finish_user_values ( const int conf_warnings ) {
+    struct symbol* sym;
+    int i;
+    int conf_unsaved;
+
+    conf_unsaved = 0;
+
+    lkconfig_prof_sym_calc_value ( modules_sym );
+
+    for_all_symbols(i, sym) {
+        lkconfig_prof_sym_calc_value ( sym );
+        if ( sym_is_choice(sym) || (sym->flags & SYMBOL_AUTO) ) {
+            continue;
+        }
+        if ( sym_has_value(sym) && (sym->flags & SYMBOL_WRITE) ) {
+            /* check that calculated value agrees with saved value */
+            switch ( sym->type ) {
+                case S_BOOLEAN:
+                case S_TRISTATE:
+                    if (
+                        sym->def[S_DEF_USER].tri != sym_get_tristate_value(sym)
+                    ) {
+                        break;
+                    }
+                    if ( !sym_is_choice(sym) ) {
+                        continue;
+                    }
+                    /* fall through */
+                default:
+                    if (
+                        !strcmp ( sym->curr.val, sym->def[S_DEF_USER].val )
+                    ) {
+                        continue;
+                    }
+                    break;
+            }
+        } else if ( !sym_has_value(sym) && !(sym->flags & SYMBOL_WRITE) ) {
+            /* no previous value and not saved */
+            continue;
+        }
+        conf_unsaved++;
+    }
+
+    for_all_symbols(i, sym) {
+        if ( sym_has_value(sym) && !sym_is_choice_value(sym) ) {
+            if ( sym->visible == no && !conf_unsaved ) {
+                sym->flags &= ~SYMBOL_DEF_USER;
+            }
+            switch ( sym->type ) {
+                case S_STRING:
+                case S_INT:
+                case S_HEX:
+                    /* Reset a string value if it's out of range */
+                    if (
+                        sym_string_within_range (
+                            sym, sym->def[S_DEF_USER].val
+                        )
+                    ) {
+                        break;
+                    }
+                    sym->flags &= ~(SYMBOL_VALID|SYMBOL_DEF_USER);
+                    conf_unsaved++;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    sym_add_change_count ( conf_warnings || conf_unsaved );
+}
+
+
+/**
+ * Loads the user values of all symbols from a config values dict,
+ * silently replacing the previous user values.
+ *
+ * This is -more or less- a copy of confdata.c's conf_read(),
+ * which reads values from an in-memory dict instead of a .config file.
+ *
+ * The dict maps symbol names to values,
+ * where tristate/boolean values are represented as int 0/1/2,
+ * string/int/hex values as str (int/hex values may also be int),
+ * and "is not set" as None.
+ * Symbols not in the dict have no user value.
+ *
+ * Alternatively, config values may be passed as list indexed by
+ * symbol index, see lkconfig_symindex.c. The list may be shorter than
+ * the number of indexed symbols. Values are the same as in the dict,
+ * except that None means "no user value";
+ * disabled tristate/boolean symbols are represented as int 0.
+ *
+ * @param cvars          conf vars, only the logger is used
+ * @param config_values  config values dict or list
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_conf__read_values (
+    struct lkconfig_conf_vars* const cvars,
+    PyObject* const config_values
+) {
+    const struct lkconfig_symindex* symindex;
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t pos;
+    Py_ssize_t k;
+    const char* name;
+    struct symbol* sym;
+    int def_flags;
+    int conf_warnings;
+
+    conf_warnings = 0;
+    def_flags     = lkconfig_conf__reset_user_values();
+
+    if ( PyList_Check ( config_values ) ) {
+        symindex = &(lkconfig_active_context->symindex);
+
+        if ( (size_t) PyList_GET_SIZE ( config_values ) > symindex->nsyms ) {
+            PyErr_SetString (
+                PyExc_ValueError, "config values list is too long"
+            );
+            return -1;
+        }
+
+        for ( k = 0; k < PyList_GET_SIZE ( config_values ); k++ ) {
+            value = PyList_GET_ITEM ( config_values, k );
+            if ( value != Py_None ) {
+                if (
+                    lkconfig_conf__read_value (
+                        cvars, symindex->syms [k], def_flags, value,
+                        &conf_warnings
+                    ) != 0
+                ) {
+                    return -1;
+                }
+            }
+        }
+
+    } else {
+        pos = 0;
+        while ( PyDict_Next ( config_values, &pos, &key, &value ) ) {
+            name = PyUnicode_AsUTF8 ( key );
+            if ( name == NULL ) { return -1; }
+
+            sym = lkconfig_symindex_find_symbol ( name );
+            if ( sym == NULL ) {
+                sym_add_change_count(1);
+                continue;
+            }
+
+            if (
+                lkconfig_conf__read_value (
+                    cvars, sym, def_flags, value, &conf_warnings
+                ) != 0
+            ) {
+                return -1;
+            }
+        }
+    }
+
+    lkconfig_conf__finish_user_values ( conf_warnings );
+    return 0;
+}
+
+
+/**
+ * A growable char buffer for NUL-terminated copies of .config spans,
+ * see lkconfig_conf__read_file().
+ * */
+struct lkconfig_conf_strbuf {
+    char*  data;
+    size_t cap;
+};
+
+/**
+ * Copies a span to a string buffer. May be called without holding the GIL.
+ *
+ * @return NUL-terminated copy, NULL if out of memory
+ * */
+static char* lkconfig_conf_strbuf_set (
+    struct lkconfig_conf_strbuf* const sbuf,
+    const char* const s, const size_t len
+) {
+    char* new_data;
+    size_t new_cap;
+
+    if ( len >= sbuf->cap ) {
+        new_cap  = (len < 255) ? 256 : (2 * len);
+        new_data = PyMem_RawRealloc ( sbuf->data, new_cap );
+        if ( new_data == NULL ) { return NULL; }
+        sbuf->data = new_data;
+        sbuf->cap  = new_cap;
+    }
+
+    memcpy ( sbuf->data, s, len );
+    sbuf->data [len] = '\0';
+    return sbuf->data;
+}
+
+
+__attribute__((format (printf, 4, 5)))
+static void lkconfig_conf__read_file_warning (
+    struct lkconfig_conf_vars* const cvars,
+    struct lkconfig_msgbuf* const mbuf,
+    int* const conf_warnings,
+    const char* const format,
+    ...
+) {
+    va_list vargs;
+
+    (*conf_warnings)++;
+
+    if ( lkconfig_conf_log_enabled ( cvars, lkconfig_warning ) ) {
+        va_start ( vargs, format );
+        lkconfig_msgbuf_appendv ( mbuf, format, vargs );
+        va_end ( vargs );
+    }
+}
+
+
+/**
+ * Sets the user value of a symbol from a .config value span,
+ * see conf_set_sym_val() in lkc's confdata.c.
+ * May be called without holding the GIL.
+ *
+ * @param sym        symbol
+ * @param def_flags  sym def flags for S_DEF_USER
+ * @param value      value span, quotes are not removed
+ * @param value_len  length of the value span
+ * @param sbuf       scratch buffer
+ *
+ * @return 0 if value has been set, 1 if value is invalid,
+ *         -1 if out of memory
+ * */
+static int lkconfig_conf__set_value_from_span (
+    struct symbol* const sym,
+    const int def_flags,
+    const char* const value,
+    const size_t value_len,
+    struct lkconfig_conf_strbuf* const sbuf
+) {
+    char* strval;
+    size_t j;
+    size_t k;
+
+    switch ( sym->type ) {
+        case S_TRISTATE:
+            if ( value[0] == 'm' ) {
+                sym->def[S_DEF_USER].tri = mod;
+                sym->flags |= def_flags;
+                return 0;
+            }
+            /* fall through */
+        case S_BOOLEAN:
+            if ( value[0] == 'y' ) {
+                sym->def[S_DEF_USER].tri = yes;
+            } else if ( value[0] == 'n' ) {
+                sym->def[S_DEF_USER].tri = no;
+            } else {
+                return 1;
+            }
+            sym->flags |= def_flags;
+            return 0;
+
+        case S_STRING:
+            /* lkc ignores values that are not double-quoted */
+            if ( value[0] != '"' ) { return 0; }
+
+            strval = lkconfig_conf_strbuf_set ( sbuf, value, value_len );
+            if ( strval == NULL ) { return -1; }
+
+            /* unescape in place, stop at the closing quote */
+            for ( j = 0, k = 1; ; k++ ) {
+                if ( k >= value_len ) { return 1; }
+
+                if ( strval[k] == '"' ) {
+                    break;
+                } else if ( (strval[k] == '\\') && ((k + 1) < value_len) ) {
+                    k++;
+                }
+                strval[j++] = strval[k];
+            }
+            strval[j] = '\0';
+            break;
+
+        case S_INT:
+        case S_HEX:
+            strval = lkconfig_conf_strbuf_set ( sbuf, value, value_len );
+            if ( strval == NULL ) { return -1; }
+            break;
+
+        default:
+            return 0;
+    }
+
+    if ( ! sym_string_valid ( sym, strval ) ) { return 1; }
+
+    sym->def[S_DEF_USER].val = strdup ( strval );
+    if ( sym->def[S_DEF_USER].val == NULL ) { return -1; }
+    sym->flags |= def_flags;
+    return 0;
+}
+
+
+/**
+ * Loads the user values of all symbols from a .config file,
+ * silently replacing the previous user values.
+ *
+ * This replaces lkc's conf_read(). The file is read with the
+ * streaming reader (see lkconfig_confread.c) and symbols are looked up
+ * without creating them. Apart from that, the behavior is the same
+ * as conf_read()'s, except for warnings, which are passed to the logger.
+ *
+ * The file is read with the GIL released.
+ *
+ * @param cvars     conf vars, only the logger is used
+ * @param filename  path to the .config file, see zconf_fopen()
+ *
+ * Unlike conf_read(), a file that cannot be opened is an error
+ * (OSError), the previous user values are kept in that case.
+ *
+ * @return 0 on success, -1 on error (python exception set)
+ * */
+static int lkconfig_conf__read_file (
+    struct lkconfig_conf_vars* const cvars,
+    const char* const filename
+) {
+    struct lkconfig_confread cr;
+    struct lkconfig_confread_line tok;
+    struct lkconfig_conf_strbuf sbuf;
+    struct lkconfig_msgbuf mbuf;
+    const char* prefix;
+    size_t prefix_len;
+    size_t value_len;
+    const char* name;
+    struct symbol* sym;
+    int def_flags;
+    int conf_warnings;
+    int open_errno;
+    int ret;
+
+    lkconfig_confread_init ( &cr );
+    lkconfig_msgbuf_init ( &mbuf );
+    sbuf.data = NULL;
+    sbuf.cap  = 0;
+
+    prefix     = CONFIG_;
+    prefix_len = strlen ( prefix );
+
+    ret = 0;
+
+    open_errno = 0;
+
+    Py_BEGIN_ALLOW_THREADS
+    if ( lkconfig_confread_open_lkc ( &cr, filename ) != 0 ) {
+        open_errno = errno;
+        ret = 1;
+
+    } else {
+        conf_warnings = 0;
+        def_flags     = lkconfig_conf__reset_user_values();
+
+        while ( (ret == 0) && lkconfig_confread_next ( &cr, &tok ) ) {
+            if ( tok.kind == LKCONFIG_CONFREAD_NONE ) { continue; }
+
+            if (
+                (tok.kind == LKCONFIG_CONFREAD_INVALID)
+                || (tok.name_len <= prefix_len)
+                || (memcmp ( tok.name, prefix, prefix_len ) != 0)
+            ) {
+                /* "is not set" lines w/o prefix are just comments */
+                if ( tok.kind != LKCONFIG_CONFREAD_UNSET ) {
+                    lkconfig_conf__read_file_warning (
+                        cvars, &mbuf, &conf_warnings,
+                        "%s:%u:warning: unexpected data: %.*s",
+                        filename, tok.lineno, (int) tok.line_len, tok.line
+                    );
+                }
+                continue;
+            }
+
+            name = lkconfig_conf_strbuf_set (
+                &sbuf, (tok.name + prefix_len), (tok.name_len - prefix_len)
+            );
+            if ( name == NULL ) {
+                ret = -1;
+                break;
+            }
+
+            sym = lkconfig_symindex_find_symbol ( name );
+            if ( sym == NULL ) {
+                sym_add_change_count(1);
+                continue;
+            }
+
+            if ( sym->flags & def_flags ) {
+                lkconfig_conf__read_file_warning (
+                    cvars, &mbuf, &conf_warnings,
+                    "%s:%u:warning: override: reassigning to symbol %s",
+                    filename, tok.lineno, sym->name
+                );
+            }
+
+            if ( tok.kind == LKCONFIG_CONFREAD_UNSET ) {
+                switch ( sym->type ) {
+                    case S_BOOLEAN:
+                    case S_TRISTATE:
+                        sym->def[S_DEF_USER].tri = no;
+                        sym->flags |= def_flags;
+                        break;
+
+                    default:
+                        break;
+                }
+
+            } else {
+                /* like lkc, the value extends to the end of the line */
+                value_len = (size_t) ((tok.line + tok.line_len) - tok.value);
+
+                switch (
+                    lkconfig_conf__set_value_from_span (
+                        sym, def_flags, tok.value, value_len, &sbuf
+                    )
+                ) {
+                    case 0:
+                        break;
+
+                    case 1:
+                        lkconfig_conf__read_file_warning (
+                            cvars, &mbuf, &conf_warnings,
+                            (
+                                "%s:%u:warning:"
+                                " symbol value '%.*s' invalid for %s"
+                            ),
+                            filename, tok.lineno,
+                            (int) value_len, tok.value, sym->name
+                        );
+                        continue;
+
+                    default:
+                        ret = -1;
+                        continue;
+                }
+            }
+
+            lkconfig_conf__read_choice_value (
+                sym, def_flags, &conf_warnings
+            );
+        }
+
+        if ( ret == 0 ) {
+            lkconfig_conf__finish_user_values ( conf_warnings );
+        }
+
+        lkconfig_confread_close ( &cr );
+    }
+
+    PyMem_RawFree ( sbuf.data );
+    Py_END_ALLOW_THREADS
+
+    if ( ret > 0 ) {
+        errno = open_errno;
+        PyErr_SetFromErrnoWithFilename ( PyExc_OSError, filename );
+        return -1;
+
+    } else if ( ret < 0 ) {
+        lkconfig_msgbuf_free ( &mbuf );
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    if (
+        lkconfig_msgbuf_flush ( &mbuf, cvars->logger, lkconfig_warning ) != 0
+    ) {
+        return -1;
+    }
+
+    return ret;
+}
+
+
+/**
+ * Creates the py object representing the value of a symbol
+ * in a config values dict, see lkconfig_conf__read_values().
+ *
+ * @param sym  symbol
+ *
+ * @return new reference to value object, NULL on error
+ * */
+static PyObject* lkconfig_conf__get_value_object ( struct symbol* const sym ) {
+    const char* strval;
+    tristate tval;
+
+    switch ( sym->type ) {
+        case S_BOOLEAN:
+        case S_TRISTATE:
+            tval = sym_get_tristate_value ( sym );
+            if ( tval == no ) { Py_RETURN_NONE; }
+            return PyLong_FromLong ( tval );
+
+        case S_STRING:
+            return PyUnicode_FromString ( sym_get_string_value ( sym ) );
+
+        case S_INT:
+        case S_HEX:
+            strval = sym_get_string_value ( sym );
+            if ( (strval == NULL) || (*strval == '\0') ) { Py_RETURN_NONE; }
+            return PyLong_FromString (
+                strval, NULL, ((sym->type == S_HEX) ? 16 : 10)
+            );
+
+        default:
+            Py_RETURN_NONE;
+    }
+}
+
+
+/**
+ * Collects the values of all symbols that would be written to a .config
+ * file by conf_write(), in the same order.
+ *
+ * @return new reference to a config values dict, NULL on error
+ * */
+static PyObject* lkconfig_conf__get_values (void) {
+    PyObject* config_values;
+    PyObject* value;
+    struct symbol* sym;
+    struct menu* menu;
+
+    config_values = PyDict_New();
+    if ( config_values == NULL ) { return NULL; }
+
+    sym_clear_all_valid();
+
+    menu = rootmenu.list;
+    while ( menu ) {
+        sym = menu->sym;
+
+        if ( (sym != NULL) && !(sym->flags & SYMBOL_CHOICE) ) {
+            lkconfig_prof_sym_calc_value ( sym );
+            if ( sym->flags & SYMBOL_WRITE ) {
+                /* symbols may appear in more than one menu entry */
+                sym->flags &= ~SYMBOL_WRITE;
+
+                if ( (sym->name != NULL) && (sym->type != S_OTHER) ) {
+                    value = lkconfig_conf__get_value_object ( sym );
+                    if ( value == NULL ) {
+                        Py_DECREF ( config_values );
+                        return NULL;
+                    }
+
+                    if (
+                        PyDict_SetItemString (
+                            config_values, sym->name, value
+                        ) != 0
+                    ) {
+                        Py_DECREF ( value );
+                        Py_DECREF ( config_values );
+                        return NULL;
+                    }
+                    Py_DECREF ( value );
+                }
+            }
+        }
+
+        if ( menu->list ) {
+            menu = menu->list;
+            continue;
+        }
+        if ( menu->next ) {
+            menu = menu->next;
+        } else while ( (menu = menu->parent) ) {
+            if ( menu->next ) {
+                menu = menu->next;
+                break;
+            }
+        }
+    }
+
+    /* restore SYMBOL_WRITE */
+    sym_clear_all_valid();
+
+    return config_values;
+}
+
+
+/**
+ * Returns whether a symbol belongs to the minimal config,
+ * i.e. whether conf_write_defconfig() would write it.
+ * Symbols without a SYMBOL_WRITE flag are never part of it.
+ *
+ * Clears the symbol's SYMBOL_WRITE flag,
+ * symbols may appear in more than one menu entry.
+ *
+ * @param sym  symbol (not a choice)
+ *
+ * @return non-zero if sym is not at its default value, else 0
+ * */
+static int lkconfig_conf__sym_is_defconfig ( struct symbol* const sym ) {
+    struct symbol* choice_sym;
+
+    lkconfig_prof_sym_calc_value ( sym );
+    if ( ! (sym->flags & SYMBOL_WRITE) ) { return 0; }
+    sym->flags &= ~SYMBOL_WRITE;
+
+    /* symbols that cannot be changed, or that equal their default */
+    if ( ! sym_is_changable ( sym ) ) { return 0; }
+
+    if (
+        strcmp (
+            sym_get_string_value ( sym ), sym_get_string_default ( sym )
+        ) == 0
+    ) {
+        return 0;
+    }
+
+    /*
+     * the default "y" value of a non-optional choice is implied
+     * by the choice, and is not written
+     * */
+    if ( sym_is_choice_value ( sym ) ) {
+        choice_sym = prop_get_symbol ( sym_get_choice_prop ( sym ) );
+
+        if (
+            (! sym_is_optional ( choice_sym ))
+            && (sym == sym_choice_default ( choice_sym ))
+            && (sym->type == S_BOOLEAN)
+            && (sym_get_tristate_value ( sym ) == yes)
+        ) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * Collects the values of all symbols that would be written to a minimal
+ * config file by conf_write_defconfig(), in the same order.
+ *
+ * @return new reference to a config values dict, NULL on error
+ * */
+static PyObject* lkconfig_conf__get_defconfig_values (void) {
+    PyObject* config_values;
+    PyObject* value;
+    struct symbol* sym;
+    struct menu* menu;
+
+    config_values = PyDict_New();
+    if ( config_values == NULL ) { return NULL; }
+
+    sym_clear_all_valid();
+
+    menu = rootmenu.list;
+    while ( menu ) {
+        sym = menu->sym;
+
+        if (
+            (sym != NULL) && !sym_is_choice ( sym )
+            && lkconfig_conf__sym_is_defconfig ( sym )
+            && (sym->name != NULL) && (sym->type != S_OTHER)
+        ) {
+            value = lkconfig_conf__get_value_object ( sym );
+            if ( value == NULL ) {
+                Py_DECREF ( config_values );
+                return NULL;
+            }
+
+            if (
+                PyDict_SetItemString ( config_values, sym->name, value ) != 0
+            ) {
+                Py_DECREF ( value );
+                Py_DECREF ( config_values );
+                return NULL;
+            }
+            Py_DECREF ( value );
+        }
+
+        if ( menu->list ) {
+            menu = menu->list;
+            continue;
+        }
+        if ( menu->next ) {
+            menu = menu->next;
+        } else while ( (menu = menu->parent) ) {
+            if ( menu->next ) {
+                menu = menu->next;
+                break;
+            }
+        }
+    }
+
+    /* restore SYMBOL_WRITE */
+    sym_clear_all_valid();
+
+    return config_values;
+}
+
+
+/**
+ * Writes the current config to a minimal config file
+ * (as in "make savedefconfig"), with the GIL released.
+ *
+ * @param defconfig_file_out  output file
+ *
+ * @return return value of conf_write_defconfig(), 0 on success
+ * */
+static int lkconfig_conf__write_defconfig_file (
+    const char* const defconfig_file_out
+) {
+    struct lkconfig_prof_timer timer;
+    int ret;
+
+    Py_BEGIN_ALLOW_THREADS
+    lkconfig_prof_timer_start ( &timer );
+    ret = conf_write_defconfig ( defconfig_file_out );
+    /* conf_write_defconfig() leaves SYMBOL_WRITE cleared */
+    sym_clear_all_valid();
+    if ( ret == 0 ) { lkconfig_prof_count_file_size ( defconfig_file_out ); }
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_conf_write );
+    Py_END_ALLOW_THREADS
+
+    return ret;
+}
+
+
+/**
+ * Runs the oldconfig passes on the symbols currently loaded
+ * and returns the resolved config as config values dict.
+ * Optionally, also writes the resolved config to a .config file.
+ *
+ * Buffered config messages are flushed on success.
+ *
+ * @param cvars            conf vars
+ * @param config_file_out  output .config file or NULL
+ *
+ * @return new reference to config values dict, NULL on error
+ * */
+static PyObject* lkconfig_conf__run_values (
+    struct lkconfig_conf_vars* const cvars,
+    const char* const config_file_out
+) {
+    struct lkconfig_prof_timer timer;
+    PyObject* result;
+
+    if ( lkconfig_conf__run_passes ( cvars ) != 0 ) { return NULL; }
+
+    lkconfig_prof_timer_start ( &timer );
+    result = lkconfig_conf__get_values();
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_conf_values );
+
+    if ( (result != NULL) && (config_file_out != NULL) ) {
+        if ( lkconfig_conf__write_file ( config_file_out ) != 0 ) {
+            PyErr_Format (
+                PyExc_OSError,
+                "failed to write config file %s", config_file_out
+            );
+            Py_CLEAR ( result );
+        }
+    }
+
+    /* on error, buffered messages get discarded */
+    if ( (result != NULL) && (lkconfig_conf_main_flush_messages() != 0) ) {
+        Py_CLEAR ( result );
+    }
+
+    return result;
+}
+
+
+/**
+ * In-memory variant of lkconfig_conf_main().
+ *
+ * Loads the input config from a config values dict,
+ * runs oldconfig and returns the resolved config as config values dict.
+ * Optionally, also writes the resolved config to a .config file.
+ *
+ * @param config_values    input config values dict
+ * @param conf_decisions   decisions dict
+ * @param config_file_out  output .config file or NULL
+ * @param logger           logger or NULL
+ * @param changes          change records list or NULL
+ * @param incremental      whether to use incremental invalidation
+ *
+ * @return new reference to config values dict, NULL on error
+ * */
+static PyObject* lkconfig_conf_main_values (
+    PyObject* const config_values,
+    PyDictObject* const conf_decisions,
+    const char* const config_file_out,
+    PyObject* const logger,
+    PyObject* const changes,
+    const int incremental
+) {
+    struct lkconfig_conf_vars cvars;
+    struct lkconfig_prof_timer timer;
+    PyObject* result;
+    int ret;
+
+    if (
+        lkconfig_conf_main_init (
+            &cvars, conf_decisions, logger, changes, incremental
+        ) != 0
+    ) {
+        lkconfig_conf_main_free ( &cvars );
+        return NULL;
+    }
+
+    lkconfig_prof_timer_start ( &timer );
+    ret = lkconfig_conf__read_values ( &cvars, config_values );
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_conf_read );
+
+    if ( ret != 0 ) {
+        lkconfig_conf_main_free ( &cvars );
+        return NULL;
+    }
+
+    result = lkconfig_conf__run_values ( &cvars, config_file_out );
+
+    lkconfig_conf_main_free ( &cvars );
+    return result;
+}
+
+
+/**
+ * Saved user value and flags of a symbol, see lkconfig_conf_snapshot.
+ * */
+struct lkconfig_conf_symval {
+    struct symbol* sym;
+    int            flags;
+    tristate       tri;
+    /* copy of the string value for string-like symbols */
+    void*          val;
 };
 
-#define lkconfig_conf_get_tristate_str(tval) \
-    (((tval) == yes) ? "y" : (((tval) == mod) ? "m" : "n"))
+/**
+ * The user values of all symbols after reading the input config,
+ * restored before each run of lkconfig_conf_main_batch().
+ * */
+struct lkconfig_conf_snapshot {
+    struct lkconfig_conf_symval* symv;
+    size_t                       len;
+};
 
+#define lkconfig_conf_sym_has_string_value(sym) \
+    (((sym)->type == S_INT) || ((sym)->type == S_HEX) \
+        || ((sym)->type == S_STRING))
 
-/* this is used by lkconfig_conf_main()'s config message callback */
-static PyObject* lkconfig_conf_main_logger;
 
+static void lkconfig_conf_snapshot_init (
+    struct lkconfig_conf_snapshot* const snap
+) {
+    snap->symv = NULL;
+    snap->len  = 0;
+}
 
-static int lkconfig_conf_log_set_symbol (
-    struct lkconfig_conf_vars* const cvars,
-    struct symbol* const sym,
-    const char* const newval_str,
-    const char* const oldval_str
+static void lkconfig_conf_snapshot_free (
+    struct lkconfig_conf_snapshot* const snap
 ) {
-    if ( sym->name == NULL ) { return 0; }
+    size_t k;
 
-    if ( ! sym_has_value(sym) ) {
-        return lkconfig_log (
-            cvars->logger, lkconfig_debug,
-            "Setting symbol %s to \"%s\"",
-            sym->name, newval_str
-        );
-    } else if ( strcmp ( newval_str, oldval_str ) != 0 ) {
-        return lkconfig_log (
-            cvars->logger, lkconfig_debug,
-            "Setting symbol %s to \"%s\" (from \"%s\")",
-            sym->name, newval_str, oldval_str
-        );
-    } else {
-        return 0;
+    for ( k = 0; k < snap->len; k++ ) {
+        if ( lkconfig_conf_sym_has_string_value ( snap->symv [k].sym ) ) {
+            free ( snap->symv [k].val );
+        }
     }
+    PyMem_Free ( snap->symv );
+    lkconfig_conf_snapshot_init ( snap );
 }
 
+/**
+ * Saves the user values and flags of all symbols.
+ *
+ * @param snap  snapshot, initialized and empty
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_conf_snapshot_save (
+    struct lkconfig_conf_snapshot* const snap
+) {
+    struct lkconfig_conf_symval* symval;
+    struct symbol* sym;
+    size_t count;
+    int i;
 
-static int lkconfig_conf__conf (
-    struct lkconfig_conf_vars* const cvars, struct menu* const menu
-);
+    count = 0;
+    for_all_symbols(i, sym) { count++; }
 
-static int lkconfig_conf__check_conf (
-    struct lkconfig_conf_vars* const cvars, struct menu* const menu
-);
+    snap->symv = PyMem_Malloc ( (count + 1) * sizeof *(snap->symv) );
+    if ( snap->symv == NULL ) { PyErr_NoMemory(); return -1; }
 
+    for_all_symbols(i, sym) {
+        symval        = &(snap->symv [snap->len]);
+        symval->sym   = sym;
+        symval->flags = sym->flags;
+        symval->tri   = sym->def[S_DEF_USER].tri;
+        symval->val   = sym->def[S_DEF_USER].val;
 
-static void lkconfig_conf_main_message_callback (
-    const char* fmt, va_list ap
-) {
-    PyObject* exc_type;
-    PyObject* exc_value;
-    PyObject* exc_traceback;
+        if (
+            lkconfig_conf_sym_has_string_value ( sym )
+            && (symval->val != NULL)
+        ) {
+            symval->val = strdup ( symval->val );
+            if ( symval->val == NULL ) {
+                PyErr_NoMemory();
+                return -1;
+            }
+        }
 
-    if ( lkconfig_conf_main_logger == NULL ) { return; }
+        (snap->len)++;
+    }
 
-    PyErr_Fetch ( &exc_type, &exc_value, &exc_traceback );
-    (void) lkconfig_logv ( lkconfig_conf_main_logger, lkconfig_debug, fmt, ap );
-    PyErr_Restore ( exc_type, exc_value, exc_traceback );
+    return 0;
 }
 
-static void lkconfig_conf_main_clear_logger_and_callback (void) {
-    conf_set_message_callback ( NULL );
-    lkconfig_conf_main_logger = NULL;
+/**
+ * Restores the user values and flags of all symbols
+ * and invalidates all symbol values.
+ *
+ * @param snap  snapshot
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_conf_snapshot_restore (
+    struct lkconfig_conf_snapshot* const snap
+) {
+    struct lkconfig_conf_symval* symval;
+    struct symbol* sym;
+    char* strval;
+    size_t k;
+
+    for ( k = 0; k < snap->len; k++ ) {
+        symval = &(snap->symv [k]);
+        sym    = symval->sym;
+
+        if ( lkconfig_conf_sym_has_string_value ( sym ) ) {
+            strval = NULL;
+            if ( symval->val != NULL ) {
+                strval = strdup ( symval->val );
+                if ( strval == NULL ) { PyErr_NoMemory(); return -1; }
+            }
+
+            free ( sym->def[S_DEF_USER].val );
+            sym->def[S_DEF_USER].val = strval;
+
+        } else {
+            sym->def[S_DEF_USER].val = symval->val;
+        }
+
+        sym->def[S_DEF_USER].tri = symval->tri;
+        sym->flags               = symval->flags;
+    }
+
+    sym_clear_all_valid();
+    return 0;
 }
 
 
-static int lkconfig_conf_main (
+/**
+ * Batch variant of lkconfig_conf_main_values().
+ *
+ * Loads the input config once, either from a .config file
+ * or from a config values dict, and runs oldconfig for each decisions dict.
+ * The symbol values are restored to the input config between runs,
+ * so that each result is the same as that of an individual run.
+ *
+ * @param config_file_in   input .config file or NULL
+ * @param config_values    input config values dict,
+ *                         only used if config_file_in is NULL
+ * @param decisions_seq    sequence of decisions dicts (PySequence_Fast)
+ * @param outfiles_seq     NULL or sequence of output .config file
+ *                         str or None objects (PySequence_Fast),
+ *                         with the same length as decisions_seq
+ * @param logger           logger or NULL
+ * @param record_changes   whether to return change records
+ * @param incremental      whether to use incremental invalidation
+ *
+ * @return new reference to a list of config values dicts,
+ *         or of 2-tuples (config values dict, change records list)
+ *         if record_changes is set, NULL on error
+ * */
+static PyObject* lkconfig_conf_main_batch (
     const char* const config_file_in,
-    const char* const config_file_out,
-    PyDictObject* const conf_decisions,
-    PyObject* const logger
+    PyObject* const config_values,
+    PyObject* const decisions_seq,
+    PyObject* const outfiles_seq,
+    PyObject* const logger,
+    const int record_changes,
+    const int incremental
 ) {
     struct lkconfig_conf_vars cvars;
+    struct lkconfig_conf_snapshot snap;
+    struct lkconfig_prof_timer timer;
+    const char* outfile;
+    PyObject* outfile_obj;
+    PyObject* changes;
+    PyObject* result;
+    PyObject* results;
+    Py_ssize_t nvariants;
+    Py_ssize_t k;
+    int ret;
 
-    cvars.conf_decisions = (PyObject*) conf_decisions;
-    cvars.logger = logger;
+    nvariants = PySequence_Fast_GET_SIZE ( decisions_seq );
 
-    lkconfig_conf_main_logger = logger;
-    conf_set_message_callback ( lkconfig_conf_main_message_callback );
+    results = PyList_New ( nvariants );
+    if ( results == NULL ) { return NULL; }
+
+    if (
+        lkconfig_conf_main_init (
+            &cvars, NULL, logger, NULL, incremental
+        ) != 0
+    ) {
+        lkconfig_conf_main_free ( &cvars );
+        Py_DECREF ( results );
+        return NULL;
+    }
+
+    /* load the input config */
+    lkconfig_prof_timer_start ( &timer );
+    if ( config_file_in != NULL ) {
+        ret = lkconfig_conf__read_file ( &cvars, config_file_in );
+    } else {
+        ret = lkconfig_conf__read_values ( &cvars, config_values );
+    }
+    lkconfig_prof_timer_stop ( &timer, lkconfig_prof_conf_read );
 
-    conf_read ( config_file_in );
+    if ( (ret >= 0) && (config_file_in != NULL) ) {
+        ret = lkconfig_conf_main_flush_messages();
+    }
 
-    do {
-        cvars.conf_cnt = 0;
-        if ( lkconfig_conf__check_conf ( &cvars, &rootmenu ) < 0 ) {
-            lkconfig_conf_main_clear_logger_and_callback();
-            return -1;
+    lkconfig_conf_snapshot_init ( &snap );
+    if ( ret == 0 ) { ret = lkconfig_conf_snapshot_save ( &snap ); }
+
+    for ( k = 0; (ret == 0) && (k < nvariants); k++ ) {
+        result  = NULL;
+        changes = NULL;
+
+        outfile = NULL;
+        if ( outfiles_seq != NULL ) {
+            outfile_obj = PySequence_Fast_GET_ITEM ( outfiles_seq, k );
+            if ( outfile_obj != Py_None ) {
+                outfile = PyUnicode_AsUTF8 ( outfile_obj );
+                if ( outfile == NULL ) { ret = -1; break; }
+            }
         }
-    } while ( cvars.conf_cnt );
 
+        if ( record_changes ) {
+            changes = PyList_New(0);
+            if ( changes == NULL ) { ret = -1; break; }
+        }
 
-    conf_write ( config_file_out );
+        /* the first variant runs on the freshly loaded config */
+        if ( k > 0 ) {
+            if ( lkconfig_conf_snapshot_restore ( &snap ) != 0 ) {
+                Py_XDECREF ( changes );
+                ret = -1;
+                break;
+            }
+            if ( cvars.depgraph != NULL ) {
+                lkconfig_depgraph_defer_all ( cvars.depgraph );
+            }
+        }
 
-    lkconfig_conf_main_clear_logger_and_callback();
-    return 0;
-}
+        if (
+            lkconfig_conf__load_decisions (
+                &cvars, PySequence_Fast_GET_ITEM ( decisions_seq, k )
+            ) != 0
+        ) {
+            Py_XDECREF ( changes );
+            ret = -1;
+            break;
+        }
+        cvars.changes = changes;
 
+        result = lkconfig_conf__run_values ( &cvars, outfile );
+        if ( result == NULL ) {
+            Py_XDECREF ( changes );
+            ret = -1;
+            break;
+        }
 
-static int lkconfig_conf__conf_askvalue_decisions (
-    struct lkconfig_conf_vars* const cvars,
-    struct symbol* const sym,
-    PyObject** const entry_out
-) {
-    *entry_out = NULL;
+        if ( changes != NULL ) {
+            result = Py_BuildValue ( "(NN)", result, changes );
+            if ( result == NULL ) { ret = -1; break; }
+        }
 
-    if ( ! sym_is_changable(sym) ) {
-        return 0;
+        /* steals reference to result */
+        PyList_SET_ITEM ( results, k, result );
     }
 
-    if ( sym->name ) {
-        *entry_out = PyDict_GetItemString ( cvars->conf_decisions, sym->name );
-        /* borrowed ref */
+    lkconfig_conf_snapshot_free ( &snap );
+    lkconfig_conf_main_free ( &cvars );
+
+    if ( ret != 0 ) {
+        Py_DECREF ( results );
+        return NULL;
     }
 
-    return 1;
+    return results;
 }
 
+#undef lkconfig_conf_sym_has_string_value
+
+
 static int lkconfig_conf__conf_get_tristate_decision_value (
-    struct lkconfig_conf_vars* const cvars,
     struct symbol* const sym,
     PyObject* const decision_entry,
     tristate* const trival_out
@@ -149,9 +1922,10 @@ static int lkconfig_conf__conf_get_tristate_decision_value (
             break;
 
         default:
+            if ( (decval == -1) && PyErr_Occurred() ) { return -1; }
             PyErr_Format (
                 PyExc_ValueError,
-                "bad decision value for tristate symbol %s: %d",
+                "bad decision value for tristate symbol %s: %ld",
                 sym->name, decval
             );
             return -1;
@@ -161,6 +1935,204 @@ static int lkconfig_conf__conf_get_tristate_decision_value (
 }
 
 
+/**
+ * Converts a decisions dict entry.
+ *
+ * Tristate/boolean symbols accept int 0/1/2,
+ * string-like symbols accept str or int 0 (disable).
+ *
+ * @param sym        symbol
+ * @param entry      decision value
+ * @param decision   decision, unset
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_conf__convert_decision (
+    struct symbol* const sym,
+    PyObject* const entry,
+    struct lkconfig_conf_decision* const decision
+) {
+    PyObject* bytes_obj;
+    const char* strval;
+    size_t len;
+
+    decision->tri    = no;
+    decision->strval = NULL;
+
+    switch ( sym->type ) {
+        case S_INT:
+        case S_HEX:
+        case S_STRING:
+            if ( PyUnicode_Check ( entry ) ) {
+                bytes_obj = PyUnicode_AsASCIIString ( entry );  /* new ref */
+                if ( bytes_obj == NULL ) { return -1; }
+
+                strval = PyBytes_AS_STRING ( bytes_obj );
+                len    = (size_t) PyBytes_GET_SIZE ( bytes_obj );
+
+                decision->strval = PyMem_Malloc ( len + 1 );
+                if ( decision->strval == NULL ) {
+                    Py_DECREF ( bytes_obj );
+                    PyErr_NoMemory();
+                    return -1;
+                }
+                memcpy ( decision->strval, strval, len + 1 );
+                Py_DECREF ( bytes_obj );
+                return 0;
+
+            } else if ( PyLong_Check ( entry ) ) {
+                if (
+                    lkconfig_conf__conf_get_tristate_decision_value (
+                        sym, entry, &(decision->tri)
+                    ) != 0
+                ) {
+                    return -1;
+                }
+
+                if ( decision->tri != no ) {
+                    PyErr_Format (
+                        PyExc_ValueError,
+                        "bad tristate decision value from string symbol %s: %d",
+                        sym->name, decision->tri
+                    );
+                    return -1;
+                }
+                return 0;
+
+            } else {
+                PyErr_Format (
+                    PyExc_ValueError,
+                    "bad decision value for string symbol %s", sym->name
+                );
+                return -1;
+            }
+
+        default:
+            if ( PyLong_Check ( entry ) ) {
+                return lkconfig_conf__conf_get_tristate_decision_value (
+                    sym, entry, &(decision->tri)
+                );
+
+            } else {
+                PyErr_Format (
+                    PyExc_ValueError,
+                    "bad decision value for tristate symbol %s", sym->name
+                );
+                return -1;
+            }
+    }
+}
+
+
+static void lkconfig_conf__free_decisions (
+    struct lkconfig_conf_vars* const cvars
+) {
+    size_t k;
+
+    for ( k = 0; k < cvars->decision_count; k++ ) {
+        PyMem_Free ( cvars->decisionv [k].strval );
+    }
+    PyMem_Free ( cvars->decisionv );
+
+    cvars->decisionv      = NULL;
+    cvars->decision_count = 0;
+    lkconfig_ptrmap_free ( &(cvars->decision_index) );
+}
+
+
+/**
+ * Converts the decisions dict into a table indexed by symbol,
+ * replacing any previously loaded decisions.
+ * Decisions for unknown symbols are ignored.
+ *
+ * This is done once per oldconfig run,
+ * so that the conf passes do not need to look up and convert
+ * dict entries for each visited symbol.
+ *
+ * @param cvars           conf vars
+ * @param conf_decisions  decisions dict
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_conf__load_decisions (
+    struct lkconfig_conf_vars* const cvars, PyObject* const conf_decisions
+) {
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t pos;
+    const char* name;
+    struct symbol* sym;
+
+    lkconfig_conf__free_decisions ( cvars );
+
+    cvars->decisionv = PyMem_Malloc (
+        ((size_t) PyDict_Size ( conf_decisions ) + 1)
+        * sizeof *(cvars->decisionv)
+    );
+    if ( cvars->decisionv == NULL ) { PyErr_NoMemory(); return -1; }
+
+    pos = 0;
+    while ( PyDict_Next ( conf_decisions, &pos, &key, &value ) ) {
+        name = PyUnicode_AsUTF8 ( key );
+        if ( name == NULL ) { return -1; }
+
+        sym = lkconfig_symindex_find_symbol ( name );
+        if ( (sym == NULL) || (sym->type == S_UNKNOWN) ) { continue; }
+
+        if (
+            lkconfig_conf__convert_decision (
+                sym, value, &(cvars->decisionv [cvars->decision_count])
+            ) != 0
+        ) {
+            return -1;
+        }
+        (cvars->decision_count)++;
+
+        if (
+            lkconfig_ptrmap_set (
+                &(cvars->decision_index), sym,
+                (int) (cvars->decision_count - 1)
+            ) != 0
+        ) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * Looks up the decision for a symbol.
+ *
+ * @param cvars         conf vars
+ * @param sym           symbol
+ * @param decision_out  decision or NULL if no decision exists
+ *
+ * @return 0 if the symbol is not changeable, else 1
+ * */
+static int lkconfig_conf__conf_askvalue_decisions (
+    struct lkconfig_conf_vars* const cvars,
+    struct symbol* const sym,
+    const struct lkconfig_conf_decision** const decision_out
+) {
+    const int* idx;
+
+    *decision_out = NULL;
+
+    if ( ! sym_is_changable(sym) ) {
+        return 0;
+    }
+
+    idx = lkconfig_ptrmap_get ( &(cvars->decision_index), sym );
+    if ( idx != NULL ) {
+        *decision_out = &(cvars->decisionv [*idx]);
+    }
+
+    return 1;
+}
+
+
 
 static int lkconfig_conf__conf_askvalue_tristate (
     struct lkconfig_conf_vars* const cvars,
@@ -168,29 +2140,19 @@ static int lkconfig_conf__conf_askvalue_tristate (
     tristate oldval,
     tristate* const newval_out
 ) {
-    PyObject* entry;
+    const struct lkconfig_conf_decision* decision;
     int ret;
 
     /* unless further information exists, use the default value */
     *newval_out = oldval;
 
-    /* entry: borrowed ref */
-    ret = lkconfig_conf__conf_askvalue_decisions ( cvars, sym, &entry );
+    ret = lkconfig_conf__conf_askvalue_decisions ( cvars, sym, &decision );
     if ( ret <= 0 ) { return ret; }
 
-    if ( entry == NULL ) {
-        ;
-
-    } else if ( PyLong_Check ( entry ) ) {
-        if (
-            lkconfig_conf__conf_get_tristate_decision_value (
-                cvars, sym, entry, newval_out
-            ) != 0
-        ) {
-            return -1;
-        }
+    if ( decision != NULL ) {
+        *newval_out = decision->tri;
 
-         if ( ! sym_tristate_within_range ( sym, *newval_out ) ) {
+        if ( ! sym_tristate_within_range ( sym, *newval_out ) ) {
             PyErr_Format (
                 PyExc_ValueError,
                 "impossible decision value for tristate symbol %s: %d",
@@ -198,16 +2160,8 @@ static int lkconfig_conf__conf_askvalue_tristate (
             );
             return -1;
         }
-
-    } else {
-        PyErr_Format (
-            PyExc_ValueError,
-            "bad decision value for tristate symbol %s", sym->name
-        );
-        return -1;
     }
 
-
     return 1;
 }
 
@@ -243,7 +2197,7 @@ static int lkconfig_conf__conf_sym (
         }
     }
 
-    if ( sym_set_tristate_value ( sym, newval ) ) {
+    if ( lkconfig_conf__sym_set_tristate_value ( cvars, sym, newval ) ) {
         return 0;
     } else {
         PyErr_Format (
@@ -259,89 +2213,48 @@ static int lkconfig_conf__conf_sym (
 static int lkconfig_conf__conf_string (
     struct lkconfig_conf_vars* const cvars, struct menu* const menu
 ) {
-    PyObject* entry;
-    PyObject* decision_value;
+    const struct lkconfig_conf_decision* decision;
     struct symbol* sym;
     const char* def;
     const char* newval;
-    tristate trival;
     int ret;
 
     sym = menu->sym;
     def = sym_get_string_value ( sym );
     newval = def;
 
-    /* entry: borrowed ref */
-    ret = lkconfig_conf__conf_askvalue_decisions ( cvars, sym, &entry );
+    ret = lkconfig_conf__conf_askvalue_decisions ( cvars, sym, &decision );
     if ( ret <= 0 ) { return ret; }
 
-    if ( ! sym_is_changable(sym) ) {
-        return 0;
-    }
-
-    decision_value = NULL;
-
-    if ( entry == NULL ) {
+    if ( decision == NULL ) {
         ;
 
-    } else if ( PyUnicode_Check ( entry ) ) {
-        decision_value = PyUnicode_AsASCIIString ( entry );  /* new ref */
-        if ( decision_value == NULL ) { return -1; }
-
-        newval = PyBytes_AsString ( decision_value );
-        if ( newval == NULL ) {
-            Py_DECREF ( decision_value );
-            return -1;
-        }
+    } else if ( decision->strval != NULL ) {
+        newval = decision->strval;
 
-    } else if ( PyLong_Check ( entry ) ) {
+    } else if (
+        def && *def && lkconfig_conf_log_enabled ( cvars, lkconfig_warning )
+    ) {
+        /* decision is "disable", which keeps the current value */
+        /* a decision implies non-NULL sym->name */
         if (
-            lkconfig_conf__conf_get_tristate_decision_value (
-                cvars, sym, entry, &trival
+            lkconfig_log (
+                cvars->logger, lkconfig_warning,
+                "Setting disabled string-like symbol %s",
+                sym->name
             ) != 0
         ) {
             return -1;
         }
-
-        switch ( trival ) {
-            case no:
-                if ( def && *def ) {
-                    /* non-NULL entry implies non-NULL sym->name */
-                    if (
-                        lkconfig_log (
-                            cvars->logger, lkconfig_warning,
-                            "Setting disabled string-like symbol %s",
-                            sym->name
-                        ) != 0
-                    ) {
-                        return -1;
-                    }
-                }
-                break;
-
-            default:
-                PyErr_Format (
-                    PyExc_ValueError,
-                    "bad tristate decision value from string symbol %s: %d",
-                    sym->name, trival
-                );
-                return -1;
-        }
-
-    } else {
-        PyErr_Format (
-            PyExc_ValueError,
-            "bad decision value for string symbol %s", sym->name
-        );
-        return -1;
     }
 
     if ( lkconfig_conf_log_set_symbol ( cvars, sym, newval, def ) != 0 ) {
-        newval = NULL; Py_XDECREF ( decision_value );
         return -1;
     }
 
-    ret = sym_set_string_value ( sym, newval ) ? 0 : -1;
+    ret = (
+        lkconfig_conf__sym_set_string_value ( cvars, sym, newval ) ? 0 : -1
+    );
     if ( ret < 0 ) {
         PyErr_Format (
             PyExc_ValueError,
@@ -350,7 +2263,6 @@ static int lkconfig_conf__conf_string (
         );
     }
 
-    newval = NULL; Py_XDECREF ( decision_value );
     return ret;
 }
 
@@ -370,7 +2282,7 @@ static int lkconfig_conf__conf_choice (
 
     if ( sym_is_changable(sym) ) {
         if ( lkconfig_conf__conf_sym ( cvars, menu ) < 0 ) { return -1; }
-        sym_calc_value ( sym );
+        lkconfig_prof_sym_calc_value ( sym );
         switch ( sym_get_tristate_value(sym) ) {
             case no:
                 return 1;
@@ -439,7 +2351,8 @@ lkconfig_conf__conf_choice_childs:
         return -1;
     }
 
-    sym_set_choice_value ( sym, child->sym );
+    /* see sym_set_choice_value() */
+    lkconfig_conf__sym_set_tristate_value ( cvars, child->sym, yes );
     for ( child = child->list; child; child = child->next ) {
         if ( lkconfig_conf__conf ( cvars, child ) < 0 ) { return -1; }
     }
@@ -530,3 +2443,4 @@ static int lkconfig_conf__check_conf (
 
 
 #undef lkconfig_conf_get_tristate_str
+#undef lkconfig_conf_log_enabled
@@ -0,0 +1,591 @@
+/*
+ * Streaming .config reader.
+ *
+ * The file is mmap-ed and tokenized in place, line by line,
+ * instead of being copied byte-wise into a line buffer.
+ * Files that cannot be mapped (pipes, character devices)
+ * are read into a buffer instead.
+ * Each line is split into name and value spans that point into the
+ * mapped file, so that nothing needs to be allocated per line.
+ *
+ * The tokenizer is shared by lkconfig_conf__read_file(),
+ * which replaces lkc's conf_read() for oldconfig,
+ * and read_config_file(), which is used by the Python config loader.
+ *
+ * Accepted lines are
+ *
+ *   <name>=<value>[...]
+ *   # <name> is not set[...]
+ *   # comment
+ *
+ * where <name> consists of [A-Za-z0-9_] and <value> is either
+ * a double- or single-quoted string (backslash escapes are skipped)
+ * or a sequence of non-whitespace chars.
+ *
+ * As in lkc's conf_read_simple(), "is not set" is a prefix match.
+ * Unlike lkc, its words may be separated by any amount of whitespace.
+ *
+ * The tokenizer does not check what follows <value>, this is up to
+ * the caller: oldconfig passes the rest of the line to the symbol,
+ * like lkc does, whereas read_config_file() accepts a trailing comment
+ * only, like the regex-based reader in kernelconfig.kconfig.config.data.
+ *
+ * The tokenizer functions do not involve python objects
+ * and may be called without holding the GIL.
+ *
+ * */
+
+#include <errno.h>      /* lkconfig_confread_open() */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+static int lkconfig_confread_is_space ( const char c ) {
+    switch ( c ) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\v':
+        case '\f':
+        case '\r':
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+static int lkconfig_confread_is_name_char ( const char c ) {
+    return (
+        ((c >= 'A') && (c <= 'Z'))
+        || ((c >= 'a') && (c <= 'z'))
+        || ((c >= '0') && (c <= '9'))
+        || (c == '_')
+    );
+}
+
+
+static void lkconfig_confread_init ( struct lkconfig_confread* const cr ) {
+    cr->data     = NULL;
+    cr->size     = 0;
+    cr->is_mmap  = 0;
+    cr->is_alloc = 0;
+    cr->pos      = 0;
+    cr->lineno   = 0;
+}
+
+
+/**
+ * Unmaps or frees a .config file and resets the reader to the empty state.
+ *
+ * @param cr  reader
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_confread_close ( struct lkconfig_confread* const cr ) {
+    if ( cr->is_mmap ) {
+        munmap ( (void*) cr->data, cr->size );
+    } else if ( cr->is_alloc ) {
+        PyMem_RawFree ( (void*) cr->data );
+    }
+    lkconfig_confread_init ( cr );
+}
+
+
+/**
+ * Reads a file that cannot be mapped into a growing buffer.
+ *
+ * @param cr  reader, must be empty
+ * @param fd  file descriptor, not closed by this function
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_confread__read_fd (
+    struct lkconfig_confread* const cr, const int fd
+) {
+    char* buf;
+    char* new_buf;
+    size_t cap;
+    size_t len;
+    ssize_t nread;
+
+    buf = NULL;
+    cap = 0;
+    len = 0;
+
+    for (;;) {
+        if ( len == cap ) {
+            cap     = (cap == 0) ? 8192 : (2 * cap);
+            new_buf = PyMem_RawRealloc ( buf, cap );
+            if ( new_buf == NULL ) {
+                PyMem_RawFree ( buf );
+                errno = ENOMEM;
+                return -1;
+            }
+            buf = new_buf;
+        }
+
+        nread = read ( fd, (buf + len), (cap - len) );
+        if ( nread > 0 ) {
+            len += (size_t) nread;
+        } else if ( nread == 0 ) {
+            break;
+        } else if ( errno != EINTR ) {
+            PyMem_RawFree ( buf );
+            return -1;
+        }
+    }
+
+    cr->data     = buf;
+    cr->size     = len;
+    cr->is_alloc = 1;
+    return 0;
+}
+
+
+/**
+ * Maps a .config file into memory,
+ * or reads it into a buffer if it is not a regular file.
+ * The reader must be empty (initialized with lkconfig_confread_init()).
+ *
+ * @param cr        reader
+ * @param filename  path to the .config file
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_confread_open (
+    struct lkconfig_confread* const cr, const char* const filename
+) {
+    struct stat stat_info;
+    void* data;
+    int fd;
+    int esav;
+
+    fd = open ( filename, O_RDONLY | O_CLOEXEC );
+    if ( fd < 0 ) { return -1; }
+
+    if ( fstat ( fd, &stat_info ) != 0 ) {
+        esav = errno;
+        close ( fd );
+        errno = esav;
+        return -1;
+    }
+
+    if ( ! S_ISREG ( stat_info.st_mode ) ) {
+        /* pipes, /dev/null, <(...) */
+        if ( lkconfig_confread__read_fd ( cr, fd ) != 0 ) {
+            esav = errno;
+            close ( fd );
+            errno = esav;
+            return -1;
+        }
+        close ( fd );
+        return 0;
+    }
+
+    /* empty files cannot be mapped, they are represented by data=NULL */
+    if ( stat_info.st_size > 0 ) {
+        data = mmap (
+            NULL, (size_t) stat_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0
+        );
+        if ( data == MAP_FAILED ) {
+            esav = errno;
+            close ( fd );
+            errno = esav;
+            return -1;
+        }
+
+        /* the file is read sequentially, exactly once */
+        madvise ( data, (size_t) stat_info.st_size, MADV_SEQUENTIAL );
+
+        cr->data    = data;
+        cr->size    = (size_t) stat_info.st_size;
+        cr->is_mmap = 1;
+    }
+
+    close ( fd );
+    return 0;
+}
+
+
+/**
+ * Maps a .config file into memory, looking it up like lkc does:
+ * relative to the current working directory first,
+ * and then relative to $srctree (see zconf_fopen()).
+ *
+ * @param cr        reader
+ * @param filename  path to the .config file
+ *
+ * @return 0 on success, else -1 (errno set)
+ * */
+static int lkconfig_confread_open_lkc (
+    struct lkconfig_confread* const cr, const char* const filename
+) {
+    char fullname[PATH_MAX+1];
+    const char* env;
+    int ret;
+
+    ret = lkconfig_confread_open ( cr, filename );
+
+    if ( (ret != 0) && (filename[0] != '/') ) {
+        env = getenv ( SRCTREE );
+        if (
+            (env != NULL)
+            && (
+                snprintf ( fullname, sizeof fullname, "%s/%s", env, filename )
+                < (int) sizeof fullname
+            )
+        ) {
+            ret = lkconfig_confread_open ( cr, fullname );
+        }
+    }
+
+    return ret;
+}
+
+
+/**
+ * Splits '<name>[ws]...' into name span and remainder.
+ *
+ * @return length of the name, 0 if s does not start with a name char
+ * */
+static size_t lkconfig_confread_scan_name (
+    const char* const s, const size_t len
+) {
+    size_t k;
+
+    for ( k = 0; (k < len) && lkconfig_confread_is_name_char ( s[k] ); k++ ) {
+        ;
+    }
+    return k;
+}
+
+
+/**
+ * Scans a value token.
+ *
+ * Quoted values extend to the closing quote,
+ * and backslash-escaped chars are skipped.
+ * Other values (and quoted values without closing quote)
+ * extend to the next whitespace char.
+ *
+ * @return length of the value token, 0 if empty
+ * */
+static size_t lkconfig_confread_scan_value (
+    const char* const s, const size_t len
+) {
+    size_t k;
+
+    if ( (len > 0) && ((s[0] == '"') || (s[0] == '\'')) ) {
+        for ( k = 1; k < len; k++ ) {
+            if ( s[k] == '\\' ) {
+                k++;
+            } else if ( s[k] == s[0] ) {
+                return k + 1;
+            }
+        }
+        /* no closing quote, fall back to unquoted */
+    }
+
+    for ( k = 0; (k < len) && ! lkconfig_confread_is_space ( s[k] ); k++ ) {
+        ;
+    }
+    return k;
+}
+
+
+/**
+ * Skips a word that must be followed by whitespace or EOL,
+ * and the whitespace after it.
+ *
+ * @return number of chars to skip, 0 if the word does not match
+ * */
+static size_t lkconfig_confread_skip_word (
+    const char* const s, const size_t len,
+    const char* const word, const size_t word_len
+) {
+    size_t k;
+
+    if ( (len < word_len) || (memcmp ( s, word, word_len ) != 0) ) {
+        return 0;
+    }
+
+    k = word_len;
+    if ( (k < len) && ! lkconfig_confread_is_space ( s[k] ) ) { return 0; }
+
+    for ( ; (k < len) && lkconfig_confread_is_space ( s[k] ); k++ ) {
+        ;
+    }
+    return k;
+}
+
+
+/**
+ * Tokenizes a line (without trailing whitespace).
+ *
+ * @param tok  line token, line/line_len must be set
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_confread_tokenize_line (
+    struct lkconfig_confread_line* const tok
+) {
+    const char* const s = tok->line;
+    const size_t len    = tok->line_len;
+    const char* eq;
+    size_t name_len;
+    size_t value_len;
+    size_t k;
+    size_t skip;
+
+    tok->kind      = LKCONFIG_CONFREAD_INVALID;
+    tok->name      = NULL;
+    tok->name_len  = 0;
+    tok->value     = NULL;
+    tok->value_len = 0;
+
+    if ( len == 0 ) {
+        tok->kind = LKCONFIG_CONFREAD_NONE;
+
+    } else if ( s[0] == '#' ) {
+        tok->kind = LKCONFIG_CONFREAD_NONE;
+
+        /* "#" ws* <name> ws+ "is" ws+ "not" ws+ "set" ... */
+        for ( k = 1; (k < len) && lkconfig_confread_is_space ( s[k] ); k++ ) {
+            ;
+        }
+
+        name_len = lkconfig_confread_scan_name ( (s + k), (len - k) );
+        if ( name_len == 0 ) { return; }
+        tok->name     = (s + k);
+        tok->name_len = name_len;
+        k += name_len;
+
+        if ( (k >= len) || ! lkconfig_confread_is_space ( s[k] ) ) { return; }
+        for ( ; (k < len) && lkconfig_confread_is_space ( s[k] ); k++ ) {
+            ;
+        }
+
+        skip = lkconfig_confread_skip_word ( (s + k), (len - k), "is", 2 );
+        if ( skip == 0 ) { return; }
+        k += skip;
+
+        skip = lkconfig_confread_skip_word ( (s + k), (len - k), "not", 3 );
+        if ( skip == 0 ) { return; }
+        k += skip;
+
+        /* prefix match, like lkc's strncmp(p, "is not set", 10) */
+        if ( ((len - k) >= 3) && (memcmp ( (s + k), "set", 3 ) == 0) ) {
+            tok->kind = LKCONFIG_CONFREAD_UNSET;
+        }
+
+    } else {
+        eq = memchr ( s, '=', len );
+        if ( eq == NULL ) { return; }
+
+        name_len = (size_t) (eq - s);
+        if (
+            (name_len == 0)
+            || (lkconfig_confread_scan_name ( s, name_len ) != name_len)
+        ) {
+            return;
+        }
+
+        k = name_len + 1;
+        value_len = lkconfig_confread_scan_value ( (s + k), (len - k) );
+        if ( value_len == 0 ) { return; }
+
+        tok->name      = s;
+        tok->name_len  = name_len;
+        tok->value     = (s + k);
+        tok->value_len = value_len;
+        tok->kind = LKCONFIG_CONFREAD_VALUE;
+    }
+}
+
+
+/**
+ * Reads and tokenizes the next line.
+ *
+ * @param cr   reader
+ * @param tok  line token, filled on success
+ *
+ * @return 1 if a line has been read, 0 at end of file
+ * */
+static int lkconfig_confread_next (
+    struct lkconfig_confread* const cr,
+    struct lkconfig_confread_line* const tok
+) {
+    const char* line;
+    const char* eol;
+    size_t line_len;
+    size_t rem;
+
+    if ( cr->pos >= cr->size ) { return 0; }
+
+    line = cr->data + cr->pos;
+    rem  = cr->size - cr->pos;
+
+    /* memchr() is vectorized by the C library */
+    eol = memchr ( line, '\n', rem );
+    if ( eol == NULL ) {
+        line_len = rem;
+        cr->pos  = cr->size;
+    } else {
+        line_len = (size_t) (eol - line);
+        cr->pos += line_len + 1;
+    }
+
+    while (
+        (line_len > 0) && lkconfig_confread_is_space ( line[line_len-1] )
+    ) {
+        line_len--;
+    }
+
+    (cr->lineno)++;
+    tok->lineno   = cr->lineno;
+    tok->line     = line;
+    tok->line_len = line_len;
+    lkconfig_confread_tokenize_line ( tok );
+    return 1;
+}
+
+
+/**
+ * Checks whether the value of a VALUE line is followed by
+ * nothing or whitespace and a comment.
+ *
+ * @param tok  VALUE line token
+ *
+ * @return non-zero if so, else 0
+ * */
+static int lkconfig_confread_value_is_followed_by_comment (
+    const struct lkconfig_confread_line* const tok
+) {
+    const char* const s = tok->value;
+    const size_t len    = (size_t) ((tok->line + tok->line_len) - s);
+    size_t k;
+
+    k = tok->value_len;
+    if ( k >= len ) { return 1; }
+    if ( ! lkconfig_confread_is_space ( s[k] ) ) { return 0; }
+
+    for ( ; (k < len) && lkconfig_confread_is_space ( s[k] ); k++ ) {
+        ;
+    }
+    return ( (k < len) && (s[k] == '#') );
+}
+
+
+/**
+ * Creates a str object from a span.
+ *
+ * @return new reference, NULL on error (python exception set)
+ * */
+static PyObject* lkconfig_confread_span_to_str (
+    const char* const s, const size_t len
+) {
+    return PyUnicode_DecodeUTF8 ( s, (Py_ssize_t) len, "strict" );
+}
+
+
+/**
+ * Reads a .config file and returns its entries as list of
+ * 3-tuples (line number, option name, value str or None).
+ *
+ * Values are returned as they appear in the file (quotes are kept),
+ * None means "is not set". Comments and blank lines are skipped.
+ *
+ * @param filename  path to the .config file
+ *
+ * @return new reference to list, NULL on error (python exception set)
+ * */
+static PyObject* lkconfig_confread_read_entries (
+    const char* const filename
+) {
+    struct lkconfig_confread cr;
+    struct lkconfig_confread_line tok;
+    PyObject* entries;
+    PyObject* name_obj;
+    PyObject* value_obj;
+    PyObject* entry;
+    int ret;
+
+    lkconfig_confread_init ( &cr );
+
+    Py_BEGIN_ALLOW_THREADS
+    ret = lkconfig_confread_open ( &cr, filename );
+    Py_END_ALLOW_THREADS
+
+    if ( ret != 0 ) {
+        PyErr_SetFromErrnoWithFilename ( PyExc_OSError, filename );
+        return NULL;
+    }
+
+    entries = PyList_New ( 0 );
+    if ( entries == NULL ) {
+        lkconfig_confread_close ( &cr );
+        return NULL;
+    }
+
+    while ( lkconfig_confread_next ( &cr, &tok ) ) {
+        if (
+            (tok.kind == LKCONFIG_CONFREAD_VALUE)
+            && ! lkconfig_confread_value_is_followed_by_comment ( &tok )
+        ) {
+            tok.kind = LKCONFIG_CONFREAD_INVALID;
+        }
+
+        switch ( tok.kind ) {
+            case LKCONFIG_CONFREAD_NONE:
+                continue;
+
+            case LKCONFIG_CONFREAD_VALUE:
+                value_obj = lkconfig_confread_span_to_str (
+                    tok.value, tok.value_len
+                );
+                if ( value_obj == NULL ) { goto err; }
+                break;
+
+            case LKCONFIG_CONFREAD_UNSET:
+                Py_INCREF ( Py_None );
+                value_obj = Py_None;
+                break;
+
+            default:
+                /* PyErr_Format() does not support %.*s */
+                value_obj = lkconfig_confread_span_to_str (
+                    tok.line, tok.line_len
+                );
+                if ( value_obj == NULL ) { goto err; }
+
+                PyErr_Format (
+                    PyExc_ValueError, "%s:%u: unexpected data: %U",
+                    filename, tok.lineno, value_obj
+                );
+                Py_DECREF ( value_obj );
+                goto err;
+        }
+
+        name_obj = lkconfig_confread_span_to_str ( tok.name, tok.name_len );
+        if ( name_obj == NULL ) {
+            Py_DECREF ( value_obj );
+            goto err;
+        }
+
+        entry = Py_BuildValue ( "(INN)", tok.lineno, name_obj, value_obj );
+        if ( lkconfig_list_append_steal_ref ( entries, entry ) != 0 ) {
+            goto err;
+        }
+    }
+
+    lkconfig_confread_close ( &cr );
+    return entries;
+
+err:
+    lkconfig_confread_close ( &cr );
+    Py_DECREF ( entries );
+    return NULL;
+}
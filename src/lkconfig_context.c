@@ -0,0 +1,724 @@
+/*
+ * lkc state handling.
+ *
+ * lkc keeps everything it has parsed in global variables
+ * (symbol_hash, rootmenu, file_list, ...).
+ * A Context object holds a saved copy of these variables.
+ *
+ * Exactly one context is active at any time, its state lives in lkc's
+ * globals. switch_context() saves the globals to the active context
+ * and loads the state of another context, so that several Kconfig trees
+ * can be kept in memory and parsed one after another.
+ *
+ * Freeing a context's state releases all symbols, properties,
+ * expressions, menus and file entries. Strings referenced by properties
+ * and menus (prompt text, help) are not freed, since lkc does not own
+ * them consistently (e.g. prompt texts may point into the middle
+ * of an allocated string), and the same applies to symbol values.
+ *
+ * */
+
+#include <sys/utsname.h>   /* lkconfig_lkc_sym_init() */
+
+/* set once conf_parse() has called sym_init(), see lkconfig_lkc_sym_init() */
+static int lkconfig_lkc_sym_init_done = 0;
+
+
+static void lkconfig_lkc_state_init ( struct lkconfig_lkc_state* const st ) {
+    memset ( st, 0, sizeof *st );
+}
+
+
+/**
+ * Copies lkc's globals to st.
+ * Does not modify the globals, st must not own any objects.
+ * */
+static void lkconfig_lkc_state_save ( struct lkconfig_lkc_state* const st ) {
+    memcpy ( st->symbol_hash, symbol_hash, sizeof st->symbol_hash );
+    st->rootmenu           = rootmenu;
+    st->file_list          = file_list;
+    st->modules_sym        = modules_sym;
+    st->modules_val        = modules_val;
+    st->sym_defconfig_list = sym_defconfig_list;
+    st->sym_env_list       = sym_env_list;
+    st->arena              = lkconfig_lkc_arena;
+}
+
+
+/**
+ * Moves st to lkc's globals and clears st afterwards.
+ * The previous state of the globals should have been saved before.
+ *
+ * Note: menus reference &rootmenu as parent,
+ *       which stays valid since rootmenu is restored at the same address.
+ * */
+static void lkconfig_lkc_state_load ( struct lkconfig_lkc_state* const st ) {
+    memcpy ( symbol_hash, st->symbol_hash, sizeof symbol_hash );
+    rootmenu           = st->rootmenu;
+    file_list          = st->file_list;
+    current_file       = NULL;
+    modules_sym        = st->modules_sym;
+    modules_val        = st->modules_val;
+    sym_defconfig_list = st->sym_defconfig_list;
+    sym_env_list       = st->sym_env_list;
+    lkconfig_lkc_arena = st->arena;
+
+    lkconfig_lkc_state_init ( st );
+}
+
+
+/**
+ * Resets lkc's globals to the initial, empty state.
+ * The previous state of the globals should have been saved before.
+ * */
+static void lkconfig_lkc_state_reset_globals (void) {
+    memset ( symbol_hash, 0, sizeof symbol_hash );
+    memset ( &rootmenu, 0, sizeof rootmenu );
+    file_list          = NULL;
+    current_file       = NULL;
+    modules_sym        = NULL;
+    modules_val        = no;
+    sym_defconfig_list = NULL;
+    sym_env_list       = NULL;
+    lkconfig_arena_init ( &lkconfig_lkc_arena );
+}
+
+
+/**
+ * Pre-parse symbol setup, replaces sym_init() for all but the first parse.
+ *
+ * sym_init() from symbol.c creates the UNAME_RELEASE symbol,
+ * but only once per process, so do that here for any other context.
+ * */
+static void lkconfig_lkc_sym_init (void) {
+    struct symbol* sym;
+    struct property* prop;
+    struct utsname uts;
+
+    if ( ! lkconfig_lkc_sym_init_done ) {
+        /* conf_parse() -> sym_init() */
+        lkconfig_lkc_sym_init_done = 1;
+        return;
+    }
+
+    uname ( &uts );
+
+    sym = sym_lookup ( "UNAME_RELEASE", 0 );
+    sym->type = S_STRING;
+    sym->flags |= SYMBOL_AUTO;
+
+    prop = prop_alloc ( P_DEFAULT, sym );
+    prop->expr = expr_alloc_symbol ( sym_lookup ( uts.release, SYMBOL_CONST ) );
+}
+
+
+/**
+ * Resets the lexer after parsing, so that conf_parse() can be called again.
+ *
+ * The lexer closes the top-level Kconfig file on EOF,
+ * but keeps its (now dangling) file handle and buffer.
+ * */
+static void lkconfig_lkc_lexer_reset (void) {
+    zconfin = NULL;
+    zconflex_destroy();
+}
+
+
+/**
+ * Acquires the lkc lock, which must be held while accessing lkc's globals
+ * from module-level functions, since lkc code may run concurrently
+ * in another thread with the GIL released.
+ * The GIL must be held, it gets released while waiting for the lock.
+ *
+ * Raises a RuntimeError if the lock is already held by the current thread,
+ * e.g. when a logger called from within oldconfig() calls back into lkconfig.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_lkc_lock_acquire (void) {
+    unsigned long thread_ident;
+
+    thread_ident = PyThread_get_thread_ident();
+
+    if ( ! PyThread_acquire_lock ( lkconfig_lkc_lock, NOWAIT_LOCK ) ) {
+        if ( lkconfig_lkc_lock_owner == thread_ident ) {
+            PyErr_SetString (
+                PyExc_RuntimeError, "lkc is already in use by this thread"
+            );
+            return -1;
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        PyThread_acquire_lock ( lkconfig_lkc_lock, WAIT_LOCK );
+        Py_END_ALLOW_THREADS
+    }
+
+    lkconfig_lkc_lock_owner = thread_ident;
+    return 0;
+}
+
+
+/**
+ * Releases the lkc lock, see lkconfig_lkc_lock_acquire().
+ * */
+static void lkconfig_lkc_lock_release (void) {
+    lkconfig_lkc_lock_owner = 0;
+    PyThread_release_lock ( lkconfig_lkc_lock );
+}
+
+
+/**
+ * Recursively adds an expression and its subexpressions to a pointer set.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_lkc_state__collect_expr (
+    struct lkconfig_ptrmap* const exprs, struct expr* const e
+) {
+    if ( e == NULL ) { return 0; }
+    if ( lkconfig_ptrmap_get ( exprs, e ) != NULL ) { return 0; }
+    if ( lkconfig_ptrmap_set ( exprs, e, 0 ) != 0 ) { return -1; }
+
+    switch ( e->type ) {
+        case E_NOT:
+        case E_LIST:
+            return lkconfig_lkc_state__collect_expr ( exprs, (e->left).expr );
+
+        case E_OR:
+        case E_AND:
+            if (
+                lkconfig_lkc_state__collect_expr ( exprs, (e->left).expr ) != 0
+            ) {
+                return -1;
+            }
+            return lkconfig_lkc_state__collect_expr ( exprs, (e->right).expr );
+
+        default:
+            /* E_NONE, E_SYMBOL, comparisons: symbol operands */
+            return 0;
+    }
+}
+
+static int lkconfig_lkc_state__collect_prop (
+    struct lkconfig_ptrmap* const props,
+    struct lkconfig_ptrmap* const exprs,
+    struct property* const prop
+) {
+    if ( prop == NULL ) { return 0; }
+    if ( lkconfig_ptrmap_get ( props, prop ) != NULL ) { return 0; }
+    if ( lkconfig_ptrmap_set ( props, prop, 0 ) != 0 ) { return -1; }
+
+    if ( lkconfig_lkc_state__collect_expr ( exprs, prop->expr ) != 0 ) {
+        return -1;
+    }
+
+    return lkconfig_lkc_state__collect_expr ( exprs, (prop->visible).expr );
+}
+
+static int lkconfig_lkc_state__collect_menu (
+    struct lkconfig_ptrmap* const props,
+    struct lkconfig_ptrmap* const exprs,
+    struct menu* const menu
+) {
+    struct menu* child;
+
+    if ( lkconfig_lkc_state__collect_prop ( props, exprs, menu->prompt ) != 0 ) {
+        return -1;
+    }
+
+    if (
+        (lkconfig_lkc_state__collect_expr ( exprs, menu->visibility ) != 0)
+        || (lkconfig_lkc_state__collect_expr ( exprs, menu->dep ) != 0)
+    ) {
+        return -1;
+    }
+
+    for ( child = menu->list; child != NULL; child = child->next ) {
+        if ( lkconfig_lkc_state__collect_menu ( props, exprs, child ) != 0 ) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void lkconfig_lkc_state__free_menu_childs ( struct menu* const menu ) {
+    struct menu* child;
+    struct menu* next;
+
+    for ( child = menu->list; child != NULL; child = next ) {
+        next = child->next;
+        lkconfig_lkc_state__free_menu_childs ( child );
+        free ( child->help );
+        free ( child );
+    }
+}
+
+static void lkconfig_lkc_state__free_ptrmap_keys (
+    const struct lkconfig_ptrmap* const pmap
+) {
+    size_t k;
+
+    for ( k = 0; k < pmap->size; k++ ) {
+        if ( pmap->keys [k] != NULL ) { free ( (void*) pmap->keys [k] ); }
+    }
+}
+
+
+/**
+ * Collects the distinct props and exprs referenced by a (saved) lkc state.
+ * Props and exprs may be shared between symbols and menus.
+ *
+ * @param st     lkc state
+ * @param props  pointer set for props
+ * @param exprs  pointer set for exprs
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_lkc_state_collect (
+    struct lkconfig_lkc_state* const st,
+    struct lkconfig_ptrmap* const props,
+    struct lkconfig_ptrmap* const exprs
+) {
+    struct symbol* sym;
+    struct property* prop;
+    unsigned int i;
+
+    for ( i = 0; i < SYMBOL_HASHSIZE; i++ ) {
+        for ( sym = st->symbol_hash [i]; sym != NULL; sym = sym->next ) {
+            if (
+                (lkconfig_lkc_state__collect_expr ( exprs, (sym->dir_dep).expr ) != 0)
+                || (lkconfig_lkc_state__collect_expr ( exprs, (sym->rev_dep).expr ) != 0)
+            ) {
+                return -1;
+            }
+
+            for ( prop = sym->prop; prop != NULL; prop = prop->next ) {
+                if ( lkconfig_lkc_state__collect_prop ( props, exprs, prop ) != 0 ) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    if ( lkconfig_lkc_state__collect_menu ( props, exprs, &(st->rootmenu) ) != 0 ) {
+        return -1;
+    }
+
+    if ( lkconfig_lkc_state__collect_expr ( exprs, st->sym_env_list ) != 0 ) {
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Frees all objects owned by a (saved) lkc state and clears it.
+ *
+ * @param st   lkc state, must not be the active state
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_lkc_state_free ( struct lkconfig_lkc_state* const st ) {
+    struct lkconfig_ptrmap props;
+    struct lkconfig_ptrmap exprs;
+    struct symbol* sym;
+    struct symbol* next_sym;
+    struct file* file;
+    struct file* next_file;
+    unsigned int i;
+    unsigned int k;
+    int ret;
+
+    lkconfig_ptrmap_init ( &props );
+    lkconfig_ptrmap_init ( &exprs );
+    ret = -1;
+
+    /* collect props and exprs first, they may be shared */
+    if ( lkconfig_lkc_state_collect ( st, &props, &exprs ) != 0 ) {
+        goto out;
+    }
+
+    /*
+     * free everything,
+     * free() is a no-op for objects in the arena, see lkconfig_arena.c
+     * */
+    lkconfig_lkc_state__free_ptrmap_keys ( &exprs );
+    lkconfig_lkc_state__free_ptrmap_keys ( &props );
+    lkconfig_lkc_state__free_menu_childs ( &(st->rootmenu) );
+
+    for ( i = 0; i < SYMBOL_HASHSIZE; i++ ) {
+        for ( sym = st->symbol_hash [i]; sym != NULL; sym = next_sym ) {
+            next_sym = sym->next;
+
+            /* see conf_read_simple() */
+            switch ( sym->type ) {
+                case S_INT:
+                case S_HEX:
+                case S_STRING:
+                    for ( k = 0; k < S_DEF_COUNT; k++ ) {
+                        free ( (sym->def [k]).val );
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            free ( sym->name );
+            free ( sym );
+        }
+    }
+
+    for ( file = st->file_list; file != NULL; file = next_file ) {
+        next_file = file->next;
+        free ( (void*) file->name );
+        free ( file );
+    }
+
+    lkconfig_arena_free ( &(st->arena) );
+    lkconfig_lkc_state_init ( st );
+    ret = 0;
+
+out:
+    lkconfig_ptrmap_free ( &props );
+    lkconfig_ptrmap_free ( &exprs );
+    return ret;
+}
+
+
+/* Context type */
+
+static void lkconfig_ContextObject__free_depgraph (
+    lkconfig_ContextObject* const self
+) {
+    if ( self->depgraph != NULL ) {
+        lkconfig_depgraph_free ( self->depgraph );
+        PyMem_Free ( self->depgraph );
+        self->depgraph = NULL;
+    }
+}
+
+static void lkconfig_ContextObject_dealloc (
+    lkconfig_ContextObject* const self
+) {
+    PyObject* err_type;
+    PyObject* err_value;
+    PyObject* err_tb;
+    int have_lock;
+
+    PyErr_Fetch ( &err_type, &err_value, &err_tb );
+
+    lkconfig_ContextObject__free_depgraph ( self );
+    lkconfig_symindex_free ( &(self->symindex) );
+    lkconfig_viewcache_free ( &(self->symviews) );
+    lkconfig_viewcache_free ( &(self->exprviews) );
+
+    /*
+     * Freeing the state must not run concurrently with lkc code,
+     * see lkconfig_ContextObject_clear().
+     * The lock may already be held by this thread if the last reference
+     * gets dropped from within a logger called by lkc code,
+     * which does not run meanwhile.
+     * */
+    have_lock = 0;
+    if ( lkconfig_lkc_lock_owner != PyThread_get_thread_ident() ) {
+        /* does not fail if the lock is not held by this thread */
+        if ( lkconfig_lkc_lock_acquire() == 0 ) { have_lock = 1; }
+    }
+
+    /* the active context is referenced by lkconfig_active_context */
+    if ( lkconfig_lkc_state_free ( &(self->state) ) != 0 ) {
+        PyErr_WriteUnraisable ( (PyObject*) self );
+    }
+
+    if ( have_lock ) { lkconfig_lkc_lock_release(); }
+
+    PyErr_Restore ( err_type, err_value, err_tb );
+    Py_TYPE(self)->tp_free ( (PyObject*) self );
+}
+
+static PyObject* lkconfig_ContextObject_new (
+    PyTypeObject* const type, PyObject* const args, PyObject* const kwargs
+) {
+    static const char* arg_kwlist[] = { NULL };
+    lkconfig_ContextObject* self;
+
+    if (
+        ! PyArg_ParseTupleAndKeywords (
+            args, kwargs, ":" lkconfig_ContextName, (char**) arg_kwlist
+        )
+    ) {
+        return NULL;
+    }
+
+    self = (lkconfig_ContextObject*) type->tp_alloc ( type, 0 );
+    if ( self == NULL ) { return NULL; }
+
+    self->have_symbols = 0;
+    self->generation   = 0;
+    self->depgraph     = NULL;
+    lkconfig_symindex_init ( &(self->symindex) );
+    lkconfig_viewcache_init ( &(self->symviews) );
+    lkconfig_viewcache_init ( &(self->exprviews) );
+    lkconfig_lkc_state_init ( &(self->state) );
+    return (PyObject*) self;
+}
+
+
+/**
+ * Checks whether the lkc object of a view still exists,
+ * i.e. whether its context has not been cleared since the view was created.
+ *
+ * @param context     the view's context
+ * @param generation  the context's generation when the view was created
+ *
+ * @return 0 if the view is valid, else non-zero (python exception set)
+ * */
+static int lkconfig_context_check_view (
+    const PyObject* const context, const unsigned long generation
+) {
+    if ( ((const lkconfig_ContextObject*) context)->generation != generation ) {
+        PyErr_SetString (
+            PyExc_RuntimeError, "the view's context has been cleared"
+        );
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Returns the dependency graph of the active context's symbols,
+ * builds it on first access.
+ *
+ * @return borrowed pointer to the graph, NULL on error (exception set)
+ * */
+static struct lkconfig_depgraph* lkconfig_context_get_depgraph (void) {
+    lkconfig_ContextObject* const ctx = lkconfig_active_context;
+    struct lkconfig_depgraph* g;
+
+    if ( ctx->depgraph == NULL ) {
+        g = PyMem_Malloc ( sizeof *g );
+        if ( g == NULL ) { PyErr_NoMemory(); return NULL; }
+
+        lkconfig_depgraph_init ( g );
+        if ( lkconfig_depgraph_build ( g, &(ctx->symindex) ) != 0 ) {
+            lkconfig_depgraph_free ( g );
+            PyMem_Free ( g );
+            return NULL;
+        }
+
+        ctx->depgraph = g;
+    }
+
+    return ctx->depgraph;
+}
+
+
+/**
+ * Makes ctx the active context.
+ *
+ * @param ctx   context
+ *
+ * @return new reference to the previously active context
+ * */
+static lkconfig_ContextObject* lkconfig_context_activate (
+    lkconfig_ContextObject* const ctx
+) {
+    lkconfig_ContextObject* prev_ctx;
+
+    prev_ctx = lkconfig_active_context;
+
+    if ( ctx == prev_ctx ) {
+        Py_INCREF ( prev_ctx );
+
+    } else {
+        lkconfig_lkc_state_save ( &(prev_ctx->state) );
+        lkconfig_lkc_state_load ( &(ctx->state) );
+
+        /* the reference to prev_ctx is passed on to the caller */
+        Py_INCREF ( ctx );
+        lkconfig_active_context = ctx;
+    }
+
+    return prev_ctx;
+}
+
+
+static int lkconfig_ContextObject__clear (
+    lkconfig_ContextObject* const self
+) {
+    struct lkconfig_lkc_state* st;
+
+    /* views that are still alive become invalid */
+    self->generation++;
+
+    lkconfig_ContextObject__free_depgraph ( self );
+    lkconfig_symindex_free ( &(self->symindex) );
+    /* views that are still alive are not cached anymore */
+    lkconfig_viewcache_free ( &(self->symviews) );
+    lkconfig_viewcache_free ( &(self->exprviews) );
+
+    if ( self == lkconfig_active_context ) {
+        st = PyMem_Malloc ( sizeof *st );
+        if ( st == NULL ) { PyErr_NoMemory(); return -1; }
+
+        /* move globals to st */
+        lkconfig_lkc_state_save ( st );
+        lkconfig_lkc_state_reset_globals();
+
+        if ( lkconfig_lkc_state_free ( st ) != 0 ) {
+            /* put state back */
+            lkconfig_lkc_state_load ( st );
+            PyMem_Free ( st );
+            return -1;
+        }
+        PyMem_Free ( st );
+
+    } else {
+        if ( lkconfig_lkc_state_free ( &(self->state) ) != 0 ) { return -1; }
+    }
+
+    self->have_symbols = 0;
+    return 0;
+}
+
+static PyObject* lkconfig_ContextObject_clear (
+    lkconfig_ContextObject* const self, PyObject* const noargs
+) {
+    int ret;
+
+    if ( lkconfig_lkc_lock_acquire() != 0 ) { return NULL; }
+    ret = lkconfig_ContextObject__clear ( self );
+    lkconfig_lkc_lock_release();
+
+    if ( ret != 0 ) { return NULL; }
+    Py_RETURN_NONE;
+}
+
+
+static PyObject* lkconfig_ContextObject_get_is_active (
+    lkconfig_ContextObject* const self, void* const closure
+) {
+    return PyBool_FromLong ( self == lkconfig_active_context );
+}
+
+static PyObject* lkconfig_ContextObject_get_have_symbols (
+    lkconfig_ContextObject* const self, void* const closure
+) {
+    return PyBool_FromLong ( self->have_symbols );
+}
+
+
+static PyMethodDef lkconfig_ContextObject_methods[] = {
+    {
+        "clear",
+        (PyCFunction) lkconfig_ContextObject_clear,
+        METH_NOARGS,
+        PyDoc_STR (
+            "clear() -- frees all symbols of this context\n"
+            "\n"
+            "Afterwards, read_symbols() may be called again for this context.\n"
+            "SymbolView and ExprView objects of this context become invalid,\n"
+            "their methods raise a RuntimeError.\n"
+        )
+    },
+    { NULL }
+};
+
+static PyGetSetDef lkconfig_ContextObject_getset[] = {
+    {
+        "is_active",
+        (getter) lkconfig_ContextObject_get_is_active,
+        NULL,
+        PyDoc_STR ( "whether this is the active context" ),
+        NULL
+    },
+    {
+        "have_symbols",
+        (getter) lkconfig_ContextObject_get_have_symbols,
+        NULL,
+        PyDoc_STR ( "whether read_symbols() has been called for this context" ),
+        NULL
+    },
+    { NULL }
+};
+
+
+static PyTypeObject lkconfig_ContextType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+
+    LKCONFIG_PYMOD_NAME "." lkconfig_ContextName,
+    sizeof (lkconfig_ContextObject),
+    0,                         /* tp_itemsize */
+    (destructor) lkconfig_ContextObject_dealloc,  /* tp_dealloc */
+    0,                         /* tp_print */
+    0,                         /* tp_getattr */
+    0,                         /* tp_setattr */
+    0,                         /* tp_reserved */
+    0,                         /* tp_repr */
+    0,                         /* tp_as_number */
+    0,                         /* tp_as_sequence */
+    0,                         /* tp_as_mapping */
+    0,                         /* tp_hash  */
+    0,                         /* tp_call */
+    0,                         /* tp_str */
+    0,                         /* tp_getattro */
+    0,                         /* tp_setattro */
+    0,                         /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT
+        /*| Py_TPFLAGS_BASETYPE*/,   /* tp_flags */
+    PyDoc_STR (
+        "lkc parser state\n"
+        "\n"
+        "Context() creates a new, empty context, "
+        "see also get_context() and switch_context()."
+    ),  /* tp doc */
+    0,                         /* tp_traverse */
+    0,                         /* tp_clear */
+    0,                         /* tp_richcompare */
+    0,                         /* tp_weaklistoffset */
+    0,                         /* tp_iter */
+    0,                         /* tp_iternext */
+    lkconfig_ContextObject_methods,  /* tp_methods */
+    0,                         /* tp_members */
+    lkconfig_ContextObject_getset,   /* tp_getset */
+    0,                         /* tp_base */
+    0,                         /* tp_dict */
+    0,                         /* tp_descr_get */
+    0,                         /* tp_descr_set */
+    0,                         /* tp_dictoffset */
+    0,                         /* tp_init */
+    0,                         /* tp_alloc */
+    lkconfig_ContextObject_new  /* tp_new */
+};
+
+
+/**
+ * Creates the lkc lock, the arena lock and the initial active context,
+ * lkc's globals are still empty.
+ *
+ * @return 0 on success, else non-zero
+ * */
+static int lkconfig_context_module_init (void) {
+    if ( lkconfig_lkc_lock == NULL ) {
+        lkconfig_lkc_lock = PyThread_allocate_lock();
+        if ( lkconfig_lkc_lock == NULL ) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+
+    if ( lkconfig_arena_module_init() != 0 ) { return -1; }
+
+    if ( lkconfig_active_context == NULL ) {
+        lkconfig_active_context = (lkconfig_ContextObject*) (
+            PyObject_CallObject ( (PyObject*) &lkconfig_ContextType, NULL )
+        );
+        if ( lkconfig_active_context == NULL ) { return -1; }
+    }
+    return 0;
+}
@@ -0,0 +1,391 @@
+/*
+ * A reverse dependency graph of lkc's symbols,
+ * used by oldconfig's incremental mode for invalidating
+ * only those symbols whose value may depend on a changed symbol,
+ * instead of all symbols (sym_clear_all_valid()).
+ *
+ * A symbol depends on all symbols referenced by its dir_dep and rev_dep
+ * expressions and by the expressions of its properties
+ * (prompt/default visibility, defaults, selects, ranges, choices).
+ * Choice symbols and their values reference each other via P_CHOICE.
+ *
+ * Changes that alter a symbol's state (e.g. SYMBOL_DEF_USER)
+ * but not its current value do not invalidate anything in lkc,
+ * the symbol is recalculated with the next sym_clear_all_valid().
+ * Such symbols are deferred and invalidated, together with their
+ * dependents, by the next lkconfig_depgraph_invalidate() call,
+ * so that incremental mode gives the same results as lkc.
+ *
+ * The graph is stored in CSR form, dependents of symbol k are
+ * targets [offsets[k]] ... targets [offsets[k+1] - 1],
+ * where k is the symbol's index in the context, see lkconfig_symindex.c.
+ *
+ * */
+
+
+static void lkconfig_depgraph_init ( struct lkconfig_depgraph* const g ) {
+    g->symindex = NULL;
+    g->offsets  = NULL;
+    g->targets  = NULL;
+    g->queue    = NULL;
+    g->marks    = NULL;
+    g->stamp    = 0;
+
+    g->pending     = NULL;
+    g->npending    = 0;
+    g->is_pending  = NULL;
+    g->pending_all = 1;
+}
+
+
+static void lkconfig_depgraph_free ( struct lkconfig_depgraph* const g ) {
+    PyMem_Free ( g->offsets );
+    PyMem_Free ( g->targets );
+    PyMem_Free ( g->queue );
+    PyMem_Free ( g->marks );
+    PyMem_Free ( g->pending );
+    PyMem_Free ( g->is_pending );
+    lkconfig_depgraph_init ( g );
+}
+
+
+/**
+ * Adds a "sym_dep -> sym_idx" edge if sym_dep is an indexed symbol.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_depgraph__add_edge (
+    const struct lkconfig_depgraph* const g,
+    struct lkconfig_intbuf* const edge_src,
+    struct lkconfig_intbuf* const edge_dst,
+    const struct symbol* const sym_dep,
+    const int sym_idx
+) {
+    int dep_idx;
+
+    /* const symbols (y/m/n, string literals) are not indexed */
+    dep_idx = lkconfig_symindex_get ( g->symindex, sym_dep );
+    if ( (dep_idx < 0) || (dep_idx == sym_idx) ) { return 0; }
+
+    if ( lkconfig_intbuf_append ( edge_src, dep_idx ) != 0 ) { return -1; }
+    return lkconfig_intbuf_append ( edge_dst, sym_idx );
+}
+
+
+/**
+ * Adds edges for all symbols referenced by an expression.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_depgraph__add_expr_edges (
+    const struct lkconfig_depgraph* const g,
+    struct lkconfig_intbuf* const edge_src,
+    struct lkconfig_intbuf* const edge_dst,
+    const struct expr* const e,
+    const int sym_idx
+) {
+#define _LKCONFIG_DEPGRAPH_ADD_SYM(_s)  \
+    do { \
+        if ( \
+            lkconfig_depgraph__add_edge ( \
+                g, edge_src, edge_dst, (_s), sym_idx \
+            ) != 0 \
+        ) { \
+            return -1; \
+        } \
+    } while (0)
+
+#define _LKCONFIG_DEPGRAPH_ADD_EXPR(_e)  \
+    do { \
+        if ( \
+            lkconfig_depgraph__add_expr_edges ( \
+                g, edge_src, edge_dst, (_e), sym_idx \
+            ) != 0 \
+        ) { \
+            return -1; \
+        } \
+    } while (0)
+
+    if ( e == NULL ) { return 0; }
+
+    switch ( e->type ) {
+        case E_OR:
+        case E_AND:
+            _LKCONFIG_DEPGRAPH_ADD_EXPR ( (e->left).expr );
+            _LKCONFIG_DEPGRAPH_ADD_EXPR ( (e->right).expr );
+            break;
+
+        case E_NOT:
+            _LKCONFIG_DEPGRAPH_ADD_EXPR ( (e->left).expr );
+            break;
+
+        case E_LIST:
+            _LKCONFIG_DEPGRAPH_ADD_EXPR ( (e->left).expr );
+            _LKCONFIG_DEPGRAPH_ADD_SYM ( (e->right).sym );
+            break;
+
+        case E_SYMBOL:
+            _LKCONFIG_DEPGRAPH_ADD_SYM ( (e->left).sym );
+            break;
+
+        case E_EQUAL:
+        case E_UNEQUAL:
+        case E_LTH:
+        case E_LEQ:
+        case E_GTH:
+        case E_GEQ:
+        case E_RANGE:
+            _LKCONFIG_DEPGRAPH_ADD_SYM ( (e->left).sym );
+            _LKCONFIG_DEPGRAPH_ADD_SYM ( (e->right).sym );
+            break;
+
+        default:
+            break;
+    }
+
+    return 0;
+
+#undef _LKCONFIG_DEPGRAPH_ADD_EXPR
+#undef _LKCONFIG_DEPGRAPH_ADD_SYM
+}
+
+
+/**
+ * Builds the reverse dependency graph of all indexed symbols.
+ * The graph must be initialized with lkconfig_depgraph_init().
+ *
+ * @param g         dependency graph
+ * @param symindex  symbol index, must outlive the graph
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_depgraph_build (
+    struct lkconfig_depgraph* const g,
+    const struct lkconfig_symindex* const symindex
+) {
+    struct lkconfig_intbuf edge_src;
+    struct lkconfig_intbuf edge_dst;
+    struct symbol* sym;
+    struct property* prop;
+    int* cursor;
+    size_t nsyms;
+    size_t k;
+    int idx;
+    int ret;
+
+    g->symindex = symindex;
+    nsyms       = symindex->nsyms;
+
+    g->offsets = PyMem_Malloc ( (nsyms + 1) * sizeof *(g->offsets) );
+    g->queue   = PyMem_Malloc ( (nsyms + 1) * sizeof *(g->queue) );
+    g->marks   = PyMem_Malloc ( (nsyms + 1) * sizeof *(g->marks) );
+    g->pending = PyMem_Malloc ( (nsyms + 1) * sizeof *(g->pending) );
+    g->is_pending = PyMem_Malloc ( (nsyms + 1) * sizeof *(g->is_pending) );
+    if (
+        (g->offsets == NULL) || (g->queue == NULL) || (g->marks == NULL)
+        || (g->pending == NULL) || (g->is_pending == NULL)
+    ) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for ( k = 0; k < nsyms; k++ ) {
+        g->marks [k]      = 0;
+        g->is_pending [k] = 0;
+    }
+    g->stamp       = 0;
+    g->npending    = 0;
+    g->pending_all = 1;
+
+    /* collect edges */
+    lkconfig_intbuf_init ( &edge_src );
+    lkconfig_intbuf_init ( &edge_dst );
+
+    ret = 0;
+    for ( k = 0; (ret == 0) && (k < nsyms); k++ ) {
+        sym = symindex->syms [k];
+        idx = (int) k;
+
+        ret = lkconfig_depgraph__add_expr_edges (
+            g, &edge_src, &edge_dst, (sym->dir_dep).expr, idx
+        );
+        if ( ret == 0 ) {
+            ret = lkconfig_depgraph__add_expr_edges (
+                g, &edge_src, &edge_dst, (sym->rev_dep).expr, idx
+            );
+        }
+
+        for (
+            prop = sym->prop; (ret == 0) && (prop != NULL); prop = prop->next
+        ) {
+            ret = lkconfig_depgraph__add_expr_edges (
+                g, &edge_src, &edge_dst, prop->expr, idx
+            );
+            if ( ret == 0 ) {
+                ret = lkconfig_depgraph__add_expr_edges (
+                    g, &edge_src, &edge_dst, (prop->visible).expr, idx
+                );
+            }
+        }
+    }
+
+    /* convert edge list to CSR */
+    if ( ret == 0 ) {
+        g->targets = PyMem_Malloc ( (edge_dst.len + 1) * sizeof *(g->targets) );
+        if ( g->targets == NULL ) {
+            PyErr_NoMemory();
+            ret = -1;
+        }
+    }
+
+    if ( ret == 0 ) {
+        for ( k = 0; k <= nsyms; k++ ) { g->offsets [k] = 0; }
+
+        for ( k = 0; k < edge_src.len; k++ ) {
+            (g->offsets [edge_src.data [k] + 1])++;
+        }
+
+        for ( k = 0; k < nsyms; k++ ) {
+            g->offsets [k + 1] += g->offsets [k];
+        }
+
+        /* queue is unused until invalidate(), use it as fill cursor */
+        cursor = g->queue;
+        for ( k = 0; k < nsyms; k++ ) { cursor [k] = g->offsets [k]; }
+
+        for ( k = 0; k < edge_src.len; k++ ) {
+            g->targets [cursor [edge_src.data [k]]++] = edge_dst.data [k];
+        }
+    }
+
+    lkconfig_intbuf_free ( &edge_src );
+    lkconfig_intbuf_free ( &edge_dst );
+    return ret;
+}
+
+
+/**
+ * Forgets all deferred symbols,
+ * after all symbols have been invalidated by sym_clear_all_valid().
+ *
+ * @param g  dependency graph
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_depgraph_clear_pending (
+    struct lkconfig_depgraph* const g
+) {
+    size_t k;
+
+    for ( k = 0; k < g->npending; k++ ) {
+        g->is_pending [g->pending [k]] = 0;
+    }
+    g->npending    = 0;
+    g->pending_all = 0;
+}
+
+
+/**
+ * Requests that the next invalidation invalidates all symbols,
+ * e.g. after loading a config, which resets the state of all symbols.
+ *
+ * @param g  dependency graph
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_depgraph_defer_all ( struct lkconfig_depgraph* const g ) {
+    g->pending_all = 1;
+}
+
+
+/**
+ * Defers the invalidation of a symbol whose state has changed
+ * without changing its current value,
+ * see lkconfig_depgraph_invalidate().
+ *
+ * @param g    dependency graph
+ * @param sym  symbol
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_depgraph_defer (
+    struct lkconfig_depgraph* const g, struct symbol* const sym
+) {
+    int sym_idx;
+
+    if ( g->pending_all ) { return; }
+
+    sym_idx = lkconfig_symindex_get ( g->symindex, sym );
+    if ( (sym_idx < 0) || g->is_pending [sym_idx] ) { return; }
+
+    g->is_pending [sym_idx]      = 1;
+    g->pending [(g->npending)++] = sym_idx;
+}
+
+
+/**
+ * Clears the SYMBOL_VALID flag of a symbol, of all deferred symbols
+ * and of all symbols that transitively depend on them,
+ * so that sym_calc_value() recalculates their values.
+ *
+ * The caller must check g->pending_all before
+ * and call sym_clear_all_valid() instead if it is set.
+ *
+ * @param g    dependency graph
+ * @param sym  changed symbol
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_depgraph_invalidate (
+    struct lkconfig_depgraph* const g, struct symbol* const sym
+) {
+    int sym_idx;
+    size_t head;
+    size_t tail;
+    size_t j;
+    int k;
+    int s;
+    int t;
+
+    sym->flags &= ~SYMBOL_VALID;
+
+    /* new mark stamp, reset marks on wraparound */
+    if ( ++(g->stamp) == 0 ) {
+        for ( head = 0; head < g->symindex->nsyms; head++ ) {
+            g->marks [head] = 0;
+        }
+        g->stamp = 1;
+    }
+
+    tail = 0;
+
+    sym_idx = lkconfig_symindex_get ( g->symindex, sym );
+    if ( sym_idx >= 0 ) {
+        g->queue [tail++] = sym_idx;
+        g->marks [sym_idx] = g->stamp;
+    }
+
+    for ( j = 0; j < g->npending; j++ ) {
+        s = g->pending [j];
+        g->is_pending [s] = 0;
+        if ( g->marks [s] != g->stamp ) {
+            g->marks [s] = g->stamp;
+            g->queue [tail++] = s;
+        }
+    }
+    g->npending = 0;
+
+    head = 0;
+    while ( head < tail ) {
+        s = g->queue [head++];
+        (g->symindex->syms [s])->flags &= ~SYMBOL_VALID;
+
+        for ( k = g->offsets [s]; k < g->offsets [s + 1]; k++ ) {
+            t = g->targets [k];
+            if ( g->marks [t] != g->stamp ) {
+                g->marks [t] = g->stamp;
+                g->queue [tail++] = t;
+            }
+        }
+    }
+}
@@ -1,6 +1,20 @@
 static void lkconfig_ExprViewObject_dealloc (
     lkconfig_ExprViewObject* const self
 ) {
+    if (
+        (self->context != NULL)
+        && (
+            ((lkconfig_ContextObject*) self->context)->generation
+            == self->generation
+        )
+    ) {
+        lkconfig_viewcache_forget (
+            &(((lkconfig_ContextObject*) self->context)->exprviews),
+            self->kconfig_expr, (PyObject*) self
+        );
+    }
+
+    Py_CLEAR ( self->context );
     Py_TYPE(self)->tp_free ( (PyObject*) self );
 }
 
@@ -15,6 +29,7 @@ static void lkconfig_ExprViewObject_get_expr__expand_none (
 }
 
 static int lkconfig_ExprViewObject_get_expr__expand_sym (
+    lkconfig_ContextObject* const ctx,
     const struct symbol* const sym_in,
     PyObject** const expr_out,  /* uninitialized */
     PyObject** const sym_out    /* uninitialized */
@@ -22,7 +37,7 @@ static int lkconfig_ExprViewObject_get_expr__expand_sym (
     if ( sym_in == NULL ) {
         Py_INCREF ( Py_None ); *sym_out = Py_None;
     } else {
-        *sym_out = lkconfig_SymbolViewObject_new_from_struct ( sym_in );
+        *sym_out = lkconfig_SymbolViewObject_new_from_struct ( ctx, sym_in );
         if ( *sym_out == NULL ) { return -1; }
     }
     Py_INCREF ( Py_None ); *expr_out = Py_None;
@@ -31,6 +46,7 @@ static int lkconfig_ExprViewObject_get_expr__expand_sym (
 }
 
 static int lkconfig_ExprViewObject_get_expr__expand_expr (
+    lkconfig_ContextObject* const ctx,
     const struct expr* const expr_in,
     PyObject** const expr_out,  /* uninitialized */
     PyObject** const sym_out    /* uninitialized */
@@ -41,7 +57,7 @@ static int lkconfig_ExprViewObject_get_expr__expand_expr (
         return 0;
     }
 
-    *expr_out = lkconfig_ExprViewObject_new_from_struct ( expr_in );
+    *expr_out = lkconfig_ExprViewObject_new_from_struct ( ctx, expr_in );
     if ( *expr_out == NULL ) { return -1; }
     Py_INCREF ( Py_None ); *sym_out = Py_None;
 
@@ -52,11 +68,22 @@ static int lkconfig_ExprViewObject_get_expr__expand_expr (
 static PyObject* lkconfig_ExprViewObject_get_expr (
     lkconfig_ExprViewObject* const self, PyObject* const noargs
 ) {
+    /* subexpressions and symbols belong to the same context */
+    lkconfig_ContextObject* const ctx = (
+        (lkconfig_ContextObject*) self->context
+    );
     PyObject* left_expr;
     PyObject* right_expr;
     PyObject* left_sym;
     PyObject* right_sym;
 
+    /* see lkconfig_context_check_view() */
+    if (
+        lkconfig_context_check_view ( self->context, self->generation ) != 0
+    ) {
+        return NULL;
+    }
+
     if ( self->kconfig_expr == NULL ) {
         /* 5-tuple (expr_type, None, None, None, None) */
         return Py_BuildValue (
@@ -71,7 +98,8 @@ static PyObject* lkconfig_ExprViewObject_get_expr (
             /* left is a symbol, right forced to None */
             if (
                 lkconfig_ExprViewObject_get_expr__expand_sym (
-                    (self->kconfig_expr->left).sym, &left_expr, &left_sym
+                    ctx, (self->kconfig_expr->left).sym,
+                    &left_expr, &left_sym
                 ) != 0
             ) {
                 return NULL;
@@ -87,7 +115,8 @@ static PyObject* lkconfig_ExprViewObject_get_expr (
             /* left is expr, right forced to None */
             if (
                 lkconfig_ExprViewObject_get_expr__expand_expr (
-                    (self->kconfig_expr->left).expr, &left_expr, &left_sym
+                    ctx, (self->kconfig_expr->left).expr,
+                    &left_expr, &left_sym
                 ) != 0
             ) {
                 return NULL;
@@ -108,7 +137,8 @@ static PyObject* lkconfig_ExprViewObject_get_expr (
             /* left is a symbol, right is a symbol */
             if (
                 lkconfig_ExprViewObject_get_expr__expand_sym (
-                    (self->kconfig_expr->left).sym, &left_expr, &left_sym
+                    ctx, (self->kconfig_expr->left).sym,
+                    &left_expr, &left_sym
                 ) != 0
             ) {
                 return NULL;
@@ -116,7 +146,8 @@ static PyObject* lkconfig_ExprViewObject_get_expr (
 
             if (
                 lkconfig_ExprViewObject_get_expr__expand_sym (
-                    (self->kconfig_expr->right).sym, &right_expr, &right_sym
+                    ctx, (self->kconfig_expr->right).sym,
+                    &right_expr, &right_sym
                 ) != 0
             ) {
                 Py_DECREF ( left_expr );
@@ -130,7 +161,8 @@ static PyObject* lkconfig_ExprViewObject_get_expr (
             /* left is expr, right is expr */
             if (
                 lkconfig_ExprViewObject_get_expr__expand_expr (
-                    (self->kconfig_expr->left).expr, &left_expr, &left_sym
+                    ctx, (self->kconfig_expr->left).expr,
+                    &left_expr, &left_sym
                 ) != 0
             ) {
                 return NULL;
@@ -138,7 +170,8 @@ static PyObject* lkconfig_ExprViewObject_get_expr (
 
             if (
                 lkconfig_ExprViewObject_get_expr__expand_expr (
-                    (self->kconfig_expr->right).expr, &right_expr, &right_sym
+                    ctx, (self->kconfig_expr->right).expr,
+                    &right_expr, &right_sym
                 ) != 0
             ) {
                 Py_DECREF ( left_expr );
@@ -151,7 +184,8 @@ static PyObject* lkconfig_ExprViewObject_get_expr (
             /* left is expr or NULL, right is symbol */
             if (
                 lkconfig_ExprViewObject_get_expr__expand_expr (
-                    (self->kconfig_expr->left).expr, &left_expr, &left_sym
+                    ctx, (self->kconfig_expr->left).expr,
+                    &left_expr, &left_sym
                 ) != 0
             ) {
                 return NULL;
@@ -159,7 +193,8 @@ static PyObject* lkconfig_ExprViewObject_get_expr (
 
             if (
                 lkconfig_ExprViewObject_get_expr__expand_sym (
-                    (self->kconfig_expr->right).sym, &right_expr, &right_sym
+                    ctx, (self->kconfig_expr->right).sym,
+                    &right_expr, &right_sym
                 ) != 0
             ) {
                 Py_DECREF ( left_expr );
@@ -257,17 +292,49 @@ static PyTypeObject lkconfig_ExprViewType = {
 };
 
 
+/**
+ * Returns the view of an expression.
+ *
+ * @param ctx           context the expr belongs to,
+ *                      not necessarily the active one
+ * @param kconfig_expr  expr, may be NULL
+ *
+ * @return new reference to the view, NULL on error (python exception set)
+ * */
 static PyObject* lkconfig_ExprViewObject_new_from_struct (
-    const struct expr* kconfig_expr
+    lkconfig_ContextObject* const ctx, const struct expr* kconfig_expr
 ) {
     lkconfig_ExprViewObject* self;
+    PyObject* view;
+
+    /* one view per expr (except for NULL), see lkconfig_viewcache.c */
+    if ( kconfig_expr != NULL ) {
+        view = lkconfig_viewcache_get ( &(ctx->exprviews), kconfig_expr );
+        if ( view != NULL ) { return view; }
+    }
 
     self = PyObject_NEW ( lkconfig_ExprViewObject, &lkconfig_ExprViewType );
     if ( self == NULL ) { return NULL; }
 
+    self->context = (PyObject*) ctx;
+    Py_INCREF ( self->context );
+    self->generation = ctx->generation;
+
     self->e_type = (kconfig_expr != NULL) ? kconfig_expr->type : E_NONE;
     self->kconfig_expr = kconfig_expr;
 
+    if (
+        (kconfig_expr != NULL)
+        && (
+            lkconfig_viewcache_add (
+                &(ctx->exprviews), kconfig_expr, (PyObject*) self
+            ) != 0
+        )
+    ) {
+        Py_DECREF ( self );
+        return NULL;
+    }
+
     return (PyObject*) self;
 }
 
@@ -0,0 +1,1684 @@
+/*
+ * ExprCode: natively evaluated symbolexpr.Expr objects.
+ *
+ * kernelconfig.kconfig.symbolexpr compiles an expression tree into
+ * a flat int array ("code") that is interpreted by the functions below.
+ * Symbols are referenced by slot numbers, their values are looked up
+ * once per call and kept in a packed value vector.
+ *
+ * Code layout, "[pc]" being the position of the opcode:
+ *
+ *   OP_CONST  value                          tristate constant (0, 1, 2)
+ *   OP_SYM    slot                           symbol
+ *   OP_CMP    cmp_op lkind lidx rkind ridx   comparison,
+ *                                            kind is OPERAND_SYM (slot)
+ *                                            or OPERAND_CONST (constant)
+ *   OP_NOT                                   negation, followed by subexpr
+ *   OP_AND    count end                      and/or, followed by count
+ *   OP_OR     count end                      subexpressions, end is the
+ *                                            position after the last one
+ *
+ * The semantics are identical to the pure-Python implementation of
+ * Expr._evaluate(), Expr._evaluate_solution() and Expr._find_solution(),
+ * including the order of solutions and of symbols within solutions.
+ *
+ * */
+
+enum {
+    LKCONFIG_EXPRCODE_OP_CONST,
+    LKCONFIG_EXPRCODE_OP_SYM,
+    LKCONFIG_EXPRCODE_OP_CMP,
+    LKCONFIG_EXPRCODE_OP_NOT,
+    LKCONFIG_EXPRCODE_OP_AND,
+    LKCONFIG_EXPRCODE_OP_OR
+};
+
+enum {
+    LKCONFIG_EXPRCODE_OPERAND_SYM,
+    LKCONFIG_EXPRCODE_OPERAND_CONST
+};
+
+/* tristate value bitmasks */
+#define LKCONFIG_EXPRCODE_MASK_N    0x1
+#define LKCONFIG_EXPRCODE_MASK_YM   0x6
+#define LKCONFIG_EXPRCODE_MASK_YMN  0x7
+
+
+/**
+ * Looked up symbol values for a single evaluate() call.
+ * raw holds new references, a missing symbol is represented by tristate n.
+ * */
+struct lkconfig_exprcode_values {
+    PyObject** raw;
+    int*       tri;
+    Py_ssize_t len;
+};
+
+/**
+ * A single solution of find_solution(),
+ * a "symbol slot => bitmask of tristate values" mapping.
+ * order lists the slots in insertion order (nkeys entries),
+ * masks has one entry per slot, 0 meaning "not in this solution".
+ * */
+struct lkconfig_exprcode_sol {
+    Py_ssize_t     nkeys;
+    int*           order;
+    unsigned char* masks;
+};
+
+/**
+ * A list of solutions, see SolutionCache.solutions.
+ * */
+struct lkconfig_exprcode_sollist {
+    struct lkconfig_exprcode_sol** v;
+    size_t len;
+    size_t cap;
+};
+
+
+static int lkconfig_exprcode__check (
+    lkconfig_ExprCodeObject* const self, Py_ssize_t* const pc
+);
+
+
+/**
+ * Converts a value to tristate, like _UnaryValueExpr._evaluate_value().
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode__to_tristate (
+    lkconfig_ExprCodeObject* const self,
+    PyObject* const value,
+    int* const tri_out
+) {
+    PyObject* tri_n;
+    long lval;
+    int bval;
+
+    tri_n = PyTuple_GET_ITEM ( self->tristates, 0 );
+
+    if ( PyObject_TypeCheck ( value, Py_TYPE(tri_n) ) ) {
+        lval = PyLong_AsLong ( value );
+        if ( (lval < 0) || (lval > 2) ) {
+            if ( ! PyErr_Occurred() ) {
+                PyErr_SetString ( PyExc_ValueError, "bad tristate value" );
+            }
+            return -1;
+        }
+        *tri_out = (int) lval;
+
+    } else {
+        bval = PyObject_IsTrue ( value );
+        if ( bval < 0 ) { return -1; }
+        *tri_out = bval ? 2 : 0;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Converts a set of expression values to a tristate bitmask.
+ *
+ * @param exact  if non-zero, expr_values must not contain any other values
+ *
+ * @return 1 if representable, 0 if not, -1 on error (python exception set)
+ * */
+static int lkconfig_exprcode__get_value_mask (
+    lkconfig_ExprCodeObject* const self,
+    PyObject* const expr_values,
+    const int exact,
+    int* const mask_out
+) {
+    Py_ssize_t size;
+    Py_ssize_t count;
+    int k;
+    int ret;
+
+    *mask_out = 0;
+    count     = 0;
+
+    for ( k = 0; k < 3; k++ ) {
+        ret = PySequence_Contains (
+            expr_values, PyTuple_GET_ITEM ( self->tristates, k )
+        );
+        if ( ret < 0 ) { return -1; }
+        if ( ret ) {
+            *mask_out |= (1 << k);
+            count++;
+        }
+    }
+
+    if ( exact ) {
+        size = PyObject_Size ( expr_values );
+        if ( size < 0 ) { return -1; }
+        if ( (size != count) || (count == 0) ) { return 0; }
+    }
+
+    return 1;
+}
+
+
+/* symbol values */
+
+static void lkconfig_exprcode_values_free (
+    struct lkconfig_exprcode_values* const vals
+) {
+    Py_ssize_t k;
+
+    if ( vals->raw != NULL ) {
+        for ( k = 0; k < vals->len; k++ ) { Py_XDECREF ( vals->raw [k] ); }
+    }
+    PyMem_Free ( vals->raw );
+    PyMem_Free ( vals->tri );
+    vals->raw = NULL;
+    vals->tri = NULL;
+    vals->len = 0;
+}
+
+
+/**
+ * Looks up the values of all symbols in symbol_value_map,
+ * missing symbols get tristate n.
+ *
+ * @return 0 on success, else non-zero (python exception set),
+ *         vals must be freed with lkconfig_exprcode_values_free()
+ *         in both cases
+ * */
+static int lkconfig_exprcode_values_load (
+    lkconfig_ExprCodeObject* const self,
+    PyObject* const symbol_value_map,
+    struct lkconfig_exprcode_values* const vals
+) {
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t k;
+
+    vals->len = 0;
+    vals->raw = PyMem_Malloc ( (self->nslots + 1) * sizeof *(vals->raw) );
+    vals->tri = PyMem_Malloc ( (self->nslots + 1) * sizeof *(vals->tri) );
+    if ( (vals->raw == NULL) || (vals->tri == NULL) ) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for ( k = 0; k < self->nslots; k++ ) {
+        key = PyTuple_GET_ITEM ( self->symbols, k );
+
+        if ( PyDict_CheckExact ( symbol_value_map ) ) {
+            value = PyDict_GetItemWithError ( symbol_value_map, key );
+            if ( value != NULL ) {
+                Py_INCREF ( value );
+            } else if ( PyErr_Occurred() ) {
+                return -1;
+            }
+
+        } else {
+            value = PyObject_GetItem ( symbol_value_map, key );
+            if ( value == NULL ) {
+                if ( ! PyErr_ExceptionMatches ( PyExc_KeyError ) ) {
+                    return -1;
+                }
+                PyErr_Clear();
+            }
+        }
+
+        if ( value == NULL ) {
+            value = PyTuple_GET_ITEM ( self->tristates, 0 );
+            Py_INCREF ( value );
+        }
+
+        vals->raw [k] = value;
+        vals->len     = k + 1;
+
+        if (
+            lkconfig_exprcode__to_tristate ( self, value, &(vals->tri [k]) )
+            != 0
+        ) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * Evaluates a comparison, like OP_EVAL(loper, roper).
+ *
+ * @param vals  symbol values, may be NULL if both operands are constants
+ *
+ * @return 1 if true, 0 if false, -1 on error (python exception set)
+ * */
+static int lkconfig_exprcode__eval_cmp (
+    lkconfig_ExprCodeObject* const self,
+    const struct lkconfig_exprcode_values* const vals,
+    const int* const insn
+) {
+    PyObject* operands [2];
+    PyObject* result;
+    int k;
+    int ret;
+
+    for ( k = 0; k < 2; k++ ) {
+        if ( insn [2 + 2*k] == LKCONFIG_EXPRCODE_OPERAND_SYM ) {
+            operands [k] = vals->raw [insn [3 + 2*k]];
+        } else {
+            operands [k] = PyTuple_GET_ITEM (
+                self->constants, insn [3 + 2*k]
+            );
+        }
+    }
+
+    result = PyObject_RichCompare ( operands [0], operands [1], insn [1] );
+    if ( result == NULL ) { return -1; }
+    ret = PyObject_IsTrue ( result );
+    Py_DECREF ( result );
+    return ret;
+}
+
+
+/* evaluate() */
+
+/**
+ * Evaluates the subexpression at *pc and moves pc past it.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode__eval (
+    lkconfig_ExprCodeObject* const self,
+    const struct lkconfig_exprcode_values* const vals,
+    Py_ssize_t* const pc,
+    int* const tri_out
+) {
+    const int* insn;
+    int count;
+    int k;
+    int ret;
+    int tri;
+
+    insn = &(self->code [*pc]);
+
+    switch ( insn [0] ) {
+        case LKCONFIG_EXPRCODE_OP_CONST:
+            *tri_out = insn [1];
+            *pc += 2;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_SYM:
+            *tri_out = vals->tri [insn [1]];
+            *pc += 2;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_CMP:
+            ret = lkconfig_exprcode__eval_cmp ( self, vals, insn );
+            if ( ret < 0 ) { return -1; }
+            *tri_out = ret ? 2 : 0;
+            *pc += 6;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_NOT:
+            *pc += 1;
+            if ( lkconfig_exprcode__eval ( self, vals, pc, &tri ) != 0 ) {
+                return -1;
+            }
+            *tri_out = 2 - tri;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_AND:
+            count    = insn [1];
+            *pc     += 3;
+            *tri_out = 2;
+            for ( k = 0; k < count; k++ ) {
+                if ( lkconfig_exprcode__eval ( self, vals, pc, &tri ) != 0 ) {
+                    return -1;
+                }
+                if ( tri < *tri_out ) { *tri_out = tri; }
+                if ( *tri_out == 0 ) { break; }
+            }
+            *pc = insn [2];
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_OR:
+            count    = insn [1];
+            *pc     += 3;
+            *tri_out = 0;
+            for ( k = 0; k < count; k++ ) {
+                if ( lkconfig_exprcode__eval ( self, vals, pc, &tri ) != 0 ) {
+                    return -1;
+                }
+                if ( tri > *tri_out ) { *tri_out = tri; }
+                if ( *tri_out == 2 ) { break; }
+            }
+            *pc = insn [2];
+            return 0;
+
+        default:
+            PyErr_SetString ( PyExc_AssertionError, "bad opcode" );
+            return -1;
+    }
+}
+
+
+/* evaluate_solution() */
+
+/**
+ * Calculates whether the subexpression at *pc evaluates to one of
+ * the values in mask and appends the involved symbols to solution.
+ * Moves pc past the subexpression.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode__eval_solution (
+    lkconfig_ExprCodeObject* const self,
+    const struct lkconfig_exprcode_values* const vals,
+    Py_ssize_t* const pc,
+    const int mask,
+    struct lkconfig_intbuf* const solution,
+    int* const solvable_out
+) {
+    const int* insn;
+    size_t solution_mark;
+    int count;
+    int k;
+    int ret;
+
+    insn = &(self->code [*pc]);
+
+    switch ( insn [0] ) {
+        case LKCONFIG_EXPRCODE_OP_CONST:
+            *solvable_out = (mask & (1 << insn [1])) ? 1 : 0;
+            *pc += 2;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_SYM:
+            *solvable_out = (mask & (1 << vals->tri [insn [1]])) ? 1 : 0;
+            *pc += 2;
+            if ( *solvable_out ) {
+                return lkconfig_intbuf_append ( solution, insn [1] );
+            }
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_CMP:
+            /* expr_values are not taken into account here */
+            ret = lkconfig_exprcode__eval_cmp ( self, vals, insn );
+            if ( ret < 0 ) { return -1; }
+            *solvable_out = ret;
+            *pc += 6;
+
+            if ( ret ) {
+                for ( k = 0; k < 2; k++ ) {
+                    if ( insn [2 + 2*k] == LKCONFIG_EXPRCODE_OPERAND_SYM ) {
+                        if (
+                            lkconfig_intbuf_append (
+                                solution, insn [3 + 2*k]
+                            ) != 0
+                        ) {
+                            return -1;
+                        }
+                    }
+                }
+            }
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_NOT:
+            *pc += 1;
+            return lkconfig_exprcode__eval_solution (
+                self, vals, pc,
+                (
+                    (mask & LKCONFIG_EXPRCODE_MASK_N)
+                    ? LKCONFIG_EXPRCODE_MASK_YM : LKCONFIG_EXPRCODE_MASK_N
+                ),
+                solution, solvable_out
+            );
+
+        case LKCONFIG_EXPRCODE_OP_AND:
+            count = insn [1];
+            *pc  += 3;
+            *solvable_out = 1;
+            for ( k = 0; (*solvable_out) && (k < count); k++ ) {
+                if (
+                    lkconfig_exprcode__eval_solution (
+                        self, vals, pc, mask, solution, solvable_out
+                    ) != 0
+                ) {
+                    return -1;
+                }
+            }
+            *pc = insn [2];
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_OR:
+            /* first solvable subexpression wins, drop symbols of the others */
+            count = insn [1];
+            *pc  += 3;
+            *solvable_out = 0;
+            solution_mark = solution->len;
+            for ( k = 0; (! *solvable_out) && (k < count); k++ ) {
+                if (
+                    lkconfig_exprcode__eval_solution (
+                        self, vals, pc, mask, solution, solvable_out
+                    ) != 0
+                ) {
+                    return -1;
+                }
+                if ( ! *solvable_out ) { solution->len = solution_mark; }
+            }
+            *pc = insn [2];
+            return 0;
+
+        default:
+            PyErr_SetString ( PyExc_AssertionError, "bad opcode" );
+            return -1;
+    }
+}
+
+
+/* find_solution() */
+
+static struct lkconfig_exprcode_sol* lkconfig_exprcode_sol_new (
+    const Py_ssize_t nslots
+) {
+    struct lkconfig_exprcode_sol* sol;
+
+    sol = PyMem_Malloc (
+        sizeof *sol + (size_t) nslots * (sizeof (int) + 1)
+    );
+    if ( sol == NULL ) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    sol->nkeys = 0;
+    sol->order = (int*) (sol + 1);
+    sol->masks = (unsigned char*) (sol->order + nslots);
+    memset ( sol->masks, 0, (size_t) nslots );
+
+    return sol;
+}
+
+
+static void lkconfig_exprcode_sollist_init (
+    struct lkconfig_exprcode_sollist* const slist
+) {
+    slist->v   = NULL;
+    slist->len = 0;
+    slist->cap = 0;
+}
+
+
+static void lkconfig_exprcode_sollist_free (
+    struct lkconfig_exprcode_sollist* const slist
+) {
+    size_t k;
+
+    for ( k = 0; k < slist->len; k++ ) { PyMem_Free ( slist->v [k] ); }
+    PyMem_Free ( slist->v );
+    lkconfig_exprcode_sollist_init ( slist );
+}
+
+
+/**
+ * Appends a solution to a solution list, which takes ownership of it.
+ * The solution is freed if the list cannot be grown.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode_sollist_append (
+    struct lkconfig_exprcode_sollist* const slist,
+    struct lkconfig_exprcode_sol* const sol
+) {
+    struct lkconfig_exprcode_sol** new_v;
+    size_t new_cap;
+
+    if ( slist->len >= slist->cap ) {
+        new_cap = (slist->cap == 0) ? 4 : (2 * slist->cap);
+        new_v   = PyMem_Realloc ( slist->v, new_cap * sizeof *new_v );
+        if ( new_v == NULL ) {
+            PyMem_Free ( sol );
+            PyErr_NoMemory();
+            return -1;
+        }
+        slist->v   = new_v;
+        slist->cap = new_cap;
+    }
+
+    slist->v [slist->len++] = sol;
+    return 0;
+}
+
+
+/**
+ * Initializes a solution list with a single, empty solution,
+ * like SolutionCache().
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode_sollist_init_empty_solution (
+    struct lkconfig_exprcode_sollist* const slist, const Py_ssize_t nslots
+) {
+    struct lkconfig_exprcode_sol* sol;
+
+    lkconfig_exprcode_sollist_init ( slist );
+
+    sol = lkconfig_exprcode_sol_new ( nslots );
+    if ( sol == NULL ) { return -1; }
+    return lkconfig_exprcode_sollist_append ( slist, sol );
+}
+
+
+/**
+ * Restricts the values of a symbol in all solutions,
+ * like SolutionCache.push_symbol().
+ * Solutions with no remaining values are dropped.
+ *
+ * @return non-zero if any solutions are left, else 0
+ * */
+static int lkconfig_exprcode_sollist_push_symbol (
+    struct lkconfig_exprcode_sollist* const slist,
+    const int slot,
+    const int mask
+) {
+    struct lkconfig_exprcode_sol* sol;
+    size_t j;
+    size_t k;
+    int entry;
+
+    j = 0;
+    for ( k = 0; k < slist->len; k++ ) {
+        sol   = slist->v [k];
+        entry = sol->masks [slot] ? (sol->masks [slot] & mask) : mask;
+
+        if ( entry ) {
+            if ( ! sol->masks [slot] ) { sol->order [sol->nkeys++] = slot; }
+            sol->masks [slot] = (unsigned char) entry;
+            slist->v [j++] = sol;
+        } else {
+            PyMem_Free ( sol );
+        }
+    }
+    slist->len = j;
+
+    return (j > 0) ? 1 : 0;
+}
+
+
+/**
+ * Merges two solutions, like SolutionCache.merge_solution_dict_x_dict().
+ *
+ * @param sol_out  set to the merged solution,
+ *                 or NULL if the solutions are incompatible
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode_sol_merge (
+    const struct lkconfig_exprcode_sol* const sol_a,
+    const struct lkconfig_exprcode_sol* const sol_b,
+    const Py_ssize_t nslots,
+    struct lkconfig_exprcode_sol** const sol_out
+) {
+    struct lkconfig_exprcode_sol* sol;
+    Py_ssize_t k;
+    int slot;
+    int entry;
+
+    *sol_out = NULL;
+
+    sol = lkconfig_exprcode_sol_new ( nslots );
+    if ( sol == NULL ) { return -1; }
+
+    for ( k = 0; k < sol_a->nkeys; k++ ) {
+        slot  = sol_a->order [k];
+        entry = sol_a->masks [slot];
+        if ( sol_b->masks [slot] ) { entry &= sol_b->masks [slot]; }
+
+        if ( ! entry ) {
+            PyMem_Free ( sol );
+            return 0;
+        }
+
+        sol->order [sol->nkeys++] = slot;
+        sol->masks [slot] = (unsigned char) entry;
+    }
+
+    for ( k = 0; k < sol_b->nkeys; k++ ) {
+        slot = sol_b->order [k];
+        if ( ! sol->masks [slot] ) {
+            sol->order [sol->nkeys++] = slot;
+            sol->masks [slot] = sol_b->masks [slot];
+        }
+    }
+
+    *sol_out = sol;
+    return 0;
+}
+
+
+/**
+ * Replaces the solutions of slist with the merged cross products of
+ * slist and each alternative, like SolutionCache.merge_alternatives().
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode_sollist_merge_alternatives (
+    struct lkconfig_exprcode_sollist* const slist,
+    const struct lkconfig_exprcode_sollist* const alternatives,
+    const size_t num_alternatives,
+    const Py_ssize_t nslots
+) {
+    struct lkconfig_exprcode_sollist merged;
+    struct lkconfig_exprcode_sol* sol;
+    size_t alt_idx;
+    size_t a;
+    size_t b;
+
+    lkconfig_exprcode_sollist_init ( &merged );
+
+    for ( alt_idx = 0; alt_idx < num_alternatives; alt_idx++ ) {
+        for ( a = 0; a < slist->len; a++ ) {
+            for ( b = 0; b < alternatives [alt_idx].len; b++ ) {
+                if (
+                    lkconfig_exprcode_sol_merge (
+                        slist->v [a], alternatives [alt_idx].v [b],
+                        nslots, &sol
+                    ) != 0
+                ) {
+                    lkconfig_exprcode_sollist_free ( &merged );
+                    return -1;
+                }
+
+                if (
+                    (sol != NULL)
+                    && (lkconfig_exprcode_sollist_append ( &merged, sol ) != 0)
+                ) {
+                    lkconfig_exprcode_sollist_free ( &merged );
+                    return -1;
+                }
+            }
+        }
+    }
+
+    lkconfig_exprcode_sollist_free ( slist );
+    *slist = merged;
+    return 0;
+}
+
+
+/**
+ * Pushes a comparison "symbol [!]= constant" to the solution list,
+ * see Expr_SymbolEQ._solve_symbol_x_constant().
+ * */
+static int lkconfig_exprcode__solve_cmp_sym_const (
+    lkconfig_ExprCodeObject* const self,
+    struct lkconfig_exprcode_sollist* const slist,
+    const int cmp_op,
+    const int expr_value,
+    const int slot,
+    const int const_idx
+) {
+    int want_eq;
+    int values;
+
+    want_eq = (cmp_op == Py_EQ) ? expr_value : (! expr_value);
+
+    values = 1 << self->constvals [const_idx];
+    if ( ! want_eq ) { values = LKCONFIG_EXPRCODE_MASK_YMN & ~values; }
+
+    return lkconfig_exprcode_sollist_push_symbol (
+        slist, slot, values & self->validmasks [slot]
+    );
+}
+
+
+static int lkconfig_exprcode__solve (
+    lkconfig_ExprCodeObject* const self,
+    Py_ssize_t* const pc,
+    const int mask,
+    struct lkconfig_exprcode_sollist* const slist,
+    int* const solvable_out
+);
+
+
+/**
+ * Solves an OR expression whose subexpressions start at *pc,
+ * see Expr_Or._find_solution().
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode__solve_or (
+    lkconfig_ExprCodeObject* const self,
+    Py_ssize_t* const pc,
+    const int count,
+    const int mask,
+    struct lkconfig_exprcode_sollist* const slist,
+    int* const solvable_out
+) {
+    struct lkconfig_exprcode_sollist* alternatives;
+    size_t num_alternatives;
+    size_t k;
+    int sub_solvable;
+    int ret;
+
+    alternatives = PyMem_Malloc ( ((size_t) count + 1) * sizeof *alternatives );
+    if ( alternatives == NULL ) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    ret = 0;
+    num_alternatives = 0;
+    for ( k = 0; (ret == 0) && (k < (size_t) count); k++ ) {
+        ret = lkconfig_exprcode_sollist_init_empty_solution (
+            &(alternatives [num_alternatives]), self->nslots
+        );
+
+        if ( ret == 0 ) {
+            ret = lkconfig_exprcode__solve (
+                self, pc, mask,
+                &(alternatives [num_alternatives]), &sub_solvable
+            );
+        }
+
+        if ( (ret == 0) && sub_solvable ) {
+            num_alternatives++;
+        } else {
+            lkconfig_exprcode_sollist_free (
+                &(alternatives [num_alternatives])
+            );
+        }
+    }
+
+    if ( ret == 0 ) {
+        ret = lkconfig_exprcode_sollist_merge_alternatives (
+            slist, alternatives, num_alternatives, self->nslots
+        );
+        *solvable_out = (slist->len > 0) ? 1 : 0;
+    }
+
+    for ( k = 0; k < num_alternatives; k++ ) {
+        lkconfig_exprcode_sollist_free ( &(alternatives [k]) );
+    }
+    PyMem_Free ( alternatives );
+
+    return ret;
+}
+
+
+/**
+ * Adds the solutions of the subexpression at *pc to slist
+ * and moves pc past it.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode__solve (
+    lkconfig_ExprCodeObject* const self,
+    Py_ssize_t* const pc,
+    const int mask,
+    struct lkconfig_exprcode_sollist* const slist,
+    int* const solvable_out
+) {
+    const int* insn;
+    int expr_value;
+    int count;
+    int k;
+    int ret;
+
+    insn = &(self->code [*pc]);
+
+    switch ( insn [0] ) {
+        case LKCONFIG_EXPRCODE_OP_CONST:
+            *solvable_out = (mask & (1 << insn [1])) ? 1 : 0;
+            *pc += 2;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_SYM:
+            *solvable_out = lkconfig_exprcode_sollist_push_symbol (
+                slist, insn [1], mask & self->validmasks [insn [1]]
+            );
+            *pc += 2;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_CMP:
+            /* bool(max(expr_values)) */
+            expr_value = (mask & LKCONFIG_EXPRCODE_MASK_YM) ? 1 : 0;
+            *pc += 6;
+
+            if ( insn [2] == LKCONFIG_EXPRCODE_OPERAND_SYM ) {
+                if ( insn [4] == LKCONFIG_EXPRCODE_OPERAND_SYM ) {
+                    /* symbol X symbol, assume solvable */
+                    *solvable_out = 1;
+                } else {
+                    *solvable_out = lkconfig_exprcode__solve_cmp_sym_const (
+                        self, slist, insn [1], expr_value, insn [3], insn [5]
+                    );
+                }
+
+            } else if ( insn [4] == LKCONFIG_EXPRCODE_OPERAND_SYM ) {
+                *solvable_out = lkconfig_exprcode__solve_cmp_sym_const (
+                    self, slist, insn [1], expr_value, insn [5], insn [3]
+                );
+
+            } else {
+                ret = lkconfig_exprcode__eval_cmp ( self, NULL, insn );
+                if ( ret < 0 ) { return -1; }
+                *solvable_out = (ret == expr_value) ? 1 : 0;
+            }
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_NOT:
+            *pc += 1;
+            return lkconfig_exprcode__solve (
+                self, pc,
+                (
+                    (mask & LKCONFIG_EXPRCODE_MASK_N)
+                    ? LKCONFIG_EXPRCODE_MASK_YM : LKCONFIG_EXPRCODE_MASK_N
+                ),
+                slist, solvable_out
+            );
+
+        case LKCONFIG_EXPRCODE_OP_AND:
+            count = insn [1];
+            *pc  += 3;
+            *solvable_out = 1;
+            for ( k = 0; (*solvable_out) && (k < count); k++ ) {
+                if (
+                    lkconfig_exprcode__solve (
+                        self, pc, mask, slist, solvable_out
+                    ) != 0
+                ) {
+                    return -1;
+                }
+            }
+            *pc = insn [2];
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_OR:
+            count = insn [1];
+            *pc  += 3;
+            ret = lkconfig_exprcode__solve_or (
+                self, pc, count, mask, slist, solvable_out
+            );
+            *pc = insn [2];
+            return ret;
+
+        default:
+            PyErr_SetString ( PyExc_AssertionError, "bad opcode" );
+            return -1;
+    }
+}
+
+
+/**
+ * Converts a solution list to a list of "symbol => set of values" dicts.
+ * Identical value sets are shared between solutions.
+ *
+ * @return new reference to a list, or NULL on error (python exception set)
+ * */
+static PyObject* lkconfig_exprcode_sollist_to_pylist (
+    lkconfig_ExprCodeObject* const self,
+    const struct lkconfig_exprcode_sollist* const slist
+) {
+    PyObject** set_cache;
+    PyObject* result;
+    PyObject* sol_dict;
+    PyObject* value_set;
+    PyObject* normvals;
+    const struct lkconfig_exprcode_sol* sol;
+    Py_ssize_t cache_size;
+    Py_ssize_t j;
+    size_t k;
+    int slot;
+    int mask;
+    int v;
+
+    cache_size = 8 * self->nslots;
+    set_cache  = PyMem_Malloc ( (size_t) (cache_size + 1) * sizeof *set_cache );
+    if ( set_cache == NULL ) { return PyErr_NoMemory(); }
+    for ( j = 0; j < cache_size; j++ ) { set_cache [j] = NULL; }
+
+    result = PyList_New ( (Py_ssize_t) slist->len );
+
+    for ( k = 0; (result != NULL) && (k < slist->len); k++ ) {
+        sol = slist->v [k];
+
+        sol_dict = PyDict_New();
+        if ( sol_dict == NULL ) { Py_CLEAR ( result ); break; }
+        PyList_SET_ITEM ( result, (Py_ssize_t) k, sol_dict );  /* steal ref */
+
+        for ( j = 0; j < sol->nkeys; j++ ) {
+            slot      = sol->order [j];
+            mask      = sol->masks [slot];
+            value_set = set_cache [8 * slot + mask];
+
+            if ( value_set == NULL ) {
+                value_set = PySet_New ( NULL );
+                if ( value_set == NULL ) { Py_CLEAR ( result ); break; }
+                set_cache [8 * slot + mask] = value_set;
+
+                normvals = PyTuple_GET_ITEM ( self->normvalues, slot );
+                for ( v = 0; v < 3; v++ ) {
+                    if (
+                        (mask & (1 << v))
+                        && (
+                            PySet_Add (
+                                value_set, PyTuple_GET_ITEM ( normvals, v )
+                            ) != 0
+                        )
+                    ) {
+                        break;
+                    }
+                }
+                if ( v < 3 ) { Py_CLEAR ( result ); break; }
+            }
+
+            if (
+                PyDict_SetItem (
+                    sol_dict, PyTuple_GET_ITEM ( self->symbols, slot ),
+                    value_set
+                ) != 0
+            ) {
+                Py_CLEAR ( result );
+                break;
+            }
+        }
+    }
+
+    for ( j = 0; j < cache_size; j++ ) { Py_XDECREF ( set_cache [j] ); }
+    PyMem_Free ( set_cache );
+
+    return result;
+}
+
+
+/**
+ * Converts a solution list to a SolutionStore,
+ * mapping slots to symbol indices via slot_index.
+ *
+ * @param self        expression code
+ * @param slist       solution list
+ * @param slot_index  sequence of symbol indices, indexed by slot
+ *
+ * @return new SolutionStore, or NULL on error (python exception set)
+ * */
+static PyObject* lkconfig_exprcode_sollist_to_store (
+    lkconfig_ExprCodeObject* const self,
+    const struct lkconfig_exprcode_sollist* const slist,
+    PyObject* const slot_index
+) {
+    lkconfig_SolutionStoreObject* store;
+    const struct lkconfig_exprcode_sol* sol;
+    PyObject* item;
+    Py_ssize_t* sym_idx;
+    Py_ssize_t max_idx;
+    uint64_t* row;
+    Py_ssize_t j;
+    size_t k;
+    int slot;
+
+    if ( PySequence_Size ( slot_index ) != self->nslots ) {
+        if ( ! PyErr_Occurred() ) {
+            PyErr_SetString ( PyExc_ValueError, "slot index size mismatch" );
+        }
+        return NULL;
+    }
+
+    sym_idx = PyMem_Malloc ( (size_t) (self->nslots + 1) * sizeof *sym_idx );
+    if ( sym_idx == NULL ) { return PyErr_NoMemory(); }
+
+    max_idx = -1;
+    for ( j = 0; j < self->nslots; j++ ) {
+        item = PySequence_GetItem ( slot_index, j );
+        if ( item == NULL ) { PyMem_Free ( sym_idx ); return NULL; }
+        sym_idx [j] = PyLong_AsSsize_t ( item );
+        Py_DECREF ( item );
+
+        if ( sym_idx [j] < 0 ) {
+            if ( ! PyErr_Occurred() ) {
+                PyErr_SetString ( PyExc_ValueError, "negative symbol index" );
+            }
+            PyMem_Free ( sym_idx );
+            return NULL;
+        }
+        if ( sym_idx [j] > max_idx ) { max_idx = sym_idx [j]; }
+    }
+
+    store = lkconfig_SolutionStoreObject_new_empty (
+        lkconfig_solstore_width_for ( (size_t) (max_idx + 1) )
+    );
+
+    for ( k = 0; (store != NULL) && (k < slist->len); k++ ) {
+        sol = slist->v [k];
+
+        row = lkconfig_solstore__append_empty ( store );
+        if ( row == NULL ) { Py_CLEAR ( store ); break; }
+
+        for ( j = 0; j < sol->nkeys; j++ ) {
+            slot = sol->order [j];
+            lkconfig_solstore_row_set (
+                row, (size_t) sym_idx [slot],
+                LKCONFIG_SOLSTORE_PRESENT | sol->masks [slot]
+            );
+        }
+    }
+    PyMem_Free ( sym_idx );
+
+    if ( (store != NULL) && (lkconfig_solstore__dedup ( store ) != 0) ) {
+        Py_CLEAR ( store );
+    }
+
+    return (PyObject*) store;
+}
+
+
+/* ExprCode type */
+
+/**
+ * Checks the subexpression at *pc and moves pc past it.
+ * Also clears self->solvable if find_solution() would need
+ * the Python implementation (which raises NotImplementedError).
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_exprcode__check (
+    lkconfig_ExprCodeObject* const self, Py_ssize_t* const pc
+) {
+    const int* insn;
+    Py_ssize_t avail;
+    int count;
+    int k;
+    int cmp_const;
+
+#define _LKCONFIG_EXPRCODE_BAD(_msg)  \
+    do { \
+        PyErr_Format ( \
+            PyExc_ValueError, "bad expression code at %zd: %s", *pc, (_msg) \
+        ); \
+        return -1; \
+    } while (0)
+
+    avail = self->code_len - *pc;
+    if ( avail < 1 ) { _LKCONFIG_EXPRCODE_BAD ( "truncated" ); }
+    insn = &(self->code [*pc]);
+
+    switch ( insn [0] ) {
+        case LKCONFIG_EXPRCODE_OP_CONST:
+            if ( avail < 2 ) { _LKCONFIG_EXPRCODE_BAD ( "truncated" ); }
+            if ( (insn [1] < 0) || (insn [1] > 2) ) {
+                _LKCONFIG_EXPRCODE_BAD ( "bad constant" );
+            }
+            *pc += 2;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_SYM:
+            if ( avail < 2 ) { _LKCONFIG_EXPRCODE_BAD ( "truncated" ); }
+            if ( (insn [1] < 0) || (insn [1] >= self->nslots) ) {
+                _LKCONFIG_EXPRCODE_BAD ( "bad symbol slot" );
+            }
+            *pc += 2;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_CMP:
+            if ( avail < 6 ) { _LKCONFIG_EXPRCODE_BAD ( "truncated" ); }
+
+            switch ( insn [1] ) {
+                case Py_LT:
+                case Py_LE:
+                case Py_EQ:
+                case Py_NE:
+                case Py_GT:
+                case Py_GE:
+                    break;
+                default:
+                    _LKCONFIG_EXPRCODE_BAD ( "bad comparison" );
+            }
+
+            cmp_const = -1;
+            for ( k = 0; k < 2; k++ ) {
+                switch ( insn [2 + 2*k] ) {
+                    case LKCONFIG_EXPRCODE_OPERAND_SYM:
+                        if (
+                            (insn [3 + 2*k] < 0)
+                            || (insn [3 + 2*k] >= self->nslots)
+                        ) {
+                            _LKCONFIG_EXPRCODE_BAD ( "bad symbol slot" );
+                        }
+                        break;
+
+                    case LKCONFIG_EXPRCODE_OPERAND_CONST:
+                        if (
+                            (insn [3 + 2*k] < 0)
+                            || (
+                                insn [3 + 2*k]
+                                >= PyTuple_GET_SIZE ( self->constants )
+                            )
+                        ) {
+                            _LKCONFIG_EXPRCODE_BAD ( "bad constant index" );
+                        }
+                        cmp_const = insn [3 + 2*k];
+                        break;
+
+                    default:
+                        _LKCONFIG_EXPRCODE_BAD ( "bad operand kind" );
+                }
+            }
+
+            /* symbol X constant: only [!]= tristate is solved natively */
+            if (
+                (insn [2] != insn [4])
+                && (
+                    ((insn [1] != Py_EQ) && (insn [1] != Py_NE))
+                    || (self->constvals [cmp_const] < 0)
+                )
+            ) {
+                self->solvable = 0;
+            }
+
+            *pc += 6;
+            return 0;
+
+        case LKCONFIG_EXPRCODE_OP_NOT:
+            *pc += 1;
+            return lkconfig_exprcode__check ( self, pc );
+
+        case LKCONFIG_EXPRCODE_OP_AND:
+        case LKCONFIG_EXPRCODE_OP_OR:
+            if ( avail < 3 ) { _LKCONFIG_EXPRCODE_BAD ( "truncated" ); }
+            count = insn [1];
+            if ( count < 1 ) { _LKCONFIG_EXPRCODE_BAD ( "empty expression" ); }
+
+            *pc += 3;
+            for ( k = 0; k < count; k++ ) {
+                if ( lkconfig_exprcode__check ( self, pc ) != 0 ) {
+                    return -1;
+                }
+            }
+
+            if ( *pc != insn [2] ) {
+                _LKCONFIG_EXPRCODE_BAD ( "end offset mismatch" );
+            }
+            return 0;
+
+        default:
+            _LKCONFIG_EXPRCODE_BAD ( "bad opcode" );
+    }
+
+#undef _LKCONFIG_EXPRCODE_BAD
+}
+
+
+static int lkconfig_ExprCodeObject_traverse (
+    lkconfig_ExprCodeObject* const self, visitproc visit, void* arg
+) {
+    Py_VISIT ( self->symbols );
+    Py_VISIT ( self->normvalues );
+    Py_VISIT ( self->constants );
+    Py_VISIT ( self->tristates );
+    return 0;
+}
+
+
+static int lkconfig_ExprCodeObject_clear (
+    lkconfig_ExprCodeObject* const self
+) {
+    Py_CLEAR ( self->symbols );
+    Py_CLEAR ( self->normvalues );
+    Py_CLEAR ( self->constants );
+    Py_CLEAR ( self->tristates );
+    return 0;
+}
+
+
+static void lkconfig_ExprCodeObject_dealloc (
+    lkconfig_ExprCodeObject* const self
+) {
+    PyObject_GC_UnTrack ( self );
+    lkconfig_ExprCodeObject_clear ( self );
+    PyMem_Free ( self->code );
+    PyMem_Free ( self->validmasks );
+    PyMem_Free ( self->constvals );
+    Py_TYPE(self)->tp_free ( (PyObject*) self );
+}
+
+
+static PyObject* lkconfig_ExprCodeObject_new (
+    PyTypeObject* const type, PyObject* const args, PyObject* const kwargs
+) {
+    lkconfig_ExprCodeObject* self;
+    PyObject* code_arg;
+    PyObject* code_seq;
+    PyObject* symbols;
+    PyObject* normvalues;
+    PyObject* constants;
+    PyObject* tristates;
+    PyObject* item;
+    Py_ssize_t pc;
+    Py_ssize_t k;
+    Py_ssize_t nconst;
+    long lval;
+    int v;
+
+    static char* kwlist[] = {
+        "code", "symbols", "normvalues", "constants", "tristates", NULL
+    };
+
+    if (
+        ! PyArg_ParseTupleAndKeywords (
+            args, kwargs, "OO!O!O!O!:ExprCode", kwlist,
+            &code_arg,
+            &PyTuple_Type, &symbols,
+            &PyTuple_Type, &normvalues,
+            &PyTuple_Type, &constants,
+            &PyTuple_Type, &tristates
+        )
+    ) {
+        return NULL;
+    }
+
+    if ( PyTuple_GET_SIZE ( tristates ) != 3 ) {
+        PyErr_SetString ( PyExc_ValueError, "tristates must be a 3-tuple" );
+        return NULL;
+    }
+
+    if ( PyTuple_GET_SIZE ( normvalues ) != PyTuple_GET_SIZE ( symbols ) ) {
+        PyErr_SetString (
+            PyExc_ValueError, "symbols and normvalues differ in length"
+        );
+        return NULL;
+    }
+
+    self = (lkconfig_ExprCodeObject*) type->tp_alloc ( type, 0 );
+    if ( self == NULL ) { return NULL; }
+
+    self->code       = NULL;
+    self->code_len   = 0;
+    self->validmasks = NULL;
+    self->constvals  = NULL;
+    self->solvable   = 1;
+    self->nslots     = PyTuple_GET_SIZE ( symbols );
+
+    Py_INCREF ( symbols );    self->symbols    = symbols;
+    Py_INCREF ( normvalues ); self->normvalues = normvalues;
+    Py_INCREF ( constants );  self->constants  = constants;
+    Py_INCREF ( tristates );  self->tristates  = tristates;
+
+    /* code */
+    code_seq = PySequence_Fast ( code_arg, "code must be a sequence" );
+    if ( code_seq == NULL ) { goto err; }
+
+    self->code_len = PySequence_Fast_GET_SIZE ( code_seq );
+    self->code = PyMem_Malloc (
+        (size_t) (self->code_len + 1) * sizeof *(self->code)
+    );
+    if ( self->code == NULL ) {
+        Py_DECREF ( code_seq );
+        PyErr_NoMemory();
+        goto err;
+    }
+
+    for ( k = 0; k < self->code_len; k++ ) {
+        lval = PyLong_AsLong ( PySequence_Fast_GET_ITEM ( code_seq, k ) );
+        if ( (lval == -1) && PyErr_Occurred() ) {
+            Py_DECREF ( code_seq );
+            goto err;
+        }
+        if ( (lval < INT_MIN) || (lval > INT_MAX) ) {
+            Py_DECREF ( code_seq );
+            PyErr_SetString ( PyExc_OverflowError, "code value out of range" );
+            goto err;
+        }
+        self->code [k] = (int) lval;
+    }
+    Py_DECREF ( code_seq );
+
+    /* valid values of each symbol */
+    self->validmasks = PyMem_Malloc ( (size_t) self->nslots + 1 );
+    if ( self->validmasks == NULL ) { PyErr_NoMemory(); goto err; }
+
+    for ( k = 0; k < self->nslots; k++ ) {
+        item = PyTuple_GET_ITEM ( normvalues, k );
+        if ( ! PyTuple_Check ( item ) || (PyTuple_GET_SIZE ( item ) != 3) ) {
+            PyErr_SetString (
+                PyExc_ValueError, "normvalues items must be 3-tuples"
+            );
+            goto err;
+        }
+
+        self->validmasks [k] = 0;
+        for ( v = 0; v < 3; v++ ) {
+            if ( PyTuple_GET_ITEM ( item, v ) != Py_None ) {
+                self->validmasks [k] |= (unsigned char) (1 << v);
+            }
+        }
+    }
+
+    /* tristate values of constants */
+    nconst = PyTuple_GET_SIZE ( constants );
+    self->constvals = PyMem_Malloc (
+        (size_t) (nconst + 1) * sizeof *(self->constvals)
+    );
+    if ( self->constvals == NULL ) { PyErr_NoMemory(); goto err; }
+
+    for ( k = 0; k < nconst; k++ ) {
+        item = PyTuple_GET_ITEM ( constants, k );
+        if (
+            PyObject_TypeCheck (
+                item, Py_TYPE ( PyTuple_GET_ITEM ( tristates, 0 ) )
+            )
+        ) {
+            if (
+                lkconfig_exprcode__to_tristate (
+                    self, item, &(self->constvals [k])
+                ) != 0
+            ) {
+                goto err;
+            }
+        } else {
+            self->constvals [k] = -1;
+        }
+    }
+
+    /* check code */
+    pc = 0;
+    if ( lkconfig_exprcode__check ( self, &pc ) != 0 ) { goto err; }
+    if ( pc != self->code_len ) {
+        PyErr_SetString ( PyExc_ValueError, "trailing expression code" );
+        goto err;
+    }
+
+    return (PyObject*) self;
+
+err:
+    Py_DECREF ( self );
+    return NULL;
+}
+
+
+static PyObject* lkconfig_ExprCodeObject_evaluate (
+    lkconfig_ExprCodeObject* const self, PyObject* const args
+) {
+    struct lkconfig_exprcode_values vals;
+    PyObject* symbol_value_map;
+    PyObject* result;
+    Py_ssize_t pc;
+    int tri;
+
+    if ( ! PyArg_ParseTuple ( args, "O", &symbol_value_map ) ) { return NULL; }
+
+    result = NULL;
+    pc     = 0;
+    if (
+        (lkconfig_exprcode_values_load ( self, symbol_value_map, &vals ) == 0)
+        && (lkconfig_exprcode__eval ( self, &vals, &pc, &tri ) == 0)
+    ) {
+        result = PyTuple_GET_ITEM ( self->tristates, tri );
+        Py_INCREF ( result );
+    }
+
+    lkconfig_exprcode_values_free ( &vals );
+    return result;
+}
+
+
+static PyObject* lkconfig_ExprCodeObject_evaluate_solution (
+    lkconfig_ExprCodeObject* const self, PyObject* const args
+) {
+    struct lkconfig_exprcode_values vals;
+    struct lkconfig_intbuf solution;
+    PyObject* symbol_value_map;
+    PyObject* expr_values;
+    PyObject* solution_set;
+    PyObject* result;
+    Py_ssize_t pc;
+    size_t k;
+    int mask;
+    int solvable;
+
+    if ( ! PyArg_ParseTuple ( args, "OO", &symbol_value_map, &expr_values ) ) {
+        return NULL;
+    }
+
+    if (
+        lkconfig_exprcode__get_value_mask ( self, expr_values, 0, &mask ) < 0
+    ) {
+        return NULL;
+    }
+
+    lkconfig_intbuf_init ( &solution );
+    result = NULL;
+    pc     = 0;
+
+    if (
+        (lkconfig_exprcode_values_load ( self, symbol_value_map, &vals ) == 0)
+        && (
+            lkconfig_exprcode__eval_solution (
+                self, &vals, &pc, mask, &solution, &solvable
+            ) == 0
+        )
+    ) {
+        solution_set = PySet_New ( NULL );
+
+        for ( k = 0; (solution_set != NULL) && (k < solution.len); k++ ) {
+            if (
+                PySet_Add (
+                    solution_set,
+                    PyTuple_GET_ITEM ( self->symbols, solution.data [k] )
+                ) != 0
+            ) {
+                Py_CLEAR ( solution_set );
+            }
+        }
+
+        if ( solution_set != NULL ) {
+            result = Py_BuildValue (
+                "(NN)", PyBool_FromLong ( solvable ), solution_set
+            );
+        }
+    }
+
+    lkconfig_intbuf_free ( &solution );
+    lkconfig_exprcode_values_free ( &vals );
+    return result;
+}
+
+
+static PyObject* lkconfig_ExprCodeObject_find_solution (
+    lkconfig_ExprCodeObject* const self, PyObject* const args
+) {
+    struct lkconfig_exprcode_sollist slist;
+    PyObject* expr_values;
+    PyObject* slot_index;
+    PyObject* solutions;
+    Py_ssize_t pc;
+    int mask;
+    int solvable;
+    int ret;
+
+    slot_index = Py_None;
+    if ( ! PyArg_ParseTuple ( args, "O|O", &expr_values, &slot_index ) ) {
+        return NULL;
+    }
+
+    if ( ! self->solvable ) { Py_RETURN_NONE; }
+
+    ret = lkconfig_exprcode__get_value_mask ( self, expr_values, 1, &mask );
+    if ( ret < 0 ) { return NULL; }
+    if ( ret == 0 ) { Py_RETURN_NONE; }
+
+    if (
+        lkconfig_exprcode_sollist_init_empty_solution ( &slist, self->nslots )
+        != 0
+    ) {
+        lkconfig_exprcode_sollist_free ( &slist );
+        return NULL;
+    }
+
+    pc = 0;
+    solutions = NULL;
+    if ( lkconfig_exprcode__solve ( self, &pc, mask, &slist, &solvable ) == 0 ) {
+        if ( slot_index == Py_None ) {
+            solutions = lkconfig_exprcode_sollist_to_pylist ( self, &slist );
+        } else {
+            solutions = lkconfig_exprcode_sollist_to_store (
+                self, &slist, slot_index
+            );
+        }
+    }
+    lkconfig_exprcode_sollist_free ( &slist );
+
+    if ( solutions == NULL ) { return NULL; }
+    return Py_BuildValue ( "(NN)", PyBool_FromLong ( solvable ), solutions );
+}
+
+
+static PyMethodDef lkconfig_ExprCodeObject_methods[] = {
+    {
+        "evaluate",
+        (PyCFunction) lkconfig_ExprCodeObject_evaluate,
+        METH_VARARGS,
+        PyDoc_STR (
+            "evaluate(symbol_value_map)\n"
+            "\n"
+            "Calculates the tristate value of the expression,\n"
+            "symbols missing in symbol_value_map are considered to be n.\n"
+        )
+    },
+    {
+        "evaluate_solution",
+        (PyCFunction) lkconfig_ExprCodeObject_evaluate_solution,
+        METH_VARARGS,
+        PyDoc_STR (
+            "evaluate_solution(symbol_value_map, expr_values)\n"
+            "\n"
+            "Returns a 2-tuple (solvable, set of involved symbols),\n"
+            "see symbolexpr.Expr.evaluate_solution().\n"
+        )
+    },
+    {
+        "find_solution",
+        (PyCFunction) lkconfig_ExprCodeObject_find_solution,
+        METH_VARARGS,
+        PyDoc_STR (
+            "find_solution(expr_values, slot_index=None)\n"
+            "\n"
+            "Returns a 2-tuple (solvable, list of symbol => value set dicts),\n"
+            "see symbolexpr.Expr.find_solution().\n"
+            "\n"
+            "If slot_index, a sequence of symbol indices indexed by slot,\n"
+            "is given, the solutions are returned as SolutionStore instead.\n"
+            "\n"
+            "Returns None if the expression or expr_values cannot be solved\n"
+            "natively, e.g. expr_values containing non-tristate values.\n"
+        )
+    },
+    { NULL }
+};
+
+
+static PyMemberDef lkconfig_ExprCodeObject_members[] = {
+    {
+        "symbols",
+        T_OBJECT, offsetof(lkconfig_ExprCodeObject, symbols), READONLY,
+        PyDoc_STR ( "tuple of symbols, indexed by slot" )
+    },
+    {
+        "solvable",
+        T_BOOL, offsetof(lkconfig_ExprCodeObject, solvable), READONLY,
+        PyDoc_STR ( "whether find_solution() is supported" )
+    },
+    { NULL }
+};
+
+
+static PyTypeObject lkconfig_ExprCodeType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+
+    LKCONFIG_PYMOD_NAME "." lkconfig_ExprCodeName,
+    sizeof (lkconfig_ExprCodeObject),
+    0,                         /* tp_itemsize */
+    (destructor) lkconfig_ExprCodeObject_dealloc,  /* tp_dealloc */
+    0,                         /* tp_print */
+    0,                         /* tp_getattr */
+    0,                         /* tp_setattr */
+    0,                         /* tp_reserved */
+    0,                         /* tp_repr */
+    0,                         /* tp_as_number */
+    0,                         /* tp_as_sequence */
+    0,                         /* tp_as_mapping */
+    PyObject_HashNotImplemented,  /* tp_hash  */
+    0,                         /* tp_call */
+    0,                         /* tp_str */
+    0,                         /* tp_getattro */
+    0,                         /* tp_setattro */
+    0,                         /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,  /* tp_flags */
+    PyDoc_STR (
+        "compiled dependency expression\n"
+        "\n"
+        "ExprCode(code, symbols, normvalues, constants, tristates)"
+        " -- see symbolexpr.Expr.compile()"
+    ),  /* tp doc */
+    (traverseproc) lkconfig_ExprCodeObject_traverse,  /* tp_traverse */
+    (inquiry) lkconfig_ExprCodeObject_clear,          /* tp_clear */
+    0,                         /* tp_richcompare */
+    0,                         /* tp_weaklistoffset */
+    0,                         /* tp_iter */
+    0,                         /* tp_iternext */
+    lkconfig_ExprCodeObject_methods,  /* tp_methods */
+    lkconfig_ExprCodeObject_members,  /* tp_members */
+    0,                         /* tp_getset */
+    0,                         /* tp_base */
+    0,                         /* tp_dict */
+    0,                         /* tp_descr_get */
+    0,                         /* tp_descr_set */
+    0,                         /* tp_dictoffset */
+    0,                         /* tp_init */
+    0,                         /* tp_alloc */
+    lkconfig_ExprCodeObject_new  /* tp_new */
+};
+
+
+static int lkconfig_ExprCodeObject_cls_init ( PyTypeObject* const pycls ) {
+    PyObject* d;
+
+    d = PyDict_New();
+    if ( d == NULL ) { return -1; }
+
+#define lkconfig_add_exprcode_int(_name, _value)  \
+    do { \
+        if ( lkconfig_dict_add_str_x_int ( d, (_name), (_value) ) != 0 ) { \
+            Py_DECREF ( d ); \
+            return -1; \
+        } \
+    } while (0)
+
+    lkconfig_add_exprcode_int ( "OP_CONST", LKCONFIG_EXPRCODE_OP_CONST );
+    lkconfig_add_exprcode_int ( "OP_SYM",   LKCONFIG_EXPRCODE_OP_SYM );
+    lkconfig_add_exprcode_int ( "OP_CMP",   LKCONFIG_EXPRCODE_OP_CMP );
+    lkconfig_add_exprcode_int ( "OP_NOT",   LKCONFIG_EXPRCODE_OP_NOT );
+    lkconfig_add_exprcode_int ( "OP_AND",   LKCONFIG_EXPRCODE_OP_AND );
+    lkconfig_add_exprcode_int ( "OP_OR",    LKCONFIG_EXPRCODE_OP_OR );
+
+    lkconfig_add_exprcode_int (
+        "OPERAND_SYM", LKCONFIG_EXPRCODE_OPERAND_SYM
+    );
+    lkconfig_add_exprcode_int (
+        "OPERAND_CONST", LKCONFIG_EXPRCODE_OPERAND_CONST
+    );
+
+    lkconfig_add_exprcode_int ( "CMP_LT", Py_LT );
+    lkconfig_add_exprcode_int ( "CMP_LE", Py_LE );
+    lkconfig_add_exprcode_int ( "CMP_EQ", Py_EQ );
+    lkconfig_add_exprcode_int ( "CMP_NE", Py_NE );
+    lkconfig_add_exprcode_int ( "CMP_GT", Py_GT );
+    lkconfig_add_exprcode_int ( "CMP_GE", Py_GE );
+
+#undef lkconfig_add_exprcode_int
+
+    pycls->tp_dict = d; d = NULL;  /* steal ref */
+
+    return PyType_Ready(pycls);
+}
+
+#undef LKCONFIG_EXPRCODE_MASK_N
+#undef LKCONFIG_EXPRCODE_MASK_YM
+#undef LKCONFIG_EXPRCODE_MASK_YMN
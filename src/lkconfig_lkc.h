@@ -3,3 +3,17 @@
 #endif
 
 #include LKCONFIG_LKC
+
+/* from symbol.c, not declared by lkc.h */
+extern tristate modules_val;
+
+/* lexer state from zconf.lex.c, not declared by lkc.h */
+extern FILE* zconfin;
+int zconflex_destroy ( void );
+
+#ifdef LKCONFIG_LKC_BUNDLED
+/* parser state from zconf.tab.c, see lkconfig__conf_parse_phases() */
+extern int zconfdebug;
+extern int zconfnerrs;
+int zconfparse ( void );
+#endif
@@ -24,8 +24,16 @@ typedef struct {
     PyObject_HEAD
 
     /* make a few fields available as PyObjects */
+    /* name str, created on first access */
     PyObject* name;
     int s_type;
+    /* symbol index, -1 if not indexed, see lkconfig_symindex.c */
+    int index;
+
+    /* context the symbol belongs to, keeps the symbol alive */
+    PyObject* context;
+    /* context generation, see lkconfig_context_check_view() */
+    unsigned long generation;
 
     const struct symbol* kconfig_sym;
 } lkconfig_SymbolViewObject;
@@ -36,16 +44,350 @@ typedef struct {
     PyObject_HEAD
     int e_type;
 
+    /* context the expr belongs to, keeps the expr alive */
+    PyObject* context;
+    /* context generation, see lkconfig_context_check_view() */
+    unsigned long generation;
+
     const struct expr* kconfig_expr;
 } lkconfig_ExprViewObject;
 
 
+#define lkconfig_SolutionStoreName  "SolutionStore"
+/**
+ * A list of expression solutions, see lkconfig_solstore.c.
+ *
+ * Each solution is a row of width words, holding one 4-bit nibble
+ * per symbol index: bit 3 marks the symbol as part of the solution,
+ * bits 0..2 are the bitmask of its allowed tristate values (n, m, y).
+ * */
+typedef struct {
+    PyObject_HEAD
+
+    uint64_t* words;
+    size_t    width;
+    size_t    len;
+    size_t    cap;
+
+    /* number of merges using this store with the GIL released */
+    int       busy;
+} lkconfig_SolutionStoreObject;
+
+
+#define lkconfig_ExprCodeName  "ExprCode"
+/**
+ * A compiled symbolexpr.Expr, see lkconfig_exprcode.c.
+ * */
+typedef struct {
+    PyObject_HEAD
+
+    /* flat expression code, see the LKCONFIG_EXPRCODE_OP_* constants */
+    int*       code;
+    Py_ssize_t code_len;
+
+    /* symbol slot => symbol / 3-tuple of normalized n, m, y values */
+    PyObject*  symbols;
+    PyObject*  normvalues;
+    Py_ssize_t nslots;
+    /* symbol slot => bitmask of valid tristate values */
+    unsigned char* validmasks;
+
+    /* constant operands of comparisons */
+    PyObject*  constants;
+    /* constant => tristate value or -1 if not a tristate */
+    int*       constvals;
+
+    /* 3-tuple (n, m, y) of tristate objects */
+    PyObject*  tristates;
+
+    /* whether find_solution() can be used */
+    char       solvable;
+} lkconfig_ExprCodeObject;
+
+
+/**
+ * An arena for the objects created by lkc's parser,
+ * see lkconfig_arena.c.
+ * */
+struct lkconfig_arena {
+    /* list of chunks, linked via their first word */
+    void*  chunks;
+    size_t nchunks;
+
+    /* free space in the newest chunk */
+    char*  pos;
+    char*  end;
+};
+
+
+/**
+ * lkc's global parser state, see lkconfig_context.c.
+ * */
+struct lkconfig_lkc_state {
+    struct symbol* symbol_hash[SYMBOL_HASHSIZE];
+    struct menu    rootmenu;
+    struct file*   file_list;
+    struct symbol* modules_sym;
+    tristate       modules_val;
+    struct symbol* sym_defconfig_list;
+    struct expr*   sym_env_list;
+
+    /* objects allocated while parsing, see lkconfig_arena.c */
+    struct lkconfig_arena arena;
+};
+
+
+/**
+ * A growable int array, used for building packed result columns.
+ *
+ * Each column is handed over to Python as bytes object,
+ * see lkconfig_intbuf_to_bytes().
+ * */
+struct lkconfig_intbuf {
+    int*   data;
+    size_t len;
+    size_t cap;
+};
+
+/**
+ * An open-addressing pointer => int hash table,
+ * see lkconfig_ptrmap_get(), lkconfig_ptrmap_set().
+ * */
+struct lkconfig_ptrmap {
+    const void** keys;
+    int*         values;
+    size_t       size;
+    size_t       count;
+};
+
+
+/**
+ * One view object per lkc object, see lkconfig_viewcache.c.
+ * */
+struct lkconfig_viewcache {
+    /* lkc object => slot */
+    struct lkconfig_ptrmap map;
+    /* slot => view (borrowed) or NULL */
+    PyObject**             views;
+    size_t                 len;
+    size_t                 cap;
+};
+
+
+/**
+ * A slot of the symbol name table, see lkconfig_symindex_find_name().
+ * */
+struct lkconfig_symindex_nameslot {
+    /* hash of the symbol name, see lkconfig_symindex_name_hash() */
+    size_t hash;
+    /* symbol index, -1 marks empty slots */
+    int    index;
+};
+
+/**
+ * Dense symbol indices of a context, see lkconfig_symindex.c.
+ * */
+struct lkconfig_symindex {
+    /* symbol => index */
+    struct lkconfig_ptrmap map;
+    /* index => symbol */
+    struct symbol**        syms;
+    size_t                 nsyms;
+
+    /* symbol name => index, open addressing */
+    struct lkconfig_symindex_nameslot* names;
+    size_t                 names_size;
+    size_t                 names_count;
+
+    /* index => interned name str, created on demand, or NULL */
+    PyObject**             pynames;
+};
+
+
+/**
+ * A reverse dependency graph of lkc's symbols,
+ * see lkconfig_depgraph_build(), lkconfig_depgraph_invalidate()
+ * and lkconfig_depgraph_defer().
+ * */
+struct lkconfig_depgraph {
+    /* symbol index of the context, not owned by the graph */
+    const struct lkconfig_symindex* symindex;
+
+    /* CSR dependents: offsets has nsyms + 1 entries */
+    int*                   offsets;
+    int*                   targets;
+
+    /* traversal state */
+    int*                   queue;
+    unsigned int*          marks;
+    unsigned int           stamp;
+
+    /*
+     * symbols whose state has changed without being invalidated,
+     * see lkconfig_depgraph_defer()
+     * */
+    int*                   pending;
+    size_t                 npending;
+    unsigned char*         is_pending;
+    /* the next invalidation must invalidate all symbols */
+    int                    pending_all;
+};
+
+
+#define lkconfig_ContextName  "Context"
+typedef struct {
+    PyObject_HEAD
+    int have_symbols;
+
+    /*
+     * incremented whenever clear() frees the state,
+     * views created before that point to freed objects
+     * */
+    unsigned long generation;
+
+    /* saved lkc state, unused while the context is active */
+    struct lkconfig_lkc_state state;
+
+    /* dense symbol indices, built after parsing */
+    struct lkconfig_symindex symindex;
+
+    /* dependency graph of the symbols, built on demand or NULL */
+    struct lkconfig_depgraph* depgraph;
+
+    /* SymbolView/ExprView objects of the context's symbols and exprs */
+    struct lkconfig_viewcache symviews;
+    struct lkconfig_viewcache exprviews;
+} lkconfig_ContextObject;
+
+/* the context whose state is currently in lkc's globals */
+static lkconfig_ContextObject* lkconfig_active_context = NULL;
+
+/*
+ * lock for lkc's globals, held while lkc code runs with the GIL released,
+ * see lkconfig_lkc_lock_acquire()
+ * */
+static PyThread_type_lock lkconfig_lkc_lock = NULL;
+static unsigned long lkconfig_lkc_lock_owner = 0;
+
+
+/**
+ * Profiled phases and counters, see lkconfig_prof.c.
+ * */
+enum {
+    lkconfig_prof_parse,
+    lkconfig_prof_menu_finalize,
+    lkconfig_prof_symindex,
+    lkconfig_prof_conf_read,
+    lkconfig_prof_conf_check,
+    lkconfig_prof_conf_values,
+    lkconfig_prof_conf_write,
+
+    lkconfig_prof__phase_count
+};
+
+enum {
+    lkconfig_prof_kconfig_files,
+    lkconfig_prof_symbols,
+    lkconfig_prof_exprs,
+    lkconfig_prof_sym_calc_value_calls,
+    lkconfig_prof_conf_runs,
+    lkconfig_prof_conf_passes,
+    lkconfig_prof_bytes_written,
+
+    lkconfig_prof__counter_count
+};
+
+/**
+ * Accumulated time of a profiled phase.
+ * */
+struct lkconfig_prof_phase {
+    unsigned long long calls;
+    unsigned long long wall_ns;
+    unsigned long long cpu_ns;
+};
+
+/**
+ * A running phase timer, see lkconfig_prof_timer_start().
+ * */
+struct lkconfig_prof_timer {
+    int                active;
+    unsigned long long wall_ns;
+    unsigned long long cpu_ns;
+};
+
+
+/**
+ * A .config file mapped into memory, see lkconfig_confread.c.
+ * */
+struct lkconfig_confread {
+    const char*  data;
+    size_t       size;
+    /* whether data has been mmap-ed */
+    int          is_mmap;
+    /* whether data has been read into a buffer (non-regular files) */
+    int          is_alloc;
+
+    /* tokenizer state */
+    size_t       pos;
+    unsigned int lineno;
+};
+
+enum {
+    /* blank line or comment */
+    LKCONFIG_CONFREAD_NONE,
+    /* <name>=<value> */
+    LKCONFIG_CONFREAD_VALUE,
+    /* # <name> is not set */
+    LKCONFIG_CONFREAD_UNSET,
+    /* anything else */
+    LKCONFIG_CONFREAD_INVALID
+};
+
+/**
+ * A tokenized .config line, all spans point into the mapped file.
+ * */
+struct lkconfig_confread_line {
+    int          kind;
+    unsigned int lineno;
+
+    /* the entire line, without trailing whitespace */
+    const char*  line;
+    size_t       line_len;
+
+    /* option name (including the CONFIG_ prefix) */
+    const char*  name;
+    size_t       name_len;
+
+    /*
+     * value token, quotes are not removed (VALUE lines only),
+     * it may be followed by other data up to the end of the line
+     * */
+    const char*  value;
+    size_t       value_len;
+};
+
+
+/**
+ * A growable list of log messages that can be filled
+ * while the GIL is released, see lkconfig_msgbuf_appendv().
+ *
+ * The messages are passed to a Python logger afterwards,
+ * see lkconfig_msgbuf_flush().
+ * */
+struct lkconfig_msgbuf {
+    char**  msgv;
+    size_t  len;
+    size_t  cap;
+    size_t  dropped;
+};
+
+
 static PyObject* lkconfig_ExprViewObject_new_from_struct (
-    const struct expr* kconfig_expr
+    lkconfig_ContextObject* const ctx, const struct expr* kconfig_expr
 );
 
 static PyObject* lkconfig_SymbolViewObject_new_from_struct (
-    const struct symbol* const sym
+    lkconfig_ContextObject* const ctx, const struct symbol* const sym
 );
 
 /**
@@ -0,0 +1,302 @@
+/*
+ * Parse-phase profiling.
+ *
+ * Profiling is disabled by default and can be enabled with
+ * set_profiling(). While enabled, read_symbols() and the oldconfig
+ * functions accumulate the wall clock and CPU time of their phases
+ * and a few counters, which can be retrieved with get_profile().
+ *
+ * CPU time is measured per thread (CLOCK_THREAD_CPUTIME_ID),
+ * lkc code always runs in the thread that called the lkconfig function.
+ *
+ * The profile is only modified while holding the lkc lock,
+ * it is a global state and not bound to a context.
+ * Timers do not involve python objects and may be used
+ * without holding the GIL.
+ *
+ * */
+
+#include <time.h>       /* lkconfig_prof_timer_start() */
+#include <sys/stat.h>   /* lkconfig_prof_count_file_size() */
+
+
+static const char* const lkconfig_prof_phase_names[] = {
+    /*
+     * reading and parsing Kconfig files, zconfparse() (lexing is driven
+     * by the parser and cannot be timed separately),
+     * all of conf_parse() if lkc is not the bundled one
+     * */
+    "parse",
+    /*
+     * menu_finalize() and the dependency checks,
+     * only with the bundled lkc, see lkconfig__conf_parse_phases()
+     * */
+    "menu_finalize",
+    /* building the dense symbol index */
+    "symindex",
+    /* loading the input config from a .config file or config values */
+    "conf_read",
+    /* the oldconfig passes */
+    "conf_check",
+    /* creating the resolved config values dict */
+    "conf_values",
+    /* writing the output .config file */
+    "conf_write",
+
+    NULL
+};
+
+static const char* const lkconfig_prof_counter_names[] = {
+    /* Kconfig files read by the parser */
+    "kconfig_files",
+    /* symbols created by the parser, including const symbols */
+    "symbols",
+    /* distinct expression nodes, see lkconfig_lkc_state_collect() */
+    "exprs",
+    /*
+     * sym_calc_value() calls issued by lkconfig,
+     * lkc's own (recursive) calls are not counted
+     * */
+    "sym_calc_value",
+    /* oldconfig runs and passes (conf_cnt iterations) */
+    "conf_runs",
+    "conf_passes",
+    /* size of the written .config files */
+    "bytes_written",
+
+    NULL
+};
+
+static int lkconfig_prof_enabled = 0;
+static struct lkconfig_prof_phase
+    lkconfig_prof_phases[lkconfig_prof__phase_count];
+static unsigned long long
+    lkconfig_prof_counters[lkconfig_prof__counter_count];
+
+
+static unsigned long long lkconfig_prof__clock_ns ( const clockid_t clk ) {
+    struct timespec ts;
+
+    if ( clock_gettime ( clk, &ts ) != 0 ) { return 0; }
+
+    return (
+        ((unsigned long long) ts.tv_sec * 1000000000ULL)
+        + (unsigned long long) ts.tv_nsec
+    );
+}
+
+
+/**
+ * Starts a phase timer. Does nothing if profiling is disabled.
+ *
+ * @param timer  timer
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_prof_timer_start (
+    struct lkconfig_prof_timer* const timer
+) {
+    timer->active = lkconfig_prof_enabled;
+    if ( timer->active ) {
+        timer->wall_ns = lkconfig_prof__clock_ns ( CLOCK_MONOTONIC );
+        timer->cpu_ns  = lkconfig_prof__clock_ns ( CLOCK_THREAD_CPUTIME_ID );
+    }
+}
+
+
+/**
+ * Stops a phase timer and adds the elapsed time to the given phase.
+ *
+ * @param timer  timer, see lkconfig_prof_timer_start()
+ * @param phase  phase, must be one of lkconfig_prof_{parse,...}
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_prof_timer_stop (
+    struct lkconfig_prof_timer* const timer, const int phase
+) {
+    struct lkconfig_prof_phase* const p = &(lkconfig_prof_phases [phase]);
+
+    if ( ! timer->active ) { return; }
+
+    (p->calls)++;
+    p->wall_ns += (
+        lkconfig_prof__clock_ns ( CLOCK_MONOTONIC ) - timer->wall_ns
+    );
+    p->cpu_ns  += (
+        lkconfig_prof__clock_ns ( CLOCK_THREAD_CPUTIME_ID ) - timer->cpu_ns
+    );
+    timer->active = 0;
+}
+
+
+/**
+ * Adds to a counter. Does nothing if profiling is disabled.
+ *
+ * @param counter  counter, must be one of lkconfig_prof_{kconfig_files,...}
+ * @param n        value to add
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_prof_count (
+    const int counter, const unsigned long long n
+) {
+    if ( lkconfig_prof_enabled ) {
+        lkconfig_prof_counters [counter] += n;
+    }
+}
+
+
+/* sym_calc_value() variant that counts calls, see lkconfig_prof_count() */
+static void lkconfig_prof_sym_calc_value ( struct symbol* const sym ) {
+    lkconfig_prof_count ( lkconfig_prof_sym_calc_value_calls, 1 );
+    sym_calc_value ( sym );
+}
+
+
+/**
+ * Adds the size of a written file to the bytes_written counter.
+ * Does nothing if profiling is disabled.
+ *
+ * @param filename  path to the file
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_prof_count_file_size ( const char* const filename ) {
+    struct stat stat_info;
+
+    if ( lkconfig_prof_enabled && (stat ( filename, &stat_info ) == 0) ) {
+        lkconfig_prof_count (
+            lkconfig_prof_bytes_written,
+            (unsigned long long) stat_info.st_size
+        );
+    }
+}
+
+
+static void lkconfig_prof_reset (void) {
+    memset ( lkconfig_prof_phases, 0, sizeof lkconfig_prof_phases );
+    memset ( lkconfig_prof_counters, 0, sizeof lkconfig_prof_counters );
+}
+
+
+/**
+ * Updates the parser counters after parsing. Does nothing if
+ * profiling is disabled. Must be called with lkc's globals active.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_prof_count_parse_results (void) {
+    struct lkconfig_lkc_state st;
+    struct lkconfig_ptrmap props;
+    struct lkconfig_ptrmap exprs;
+    const struct file* file;
+    const struct symbol* sym;
+    unsigned long long nfiles;
+    unsigned long long nsyms;
+    unsigned int i;
+    int ret;
+
+    if ( ! lkconfig_prof_enabled ) { return 0; }
+
+    nfiles = 0;
+    for ( file = file_list; file != NULL; file = file->next ) { nfiles++; }
+
+    /* unlike for_all_symbols(), this includes the S_OTHER symbols */
+    nsyms = 0;
+    for ( i = 0; i < SYMBOL_HASHSIZE; i++ ) {
+        for ( sym = symbol_hash [i]; sym != NULL; sym = sym->next ) {
+            nsyms++;
+        }
+    }
+
+    /* st does not own anything, see lkconfig_lkc_state_save() */
+    lkconfig_lkc_state_save ( &st );
+    lkconfig_ptrmap_init ( &props );
+    lkconfig_ptrmap_init ( &exprs );
+
+    ret = lkconfig_lkc_state_collect ( &st, &props, &exprs );
+    if ( ret == 0 ) {
+        lkconfig_prof_count ( lkconfig_prof_kconfig_files, nfiles );
+        lkconfig_prof_count ( lkconfig_prof_symbols, nsyms );
+        lkconfig_prof_count ( lkconfig_prof_exprs, exprs.count );
+    }
+
+    lkconfig_ptrmap_free ( &props );
+    lkconfig_ptrmap_free ( &exprs );
+    return ret;
+}
+
+
+/**
+ * Creates the profile dict, see get_profile().
+ *
+ * @return new reference to dict, NULL on error (python exception set)
+ * */
+static PyObject* lkconfig_prof_get_dict (void) {
+    const struct lkconfig_prof_phase* p;
+    PyObject* profile;
+    PyObject* phases;
+    PyObject* counters;
+    PyObject* item;
+    int k;
+
+    phases = PyDict_New();
+    if ( phases == NULL ) { return NULL; }
+
+    for ( k = 0; k < lkconfig_prof__phase_count; k++ ) {
+        p = &(lkconfig_prof_phases [k]);
+
+        item = Py_BuildValue (
+            "{sKsdsd}",
+            "calls", p->calls,
+            "wall", ((double) p->wall_ns / 1e9),
+            "cpu", ((double) p->cpu_ns / 1e9)
+        );
+        if (
+            (item == NULL)
+            || (
+                PyDict_SetItemString (
+                    phases, lkconfig_prof_phase_names [k], item
+                ) != 0
+            )
+        ) {
+            Py_XDECREF ( item );
+            Py_DECREF ( phases );
+            return NULL;
+        }
+        Py_DECREF ( item );
+    }
+
+    counters = PyDict_New();
+    if ( counters == NULL ) {
+        Py_DECREF ( phases );
+        return NULL;
+    }
+
+    for ( k = 0; k < lkconfig_prof__counter_count; k++ ) {
+        item = PyLong_FromUnsignedLongLong ( lkconfig_prof_counters [k] );
+        if (
+            (item == NULL)
+            || (
+                PyDict_SetItemString (
+                    counters, lkconfig_prof_counter_names [k], item
+                ) != 0
+            )
+        ) {
+            Py_XDECREF ( item );
+            Py_DECREF ( counters );
+            Py_DECREF ( phases );
+            return NULL;
+        }
+        Py_DECREF ( item );
+    }
+
+    profile = Py_BuildValue (
+        "{sNsNsO}",
+        "phases", phases,
+        "counters", counters,
+        "enabled", (lkconfig_prof_enabled ? Py_True : Py_False)
+    );
+    return profile;
+}
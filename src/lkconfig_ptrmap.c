@@ -0,0 +1,145 @@
+/*
+ * A small open-addressing pointer => int hash table,
+ * used for deduplicating lkc objects (struct expr, struct symbol)
+ * when exporting them to Python.
+ *
+ * Keys must not be NULL (NULL marks empty slots).
+ *
+ * */
+
+#define LKCONFIG_PTRMAP_INITIAL_SIZE  1024
+
+
+static size_t lkconfig_ptrmap_hash ( const void* const key ) {
+    uintptr_t h;
+
+    /* pointer bits are not random, at least the lowest bits are zero */
+    h = (uintptr_t) key;
+    h ^= (h >> 17);
+    h *= (uintptr_t) 0x9e3779b97f4a7c15ULL;
+    h ^= (h >> 29);
+    return (size_t) h;
+}
+
+
+static void lkconfig_ptrmap_init ( struct lkconfig_ptrmap* const pmap ) {
+    pmap->keys   = NULL;
+    pmap->values = NULL;
+    pmap->size   = 0;
+    pmap->count  = 0;
+}
+
+
+static void lkconfig_ptrmap_free ( struct lkconfig_ptrmap* const pmap ) {
+    PyMem_Free ( pmap->keys );
+    PyMem_Free ( pmap->values );
+    lkconfig_ptrmap_init ( pmap );
+}
+
+
+/**
+ * Looks up a key and returns a pointer to its value slot.
+ *
+ * @param pmap   pointer map
+ * @param key    key, must not be NULL
+ *
+ * @return pointer to value or NULL if key not found
+ * */
+static int* lkconfig_ptrmap_get (
+    const struct lkconfig_ptrmap* const pmap, const void* const key
+) {
+    size_t mask;
+    size_t k;
+
+    if ( pmap->size == 0 ) { return NULL; }
+
+    mask = pmap->size - 1;
+    for ( k = lkconfig_ptrmap_hash ( key ) & mask; ; k = (k + 1) & mask ) {
+        if ( pmap->keys [k] == key ) {
+            return &(pmap->values [k]);
+        } else if ( pmap->keys [k] == NULL ) {
+            return NULL;
+        }
+    }
+}
+
+
+static void lkconfig_ptrmap__insert_nogrow (
+    struct lkconfig_ptrmap* const pmap,
+    const void* const key,
+    const int value
+) {
+    size_t mask;
+    size_t k;
+
+    mask = pmap->size - 1;
+    for ( k = lkconfig_ptrmap_hash ( key ) & mask; ; k = (k + 1) & mask ) {
+        if ( pmap->keys [k] == key ) {
+            pmap->values [k] = value;
+            return;
+        } else if ( pmap->keys [k] == NULL ) {
+            pmap->keys [k]   = key;
+            pmap->values [k] = value;
+            (pmap->count)++;
+            return;
+        }
+    }
+}
+
+
+static int lkconfig_ptrmap__grow ( struct lkconfig_ptrmap* const pmap ) {
+    struct lkconfig_ptrmap new_pmap;
+    size_t k;
+
+    new_pmap.size = (
+        (pmap->size == 0) ? LKCONFIG_PTRMAP_INITIAL_SIZE : (2 * pmap->size)
+    );
+    new_pmap.count  = 0;
+    new_pmap.keys   = PyMem_Malloc ( new_pmap.size * sizeof *new_pmap.keys );
+    new_pmap.values = PyMem_Malloc ( new_pmap.size * sizeof *new_pmap.values );
+
+    if ( (new_pmap.keys == NULL) || (new_pmap.values == NULL) ) {
+        lkconfig_ptrmap_free ( &new_pmap );
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for ( k = 0; k < new_pmap.size; k++ ) { new_pmap.keys [k] = NULL; }
+
+    for ( k = 0; k < pmap->size; k++ ) {
+        if ( pmap->keys [k] != NULL ) {
+            lkconfig_ptrmap__insert_nogrow (
+                &new_pmap, pmap->keys [k], pmap->values [k]
+            );
+        }
+    }
+
+    lkconfig_ptrmap_free ( pmap );
+    *pmap = new_pmap;
+    return 0;
+}
+
+
+/**
+ * Adds or replaces a key => value entry.
+ * A python exception is created if the table cannot be grown.
+ *
+ * @param pmap   pointer map
+ * @param key    key, must not be NULL
+ * @param value  value
+ *
+ * @return 0 on success, else non-zero
+ * */
+static int lkconfig_ptrmap_set (
+    struct lkconfig_ptrmap* const pmap,
+    const void* const key,
+    const int value
+) {
+    /* keep load factor <= 0.5 */
+    if ( (2 * (pmap->count + 1)) > pmap->size ) {
+        if ( lkconfig_ptrmap__grow ( pmap ) != 0 ) { return -1; }
+    }
+
+    lkconfig_ptrmap__insert_nogrow ( pmap, key, value );
+    return 0;
+}
@@ -0,0 +1,1085 @@
+/*
+ * SolutionStore: a list of expression solutions in packed bitset form.
+ *
+ * A solution maps (dense) symbol indices to sets of tristate values,
+ * see solcache.SolutionCache for the dict-based equivalent.
+ * Each symbol index occupies one nibble of a solution row,
+ * bit 3 being set if the symbol is part of the solution and
+ * bits 0..2 holding the allowed values, n=bit 0, m=bit 1, y=bit 2.
+ * A nibble of zero means "not part of the solution", so that rows
+ * of different width can be merged by padding with zero words.
+ *
+ * Merging two solutions is done word-wise: the value bits of symbols
+ * that are present in both solutions get intersected,
+ * all other nibbles are taken as-is from the solution that provides them.
+ *
+ * Duplicate solutions are removed after each operation,
+ * keeping the first one.
+ *
+ * Large merges run with the GIL released, so that solutions
+ * can be computed by several threads, see ConfigGraph.resolve().
+ * Row data is therefore allocated with the raw PyMem functions,
+ * and stores taking part in such a merge are marked as busy.
+ *
+ * */
+
+#define LKCONFIG_SOLSTORE_NIBBLES   16
+#define LKCONFIG_SOLSTORE_PRESENT   0x8
+#define LKCONFIG_SOLSTORE_LOW       0x1111111111111111ULL
+
+/* minimum cross product size for releasing the GIL in merge() */
+#define LKCONFIG_SOLSTORE_NOGIL_MIN  256
+
+#define lkconfig_solstore_row(_store, _k)  \
+    (&((_store)->words [(_k) * (_store)->width]))
+
+#define lkconfig_solstore_width_for(_nsyms)  \
+    (((_nsyms) + LKCONFIG_SOLSTORE_NIBBLES - 1) / LKCONFIG_SOLSTORE_NIBBLES)
+
+
+static PyTypeObject lkconfig_SolutionStoreType;
+
+
+/**
+ * Creates a new, empty solution store (zero solutions).
+ *
+ * @param width  row width (number of words per solution)
+ *
+ * @return new solution store, or NULL on error (python exception set)
+ * */
+static lkconfig_SolutionStoreObject* lkconfig_SolutionStoreObject_new_empty (
+    const size_t width
+) {
+    lkconfig_SolutionStoreObject* self;
+
+    self = (lkconfig_SolutionStoreObject*) (
+        lkconfig_SolutionStoreType.tp_alloc ( &lkconfig_SolutionStoreType, 0 )
+    );
+    if ( self == NULL ) { return NULL; }
+
+    self->words = NULL;
+    self->width = width;
+    self->len   = 0;
+    self->cap   = 0;
+    self->busy  = 0;
+
+    return self;
+}
+
+
+/**
+ * Checks whether a store can be used,
+ * i.e. that it is not part of a merge running in another thread.
+ *
+ * @return 0 if usable, else non-zero (python exception set)
+ * */
+static int lkconfig_solstore__check_idle (
+    const lkconfig_SolutionStoreObject* const self
+) {
+    if ( self->busy ) {
+        PyErr_SetString (
+            PyExc_RuntimeError, "SolutionStore is in use by another thread"
+        );
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * Sets a row's nibble for the given symbol index,
+ * the row must be wide enough.
+ * */
+static void lkconfig_solstore_row_set (
+    uint64_t* const row, const size_t idx, const int nibble
+) {
+    const unsigned shift = 4 * (idx % LKCONFIG_SOLSTORE_NIBBLES);
+    uint64_t* const word = &(row [idx / LKCONFIG_SOLSTORE_NIBBLES]);
+
+    *word = (
+        (*word & ~(((uint64_t) 0xf) << shift))
+        | (((uint64_t) (nibble & 0xf)) << shift)
+    );
+}
+
+
+/**
+ * Makes room for at least cap solutions.
+ * Can be called without holding the GIL.
+ *
+ * @return 0 on success, else non-zero (out of memory, no exception set)
+ * */
+static int lkconfig_solstore__reserve_raw (
+    lkconfig_SolutionStoreObject* const self, const size_t cap
+) {
+    uint64_t* new_words;
+    size_t new_cap;
+
+    if ( cap <= self->cap ) { return 0; }
+
+    new_cap = (self->cap == 0) ? 4 : self->cap;
+    while ( new_cap < cap ) { new_cap *= 2; }
+
+    new_words = PyMem_RawRealloc (
+        self->words, (new_cap * self->width + 1) * sizeof *new_words
+    );
+    if ( new_words == NULL ) { return -1; }
+
+    self->words = new_words;
+    self->cap   = new_cap;
+    return 0;
+}
+
+
+/**
+ * Makes room for at least cap solutions.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_solstore__reserve (
+    lkconfig_SolutionStoreObject* const self, const size_t cap
+) {
+    if ( lkconfig_solstore__reserve_raw ( self, cap ) != 0 ) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * Widens all rows so that they can hold at least width words.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_solstore__grow_width (
+    lkconfig_SolutionStoreObject* const self, const size_t width
+) {
+    uint64_t* new_words;
+    size_t k;
+    size_t w;
+
+    if ( width <= self->width ) { return 0; }
+
+    new_words = PyMem_RawMalloc (
+        (self->cap * width + 1) * sizeof *new_words
+    );
+    if ( new_words == NULL ) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for ( k = 0; k < self->len; k++ ) {
+        for ( w = 0; w < self->width; w++ ) {
+            new_words [k * width + w] = self->words [k * self->width + w];
+        }
+        for ( ; w < width; w++ ) { new_words [k * width + w] = 0; }
+    }
+
+    PyMem_RawFree ( self->words );
+    self->words = new_words;
+    self->width = width;
+    return 0;
+}
+
+
+/**
+ * Appends a zero row (empty solution) and returns it.
+ *
+ * @return new row, or NULL on error (python exception set)
+ * */
+static uint64_t* lkconfig_solstore__append_empty (
+    lkconfig_SolutionStoreObject* const self
+) {
+    uint64_t* row;
+
+    if ( lkconfig_solstore__reserve ( self, self->len + 1 ) != 0 ) {
+        return NULL;
+    }
+
+    row = lkconfig_solstore_row ( self, self->len );
+    memset ( row, 0, self->width * sizeof *row );
+    (self->len)++;
+    return row;
+}
+
+
+static uint64_t lkconfig_solstore__hash_row (
+    const uint64_t* const row, const size_t width
+) {
+    uint64_t h;
+    size_t w;
+
+    h = 0x9e3779b97f4a7c15ULL;
+    for ( w = 0; w < width; w++ ) {
+        h ^= row [w] + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    }
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+
+/**
+ * Removes duplicate solutions, keeping the first occurrence.
+ * Can be called without holding the GIL.
+ *
+ * @return 0 on success, else non-zero (out of memory, no exception set)
+ * */
+static int lkconfig_solstore__dedup_raw (
+    lkconfig_SolutionStoreObject* const self
+) {
+    size_t* table;
+    size_t table_mask;
+    size_t table_size;
+    size_t pos;
+    size_t j;
+    size_t k;
+    int is_dup;
+
+    if ( self->len < 2 ) { return 0; }
+
+    table_size = 4;
+    while ( table_size < 2 * self->len ) { table_size *= 2; }
+    table_mask = table_size - 1;
+
+    /* entries are row index + 1, 0 means empty */
+    table = PyMem_RawMalloc ( table_size * sizeof *table );
+    if ( table == NULL ) { return -1; }
+    memset ( table, 0, table_size * sizeof *table );
+
+    j = 0;
+    for ( k = 0; k < self->len; k++ ) {
+        pos = (size_t) (
+            lkconfig_solstore__hash_row (
+                lkconfig_solstore_row ( self, k ), self->width
+            ) & table_mask
+        );
+
+        is_dup = 0;
+        while ( table [pos] != 0 ) {
+            if (
+                memcmp (
+                    lkconfig_solstore_row ( self, table [pos] - 1 ),
+                    lkconfig_solstore_row ( self, k ),
+                    self->width * sizeof *(self->words)
+                ) == 0
+            ) {
+                is_dup = 1;
+                break;
+            }
+            pos = (pos + 1) & table_mask;
+        }
+
+        if ( ! is_dup ) {
+            if ( j != k ) {
+                memcpy (
+                    lkconfig_solstore_row ( self, j ),
+                    lkconfig_solstore_row ( self, k ),
+                    self->width * sizeof *(self->words)
+                );
+            }
+            table [pos] = ++j;
+        }
+    }
+
+    self->len = j;
+    PyMem_RawFree ( table );
+    return 0;
+}
+
+
+/**
+ * Removes duplicate solutions, keeping the first occurrence.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_solstore__dedup ( lkconfig_SolutionStoreObject* const self ) {
+    if ( lkconfig_solstore__dedup_raw ( self ) != 0 ) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * Merges two solution rows, like SolutionCache.merge_solution_dict_x_dict().
+ * Rows narrower than width are zero-padded.
+ *
+ * @return 1 if merged, 0 if the solutions are incompatible
+ * */
+static int lkconfig_solstore__merge_row (
+    const uint64_t* const row_a, const size_t width_a,
+    const uint64_t* const row_b, const size_t width_b,
+    uint64_t* const row_out, const size_t width
+) {
+    uint64_t a;
+    uint64_t b;
+    uint64_t pa;
+    uint64_t pb;
+    uint64_t v;
+    uint64_t nonempty;
+    size_t w;
+
+    for ( w = 0; w < width; w++ ) {
+        a = (w < width_a) ? row_a [w] : 0;
+        b = (w < width_b) ? row_b [w] : 0;
+
+        /* spread the present bits to full nibbles */
+        pa = ((a >> 3) & LKCONFIG_SOLSTORE_LOW) * 0xf;
+        pb = ((b >> 3) & LKCONFIG_SOLSTORE_LOW) * 0xf;
+
+        /* symbols present in both rows must have a common value */
+        v = a & b;
+        nonempty = (v | (v >> 1) | (v >> 2)) & LKCONFIG_SOLSTORE_LOW;
+        if ( (pa & pb & LKCONFIG_SOLSTORE_LOW) & ~nonempty ) { return 0; }
+
+        row_out [w] = v | (a & ~pb) | (b & ~pa);
+    }
+
+    return 1;
+}
+
+
+/**
+ * Appends the merged cross product of two stores to dst.
+ * dst must be at least as wide as a and b.
+ * Can be called without holding the GIL.
+ *
+ * @return 0 on success, else non-zero (out of memory, no exception set)
+ * */
+static int lkconfig_solstore__append_product (
+    lkconfig_SolutionStoreObject* const dst,
+    const lkconfig_SolutionStoreObject* const sa,
+    const lkconfig_SolutionStoreObject* const sb
+) {
+    uint64_t* row;
+    size_t a;
+    size_t b;
+
+    for ( a = 0; a < sa->len; a++ ) {
+        for ( b = 0; b < sb->len; b++ ) {
+            if ( lkconfig_solstore__reserve_raw ( dst, dst->len + 1 ) != 0 ) {
+                return -1;
+            }
+
+            row = lkconfig_solstore_row ( dst, dst->len );
+            if (
+                lkconfig_solstore__merge_row (
+                    lkconfig_solstore_row ( sa, a ), sa->width,
+                    lkconfig_solstore_row ( sb, b ), sb->width,
+                    row, dst->width
+                )
+            ) {
+                (dst->len)++;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * Replaces the solutions of self with those of other (steals the data).
+ * */
+static void lkconfig_solstore__take (
+    lkconfig_SolutionStoreObject* const self,
+    lkconfig_SolutionStoreObject* const other
+) {
+    PyMem_RawFree ( self->words );
+    self->words  = other->words;
+    self->width  = other->width;
+    self->len    = other->len;
+    self->cap    = other->cap;
+
+    other->words = NULL;
+    other->len   = 0;
+    other->cap   = 0;
+}
+
+
+/* Python interface */
+
+static void lkconfig_SolutionStoreObject_dealloc (
+    lkconfig_SolutionStoreObject* const self
+) {
+    PyMem_RawFree ( self->words );
+    Py_TYPE(self)->tp_free ( (PyObject*) self );
+}
+
+
+static PyObject* lkconfig_SolutionStoreObject_new (
+    PyTypeObject* const type, PyObject* const args, PyObject* const kwargs
+) {
+    lkconfig_SolutionStoreObject* self;
+    int empty;
+
+    static char* kwlist[] = { "empty", NULL };
+
+    empty = 0;
+    if (
+        ! PyArg_ParseTupleAndKeywords (
+            args, kwargs, "|p:SolutionStore", kwlist, &empty
+        )
+    ) {
+        return NULL;
+    }
+
+    self = (lkconfig_SolutionStoreObject*) type->tp_alloc ( type, 0 );
+    if ( self == NULL ) { return NULL; }
+
+    self->words = NULL;
+    self->width = 0;
+    self->len   = 0;
+    self->cap   = 0;
+    self->busy  = 0;
+
+    /* like SolutionCache(), start with a single, empty solution */
+    if ( (! empty) && (lkconfig_solstore__append_empty ( self ) == NULL) ) {
+        Py_DECREF ( self );
+        return NULL;
+    }
+
+    return (PyObject*) self;
+}
+
+
+static Py_ssize_t lkconfig_SolutionStoreObject_len (
+    lkconfig_SolutionStoreObject* const self
+) {
+    if ( lkconfig_solstore__check_idle ( self ) != 0 ) { return -1; }
+    return (Py_ssize_t) self->len;
+}
+
+
+static PyObject* lkconfig_SolutionStoreObject_copy (
+    lkconfig_SolutionStoreObject* const self, PyObject* const noargs
+) {
+    lkconfig_SolutionStoreObject* obj;
+
+    if ( lkconfig_solstore__check_idle ( self ) != 0 ) { return NULL; }
+
+    obj = lkconfig_SolutionStoreObject_new_empty ( self->width );
+    if ( obj == NULL ) { return NULL; }
+
+    if ( lkconfig_solstore__reserve ( obj, self->len ) != 0 ) {
+        Py_DECREF ( obj );
+        return NULL;
+    }
+
+    if ( self->len > 0 ) {
+        memcpy (
+            obj->words, self->words,
+            self->len * self->width * sizeof *(self->words)
+        );
+    }
+    obj->len = self->len;
+
+    return (PyObject*) obj;
+}
+
+
+static PyObject* lkconfig_SolutionStoreObject_clear (
+    lkconfig_SolutionStoreObject* const self, PyObject* const noargs
+) {
+    if ( lkconfig_solstore__check_idle ( self ) != 0 ) { return NULL; }
+    self->len = 0;
+    Py_RETURN_NONE;
+}
+
+
+/**
+ * Parses a (symbol index, value mask) pair.
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_solstore__parse_assignment (
+    PyObject* const item, Py_ssize_t* const idx_out, int* const mask_out
+) {
+    if ( ! PyArg_ParseTuple ( item, "ni", idx_out, mask_out ) ) {
+        return -1;
+    }
+
+    if ( *idx_out < 0 ) {
+        PyErr_SetString ( PyExc_ValueError, "negative symbol index" );
+        return -1;
+    }
+
+    if ( (*mask_out & ~0x7) || (! *mask_out) ) {
+        PyErr_SetString ( PyExc_ValueError, "bad value mask" );
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static PyObject* lkconfig_SolutionStoreObject_add_solutions (
+    lkconfig_SolutionStoreObject* const self, PyObject* const args
+) {
+    PyObject* solutions_arg;
+    PyObject* solutions;
+    PyObject* assignments;
+    PyObject* item;
+    uint64_t* row;
+    Py_ssize_t k;
+    Py_ssize_t j;
+    Py_ssize_t idx;
+    int mask;
+
+    if ( ! PyArg_ParseTuple ( args, "O", &solutions_arg ) ) { return NULL; }
+    if ( lkconfig_solstore__check_idle ( self ) != 0 ) { return NULL; }
+
+    solutions = PySequence_Fast (
+        solutions_arg, "solutions must be a sequence"
+    );
+    if ( solutions == NULL ) { return NULL; }
+
+    for ( k = 0; k < PySequence_Fast_GET_SIZE ( solutions ); k++ ) {
+        assignments = PySequence_Fast (
+            PySequence_Fast_GET_ITEM ( solutions, k ),
+            "solution must be a sequence of (index, mask) pairs"
+        );
+        if ( assignments == NULL ) { goto err; }
+
+        /* widen first, rows may be reallocated */
+        for ( j = 0; j < PySequence_Fast_GET_SIZE ( assignments ); j++ ) {
+            item = PySequence_Fast_GET_ITEM ( assignments, j );
+            if (
+                (lkconfig_solstore__parse_assignment ( item, &idx, &mask ) != 0)
+                || (
+                    lkconfig_solstore__grow_width (
+                        self, lkconfig_solstore_width_for ( (size_t) idx + 1 )
+                    ) != 0
+                )
+            ) {
+                Py_DECREF ( assignments );
+                goto err;
+            }
+        }
+
+        row = lkconfig_solstore__append_empty ( self );
+        if ( row == NULL ) { Py_DECREF ( assignments ); goto err; }
+
+        for ( j = 0; j < PySequence_Fast_GET_SIZE ( assignments ); j++ ) {
+            item = PySequence_Fast_GET_ITEM ( assignments, j );
+            /* already checked */
+            lkconfig_solstore__parse_assignment ( item, &idx, &mask );
+            lkconfig_solstore_row_set (
+                row, (size_t) idx, LKCONFIG_SOLSTORE_PRESENT | mask
+            );
+        }
+
+        Py_DECREF ( assignments );
+    }
+
+    Py_DECREF ( solutions );
+
+    if ( lkconfig_solstore__dedup ( self ) != 0 ) { return NULL; }
+    Py_RETURN_NONE;
+
+err:
+    Py_DECREF ( solutions );
+    return NULL;
+}
+
+
+static PyObject* lkconfig_SolutionStoreObject_push_symbol (
+    lkconfig_SolutionStoreObject* const self, PyObject* const args
+) {
+    Py_ssize_t idx;
+    uint64_t* row;
+    uint64_t word;
+    unsigned shift;
+    size_t widx;
+    size_t j;
+    size_t k;
+    int mask;
+    int nibble;
+
+    if ( ! PyArg_ParseTuple ( args, "ni", &idx, &mask ) ) { return NULL; }
+    if ( lkconfig_solstore__check_idle ( self ) != 0 ) { return NULL; }
+
+    if ( idx < 0 ) {
+        PyErr_SetString ( PyExc_ValueError, "negative symbol index" );
+        return NULL;
+    }
+    mask &= 0x7;
+
+    if (
+        lkconfig_solstore__grow_width (
+            self, lkconfig_solstore_width_for ( (size_t) idx + 1 )
+        ) != 0
+    ) {
+        return NULL;
+    }
+
+    widx  = (size_t) idx / LKCONFIG_SOLSTORE_NIBBLES;
+    shift = 4 * ((size_t) idx % LKCONFIG_SOLSTORE_NIBBLES);
+
+    j = 0;
+    for ( k = 0; k < self->len; k++ ) {
+        row    = lkconfig_solstore_row ( self, k );
+        word   = row [widx];
+        nibble = (int) ((word >> shift) & 0xf);
+
+        if ( nibble & LKCONFIG_SOLSTORE_PRESENT ) {
+            nibble &= (LKCONFIG_SOLSTORE_PRESENT | mask);
+        } else {
+            nibble = LKCONFIG_SOLSTORE_PRESENT | mask;
+        }
+
+        if ( nibble & 0x7 ) {
+            lkconfig_solstore_row_set ( row, (size_t) idx, nibble );
+            if ( j != k ) {
+                memcpy (
+                    lkconfig_solstore_row ( self, j ), row,
+                    self->width * sizeof *row
+                );
+            }
+            j++;
+        }
+    }
+    self->len = j;
+
+    if ( lkconfig_solstore__dedup ( self ) != 0 ) { return NULL; }
+    return PyBool_FromLong ( self->len > 0 );
+}
+
+
+/**
+ * Appends the merged cross products of sa and each of the nalts stores
+ * in alts to dst and removes duplicates afterwards.
+ * dst must be at least as wide as sa and each alternative.
+ *
+ * The GIL gets released if the products are large enough,
+ * the stores are marked as busy meanwhile.
+ *
+ * @return 0 on success, else non-zero (out of memory, no exception set)
+ * */
+static int lkconfig_solstore__merge_products (
+    lkconfig_SolutionStoreObject* const dst,
+    lkconfig_SolutionStoreObject* const sa,
+    lkconfig_SolutionStoreObject* const* const alts,
+    const size_t nalts
+) {
+    size_t work;
+    size_t k;
+    int ret;
+
+    work = 0;
+    for ( k = 0; k < nalts; k++ ) { work += sa->len * alts [k]->len; }
+
+    if ( work < LKCONFIG_SOLSTORE_NOGIL_MIN ) {
+        for ( k = 0; k < nalts; k++ ) {
+            if ( lkconfig_solstore__append_product ( dst, sa, alts [k] ) != 0 ) {
+                return -1;
+            }
+        }
+        return lkconfig_solstore__dedup_raw ( dst );
+    }
+
+    (sa->busy)++;
+    for ( k = 0; k < nalts; k++ ) { (alts [k]->busy)++; }
+
+    Py_BEGIN_ALLOW_THREADS
+    ret = 0;
+    for ( k = 0; (ret == 0) && (k < nalts); k++ ) {
+        ret = lkconfig_solstore__append_product ( dst, sa, alts [k] );
+    }
+    if ( ret == 0 ) { ret = lkconfig_solstore__dedup_raw ( dst ); }
+    Py_END_ALLOW_THREADS
+
+    (sa->busy)--;
+    for ( k = 0; k < nalts; k++ ) { (alts [k]->busy)--; }
+
+    return ret;
+}
+
+
+static PyObject* lkconfig_SolutionStoreObject_merge (
+    lkconfig_SolutionStoreObject* const self, PyObject* const args
+) {
+    lkconfig_SolutionStoreObject* other;
+    lkconfig_SolutionStoreObject* merged;
+
+    if (
+        ! PyArg_ParseTuple ( args, "O!", &lkconfig_SolutionStoreType, &other )
+    ) {
+        return NULL;
+    }
+
+    if (
+        (lkconfig_solstore__check_idle ( self ) != 0)
+        || (lkconfig_solstore__check_idle ( other ) != 0)
+    ) {
+        return NULL;
+    }
+
+    merged = lkconfig_SolutionStoreObject_new_empty (
+        (self->width > other->width) ? self->width : other->width
+    );
+    if ( merged == NULL ) { return NULL; }
+
+    if ( lkconfig_solstore__merge_products ( merged, self, &other, 1 ) != 0 ) {
+        Py_DECREF ( merged );
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    lkconfig_solstore__take ( self, merged );
+    Py_DECREF ( merged );
+
+    return PyBool_FromLong ( self->len > 0 );
+}
+
+
+static PyObject* lkconfig_SolutionStoreObject_merge_alternatives (
+    lkconfig_SolutionStoreObject* const self, PyObject* const args
+) {
+    lkconfig_SolutionStoreObject* merged;
+    lkconfig_SolutionStoreObject** alts;
+    PyObject* alternatives_arg;
+    PyObject* alternatives;
+    PyObject* item;
+    size_t width;
+    size_t nalts;
+    size_t k;
+    int ret;
+
+    if ( ! PyArg_ParseTuple ( args, "O", &alternatives_arg ) ) { return NULL; }
+    if ( lkconfig_solstore__check_idle ( self ) != 0 ) { return NULL; }
+
+    alternatives = PySequence_Fast (
+        alternatives_arg, "alternatives must be a sequence"
+    );
+    if ( alternatives == NULL ) { return NULL; }
+
+    /*
+     * keep own references to the alternatives,
+     * the sequence may change while the GIL is released
+     * */
+    nalts = (size_t) PySequence_Fast_GET_SIZE ( alternatives );
+    alts  = PyMem_Malloc ( (nalts + 1) * sizeof *alts );
+    if ( alts == NULL ) {
+        Py_DECREF ( alternatives );
+        return PyErr_NoMemory();
+    }
+
+    width = self->width;
+    for ( k = 0; k < nalts; k++ ) {
+        item = PySequence_Fast_GET_ITEM ( alternatives, (Py_ssize_t) k );
+        if (
+            (! PyObject_TypeCheck ( item, &lkconfig_SolutionStoreType ))
+            || (
+                lkconfig_solstore__check_idle (
+                    (lkconfig_SolutionStoreObject*) item
+                ) != 0
+            )
+        ) {
+            if ( ! PyErr_Occurred() ) {
+                PyErr_SetString (
+                    PyExc_TypeError,
+                    "alternatives must be SolutionStore objects"
+                );
+            }
+            nalts = k;
+            Py_DECREF ( alternatives );
+            goto err;
+        }
+
+        Py_INCREF ( item );
+        alts [k] = (lkconfig_SolutionStoreObject*) item;
+        if ( alts [k]->width > width ) { width = alts [k]->width; }
+    }
+    Py_DECREF ( alternatives );
+
+    merged = lkconfig_SolutionStoreObject_new_empty ( width );
+    if ( merged == NULL ) { goto err; }
+
+    ret = lkconfig_solstore__merge_products ( merged, self, alts, nalts );
+    if ( ret != 0 ) {
+        Py_DECREF ( merged );
+        PyErr_NoMemory();
+        goto err;
+    }
+
+    lkconfig_solstore__take ( self, merged );
+    Py_DECREF ( merged );
+
+    for ( k = 0; k < nalts; k++ ) { Py_DECREF ( alts [k] ); }
+    PyMem_Free ( alts );
+
+    return PyBool_FromLong ( self->len > 0 );
+
+err:
+    for ( k = 0; k < nalts; k++ ) { Py_DECREF ( alts [k] ); }
+    PyMem_Free ( alts );
+    return NULL;
+}
+
+
+static PyObject* lkconfig_SolutionStoreObject_get_solutions (
+    lkconfig_SolutionStoreObject* const self, PyObject* const args
+) {
+    PyObject* symbols;
+    PyObject* normvalues;
+    PyObject* set_cache;
+    PyObject* result;
+    PyObject* sol_dict;
+    PyObject* cache_key;
+    PyObject* value_set;
+    PyObject* normvals;
+    PyObject* sym;
+    const uint64_t* row;
+    uint64_t word;
+    Py_ssize_t idx;
+    size_t k;
+    size_t w;
+    int p;
+    int v;
+    int mask;
+    int ret;
+
+    if ( ! PyArg_ParseTuple ( args, "OO", &symbols, &normvalues ) ) {
+        return NULL;
+    }
+    if ( lkconfig_solstore__check_idle ( self ) != 0 ) { return NULL; }
+
+    set_cache = PyDict_New();
+    if ( set_cache == NULL ) { return NULL; }
+
+    result = PyList_New ( (Py_ssize_t) self->len );
+
+    for ( k = 0; (result != NULL) && (k < self->len); k++ ) {
+        sol_dict = PyDict_New();
+        if ( sol_dict == NULL ) { Py_CLEAR ( result ); break; }
+        PyList_SET_ITEM ( result, (Py_ssize_t) k, sol_dict );  /* steal ref */
+
+        row = lkconfig_solstore_row ( self, k );
+        for ( w = 0; (result != NULL) && (w < self->width); w++ ) {
+            word = row [w];
+
+            for (
+                p = 0;
+                (word != 0) && (p < LKCONFIG_SOLSTORE_NIBBLES);
+                p++, word >>= 4
+            ) {
+                if ( ! (word & LKCONFIG_SOLSTORE_PRESENT) ) { continue; }
+
+                idx  = (Py_ssize_t) (w * LKCONFIG_SOLSTORE_NIBBLES + p);
+                mask = (int) (word & 0x7);
+
+                /* get or create the value set */
+                cache_key = PyLong_FromSsize_t ( 8 * idx + mask );
+                if ( cache_key == NULL ) { Py_CLEAR ( result ); break; }
+
+                value_set = PyDict_GetItemWithError ( set_cache, cache_key );
+                if ( value_set == NULL ) {
+                    if ( PyErr_Occurred() ) {
+                        Py_DECREF ( cache_key );
+                        Py_CLEAR ( result );
+                        break;
+                    }
+
+                    normvals = PySequence_GetItem ( normvalues, idx );
+                    value_set = (normvals != NULL) ? PySet_New ( NULL ) : NULL;
+
+                    for ( v = 0; (value_set != NULL) && (v < 3); v++ ) {
+                        if (
+                            (mask & (1 << v))
+                            && (
+                                PySet_Add (
+                                    value_set,
+                                    PySequence_Fast_GET_ITEM ( normvals, v )
+                                ) != 0
+                            )
+                        ) {
+                            Py_CLEAR ( value_set );
+                        }
+                    }
+                    Py_XDECREF ( normvals );
+
+                    ret = -1;
+                    if ( value_set != NULL ) {
+                        ret = PyDict_SetItem ( set_cache, cache_key, value_set );
+                        Py_DECREF ( value_set );  /* set_cache holds a ref */
+                    }
+                    if ( ret != 0 ) {
+                        Py_DECREF ( cache_key );
+                        Py_CLEAR ( result );
+                        break;
+                    }
+                }
+                Py_DECREF ( cache_key );
+
+                sym = PySequence_GetItem ( symbols, idx );
+                if ( sym == NULL ) { Py_CLEAR ( result ); break; }
+                ret = PyDict_SetItem ( sol_dict, sym, value_set );
+                Py_DECREF ( sym );
+                if ( ret != 0 ) { Py_CLEAR ( result ); break; }
+            }
+        }
+    }
+
+    Py_DECREF ( set_cache );
+    return result;
+}
+
+
+static PySequenceMethods lkconfig_SolutionStoreObject_as_sequence = {
+    (lenfunc) lkconfig_SolutionStoreObject_len,  /* sq_length */
+    0,                                           /* sq_concat */
+    0,                                           /* sq_repeat */
+    0,                                           /* sq_item */
+    0,                                           /* was_sq_slice */
+    0,                                           /* sq_ass_item */
+    0,                                           /* was_sq_ass_slice */
+    0,                                           /* sq_contains */
+    0,                                           /* sq_inplace_concat */
+    0                                            /* sq_inplace_repeat */
+};
+
+
+static PyMethodDef lkconfig_SolutionStoreObject_methods[] = {
+    {
+        "copy",
+        (PyCFunction) lkconfig_SolutionStoreObject_copy,
+        METH_NOARGS,
+        PyDoc_STR ( "copy() -- returns a copy of this solution store" )
+    },
+    {
+        "clear",
+        (PyCFunction) lkconfig_SolutionStoreObject_clear,
+        METH_NOARGS,
+        PyDoc_STR ( "clear() -- removes all solutions" )
+    },
+    {
+        "add_solutions",
+        (PyCFunction) lkconfig_SolutionStoreObject_add_solutions,
+        METH_VARARGS,
+        PyDoc_STR (
+            "add_solutions(solutions)\n"
+            "\n"
+            "Appends solutions, each given as a sequence of\n"
+            "(symbol index, value mask) pairs.\n"
+            "Value masks must not be empty, bit 0 is n, bit 1 m, bit 2 y.\n"
+        )
+    },
+    {
+        "push_symbol",
+        (PyCFunction) lkconfig_SolutionStoreObject_push_symbol,
+        METH_VARARGS,
+        PyDoc_STR (
+            "push_symbol(index, mask)\n"
+            "\n"
+            "Restricts the values of a symbol in all solutions\n"
+            "and drops solutions with no values left.\n"
+            "Returns True if any solutions are left, else False.\n"
+        )
+    },
+    {
+        "merge",
+        (PyCFunction) lkconfig_SolutionStoreObject_merge,
+        METH_VARARGS,
+        PyDoc_STR (
+            "merge(other)\n"
+            "\n"
+            "Replaces the solutions with the merged cross product\n"
+            "of this and the other store.\n"
+            "Returns True if any solutions are left, else False.\n"
+        )
+    },
+    {
+        "merge_alternatives",
+        (PyCFunction) lkconfig_SolutionStoreObject_merge_alternatives,
+        METH_VARARGS,
+        PyDoc_STR (
+            "merge_alternatives(alternatives)\n"
+            "\n"
+            "Like merge(), but for a sequence of stores,\n"
+            "the resulting solutions are concatenated.\n"
+            "Returns True if any solutions are left, else False.\n"
+        )
+    },
+    {
+        "get_solutions",
+        (PyCFunction) lkconfig_SolutionStoreObject_get_solutions,
+        METH_VARARGS,
+        PyDoc_STR (
+            "get_solutions(symbols, normvalues)\n"
+            "\n"
+            "Returns the solutions as list of symbol => value set dicts.\n"
+            "\n"
+            "Arguments:\n"
+            "* symbols     -- symbols, indexed by symbol index\n"
+            "* normvalues  -- 3-tuples of the values corresponding\n"
+            "                 to n, m and y, indexed by symbol index\n"
+        )
+    },
+    { NULL }
+};
+
+
+static PyMemberDef lkconfig_SolutionStoreObject_members[] = {
+    {
+        "width",
+        T_PYSSIZET, offsetof(lkconfig_SolutionStoreObject, width), READONLY,
+        PyDoc_STR ( "number of 64-bit words per solution" )
+    },
+    { NULL }
+};
+
+
+static PyTypeObject lkconfig_SolutionStoreType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+
+    LKCONFIG_PYMOD_NAME "." lkconfig_SolutionStoreName,
+    sizeof (lkconfig_SolutionStoreObject),
+    0,                         /* tp_itemsize */
+    (destructor) lkconfig_SolutionStoreObject_dealloc,  /* tp_dealloc */
+    0,                         /* tp_print */
+    0,                         /* tp_getattr */
+    0,                         /* tp_setattr */
+    0,                         /* tp_reserved */
+    0,                         /* tp_repr */
+    0,                         /* tp_as_number */
+    &lkconfig_SolutionStoreObject_as_sequence,  /* tp_as_sequence */
+    0,                         /* tp_as_mapping */
+    PyObject_HashNotImplemented,  /* tp_hash  */
+    0,                         /* tp_call */
+    0,                         /* tp_str */
+    0,                         /* tp_getattro */
+    0,                         /* tp_setattro */
+    0,                         /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,        /* tp_flags */
+    PyDoc_STR (
+        "packed list of expression solutions\n"
+        "\n"
+        "SolutionStore(empty=False) -- creates a new store with a single,\n"
+        "empty solution, or no solutions at all if empty is True."
+    ),  /* tp doc */
+    0,                         /* tp_traverse */
+    0,                         /* tp_clear */
+    0,                         /* tp_richcompare */
+    0,                         /* tp_weaklistoffset */
+    0,                         /* tp_iter */
+    0,                         /* tp_iternext */
+    lkconfig_SolutionStoreObject_methods,  /* tp_methods */
+    lkconfig_SolutionStoreObject_members,  /* tp_members */
+    0,                         /* tp_getset */
+    0,                         /* tp_base */
+    0,                         /* tp_dict */
+    0,                         /* tp_descr_get */
+    0,                         /* tp_descr_set */
+    0,                         /* tp_dictoffset */
+    0,                         /* tp_init */
+    0,                         /* tp_alloc */
+    lkconfig_SolutionStoreObject_new  /* tp_new */
+};
+
+#undef LKCONFIG_SOLSTORE_LOW
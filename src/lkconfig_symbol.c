@@ -1,7 +1,22 @@
+/**
+ * Checks whether the view's symbol still exists,
+ * see lkconfig_context_check_view().
+ *
+ * @return 0 if the view is valid, else non-zero (python exception set)
+ * */
+static int lkconfig_SymbolViewObject__check (
+    const lkconfig_SymbolViewObject* const self
+) {
+    return lkconfig_context_check_view ( self->context, self->generation );
+}
+
+
 /** is_choice :: SymbolViewObject -> bool */
 static PyObject* lkconfig_SymbolViewObject_is_choice (
     lkconfig_SymbolViewObject* const self, PyObject* const args
 ) {
+    if ( lkconfig_SymbolViewObject__check ( self ) != 0 ) { return NULL; }
+
     if ( sym_is_choice((struct symbol*) self->kconfig_sym) ) {
         Py_RETURN_TRUE;
     } else {
@@ -11,6 +26,9 @@ static PyObject* lkconfig_SymbolViewObject_is_choice (
 
 #define lkconfig_SymbolViewObject__is_of_type_func_body(_type)  \
     do { \
+        if ( lkconfig_SymbolViewObject__check ( self ) != 0 ) { \
+            return NULL; \
+        } \
         if ( self->kconfig_sym->type == (_type) ) { \
             Py_RETURN_TRUE; \
         } else { \
@@ -65,10 +83,13 @@ static PyObject* lkconfig_SymbolViewObject_is_other (
 static PyObject* lkconfig_SymbolViewObject_get_dir_dep (
     lkconfig_SymbolViewObject* const self, PyObject* const args
 ) {
+    if ( lkconfig_SymbolViewObject__check ( self ) != 0 ) { return NULL; }
+
     if ( self->kconfig_sym == NULL ) {
         Py_RETURN_NONE;
     } else {
         return lkconfig_ExprViewObject_new_from_struct (
+            (lkconfig_ContextObject*) self->context,
             (self->kconfig_sym->dir_dep).expr
         );
     }
@@ -77,10 +98,13 @@ static PyObject* lkconfig_SymbolViewObject_get_dir_dep (
 static PyObject* lkconfig_SymbolViewObject_get_rev_dep (
     lkconfig_SymbolViewObject* const self, PyObject* const args
 ) {
+    if ( lkconfig_SymbolViewObject__check ( self ) != 0 ) { return NULL; }
+
     if ( self->kconfig_sym == NULL ) {
         Py_RETURN_NONE;
     } else {
         return lkconfig_ExprViewObject_new_from_struct (
+            (lkconfig_ContextObject*) self->context,
             (self->kconfig_sym->rev_dep).expr
         );
     }
@@ -88,6 +112,7 @@ static PyObject* lkconfig_SymbolViewObject_get_rev_dep (
 
 
 static int lkconfig_SymbolViewObject__create_prompt_and_append_to_list (
+    lkconfig_ContextObject* const ctx,
     PyObject* const l, const struct property* const prompt
 ) {
     PyObject* text;
@@ -103,7 +128,7 @@ static int lkconfig_SymbolViewObject__create_prompt_and_append_to_list (
     eview = NULL;
     if ( prompt->visible.expr != NULL ) {
         eview = lkconfig_ExprViewObject_new_from_struct (
-            prompt->visible.expr
+            ctx, prompt->visible.expr
         );
 
         if ( eview == NULL ) {
@@ -138,6 +163,8 @@ static PyObject* lkconfig_SymbolViewObject_get_prompt (
     const struct property* prompt;
     PyObject* prompt_list;
 
+    if ( lkconfig_SymbolViewObject__check ( self ) != 0 ) { return NULL; }
+
     prompt_list = PyList_New(0);
 
     if ( prompt_list != NULL ) {
@@ -145,6 +172,7 @@ static PyObject* lkconfig_SymbolViewObject_get_prompt (
             if ( prompt->text != NULL ) {
                 if (
                     lkconfig_SymbolViewObject__create_prompt_and_append_to_list (
+                        (lkconfig_ContextObject*) self->context,
                         prompt_list, prompt
                     ) != 0
                 ) {
@@ -160,11 +188,12 @@ static PyObject* lkconfig_SymbolViewObject_get_prompt (
 
 
 static int lkconfig_SymbolViewObject__create_expr_and_append_to_list (
+    lkconfig_ContextObject* const ctx,
     PyObject* const l, const struct expr* const e
 ) {
     return lkconfig_list_append_steal_ref (
         l,
-        lkconfig_ExprViewObject_new_from_struct ( e )
+        lkconfig_ExprViewObject_new_from_struct ( ctx, e )
     );
 }
 
@@ -175,6 +204,8 @@ static PyObject* lkconfig_SymbolViewObject_get_selects (
     const struct property* sel;
     PyObject* sel_list;
 
+    if ( lkconfig_SymbolViewObject__check ( self ) != 0 ) { return NULL; }
+
     sel_list = PyList_New(0);
     if ( sel_list == NULL ) { return NULL; }
 
@@ -187,6 +218,7 @@ static PyObject* lkconfig_SymbolViewObject_get_selects (
 
         if (
             lkconfig_SymbolViewObject__create_expr_and_append_to_list (
+                (lkconfig_ContextObject*) self->context,
                 sel_list, sel->expr
             ) != 0
         ) {
@@ -200,17 +232,20 @@ static PyObject* lkconfig_SymbolViewObject_get_selects (
 
 
 static int lkconfig_SymbolViewObject__create_default_and_append_to_list (
+    lkconfig_ContextObject* const ctx,
     PyObject* const l, const struct property* const def_prop
 ) {
     PyObject* default_tuple;
     PyObject* eview_dir_dep;
     PyObject* eview_vis_dep;
 
-    eview_dir_dep = lkconfig_ExprViewObject_new_from_struct ( def_prop->expr );
+    eview_dir_dep = lkconfig_ExprViewObject_new_from_struct (
+        ctx, def_prop->expr
+    );
     if ( eview_dir_dep == NULL ) { return -1; }
 
     eview_vis_dep = lkconfig_ExprViewObject_new_from_struct (
-        (def_prop->visible).expr
+        ctx, (def_prop->visible).expr
     );
     if ( eview_vis_dep == NULL ) {
         Py_DECREF ( eview_dir_dep );
@@ -230,6 +265,8 @@ static PyObject* lkconfig_SymbolViewObject_get_defaults (
     const struct property* prop;
     PyObject* def_list;
 
+    if ( lkconfig_SymbolViewObject__check ( self ) != 0 ) { return NULL; }
+
     def_list = PyList_New(0);
     if ( def_list == NULL ) { return NULL; }
 
@@ -237,7 +274,7 @@ static PyObject* lkconfig_SymbolViewObject_get_defaults (
         /* (prop->visible.expr AND prop->expr) OR rev_dep */
         if (
             lkconfig_SymbolViewObject__create_default_and_append_to_list (
-                def_list, prop
+                (lkconfig_ContextObject*) self->context, def_list, prop
             ) != 0
         ) {
             Py_DECREF ( def_list );
@@ -252,7 +289,21 @@ static PyObject* lkconfig_SymbolViewObject_get_defaults (
 static void lkconfig_SymbolViewObject_dealloc (
     lkconfig_SymbolViewObject* const self
 ) {
+    if (
+        (self->context != NULL)
+        && (
+            ((lkconfig_ContextObject*) self->context)->generation
+            == self->generation
+        )
+    ) {
+        lkconfig_viewcache_forget (
+            &(((lkconfig_ContextObject*) self->context)->symviews),
+            self->kconfig_sym, (PyObject*) self
+        );
+    }
+
     Py_CLEAR ( self->name );
+    Py_CLEAR ( self->context );
     Py_TYPE(self)->tp_free ( (PyObject*) self );
 }
 
@@ -359,17 +410,62 @@ static PyMethodDef lkconfig_SymbolViewObject_methods[] = {
     { NULL }
 };
 
-static PyMemberDef lkconfig_SymbolViewObject_members[] = {
+/** name :: SymbolViewObject -> str or None, created on first access */
+static PyObject* lkconfig_SymbolViewObject_get_name (
+    lkconfig_SymbolViewObject* const self, void* const closure
+) {
+    struct lkconfig_symindex* sidx;
+
+    if ( self->name == NULL ) {
+        if ( lkconfig_SymbolViewObject__check ( self ) != 0 ) {
+            return NULL;
+        }
+
+        sidx = &(((lkconfig_ContextObject*) self->context)->symindex);
+
+        if (
+            (self->index >= 0) && ((size_t) self->index < sidx->nsyms)
+            && (sidx->syms [self->index] == self->kconfig_sym)
+        ) {
+            /* all views of an indexed symbol share its name str */
+            self->name = lkconfig_symindex_get_pyname ( sidx, self->index );
+            Py_XINCREF ( self->name );
+
+        } else if ( self->kconfig_sym->name == NULL ) {
+            Py_INCREF ( Py_None );
+            self->name = Py_None;
+
+        } else {
+            self->name = PyUnicode_FromString ( self->kconfig_sym->name );
+        }
+
+        if ( self->name == NULL ) { return NULL; }
+    }
+
+    Py_INCREF ( self->name );
+    return self->name;
+}
+
+static PyGetSetDef lkconfig_SymbolViewObject_getset[] = {
     {
         "name",
-        T_OBJECT_EX, offsetof(lkconfig_SymbolViewObject, name), READONLY,
-        PyDoc_STR ( "symbol name" )
+        (getter) lkconfig_SymbolViewObject_get_name, NULL,
+        PyDoc_STR ( "symbol name" ), NULL
     },
+    { NULL }
+};
+
+static PyMemberDef lkconfig_SymbolViewObject_members[] = {
     {
         "s_type",
         T_INT, offsetof(lkconfig_SymbolViewObject, s_type), READONLY,
         PyDoc_STR ( "symbol type" )
     },
+    {
+        "index",
+        T_INT, offsetof(lkconfig_SymbolViewObject, index), READONLY,
+        PyDoc_STR ( "symbol index, -1 if not indexed" )
+    },
     { NULL }
 };
 
@@ -406,7 +502,7 @@ static PyTypeObject lkconfig_SymbolViewType = {
     0,                         /* tp_iternext */
     lkconfig_SymbolViewObject_methods,  /* tp_methods */
     lkconfig_SymbolViewObject_members,  /* tp_members */
-    0,                         /* tp_getset */
+    lkconfig_SymbolViewObject_getset,  /* tp_getset */
     0,                         /* tp_base */
     0,                         /* tp_dict */
     0,                         /* tp_descr_get */
@@ -418,28 +514,44 @@ static PyTypeObject lkconfig_SymbolViewType = {
 };
 
 
+/**
+ * Returns the view of a symbol.
+ *
+ * @param ctx  context the symbol belongs to, not necessarily the active one
+ * @param sym  symbol
+ *
+ * @return new reference to the view, NULL on error (python exception set)
+ * */
 static PyObject* lkconfig_SymbolViewObject_new_from_struct (
-    const struct symbol* const sym
+    lkconfig_ContextObject* const ctx, const struct symbol* const sym
 ) {
     lkconfig_SymbolViewObject* self;
+    PyObject* view;
+
+    /* one view per symbol, see lkconfig_viewcache.c */
+    view = lkconfig_viewcache_get ( &(ctx->symviews), sym );
+    if ( view != NULL ) { return view; }
 
     self = PyObject_NEW (
         lkconfig_SymbolViewObject, &lkconfig_SymbolViewType
     );
     if ( self == NULL ) { return NULL; }
 
-    if ( sym->name == NULL ) {
-        Py_INCREF ( Py_None );
-        self->name = Py_None;
-    } else {
-        self->name = PyUnicode_FromString ( sym->name );
-        if ( self->name == NULL ) {
-            Py_DECREF ( self );
-            return NULL;
-        }
-    }
+    self->context = (PyObject*) ctx;
+    Py_INCREF ( self->context );
+    self->generation = ctx->generation;
 
+    self->name   = NULL;
     self->s_type = sym->type;
+    self->index  = lkconfig_symindex_get ( &(ctx->symindex), sym );
     self->kconfig_sym = sym;
+
+    if (
+        lkconfig_viewcache_add ( &(ctx->symviews), sym, (PyObject*) self ) != 0
+    ) {
+        Py_DECREF ( self );
+        return NULL;
+    }
+
     return (PyObject*) self;
 }
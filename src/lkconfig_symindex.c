@@ -0,0 +1,359 @@
+/*
+ * Dense symbol indices.
+ *
+ * After parsing, each symbol of a context gets a stable index
+ * 0 .. nsyms - 1, in the order of get_symbols() and get_symbol_table(),
+ * i.e. the symbol table row of a symbol is also its index.
+ * Symbols of unknown type (S_UNKNOWN) are not indexed, which includes
+ * const symbols (string literals) and undefined symbols.
+ *
+ * The index is shared by SymbolView.index, the index-based value
+ * functions (get_symbol_value(), set_symbol_value(), ...),
+ * list-type config values (oldconfig_values())
+ * and the dependency graph, see lkconfig_depgraph.c.
+ *
+ * Symbols created by lkc after parsing are not indexed.
+ *
+ * The index also has its own name => index table, which replaces
+ * the strcmp() walk through lkc's fixed-size symbol_hash (sym_find())
+ * for indexed symbols, see lkconfig_symindex_find_symbol(),
+ * and keeps one interned Python str per symbol name,
+ * see lkconfig_symindex_get_pyname().
+ *
+ * */
+
+#define LKCONFIG_SYMINDEX_NAMES_INITIAL_SIZE  1024
+
+
+/* FNV-1a */
+static size_t lkconfig_symindex_name_hash ( const char* const name ) {
+    const unsigned char* p;
+    size_t h;
+
+    h = (size_t) 2166136261U;
+    for ( p = (const unsigned char*) name; *p != '\0'; p++ ) {
+        h ^= (size_t) *p;
+        h *= (size_t) 16777619U;
+    }
+    return h;
+}
+
+
+static void lkconfig_symindex_init ( struct lkconfig_symindex* const sidx ) {
+    lkconfig_ptrmap_init ( &(sidx->map) );
+    sidx->syms        = NULL;
+    sidx->nsyms       = 0;
+    sidx->names       = NULL;
+    sidx->names_size  = 0;
+    sidx->names_count = 0;
+    sidx->pynames     = NULL;
+}
+
+
+static void lkconfig_symindex_free ( struct lkconfig_symindex* const sidx ) {
+    size_t k;
+
+    if ( sidx->pynames != NULL ) {
+        for ( k = 0; k < sidx->nsyms; k++ ) {
+            Py_XDECREF ( sidx->pynames [k] );
+        }
+        PyMem_Free ( sidx->pynames );
+    }
+
+    lkconfig_ptrmap_free ( &(sidx->map) );
+    PyMem_Free ( sidx->syms );
+    PyMem_Free ( sidx->names );
+    lkconfig_symindex_init ( sidx );
+}
+
+
+static void lkconfig_symindex__insert_name_nogrow (
+    struct lkconfig_symindex* const sidx,
+    const size_t hash,
+    const int index
+) {
+    const char* const name = sidx->syms [index]->name;
+    struct lkconfig_symindex_nameslot* slot;
+    size_t mask;
+    size_t k;
+
+    mask = sidx->names_size - 1;
+    for ( k = hash & mask; ; k = (k + 1) & mask ) {
+        slot = &(sidx->names [k]);
+
+        if ( slot->index < 0 ) {
+            slot->hash  = hash;
+            slot->index = index;
+            (sidx->names_count)++;
+            return;
+
+        } else if (
+            (slot->hash == hash)
+            && (strcmp ( sidx->syms [slot->index]->name, name ) == 0)
+        ) {
+            /* keep the first symbol, as sym_find() does */
+            return;
+        }
+    }
+}
+
+
+static int lkconfig_symindex__grow_names (
+    struct lkconfig_symindex* const sidx
+) {
+    struct lkconfig_symindex_nameslot* old_names;
+    size_t old_size;
+    size_t k;
+
+    old_names = sidx->names;
+    old_size  = sidx->names_size;
+
+    sidx->names_size = (
+        (old_size == 0) ? LKCONFIG_SYMINDEX_NAMES_INITIAL_SIZE : (2 * old_size)
+    );
+    sidx->names_count = 0;
+    sidx->names = PyMem_Malloc ( sidx->names_size * sizeof *(sidx->names) );
+
+    if ( sidx->names == NULL ) {
+        sidx->names      = old_names;
+        sidx->names_size = old_size;
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for ( k = 0; k < sidx->names_size; k++ ) {
+        (sidx->names [k]).index = -1;
+    }
+
+    /* the hashes are cached, rehashing does not touch the names */
+    for ( k = 0; k < old_size; k++ ) {
+        if ( (old_names [k]).index >= 0 ) {
+            lkconfig_symindex__insert_name_nogrow (
+                sidx, (old_names [k]).hash, (old_names [k]).index
+            );
+        }
+    }
+
+    PyMem_Free ( old_names );
+    return 0;
+}
+
+
+/**
+ * Adds the name of an indexed symbol to the name table.
+ *
+ * @param sidx   symbol index
+ * @param index  symbol index of the symbol
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_symindex__add_name (
+    struct lkconfig_symindex* const sidx, const int index
+) {
+    /* keep load factor <= 0.5 */
+    if ( (2 * (sidx->names_count + 1)) > sidx->names_size ) {
+        if ( lkconfig_symindex__grow_names ( sidx ) != 0 ) { return -1; }
+    }
+
+    lkconfig_symindex__insert_name_nogrow (
+        sidx, lkconfig_symindex_name_hash ( sidx->syms [index]->name ), index
+    );
+    return 0;
+}
+
+
+/**
+ * Indexes all symbols in lkc's globals.
+ * The index must be empty (initialized with lkconfig_symindex_init()).
+ *
+ * @param sidx  symbol index
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_symindex_build ( struct lkconfig_symindex* const sidx ) {
+    struct symbol* sym;
+    size_t count;
+    int i;
+
+    /* same symbol selection as lkconfig_get_symbols() */
+    count = 0;
+    for_all_symbols(i, sym) {
+        if ( sym->type != S_UNKNOWN ) { count++; }
+    }
+
+    sidx->syms    = PyMem_Malloc ( (count + 1) * sizeof *(sidx->syms) );
+    sidx->pynames = PyMem_Malloc ( (count + 1) * sizeof *(sidx->pynames) );
+    if ( (sidx->syms == NULL) || (sidx->pynames == NULL) ) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for_all_symbols(i, sym) {
+        if ( sym->type != S_UNKNOWN ) {
+            if (
+                lkconfig_ptrmap_set (
+                    &(sidx->map), sym, (int) sidx->nsyms
+                ) != 0
+            ) {
+                return -1;
+            }
+            sidx->pynames [sidx->nsyms] = NULL;
+            sidx->syms [(sidx->nsyms)++] = sym;
+
+            /* same symbol selection as sym_find() */
+            if (
+                (sym->name != NULL) && !(sym->flags & SYMBOL_CONST)
+                && (lkconfig_symindex__add_name (
+                    sidx, (int) (sidx->nsyms - 1)
+                ) != 0)
+            ) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * Looks up the index of a symbol.
+ *
+ * @param sidx  symbol index
+ * @param sym   symbol, may be NULL
+ *
+ * @return index, or -1 if the symbol is not indexed
+ * */
+static int lkconfig_symindex_get (
+    const struct lkconfig_symindex* const sidx,
+    const struct symbol* const sym
+) {
+    const int* idx;
+
+    if ( sym == NULL ) { return -1; }
+
+    idx = lkconfig_ptrmap_get ( &(sidx->map), sym );
+    return (idx == NULL) ? -1 : *idx;
+}
+
+
+/**
+ * Returns the symbol with the given index
+ * from the active context's symbol index.
+ *
+ * @param idx  symbol index
+ *
+ * @return symbol, or NULL if the index is out of range (python exception set)
+ * */
+static struct symbol* lkconfig_symindex_get_active_symbol (
+    const Py_ssize_t idx
+) {
+    const struct lkconfig_symindex* const sidx = (
+        &(lkconfig_active_context->symindex)
+    );
+
+    if ( (idx < 0) || ((size_t) idx >= sidx->nsyms) ) {
+        PyErr_Format (
+            PyExc_IndexError, "symbol index out of range: %zd", idx
+        );
+        return NULL;
+    }
+
+    return sidx->syms [idx];
+}
+
+
+/**
+ * Looks up the index of a symbol by name.
+ *
+ * @param sidx  symbol index
+ * @param name  symbol name
+ *
+ * @return index, or -1 if no symbol of that name is indexed
+ * */
+static int lkconfig_symindex_find_name (
+    const struct lkconfig_symindex* const sidx, const char* const name
+) {
+    const struct lkconfig_symindex_nameslot* slot;
+    size_t hash;
+    size_t mask;
+    size_t k;
+
+    if ( sidx->names_size == 0 ) { return -1; }
+
+    hash = lkconfig_symindex_name_hash ( name );
+    mask = sidx->names_size - 1;
+
+    for ( k = hash & mask; ; k = (k + 1) & mask ) {
+        slot = &(sidx->names [k]);
+
+        if ( slot->index < 0 ) {
+            return -1;
+
+        } else if (
+            (slot->hash == hash)
+            && (strcmp ( sidx->syms [slot->index]->name, name ) == 0)
+        ) {
+            return slot->index;
+        }
+    }
+}
+
+
+/**
+ * sym_find() variant that looks up indexed symbols
+ * in the active context's name table.
+ *
+ * Falls back to sym_find() for everything else,
+ * i.e. the "y", "m", "n" constants, symbols of unknown type
+ * and symbols created after parsing.
+ *
+ * @param name  symbol name
+ *
+ * @return symbol or NULL
+ * */
+static struct symbol* lkconfig_symindex_find_symbol ( const char* const name ) {
+    const struct lkconfig_symindex* const sidx = (
+        &(lkconfig_active_context->symindex)
+    );
+    int idx;
+
+    /* sym_find() maps single-char names to the constants first */
+    if ( (name [0] != '\0') && (name [1] != '\0') ) {
+        idx = lkconfig_symindex_find_name ( sidx, name );
+        if ( idx >= 0 ) { return sidx->syms [idx]; }
+    }
+
+    return sym_find ( name );
+}
+
+
+/**
+ * Returns the interned name str of an indexed symbol,
+ * which gets created on first access.
+ *
+ * @param sidx  symbol index
+ * @param idx   symbol index of the symbol
+ *
+ * @return borrowed reference to str or None,
+ *         NULL on error (python exception set)
+ * */
+static PyObject* lkconfig_symindex_get_pyname (
+    struct lkconfig_symindex* const sidx, const int idx
+) {
+    const char* name;
+
+    if ( sidx->pynames [idx] == NULL ) {
+        name = sidx->syms [idx]->name;
+
+        if ( name == NULL ) {
+            Py_INCREF ( Py_None );
+            sidx->pynames [idx] = Py_None;
+        } else {
+            sidx->pynames [idx] = PyUnicode_InternFromString ( name );
+            if ( sidx->pynames [idx] == NULL ) { return NULL; }
+        }
+    }
+
+    return sidx->pynames [idx];
+}
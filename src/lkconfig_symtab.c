@@ -0,0 +1,885 @@
+/*
+ * Bulk symbol export.
+ *
+ * get_symbol_table() walks all symbols once and returns a
+ * SymbolTable struct sequence made of parallel columns,
+ * instead of one SymbolView object per symbol
+ * (and further objects per get_<property>() call).
+ *
+ * Numeric columns are packed int arrays (bytes objects,
+ * use memoryview(col).cast("i") for accessing them).
+ *
+ * Expressions are exported as one flat, deduplicated node table
+ * (expr_types, expr_lefts, expr_rights, expr_syms) in topological order,
+ * i.e. each node's operands precede the node itself.
+ * lkc shares struct expr objects in some places and copies them in others
+ * (e.g. inherited menu dependencies), so nodes are deduplicated
+ * by struct expr pointer first and then structurally.
+ *
+ * Node operands depend on the node type:
+ *
+ *   E_SYMBOL                  expr_syms  -> index into expr_symbol_names
+ *   E_NOT                     expr_lefts -> node
+ *   E_AND, E_OR               expr_lefts, expr_rights -> node
+ *   E_EQUAL, ..., E_RANGE     expr_lefts, expr_rights -> E_SYMBOL node
+ *   E_LIST                    expr_lefts -> node or -1,
+ *                             expr_rights -> E_SYMBOL node
+ *
+ * Unused operands are set to -1. Symbol properties (dir_deps, ...)
+ * reference expressions by node index, with -1 meaning "no expression".
+ * Select targets and choice values are E_SYMBOL nodes.
+ *
+ * */
+
+#define lkconfig_SymbolTableName  "SymbolTable"
+
+enum {
+    lkconfig_symtab_names,
+    lkconfig_symtab_s_types,
+    lkconfig_symtab_flags,
+    lkconfig_symtab_dir_deps,
+    lkconfig_symtab_prompt_offsets,
+    lkconfig_symtab_prompt_counts,
+    lkconfig_symtab_prompt_texts,
+    lkconfig_symtab_prompt_vis_deps,
+    lkconfig_symtab_default_offsets,
+    lkconfig_symtab_default_counts,
+    lkconfig_symtab_default_dir_deps,
+    lkconfig_symtab_default_vis_deps,
+    lkconfig_symtab_select_offsets,
+    lkconfig_symtab_select_counts,
+    lkconfig_symtab_select_targets,
+    lkconfig_symtab_select_vis_deps,
+    lkconfig_symtab_choice_offsets,
+    lkconfig_symtab_choice_counts,
+    lkconfig_symtab_choice_values,
+    lkconfig_symtab_expr_types,
+    lkconfig_symtab_expr_lefts,
+    lkconfig_symtab_expr_rights,
+    lkconfig_symtab_expr_syms,
+    lkconfig_symtab_expr_symbol_names,
+
+    lkconfig__symtab_field_count
+};
+
+static PyStructSequence_Field lkconfig_SymbolTable_fields[] = {
+    { "names",            "list of symbol names (str or None)" },
+    { "s_types",          "packed int array of symbol types (S_*)" },
+    { "flags",            "packed int array of symbol flags (SYMBOL_*)" },
+    { "dir_deps",         "packed int array of dir_dep expr indices" },
+    { "prompt_offsets",   "packed int array, offset into prompt_texts" },
+    { "prompt_counts",    "packed int array, number of prompts" },
+    { "prompt_texts",     "list of prompt texts" },
+    { "prompt_vis_deps",  "packed int array of prompt visibility expr indices" },
+    { "default_offsets",  "packed int array, offset into default_dir_deps" },
+    { "default_counts",   "packed int array, number of defaults" },
+    { "default_dir_deps", "packed int array of default expr indices" },
+    { "default_vis_deps", "packed int array of default visibility expr indices" },
+    { "select_offsets",   "packed int array, offset into select_targets" },
+    { "select_counts",    "packed int array, number of selects" },
+    { "select_targets",   "packed int array of selected E_SYMBOL expr indices" },
+    { "select_vis_deps",  "packed int array of select condition expr indices" },
+    { "choice_offsets",   "packed int array, offset into choice_values" },
+    { "choice_counts",    "packed int array, number of choice values" },
+    { "choice_values",    "packed int array of choice value E_SYMBOL expr indices" },
+    { "expr_types",       "packed int array of expr node types (E_*)" },
+    { "expr_lefts",       "packed int array of left operand node indices" },
+    { "expr_rights",      "packed int array of right operand node indices" },
+    { "expr_syms",        "packed int array, E_SYMBOL node symbol indices" },
+    { "expr_symbol_names", "list of symbol names referenced by E_SYMBOL nodes" },
+    { NULL, NULL }
+};
+
+static PyStructSequence_Desc lkconfig_SymbolTable_desc = {
+    LKCONFIG_PYMOD_NAME "." lkconfig_SymbolTableName,
+    PyDoc_STR ( "packed kconfig symbol table, see get_symbol_table()" ),
+    lkconfig_SymbolTable_fields,
+    lkconfig__symtab_field_count
+};
+
+static PyTypeObject lkconfig_SymbolTableType;
+
+
+/* int columns, in the same order as the SymbolTable fields */
+enum {
+    lkconfig_symtab_col_s_types,
+    lkconfig_symtab_col_flags,
+    lkconfig_symtab_col_dir_deps,
+    lkconfig_symtab_col_prompt_offsets,
+    lkconfig_symtab_col_prompt_counts,
+    lkconfig_symtab_col_prompt_vis_deps,
+    lkconfig_symtab_col_default_offsets,
+    lkconfig_symtab_col_default_counts,
+    lkconfig_symtab_col_default_dir_deps,
+    lkconfig_symtab_col_default_vis_deps,
+    lkconfig_symtab_col_select_offsets,
+    lkconfig_symtab_col_select_counts,
+    lkconfig_symtab_col_select_targets,
+    lkconfig_symtab_col_select_vis_deps,
+    lkconfig_symtab_col_choice_offsets,
+    lkconfig_symtab_col_choice_counts,
+    lkconfig_symtab_col_choice_values,
+    lkconfig_symtab_col_expr_types,
+    lkconfig_symtab_col_expr_lefts,
+    lkconfig_symtab_col_expr_rights,
+    lkconfig_symtab_col_expr_syms,
+
+    lkconfig__symtab_col_count
+};
+
+struct lkconfig_symtab_builder {
+    PyObject* names;
+    PyObject* prompt_texts;
+    PyObject* expr_symbol_names;
+
+    struct lkconfig_intbuf cols[lkconfig__symtab_col_count];
+
+    /* struct expr* => node index */
+    struct lkconfig_ptrmap expr_map;
+    /* struct symbol* => expr_symbol_names index */
+    struct lkconfig_ptrmap expr_sym_map;
+
+    /* structural node dedup: hash set of node indices, -1 => empty slot */
+    int*   node_set;
+    size_t node_set_size;
+};
+
+
+static int lkconfig_symtab_builder_init (
+    struct lkconfig_symtab_builder* const builder
+) {
+    unsigned int k;
+
+    for ( k = 0; k < lkconfig__symtab_col_count; k++ ) {
+        lkconfig_intbuf_init ( &(builder->cols [k]) );
+    }
+
+    lkconfig_ptrmap_init ( &(builder->expr_map) );
+    lkconfig_ptrmap_init ( &(builder->expr_sym_map) );
+    builder->node_set      = NULL;
+    builder->node_set_size = 0;
+
+    builder->names             = PyList_New(0);
+    builder->prompt_texts      = PyList_New(0);
+    builder->expr_symbol_names = PyList_New(0);
+
+    if (
+        (builder->names == NULL)
+        || (builder->prompt_texts == NULL)
+        || (builder->expr_symbol_names == NULL)
+    ) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static void lkconfig_symtab_builder_free (
+    struct lkconfig_symtab_builder* const builder
+) {
+    unsigned int k;
+
+    for ( k = 0; k < lkconfig__symtab_col_count; k++ ) {
+        lkconfig_intbuf_free ( &(builder->cols [k]) );
+    }
+
+    lkconfig_ptrmap_free ( &(builder->expr_map) );
+    lkconfig_ptrmap_free ( &(builder->expr_sym_map) );
+    PyMem_Free ( builder->node_set );
+    builder->node_set      = NULL;
+    builder->node_set_size = 0;
+
+    Py_CLEAR ( builder->names );
+    Py_CLEAR ( builder->prompt_texts );
+    Py_CLEAR ( builder->expr_symbol_names );
+}
+
+#define lkconfig_symtab_builder_append_int(_builder, _col, _value)  \
+    lkconfig_intbuf_append ( \
+        &((_builder)->cols [lkconfig_symtab_col_ ## _col]), (_value) \
+    )
+
+#define lkconfig_symtab_builder_col_len(_builder, _col)  \
+    ((int) ((_builder)->cols [lkconfig_symtab_col_ ## _col]).len)
+
+
+/**
+ * Adds an optional string to a list, None is used for NULL strings.
+ *
+ * @param l    PyList
+ * @param s    str, may be NULL
+ *
+ * @return 0 on success, else non-zero
+ * */
+static int lkconfig_symtab_list_append_str_or_none (
+    PyObject* const l, const char* const s
+) {
+    if ( s == NULL ) {
+        return PyList_Append ( l, Py_None );
+    } else {
+        return lkconfig_list_append_steal_ref ( l, PyUnicode_FromString ( s ) );
+    }
+}
+
+
+#define lkconfig_symtab_builder_node_col(_builder, _col, _idx)  \
+    (((_builder)->cols [lkconfig_symtab_col_expr_ ## _col]).data [(_idx)])
+
+
+static size_t lkconfig_symtab_node_hash (
+    const int e_type, const int left, const int right, const int sym_idx
+) {
+    size_t h;
+
+    h = (size_t) e_type;
+    h = (h * 1000003) ^ (size_t) (unsigned int) left;
+    h = (h * 1000003) ^ (size_t) (unsigned int) right;
+    h = (h * 1000003) ^ (size_t) (unsigned int) sym_idx;
+    h ^= (h >> 16);
+    return h;
+}
+
+/**
+ * Looks up a node in the structural dedup table.
+ *
+ * @return pointer to the node's slot in node_set,
+ *         which is -1 if the node does not exist yet
+ * */
+static int* lkconfig_symtab_builder__find_node_slot (
+    struct lkconfig_symtab_builder* const builder,
+    const int e_type, const int left, const int right, const int sym_idx
+) {
+    size_t mask;
+    size_t k;
+    int node_idx;
+
+    mask = builder->node_set_size - 1;
+    for (
+        k = lkconfig_symtab_node_hash ( e_type, left, right, sym_idx ) & mask;
+        ;
+        k = (k + 1) & mask
+    ) {
+        node_idx = builder->node_set [k];
+
+        if (
+            (node_idx < 0)
+            || (
+                (lkconfig_symtab_builder_node_col(builder, types, node_idx) == e_type)
+                && (lkconfig_symtab_builder_node_col(builder, lefts, node_idx) == left)
+                && (lkconfig_symtab_builder_node_col(builder, rights, node_idx) == right)
+                && (lkconfig_symtab_builder_node_col(builder, syms, node_idx) == sym_idx)
+            )
+        ) {
+            return &(builder->node_set [k]);
+        }
+    }
+}
+
+static int lkconfig_symtab_builder__grow_node_set (
+    struct lkconfig_symtab_builder* const builder
+) {
+    int* old_set;
+    size_t old_size;
+    size_t k;
+    int node_idx;
+
+    old_set  = builder->node_set;
+    old_size = builder->node_set_size;
+
+    builder->node_set_size = (old_size == 0) ? 4096 : (2 * old_size);
+    builder->node_set = PyMem_Malloc (
+        builder->node_set_size * sizeof *(builder->node_set)
+    );
+    if ( builder->node_set == NULL ) {
+        builder->node_set      = old_set;
+        builder->node_set_size = old_size;
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for ( k = 0; k < builder->node_set_size; k++ ) {
+        builder->node_set [k] = -1;
+    }
+
+    for ( k = 0; k < old_size; k++ ) {
+        node_idx = old_set [k];
+        if ( node_idx >= 0 ) {
+            *(
+                lkconfig_symtab_builder__find_node_slot (
+                    builder,
+                    lkconfig_symtab_builder_node_col(builder, types, node_idx),
+                    lkconfig_symtab_builder_node_col(builder, lefts, node_idx),
+                    lkconfig_symtab_builder_node_col(builder, rights, node_idx),
+                    lkconfig_symtab_builder_node_col(builder, syms, node_idx)
+                )
+            ) = node_idx;
+        }
+    }
+
+    PyMem_Free ( old_set );
+    return 0;
+}
+
+/**
+ * Adds an expression node unless a structurally identical node exists.
+ *
+ * @return node index, or -2 on error
+ * */
+static int lkconfig_symtab_builder_add_node (
+    struct lkconfig_symtab_builder* const builder,
+    const int e_type, const int left, const int right, const int sym_idx
+) {
+    int* slot;
+    int node_idx;
+
+    node_idx = lkconfig_symtab_builder_col_len ( builder, expr_types );
+
+    /* keep load factor <= 0.5 */
+    if ( (size_t) (2 * (node_idx + 1)) > builder->node_set_size ) {
+        if ( lkconfig_symtab_builder__grow_node_set ( builder ) != 0 ) {
+            return -2;
+        }
+    }
+
+    slot = lkconfig_symtab_builder__find_node_slot (
+        builder, e_type, left, right, sym_idx
+    );
+    if ( *slot >= 0 ) { return *slot; }
+
+    if (
+        (lkconfig_symtab_builder_append_int ( builder, expr_types, e_type ) != 0)
+        || (lkconfig_symtab_builder_append_int ( builder, expr_lefts, left ) != 0)
+        || (lkconfig_symtab_builder_append_int ( builder, expr_rights, right ) != 0)
+        || (lkconfig_symtab_builder_append_int ( builder, expr_syms, sym_idx ) != 0)
+    ) {
+        return -2;
+    }
+
+    *slot = node_idx;
+    return node_idx;
+}
+
+/**
+ * Adds an E_SYMBOL node referencing the given symbol.
+ *
+ * @param builder   symbol table builder
+ * @param sym       symbol, may be NULL (node sym index is then -1)
+ *
+ * @return node index, or -2 on error
+ * */
+static int lkconfig_symtab_builder_add_symbol_node (
+    struct lkconfig_symtab_builder* const builder,
+    const struct symbol* const sym
+) {
+    const int* sym_idx_ptr;
+    int sym_idx;
+
+    if ( sym == NULL ) {
+        sym_idx = -1;
+
+    } else {
+        sym_idx_ptr = lkconfig_ptrmap_get ( &(builder->expr_sym_map), sym );
+
+        if ( sym_idx_ptr != NULL ) {
+            sym_idx = *sym_idx_ptr;
+
+        } else {
+            sym_idx = (int) PyList_GET_SIZE ( builder->expr_symbol_names );
+
+            if (
+                lkconfig_symtab_list_append_str_or_none (
+                    builder->expr_symbol_names, sym->name
+                ) != 0
+            ) {
+                return -2;
+            }
+
+            if (
+                lkconfig_ptrmap_set ( &(builder->expr_sym_map), sym, sym_idx )
+                != 0
+            ) {
+                return -2;
+            }
+        }
+    }
+
+    return lkconfig_symtab_builder_add_node (
+        builder, E_SYMBOL, -1, -1, sym_idx
+    );
+}
+
+/**
+ * Recursively adds an expression to the expression node table
+ * and returns the index of its top-level node.
+ *
+ * @param builder   symbol table builder
+ * @param e         expression, may be NULL
+ *
+ * @return node index, -1 if e is NULL (or E_NONE), -2 on error
+ * */
+static int lkconfig_symtab_builder_add_expr (
+    struct lkconfig_symtab_builder* const builder,
+    const struct expr* const e
+) {
+    const int* node_idx_ptr;
+    int node_idx;
+    int left;
+    int right;
+
+    if ( e == NULL ) { return -1; }
+
+    node_idx_ptr = lkconfig_ptrmap_get ( &(builder->expr_map), e );
+    if ( node_idx_ptr != NULL ) { return *node_idx_ptr; }
+
+    switch ( e->type ) {
+        case E_NONE:
+            return -1;
+
+        case E_SYMBOL:
+            node_idx = lkconfig_symtab_builder_add_symbol_node (
+                builder, (e->left).sym
+            );
+            break;
+
+        case E_NOT:
+            left = lkconfig_symtab_builder_add_expr ( builder, (e->left).expr );
+            if ( left < -1 ) { return -2; }
+
+            node_idx = lkconfig_symtab_builder_add_node (
+                builder, e->type, left, -1, -1
+            );
+            break;
+
+        case E_OR:
+        case E_AND:
+            left = lkconfig_symtab_builder_add_expr ( builder, (e->left).expr );
+            if ( left < -1 ) { return -2; }
+
+            right = lkconfig_symtab_builder_add_expr ( builder, (e->right).expr );
+            if ( right < -1 ) { return -2; }
+
+            node_idx = lkconfig_symtab_builder_add_node (
+                builder, e->type, left, right, -1
+            );
+            break;
+
+        case E_EQUAL:
+        case E_UNEQUAL:
+        case E_LTH:
+        case E_LEQ:
+        case E_GTH:
+        case E_GEQ:
+        case E_RANGE:
+            left = lkconfig_symtab_builder_add_symbol_node (
+                builder, (e->left).sym
+            );
+            if ( left < -1 ) { return -2; }
+
+            right = lkconfig_symtab_builder_add_symbol_node (
+                builder, (e->right).sym
+            );
+            if ( right < -1 ) { return -2; }
+
+            node_idx = lkconfig_symtab_builder_add_node (
+                builder, e->type, left, right, -1
+            );
+            break;
+
+        case E_LIST:
+            left = lkconfig_symtab_builder_add_expr ( builder, (e->left).expr );
+            if ( left < -1 ) { return -2; }
+
+            right = lkconfig_symtab_builder_add_symbol_node (
+                builder, (e->right).sym
+            );
+            if ( right < -1 ) { return -2; }
+
+            node_idx = lkconfig_symtab_builder_add_node (
+                builder, e->type, left, right, -1
+            );
+            break;
+
+        default:
+            PyErr_Format ( PyExc_ValueError, "unknown type '%d'", e->type );
+            return -2;
+    }
+
+    if ( node_idx < 0 ) { return -2; }
+
+    if ( lkconfig_ptrmap_set ( &(builder->expr_map), e, node_idx ) != 0 ) {
+        return -2;
+    }
+
+    return node_idx;
+}
+
+#undef lkconfig_symtab_builder_node_col
+
+
+static int lkconfig_symtab_builder_add_prompts (
+    struct lkconfig_symtab_builder* const builder,
+    const struct symbol* const sym
+) {
+    const struct property* prompt;
+    int count;
+    int eidx;
+
+    if (
+        lkconfig_symtab_builder_append_int (
+            builder, prompt_offsets,
+            lkconfig_symtab_builder_col_len ( builder, prompt_vis_deps )
+        ) != 0
+    ) {
+        return -1;
+    }
+
+    count = 0;
+    for_all_prompts ( sym, prompt ) {
+        /* see lkconfig_SymbolViewObject_get_prompt() */
+        if ( prompt->text != NULL ) {
+            eidx = lkconfig_symtab_builder_add_expr (
+                builder, prompt->visible.expr
+            );
+            if ( eidx < -1 ) { return -1; }
+
+            if (
+                lkconfig_symtab_list_append_str_or_none (
+                    builder->prompt_texts, prompt->text
+                ) != 0
+            ) {
+                return -1;
+            }
+
+            if (
+                lkconfig_symtab_builder_append_int (
+                    builder, prompt_vis_deps, eidx
+                ) != 0
+            ) {
+                return -1;
+            }
+
+            count++;
+        }
+    }
+
+    return lkconfig_symtab_builder_append_int ( builder, prompt_counts, count );
+}
+
+
+static int lkconfig_symtab_builder_add_defaults (
+    struct lkconfig_symtab_builder* const builder,
+    const struct symbol* const sym
+) {
+    const struct property* prop;
+    int count;
+    int eidx;
+
+    if (
+        lkconfig_symtab_builder_append_int (
+            builder, default_offsets,
+            lkconfig_symtab_builder_col_len ( builder, default_dir_deps )
+        ) != 0
+    ) {
+        return -1;
+    }
+
+    count = 0;
+    for_all_defaults ( sym, prop ) {
+        eidx = lkconfig_symtab_builder_add_expr ( builder, prop->expr );
+        if ( eidx < -1 ) { return -1; }
+
+        if (
+            lkconfig_symtab_builder_append_int (
+                builder, default_dir_deps, eidx
+            ) != 0
+        ) {
+            return -1;
+        }
+
+        eidx = lkconfig_symtab_builder_add_expr (
+            builder, (prop->visible).expr
+        );
+        if ( eidx < -1 ) { return -1; }
+
+        if (
+            lkconfig_symtab_builder_append_int (
+                builder, default_vis_deps, eidx
+            ) != 0
+        ) {
+            return -1;
+        }
+
+        count++;
+    }
+
+    return lkconfig_symtab_builder_append_int ( builder, default_counts, count );
+}
+
+
+static int lkconfig_symtab_builder_add_selects (
+    struct lkconfig_symtab_builder* const builder,
+    const struct symbol* const sym
+) {
+    const struct property* prop;
+    int count;
+    int eidx;
+
+    if (
+        lkconfig_symtab_builder_append_int (
+            builder, select_offsets,
+            lkconfig_symtab_builder_col_len ( builder, select_targets )
+        ) != 0
+    ) {
+        return -1;
+    }
+
+    count = 0;
+    for_all_properties ( sym, prop, P_SELECT ) {
+        eidx = lkconfig_symtab_builder_add_expr ( builder, prop->expr );
+        if ( eidx < -1 ) { return -1; }
+
+        if (
+            lkconfig_symtab_builder_append_int (
+                builder, select_targets, eidx
+            ) != 0
+        ) {
+            return -1;
+        }
+
+        eidx = lkconfig_symtab_builder_add_expr (
+            builder, (prop->visible).expr
+        );
+        if ( eidx < -1 ) { return -1; }
+
+        if (
+            lkconfig_symtab_builder_append_int (
+                builder, select_vis_deps, eidx
+            ) != 0
+        ) {
+            return -1;
+        }
+
+        count++;
+    }
+
+    return lkconfig_symtab_builder_append_int ( builder, select_counts, count );
+}
+
+
+static int lkconfig_symtab_builder_add_choice_values (
+    struct lkconfig_symtab_builder* const builder,
+    struct symbol* const sym
+) {
+    const struct property* prop;
+    struct expr* e;
+    struct symbol* choice_sym;
+    int count;
+    int eidx;
+
+    if (
+        lkconfig_symtab_builder_append_int (
+            builder, choice_offsets,
+            lkconfig_symtab_builder_col_len ( builder, choice_values )
+        ) != 0
+    ) {
+        return -1;
+    }
+
+    count = 0;
+    prop  = sym_is_choice ( sym ) ? sym_get_choice_prop ( sym ) : NULL;
+    if ( prop != NULL ) {
+        expr_list_for_each_sym ( prop->expr, e, choice_sym ) {
+            eidx = lkconfig_symtab_builder_add_symbol_node (
+                builder, choice_sym
+            );
+            if ( eidx < 0 ) { return -1; }
+
+            if (
+                lkconfig_symtab_builder_append_int (
+                    builder, choice_values, eidx
+                ) != 0
+            ) {
+                return -1;
+            }
+
+            count++;
+        }
+    }
+
+    return lkconfig_symtab_builder_append_int ( builder, choice_counts, count );
+}
+
+
+static int lkconfig_symtab_builder_add_symbol (
+    struct lkconfig_symtab_builder* const builder,
+    struct symbol* const sym
+) {
+    struct lkconfig_symindex* const symindex = (
+        &(lkconfig_active_context->symindex)
+    );
+    PyObject* name;
+    int sym_idx;
+    int eidx;
+
+    /* reuse the interned name of indexed symbols */
+    sym_idx = lkconfig_symindex_get ( symindex, sym );
+    if ( sym_idx >= 0 ) {
+        name = lkconfig_symindex_get_pyname ( symindex, sym_idx );
+        if (
+            (name == NULL) || (PyList_Append ( builder->names, name ) != 0)
+        ) {
+            return -1;
+        }
+
+    } else if (
+        lkconfig_symtab_list_append_str_or_none ( builder->names, sym->name )
+        != 0
+    ) {
+        return -1;
+    }
+
+    if (
+        lkconfig_symtab_builder_append_int ( builder, s_types, sym->type ) != 0
+    ) {
+        return -1;
+    }
+
+    if (
+        lkconfig_symtab_builder_append_int ( builder, flags, sym->flags ) != 0
+    ) {
+        return -1;
+    }
+
+    eidx = lkconfig_symtab_builder_add_expr ( builder, (sym->dir_dep).expr );
+    if ( eidx < -1 ) { return -1; }
+
+    if (
+        lkconfig_symtab_builder_append_int ( builder, dir_deps, eidx ) != 0
+    ) {
+        return -1;
+    }
+
+    if ( lkconfig_symtab_builder_add_prompts ( builder, sym ) != 0 ) {
+        return -1;
+    }
+
+    if ( lkconfig_symtab_builder_add_defaults ( builder, sym ) != 0 ) {
+        return -1;
+    }
+
+    if ( lkconfig_symtab_builder_add_selects ( builder, sym ) != 0 ) {
+        return -1;
+    }
+
+    if ( lkconfig_symtab_builder_add_choice_values ( builder, sym ) != 0 ) {
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Creates a SymbolTable struct sequence from a filled builder.
+ *
+ * The builder's lists are transferred to the SymbolTable
+ * (builder->names etc. are set to NULL), but the int buffers are not,
+ * so lkconfig_symtab_builder_free() still needs to be called afterwards.
+ *
+ * @param builder   symbol table builder
+ *
+ * @return new reference to a SymbolTable object, or NULL on error
+ * */
+static PyObject* lkconfig_symtab_builder_finalize (
+    struct lkconfig_symtab_builder* const builder
+) {
+    static const int col_field_map[lkconfig__symtab_col_count] = {
+        lkconfig_symtab_s_types,
+        lkconfig_symtab_flags,
+        lkconfig_symtab_dir_deps,
+        lkconfig_symtab_prompt_offsets,
+        lkconfig_symtab_prompt_counts,
+        lkconfig_symtab_prompt_vis_deps,
+        lkconfig_symtab_default_offsets,
+        lkconfig_symtab_default_counts,
+        lkconfig_symtab_default_dir_deps,
+        lkconfig_symtab_default_vis_deps,
+        lkconfig_symtab_select_offsets,
+        lkconfig_symtab_select_counts,
+        lkconfig_symtab_select_targets,
+        lkconfig_symtab_select_vis_deps,
+        lkconfig_symtab_choice_offsets,
+        lkconfig_symtab_choice_counts,
+        lkconfig_symtab_choice_values,
+        lkconfig_symtab_expr_types,
+        lkconfig_symtab_expr_lefts,
+        lkconfig_symtab_expr_rights,
+        lkconfig_symtab_expr_syms
+    };
+
+    PyObject* symtab;
+    PyObject* col;
+    unsigned int k;
+
+    symtab = PyStructSequence_New ( &lkconfig_SymbolTableType );
+    if ( symtab == NULL ) { return NULL; }
+
+    for ( k = 0; k < lkconfig__symtab_col_count; k++ ) {
+        col = lkconfig_intbuf_to_bytes ( &(builder->cols [k]) );
+        if ( col == NULL ) {
+            Py_DECREF ( symtab );
+            return NULL;
+        }
+        PyStructSequence_SET_ITEM ( symtab, col_field_map [k], col );
+    }
+
+    PyStructSequence_SET_ITEM ( symtab, lkconfig_symtab_names, builder->names );
+    builder->names = NULL;
+
+    PyStructSequence_SET_ITEM (
+        symtab, lkconfig_symtab_prompt_texts, builder->prompt_texts
+    );
+    builder->prompt_texts = NULL;
+
+    PyStructSequence_SET_ITEM (
+        symtab, lkconfig_symtab_expr_symbol_names, builder->expr_symbol_names
+    );
+    builder->expr_symbol_names = NULL;
+
+    return symtab;
+}
+
+
+static PyObject* lkconfig__get_symbol_table ( PyObject* self, PyObject* noargs ) {
+    struct lkconfig_symtab_builder builder;
+    unsigned int i;
+    struct symbol* sym;
+    PyObject* symtab;
+
+    if ( lkconfig_symtab_builder_init ( &builder ) != 0 ) {
+        lkconfig_symtab_builder_free ( &builder );
+        return NULL;
+    }
+
+    for_all_symbols(i, sym) {
+        /* same symbol selection as lkconfig_get_symbols() */
+        if ( sym->type != S_UNKNOWN ) {
+            if ( lkconfig_symtab_builder_add_symbol ( &builder, sym ) != 0 ) {
+                lkconfig_symtab_builder_free ( &builder );
+                return NULL;
+            }
+        }
+    }
+
+    symtab = lkconfig_symtab_builder_finalize ( &builder );
+    lkconfig_symtab_builder_free ( &builder );
+    return symtab;
+}
+
+
+static int lkconfig_SymbolTable_cls_init ( PyTypeObject* const pycls ) {
+    return PyStructSequence_InitType2 ( pycls, &lkconfig_SymbolTable_desc );
+}
+
+#undef lkconfig_symtab_builder_col_len
+#undef lkconfig_symtab_builder_append_int
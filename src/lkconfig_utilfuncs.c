@@ -133,3 +133,253 @@ static int lkconfig_log (
 
     return ret;
 }
+
+
+/**
+ * Determines the lowest log level that is enabled for a logger,
+ * so that messages for disabled levels need not be formatted at all.
+ *
+ * Uses the logger's getEffectiveLevel() method if available,
+ * otherwise all log levels are considered enabled.
+ *
+ * @param logger     logger, may be NULL (no log level enabled)
+ * @param level_out  lowest enabled lkconfig_{debug,...} log level,
+ *                   or lkconfig__log_level_count if logging is disabled
+ *
+ * @return 0 => success, non-zero => failure
+ * */
+static int lkconfig_logger_get_level (
+    PyObject* const logger, int* const level_out
+) {
+    /* numeric values of logging.DEBUG, ..., logging.CRITICAL */
+    static const long py_levels[lkconfig__log_level_count] = {
+        10, 20, 30, 40, 50
+    };
+    PyObject* py_level_obj;
+    long py_level;
+    int level;
+
+    if ( logger == NULL ) {
+        *level_out = lkconfig__log_level_count;
+        return 0;
+    }
+
+    *level_out = lkconfig_debug;
+
+    if ( ! PyObject_HasAttrString ( logger, "getEffectiveLevel" ) ) {
+        return 0;
+    }
+
+    py_level_obj = PyObject_CallMethod (
+        logger, (char*) "getEffectiveLevel", NULL
+    );
+    if ( py_level_obj == NULL ) { return -1; }
+
+    py_level = PyLong_AsLong ( py_level_obj );
+    Py_DECREF ( py_level_obj );
+    if ( (py_level == -1) && PyErr_Occurred() ) { return -1; }
+
+    for (
+        level = lkconfig_debug;
+        (level < lkconfig__log_level_count) && (py_levels [level] < py_level);
+        level++
+    ) { ; }
+
+    *level_out = level;
+    return 0;
+}
+
+
+/**
+ * Initializes an int buffer.
+ *
+ * @param ibuf   int buffer, uninitialized
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_intbuf_init ( struct lkconfig_intbuf* const ibuf ) {
+    ibuf->data = NULL;
+    ibuf->len  = 0;
+    ibuf->cap  = 0;
+}
+
+/**
+ * Frees an int buffer's data and resets it to the empty state.
+ *
+ * @param ibuf   int buffer
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_intbuf_free ( struct lkconfig_intbuf* const ibuf ) {
+    PyMem_Free ( ibuf->data );
+    lkconfig_intbuf_init ( ibuf );
+}
+
+/**
+ * Appends an int to an int buffer, growing it if necessary.
+ * A python exception is created if the buffer cannot be grown.
+ *
+ * @param ibuf   int buffer
+ * @param value  int to append
+ *
+ * @return 0 on success, else non-zero
+ * */
+static int lkconfig_intbuf_append (
+    struct lkconfig_intbuf* const ibuf, const int value
+) {
+    int* new_data;
+    size_t new_cap;
+
+    if ( ibuf->len >= ibuf->cap ) {
+        new_cap  = (ibuf->cap == 0) ? 1024 : (2 * ibuf->cap);
+        new_data = PyMem_Realloc ( ibuf->data, new_cap * sizeof *new_data );
+        if ( new_data == NULL ) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        ibuf->data = new_data;
+        ibuf->cap  = new_cap;
+    }
+
+    ibuf->data [ibuf->len++] = value;
+    return 0;
+}
+
+/**
+ * Creates a new bytes object from an int buffer's data.
+ * The bytes object can be accessed on the Python side
+ * via memoryview(obj).cast("i").
+ *
+ * @param ibuf   int buffer
+ *
+ * @return new reference to a bytes object, or NULL on error
+ * */
+static PyObject* lkconfig_intbuf_to_bytes (
+    const struct lkconfig_intbuf* const ibuf
+) {
+    return PyBytes_FromStringAndSize (
+        (const char*) ibuf->data, (Py_ssize_t) (ibuf->len * sizeof (int))
+    );
+}
+
+
+/**
+ * Initializes a message buffer.
+ *
+ * @param mbuf   message buffer, uninitialized
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_msgbuf_init ( struct lkconfig_msgbuf* const mbuf ) {
+    mbuf->msgv    = NULL;
+    mbuf->len     = 0;
+    mbuf->cap     = 0;
+    mbuf->dropped = 0;
+}
+
+/**
+ * Frees a message buffer's messages and resets it to the empty state.
+ * May be called without holding the GIL.
+ *
+ * @param mbuf   message buffer
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_msgbuf_free ( struct lkconfig_msgbuf* const mbuf ) {
+    size_t k;
+
+    for ( k = 0; k < mbuf->len; k++ ) {
+        PyMem_RawFree ( mbuf->msgv [k] );
+    }
+    PyMem_RawFree ( mbuf->msgv );
+    lkconfig_msgbuf_init ( mbuf );
+}
+
+/**
+ * Formats a message and appends it to a message buffer.
+ * May be called without holding the GIL.
+ *
+ * Messages that cannot be stored due to memory allocation failure
+ * are counted as dropped.
+ *
+ * @param mbuf    message buffer
+ * @param format  printf-like format string
+ * @param vargs   format varargs
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_msgbuf_appendv (
+    struct lkconfig_msgbuf* const mbuf,
+    const char* const format,
+    va_list vargs
+) {
+    va_list vargs_copy;
+    char** new_msgv;
+    char* msg;
+    size_t new_cap;
+    int msg_len;
+
+    va_copy ( vargs_copy, vargs );
+    msg_len = vsnprintf ( NULL, 0, format, vargs_copy );
+    va_end ( vargs_copy );
+
+    if ( msg_len < 0 ) {
+        (mbuf->dropped)++;
+        return;
+    }
+
+    if ( mbuf->len >= mbuf->cap ) {
+        new_cap  = (mbuf->cap == 0) ? 64 : (2 * mbuf->cap);
+        new_msgv = PyMem_RawRealloc ( mbuf->msgv, new_cap * sizeof *new_msgv );
+        if ( new_msgv == NULL ) {
+            (mbuf->dropped)++;
+            return;
+        }
+        mbuf->msgv = new_msgv;
+        mbuf->cap  = new_cap;
+    }
+
+    msg = PyMem_RawMalloc ( (size_t) msg_len + 1 );
+    if ( msg == NULL ) {
+        (mbuf->dropped)++;
+        return;
+    }
+
+    vsnprintf ( msg, (size_t) msg_len + 1, format, vargs );
+    mbuf->msgv [mbuf->len++] = msg;
+}
+
+/**
+ * Passes all messages from a message buffer to a logger
+ * and empties the buffer, even if logging fails.
+ * The GIL must be held.
+ *
+ * @param mbuf       message buffer
+ * @param logger     logger, may be NULL
+ * @param log_level  log level, must be one of lkconfig_{debug,...}
+ *
+ * @return 0 => success, non-zero => failure
+ * */
+static int lkconfig_msgbuf_flush (
+    struct lkconfig_msgbuf* const mbuf,
+    PyObject* const logger,
+    const int log_level
+) {
+    size_t k;
+    int ret;
+
+    ret = 0;
+    for ( k = 0; (ret == 0) && (k < mbuf->len); k++ ) {
+        ret = lkconfig_log ( logger, log_level, "%s", mbuf->msgv [k] );
+    }
+
+    if ( (ret == 0) && (mbuf->dropped > 0) ) {
+        ret = lkconfig_log (
+            logger, lkconfig_warning,
+            "%zu log messages have been dropped", mbuf->dropped
+        );
+    }
+
+    lkconfig_msgbuf_free ( mbuf );
+    return ret;
+}
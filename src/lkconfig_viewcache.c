@@ -0,0 +1,120 @@
+/*
+ * A per-context cache of SymbolView/ExprView objects,
+ * which keeps at most one view per lkc object.
+ *
+ * The cache does not own the views, it holds borrowed references
+ * that get removed by the views' dealloc functions,
+ * see lkconfig_viewcache_forget().
+ * Views keep their context alive, so the cache outlives its views
+ * unless the context gets cleared, in which case the remaining views
+ * are simply forgotten. They are invalid then,
+ * see lkconfig_context_check_view().
+ *
+ * Lookups and modifications require the GIL.
+ *
+ * */
+
+
+static void lkconfig_viewcache_init ( struct lkconfig_viewcache* const vc ) {
+    lkconfig_ptrmap_init ( &(vc->map) );
+    vc->views = NULL;
+    vc->len   = 0;
+    vc->cap   = 0;
+}
+
+
+static void lkconfig_viewcache_free ( struct lkconfig_viewcache* const vc ) {
+    lkconfig_ptrmap_free ( &(vc->map) );
+    PyMem_Free ( vc->views );
+    lkconfig_viewcache_init ( vc );
+}
+
+
+/**
+ * Looks up the view of an lkc object.
+ *
+ * @param vc   view cache
+ * @param obj  lkc object, must not be NULL
+ *
+ * @return new reference to the view, or NULL if not cached
+ * */
+static PyObject* lkconfig_viewcache_get (
+    const struct lkconfig_viewcache* const vc, const void* const obj
+) {
+    const int* slot;
+    PyObject* view;
+
+    slot = lkconfig_ptrmap_get ( &(vc->map), obj );
+    if ( slot == NULL ) { return NULL; }
+
+    view = vc->views [*slot];
+    Py_XINCREF ( view );
+    return view;
+}
+
+
+/**
+ * Adds the view of an lkc object to the cache.
+ *
+ * @param vc    view cache
+ * @param obj   lkc object, must not be NULL
+ * @param view  view (borrowed)
+ *
+ * @return 0 on success, else non-zero (python exception set)
+ * */
+static int lkconfig_viewcache_add (
+    struct lkconfig_viewcache* const vc,
+    const void* const obj,
+    PyObject* const view
+) {
+    PyObject** new_views;
+    const int* slot;
+    size_t new_cap;
+
+    /* slots of dead views get reused */
+    slot = lkconfig_ptrmap_get ( &(vc->map), obj );
+    if ( slot != NULL ) {
+        vc->views [*slot] = view;
+        return 0;
+    }
+
+    if ( vc->len >= vc->cap ) {
+        new_cap   = (vc->cap == 0) ? 256 : (2 * vc->cap);
+        new_views = PyMem_Realloc ( vc->views, new_cap * sizeof *new_views );
+        if ( new_views == NULL ) { PyErr_NoMemory(); return -1; }
+
+        vc->views = new_views;
+        vc->cap   = new_cap;
+    }
+
+    if ( lkconfig_ptrmap_set ( &(vc->map), obj, (int) vc->len ) != 0 ) {
+        return -1;
+    }
+    vc->views [(vc->len)++] = view;
+    return 0;
+}
+
+
+/**
+ * Removes a view from the cache, if it is the view of the given object.
+ *
+ * @param vc    view cache
+ * @param obj   lkc object, may be NULL
+ * @param view  view
+ *
+ * @return None (implicit)
+ * */
+static void lkconfig_viewcache_forget (
+    struct lkconfig_viewcache* const vc,
+    const void* const obj,
+    const PyObject* const view
+) {
+    const int* slot;
+
+    if ( obj == NULL ) { return; }
+
+    slot = lkconfig_ptrmap_get ( &(vc->map), obj );
+    if ( (slot != NULL) && (vc->views [*slot] == view) ) {
+        vc->views [*slot] = NULL;
+    }
+}